@@ -188,6 +188,7 @@ void tscGetMetricMetaCacheKey(SSqlCmd* pCmd, char* keyStr, uint64_t uid);
 int  tscGetMetricMeta(SSqlObj* pSql);
 int  tscGetMeterMeta(SSqlObj* pSql, char* meterId, int32_t tableIndex);
 int  tscGetMeterMetaEx(SSqlObj* pSql, char* meterId, bool createIfNotExists);
+int  tscCreateTablesInBatch(SSqlObj* pSql, char* items, int32_t len, int32_t numOfTables);
 
 void tscResetForNextRetrieve(SSqlRes* pRes);
 
@@ -100,9 +100,20 @@ enum _sql_cmd {
   TSDB_SQL_CURRENT_USER,
   TSDB_SQL_CFG_LOCAL,
 
+  /*
+   * appended here so that the values above keep their numbering, it is still
+   * a write command sent to the mgmt node, see TSC_IS_MGMT_CMD
+   */
+  TSDB_SQL_MULTI_CREATE_TABLE,
+
   TSDB_SQL_MAX
 };
 
+#define TSC_IS_MGMT_WRITE_CMD(cmd) \
+  (((cmd) > TSDB_SQL_MGMT && (cmd) < TSDB_SQL_READ) || (cmd) == TSDB_SQL_MULTI_CREATE_TABLE)
+#define TSC_IS_MGMT_CMD(cmd) \
+  (((cmd) > TSDB_SQL_MGMT && (cmd) < TSDB_SQL_LOCAL) || (cmd) == TSDB_SQL_MULTI_CREATE_TABLE)
+
 // forward declaration
 struct SSqlInfo;
 
@@ -274,6 +285,7 @@ typedef struct {
 
   int8_t          isInsertFromFile;  // load data from file or not
   bool            import;            // import/insert type
+  bool            columnar;          // submit blocks in payload are column-major, see TSDB_SUBMIT_COLUMNAR
   char            msgType;
   uint16_t        type;  // query type
   char            intervalTimeUnit;
@@ -360,6 +372,8 @@ typedef struct _tsc_obj {
   struct _sql_obj *pHb;
   struct _sql_obj *sqlList;
   struct _sstream *streamList;
+  int32_t          submitCredits;  // submits the vnode can still park, from the last submit response, -1 if unknown
+  uint32_t         features;       // TSDB_CONN_FEATURE_XXX advertised by mgmt node in the connect response
   pthread_mutex_t  mutex;
 } STscObj;
 
@@ -371,6 +385,7 @@ typedef struct _sql_obj {
   void *            param;
   uint32_t          ip;
   short             vnode;
+  uint32_t          vnodeFeatures;  // TSDB_VNODE_FEATURE_XXX of the ip/vnode, if the last response is a submit response
   int64_t           stime;
   uint32_t          queryId;
   void *            thandle;
@@ -503,9 +503,23 @@ static void setInitialValueForRangeQueryCondition(tSKipListQueryCond *q, int8_t
 }
 
 static void tSQLDoFilterInitialResult(tSkipList *pSkipList, bool (*fp)(), tQueryInfo *queryColInfo,
-                                      tQueryResultset *result) {
+                                      tQueryResultset *result, SBinaryFilterSupp *param) {
+  /*
+   * the first tag column is indexed by pSkipList itself, the other tag columns may have secondary indexes,
+   * whose nodes keep the node of pSkipList as data
+   */
+  tSkipList *pIndex = NULL;
+  if (queryColInfo->colIdx == 0) {
+    pIndex = pSkipList;
+  } else if (queryColInfo->colIdx > 0 && param->getIndexFn != NULL) {
+    pIndex = param->getIndexFn(param->pExtInfo, queryColInfo->colIdx);
+  }
+
   // primary key filter, search according to skiplist
-  if (queryColInfo->colIdx == 0 && queryColInfo->optr != TSDB_RELATION_LIKE) {
+  if (pIndex != NULL && queryColInfo->optr != TSDB_RELATION_LIKE) {
+    tSkipList *pOrigin = pSkipList;
+    pSkipList = pIndex;
+
     tSKipListQueryCond q;
     setInitialValueForRangeQueryCondition(&q, queryColInfo->q.nType);
 
@@ -548,6 +562,12 @@ static void tSQLDoFilterInitialResult(tSkipList *pSkipList, bool (*fp)(), tQuery
 
     tSkipListDestroyKey(&q.upperBnd);
     tSkipListDestroyKey(&q.lowerBnd);
+
+    if (pIndex != pOrigin) {
+      for (int32_t i = 0; i < result->num; ++i) {
+        result->pRes[i] = ((tSkipListNode *)result->pRes[i])->pData;
+      }
+    }
   } else {
     /*
      * Brutal force scan the whole skiplit to find the appropriate result,
@@ -736,6 +756,41 @@ static void tSQLBinaryTraverseOnSkipList(tSQLBinaryExpr *pExpr, tQueryResultset
   pResult->num = n;
 }
 
+/*
+ * rough cost of filtering through the index, the smaller the more selective: point query, range query,
+ * and the others which almost return the whole index
+ */
+static int32_t tSQLIndexFilterCost(tSQLBinaryExpr *pExpr) {
+  const int32_t FULL_SCAN_COST = 64;
+
+  if (pExpr->filterOnPrimaryKey == 0) {
+    return FULL_SCAN_COST;
+  }
+
+  if (pExpr->pLeft->nodeType == TSQL_NODE_EXPR && pExpr->pRight->nodeType == TSQL_NODE_EXPR) {
+    int32_t left = tSQLIndexFilterCost(pExpr->pLeft->pExpr);
+    int32_t right = tSQLIndexFilterCost(pExpr->pRight->pExpr);
+
+    if (pExpr->nSQLBinaryOptr == TSDB_RELATION_AND) {
+      return MIN(left, right);
+    } else {
+      return MIN(left + right, FULL_SCAN_COST);
+    }
+  }
+
+  switch (pExpr->nSQLBinaryOptr) {
+    case TSDB_RELATION_EQUAL:
+      return 1;
+    case TSDB_RELATION_LESS:
+    case TSDB_RELATION_LESS_EQUAL:
+    case TSDB_RELATION_LARGE:
+    case TSDB_RELATION_LARGE_EQUAL:
+      return 4;
+    default:
+      return 16;
+  }
+}
+
 // post-root order traverse syntax tree
 void tSQLBinaryExprTraverse(tSQLBinaryExpr *pExpr, tSkipList *pSkipList, tQueryResultset *result,
                             SBinaryFilterSupp *param) {
@@ -750,7 +805,7 @@ void tSQLBinaryExprTraverse(tSQLBinaryExpr *pExpr, tSkipList *pSkipList, tQueryR
   if (pLeft->nodeType == TSQL_NODE_EXPR || pRight->nodeType == TSQL_NODE_EXPR) {
     uint8_t weight = pLeft->pExpr->filterOnPrimaryKey + pRight->pExpr->filterOnPrimaryKey;
 
-    if (weight == 0 && result->num > 0 && pSkipList == NULL) {
+    if (pSkipList == NULL) {
       /**
        * Perform the filter operation based on the initial filter result, which is obtained from filtering from index.
        * Since no index presented, the filter operation is done by scan all elements in the result set.
@@ -764,35 +819,33 @@ void tSQLBinaryExprTraverse(tSQLBinaryExpr *pExpr, tSkipList *pSkipList, tQueryR
        */
       assert(result->num == 0);
       tSQLBinaryTraverseOnSkipList(pExpr, result, pSkipList, param);
-    } else if (weight == 2 || (weight == 1 && pExpr->nSQLBinaryOptr == TSDB_RELATION_OR)) {
+    } else if (pExpr->nSQLBinaryOptr == TSDB_RELATION_OR) {
       tQueryResultset rLeft = {0};
       tQueryResultset rRight = {0};
 
       tSQLBinaryExprTraverse(pLeft->pExpr, pSkipList, &rLeft, param);
       tSQLBinaryExprTraverse(pRight->pExpr, pSkipList, &rRight, param);
 
-      if (pExpr->nSQLBinaryOptr == TSDB_RELATION_AND) {  // CROSS
-        intersect(&rLeft, &rRight, result);
-      } else if (pExpr->nSQLBinaryOptr == TSDB_RELATION_OR) {  // or
-        merge(&rLeft, &rRight, result);
+      if (param->mergeFn != NULL) {
+        param->mergeFn(param->pExtInfo, &rLeft, &rRight, result);
       } else {
-        assert(false);
+        merge(&rLeft, &rRight, result);
       }
 
       free(rLeft.pRes);
       free(rRight.pRes);
     } else {
       /*
-       * (weight == 1 && pExpr->nSQLBinaryOptr == TSDB_RELATION_AND) is handled here
+       * (weight > 0 && pExpr->nSQLBinaryOptr == TSDB_RELATION_AND) is handled here
        *
-       * first, we filter results based on the skiplist index, which is the initial filter stage,
+       * first, we filter results based on the most selective index, which is the initial filter stage,
        * then, we conduct the secondary filter operation based on the result from the initial filter stage.
        */
       assert(pExpr->nSQLBinaryOptr == TSDB_RELATION_AND);
 
       tSQLBinaryExpr *pFirst = NULL;
       tSQLBinaryExpr *pSecond = NULL;
-      if (pLeft->pExpr->filterOnPrimaryKey == 1) {
+      if (tSQLIndexFilterCost(pLeft->pExpr) <= tSQLIndexFilterCost(pRight->pExpr)) {
         pFirst = pLeft->pExpr;
         pSecond = pRight->pExpr;
       } else {
@@ -819,7 +872,7 @@ void tSQLBinaryExprTraverse(tSQLBinaryExpr *pExpr, tSkipList *pSkipList, tQueryR
       tSQLListTraverseOnResult(pExpr, param->fp, result);
     } else {
       assert(result->num == 0);
-      tSQLDoFilterInitialResult(pSkipList, param->fp, pExpr->info, result);
+      tSQLDoFilterInitialResult(pSkipList, param->fp, pExpr->info, result, param);
     }
   }
 }
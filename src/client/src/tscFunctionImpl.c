@@ -500,6 +500,124 @@ do {                                              \
     LOOPCHECK_N(*_data, _list, ctx, tsdbType, sign, notNullElems);             \
   } while (0)
 
+/*
+ * Type specialised kernels over a whole column block. If there is no null value in the block, which is known from
+ * SField.numOfNullPoints of the file block, the loops have no per element check and four independent accumulators,
+ * so they can be vectorized by compiler. Otherwise the null values are excluded by comparing with the bit pattern of
+ * null value, still without branch. Return the number of not null elements.
+ */
+#define DEFINE_SUM_KERNEL(name, type, sumType, utype, nullVal)                     \
+  static int32_t name(const char *pData, int32_t size, bool hasNull, sumType *sum) { \
+    const type *d = (const type *)pData;                                           \
+    sumType     s0 = 0, s1 = 0, s2 = 0, s3 = 0;                                    \
+    int32_t     i = 0;                                                             \
+                                                                                   \
+    if (!hasNull) {                                                                \
+      for (; i + 4 <= size; i += 4) {                                              \
+        s0 += d[i];                                                                \
+        s1 += d[i + 1];                                                            \
+        s2 += d[i + 2];                                                            \
+        s3 += d[i + 3];                                                            \
+      }                                                                            \
+      for (; i < size; ++i) {                                                      \
+        s0 += d[i];                                                                \
+      }                                                                            \
+      *sum += (s0 + s1) + (s2 + s3);                                               \
+      return size;                                                                 \
+    }                                                                              \
+                                                                                   \
+    const utype *u = (const utype *)pData;                                         \
+    int32_t      num = 0;                                                          \
+    for (; i < size; ++i) {                                                        \
+      bool notNull = (u[i] != (utype)(nullVal));                                   \
+      s0 += notNull ? d[i] : 0;                                                    \
+      num += notNull;                                                              \
+    }                                                                              \
+    *sum += s0;                                                                    \
+    return num;                                                                    \
+  }
+
+DEFINE_SUM_KERNEL(blockSum_i8, int8_t, int64_t, uint8_t, TSDB_DATA_TINYINT_NULL)
+DEFINE_SUM_KERNEL(blockSum_i16, int16_t, int64_t, uint16_t, TSDB_DATA_SMALLINT_NULL)
+DEFINE_SUM_KERNEL(blockSum_i32, int32_t, int64_t, uint32_t, TSDB_DATA_INT_NULL)
+DEFINE_SUM_KERNEL(blockSum_i64, int64_t, int64_t, uint64_t, TSDB_DATA_BIGINT_NULL)
+DEFINE_SUM_KERNEL(blockSum_ds, float, double, uint32_t, TSDB_DATA_FLOAT_NULL)
+DEFINE_SUM_KERNEL(blockSum_dd, double, double, uint64_t, TSDB_DATA_DOUBLE_NULL)
+
+// the sum of average is accumulated in double for all types
+DEFINE_SUM_KERNEL(blockSumDouble_i8, int8_t, double, uint8_t, TSDB_DATA_TINYINT_NULL)
+DEFINE_SUM_KERNEL(blockSumDouble_i16, int16_t, double, uint16_t, TSDB_DATA_SMALLINT_NULL)
+DEFINE_SUM_KERNEL(blockSumDouble_i32, int32_t, double, uint32_t, TSDB_DATA_INT_NULL)
+DEFINE_SUM_KERNEL(blockSumDouble_i64, int64_t, double, uint64_t, TSDB_DATA_BIGINT_NULL)
+
+/*
+ * The min/max value is reduced first, then its position is located, which is the last occurrence of the min value or
+ * the first occurrence of the max value, identical to the element by element update.
+ */
+#define DEFINE_MINMAX_KERNEL(name, type, utype, nullVal)                                                     \
+  static int32_t name(const char *pData, int32_t size, bool hasNull, int32_t isMin, type *val, int32_t *index) { \
+    const type * d = (const type *)pData;                                                                    \
+    const utype *u = (const utype *)pData;                                                                   \
+    int32_t      num = size;                                                                                 \
+    int32_t      i = 0;                                                                                      \
+                                                                                                             \
+    if (hasNull) {                                                                                           \
+      while (i < size && u[i] == (utype)(nullVal)) {                                                         \
+        ++i;                                                                                                 \
+      }                                                                                                      \
+      if (i == size) {                                                                                       \
+        return 0;                                                                                            \
+      }                                                                                                      \
+    }                                                                                                        \
+                                                                                                             \
+    type m = d[i];                                                                                           \
+    if (!hasNull) {                                                                                          \
+      if (isMin) {                                                                                           \
+        for (; i < size; ++i) m = (d[i] < m) ? d[i] : m;                                                     \
+      } else {                                                                                               \
+        for (; i < size; ++i) m = (d[i] > m) ? d[i] : m;                                                     \
+      }                                                                                                      \
+    } else {                                                                                                 \
+      num = 0;                                                                                               \
+      for (; i < size; ++i) {                                                                                \
+        bool notNull = (u[i] != (utype)(nullVal));                                                           \
+        m = (notNull && ((d[i] < m) ^ (!isMin))) ? d[i] : m;                                                 \
+        num += notNull;                                                                                      \
+      }                                                                                                      \
+    }                                                                                                        \
+                                                                                                             \
+    if (isMin) {                                                                                             \
+      for (i = size - 1; i > 0 && !(d[i] == m && u[i] != (utype)(nullVal)); --i) {                           \
+      }                                                                                                      \
+    } else {                                                                                                 \
+      for (i = 0; i < size - 1 && !(d[i] == m && u[i] != (utype)(nullVal)); ++i) {                           \
+      }                                                                                                      \
+    }                                                                                                        \
+                                                                                                             \
+    *val = m;                                                                                                \
+    *index = i;                                                                                              \
+    return num;                                                                                              \
+  }
+
+DEFINE_MINMAX_KERNEL(blockMinMax_i8, int8_t, uint8_t, TSDB_DATA_TINYINT_NULL)
+DEFINE_MINMAX_KERNEL(blockMinMax_i16, int16_t, uint16_t, TSDB_DATA_SMALLINT_NULL)
+DEFINE_MINMAX_KERNEL(blockMinMax_i32, int32_t, uint32_t, TSDB_DATA_INT_NULL)
+DEFINE_MINMAX_KERNEL(blockMinMax_i64, int64_t, uint64_t, TSDB_DATA_BIGINT_NULL)
+DEFINE_MINMAX_KERNEL(blockMinMax_ds, float, uint32_t, TSDB_DATA_FLOAT_NULL)
+DEFINE_MINMAX_KERNEL(blockMinMax_dd, double, uint64_t, TSDB_DATA_DOUBLE_NULL)
+
+#define APPLY_MINMAX_KERNEL(ctx, kernel, type, output, isMin, notNullElems)                     \
+  do {                                                                                          \
+    type    _val = 0;                                                                           \
+    int32_t _index = 0;                                                                         \
+    (notNullElems) = kernel(GET_INPUT_CHAR(ctx), (ctx)->size, (ctx)->hasNull, isMin, &_val, &_index); \
+    if ((notNullElems) > 0 && ((*(type *)(output) < _val) ^ (isMin))) {                         \
+      *(type *)(output) = _val;                                                                 \
+      TSKEY k = (ctx)->ptsList[_index];                                                         \
+      DO_UPDATE_TAG_COLUMNS(ctx, k);                                                            \
+    }                                                                                           \
+  } while (0)
+
 static void do_sum(SQLFunctionCtx *pCtx) {
   int32_t notNullElems = 0;
 
@@ -523,20 +641,20 @@ static void do_sum(SQLFunctionCtx *pCtx) {
       int64_t *retVal = pCtx->aOutputBuf;
 
       if (pCtx->inputType == TSDB_DATA_TYPE_TINYINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, int8_t, notNullElems, pCtx->inputType);
+        notNullElems = blockSum_i8(pData, pCtx->size, pCtx->hasNull, retVal);
       } else if (pCtx->inputType == TSDB_DATA_TYPE_SMALLINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, int16_t, notNullElems, pCtx->inputType);
+        notNullElems = blockSum_i16(pData, pCtx->size, pCtx->hasNull, retVal);
       } else if (pCtx->inputType == TSDB_DATA_TYPE_INT) {
-        LIST_ADD_N(*retVal, pCtx, pData, int32_t, notNullElems, pCtx->inputType);
+        notNullElems = blockSum_i32(pData, pCtx->size, pCtx->hasNull, retVal);
       } else if (pCtx->inputType == TSDB_DATA_TYPE_BIGINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, int64_t, notNullElems, pCtx->inputType);
+        notNullElems = blockSum_i64(pData, pCtx->size, pCtx->hasNull, retVal);
       }
     } else if (pCtx->inputType == TSDB_DATA_TYPE_DOUBLE) {
       double *retVal = pCtx->aOutputBuf;
-      LIST_ADD_N(*retVal, pCtx, pData, double, notNullElems, pCtx->inputType);
+      notNullElems = blockSum_dd(pData, pCtx->size, pCtx->hasNull, retVal);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_FLOAT) {
       double *retVal = pCtx->aOutputBuf;
-      LIST_ADD_N(*retVal, pCtx, pData, float, notNullElems, pCtx->inputType);
+      notNullElems = blockSum_ds(pData, pCtx->size, pCtx->hasNull, retVal);
     }
   }
 
@@ -747,17 +865,17 @@ static void avg_function(SQLFunctionCtx *pCtx) {
     void *pData = GET_INPUT_CHAR(pCtx);
 
     if (pCtx->inputType == TSDB_DATA_TYPE_TINYINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, int8_t, notNullElems, pCtx->inputType);
+      notNullElems = blockSumDouble_i8(pData, pCtx->size, pCtx->hasNull, pVal);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_SMALLINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, int16_t, notNullElems, pCtx->inputType);
+      notNullElems = blockSumDouble_i16(pData, pCtx->size, pCtx->hasNull, pVal);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_INT) {
-      LIST_ADD_N(*pVal, pCtx, pData, int32_t, notNullElems, pCtx->inputType);
+      notNullElems = blockSumDouble_i32(pData, pCtx->size, pCtx->hasNull, pVal);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_BIGINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, int64_t, notNullElems, pCtx->inputType);
+      notNullElems = blockSumDouble_i64(pData, pCtx->size, pCtx->hasNull, pVal);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_DOUBLE) {
-      LIST_ADD_N(*pVal, pCtx, pData, double, notNullElems, pCtx->inputType);
+      notNullElems = blockSum_dd(pData, pCtx->size, pCtx->hasNull, pVal);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_FLOAT) {
-      LIST_ADD_N(*pVal, pCtx, pData, float, notNullElems, pCtx->inputType);
+      notNullElems = blockSum_ds(pData, pCtx->size, pCtx->hasNull, pVal);
     }
   }
 
@@ -950,8 +1068,9 @@ static void minMax_function(SQLFunctionCtx *pCtx, char *pOutput, int32_t isMin,
 
       UPDATE_DATA(pCtx, *data, val, notNullElems, isMin, key);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_FLOAT) {
+      // the min/max of float column are saved as float in the low 4 bytes
       float *data = (float *)pOutput;
-      double val = GET_DOUBLE_VAL(tval);
+      double val = GET_FLOAT_VAL(tval);
 
       UPDATE_DATA(pCtx, *data, val, notNullElems, isMin, key);
     }
@@ -959,42 +1078,25 @@ static void minMax_function(SQLFunctionCtx *pCtx, char *pOutput, int32_t isMin,
     return;
   }
 
-  void *p = GET_INPUT_CHAR(pCtx);
   *notNullElems = 0;
 
   if (pCtx->inputType >= TSDB_DATA_TYPE_TINYINT && pCtx->inputType <= TSDB_DATA_TYPE_BIGINT) {
     if (pCtx->inputType == TSDB_DATA_TYPE_TINYINT) {
-      TYPED_LOOPCHECK_N(int8_t, pOutput, p, pCtx, pCtx->inputType, isMin, *notNullElems);
+      APPLY_MINMAX_KERNEL(pCtx, blockMinMax_i8, int8_t, pOutput, isMin, *notNullElems);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_SMALLINT) {
-      TYPED_LOOPCHECK_N(int16_t, pOutput, p, pCtx, pCtx->inputType, isMin, *notNullElems);
+      APPLY_MINMAX_KERNEL(pCtx, blockMinMax_i16, int16_t, pOutput, isMin, *notNullElems);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_INT) {
-      int32_t *pData = p;
-      int32_t *retVal = pOutput;
-
-      for (int32_t i = 0; i < pCtx->size; ++i) {
-        if (pCtx->hasNull && isNull(&pData[i], pCtx->inputType)) {
-          continue;
-        }
-
-        if ((*retVal < pData[i]) ^ isMin) {
-          *retVal = pData[i];
-          TSKEY k = pCtx->ptsList[i];
-
-          DO_UPDATE_TAG_COLUMNS(pCtx, k);
-        }
-
-        *notNullElems += 1;
-      }
+      APPLY_MINMAX_KERNEL(pCtx, blockMinMax_i32, int32_t, pOutput, isMin, *notNullElems);
 #if defined(_DEBUG_VIEW)
-      pTrace("max value updated:%d", *retVal);
+      pTrace("max value updated:%d", *(int32_t *)pOutput);
 #endif
     } else if (pCtx->inputType == TSDB_DATA_TYPE_BIGINT) {
-      TYPED_LOOPCHECK_N(int64_t, pOutput, p, pCtx, pCtx->inputType, isMin, *notNullElems);
+      APPLY_MINMAX_KERNEL(pCtx, blockMinMax_i64, int64_t, pOutput, isMin, *notNullElems);
     }
   } else if (pCtx->inputType == TSDB_DATA_TYPE_DOUBLE) {
-    TYPED_LOOPCHECK_N(double, pOutput, p, pCtx, pCtx->inputType, isMin, *notNullElems);
+    APPLY_MINMAX_KERNEL(pCtx, blockMinMax_dd, double, pOutput, isMin, *notNullElems);
   } else if (pCtx->inputType == TSDB_DATA_TYPE_FLOAT) {
-    TYPED_LOOPCHECK_N(float, pOutput, p, pCtx, pCtx->inputType, isMin, *notNullElems);
+    APPLY_MINMAX_KERNEL(pCtx, blockMinMax_ds, float, pOutput, isMin, *notNullElems);
   }
 }
 
@@ -3351,7 +3453,7 @@ static void spread_function(SQLFunctionCtx *pCtx) {
         if (pInfo->max < pCtx->preAggVals.max) {
           pInfo->max = pCtx->preAggVals.max;
         }
-      } else if (pCtx->inputType == TSDB_DATA_TYPE_DOUBLE || pCtx->inputType == TSDB_DATA_TYPE_FLOAT) {
+      } else if (pCtx->inputType == TSDB_DATA_TYPE_DOUBLE) {
         if (pInfo->min > GET_DOUBLE_VAL(&(pCtx->preAggVals.min))) {
           pInfo->min = GET_DOUBLE_VAL(&(pCtx->preAggVals.min));
         }
@@ -3359,6 +3461,14 @@ static void spread_function(SQLFunctionCtx *pCtx) {
         if (pInfo->max < GET_DOUBLE_VAL(&(pCtx->preAggVals.max))) {
           pInfo->max = GET_DOUBLE_VAL(&(pCtx->preAggVals.max));
         }
+      } else if (pCtx->inputType == TSDB_DATA_TYPE_FLOAT) {
+        if (pInfo->min > GET_FLOAT_VAL(&(pCtx->preAggVals.min))) {
+          pInfo->min = GET_FLOAT_VAL(&(pCtx->preAggVals.min));
+        }
+
+        if (pInfo->max < GET_FLOAT_VAL(&(pCtx->preAggVals.max))) {
+          pInfo->max = GET_FLOAT_VAL(&(pCtx->preAggVals.max));
+        }
       }
     } else {
       if (pInfo->min > pCtx->param[1].dKey) {
@@ -3861,8 +3971,8 @@ static void getStatics_f(int64_t *primaryKey, float *data, int32_t numOfRow, dou
 
   *(int32_t*)max = *(int32_t*)(&fmax);
   *(int32_t*)min = *(int32_t*)(&fmin);
-  *(int32_t*)minIndex = *(int32_t*)(&fminIndex);
-  *(int32_t*)maxIndex = *(int32_t*)(&fmaxIndex);
+  *minIndex = (int16_t)fminIndex;
+  *maxIndex = (int16_t)fmaxIndex;
 
 }
 
@@ -3914,8 +4024,8 @@ static void getStatics_d(int64_t *primaryKey, double *data, int32_t numOfRow, do
 
   *(int64_t*)max = *(int64_t*)(&dmax);
   *(int64_t*)min = *(int64_t*)(&dmin);
-  *(int64_t*)minIndex = *(int64_t*)(&dminIndex);
-  *(int64_t*)maxIndex = *(int64_t*)(&dmaxIndex);
+  *minIndex = (int16_t)dminIndex;
+  *maxIndex = (int16_t)dmaxIndex;
 }
 
 void getStatistics(char *priData, char *data, int32_t size, int32_t numOfRow, int32_t type, int64_t *min, int64_t *max,
@@ -24,6 +24,7 @@
 #include "os.h"
 #include "ihash.h"
 #include "tscSecondaryMerge.h"
+#include "tcache.h"
 #include "tscUtil.h"
 #include "tschemautil.h"
 #include "tsclient.h"
@@ -39,6 +40,14 @@ enum {
   TSDB_USE_CLI_TS = 1,
 };
 
+// timestamp of the last 'YYYY-MM-DD HH:MM' prefix seen by the fast value parser
+typedef struct STimeParseCache {
+  bool    valid;
+  int16_t timePrec;
+  char    prefix[16];
+  int64_t base;
+} STimeParseCache;
+
 static int32_t tscAllocateMemIfNeed(STableDataBlocks *pDataBlock, int32_t rowSize);
 
 static int32_t tscToInteger(SSQLToken *pToken, int64_t *value, char **endPtr) {
@@ -391,8 +400,339 @@ static int32_t tsCheckTimestamp(STableDataBlocks *pDataBlocks, const char *start
   return TSDB_CODE_SUCCESS;
 }
 
+/*
+ * Fast path for the plain literals that make up almost all of the VALUES clauses: decimal numbers, NULL,
+ * simple quoted strings and 'YYYY-MM-DD HH:MM:SS[.fraction]' timestamps. Other forms (now, time expressions,
+ * escaped strings, hex/bin numbers, bool literals, parameters, ...) are left to the tokenizer based path,
+ * which also produces the error messages, so nothing is consumed unless the value is accepted.
+ */
+#define TS_FAST_MAX_INT_DIGITS 18  // never overflows an int64_t
+#define TS_FAST_MAX_DBL_DIGITS 19  // never overflows an uint64_t
+
+static const double tsFastPow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                     1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+static FORCE_INLINE bool tsIsSpace(char c) {
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\f';
+}
+
+static FORCE_INLINE bool tsIsDigit(char c) { return c >= '0' && c <= '9'; }
+
+// the value must be followed by the next value, the end of row, or the end of sql string
+static FORCE_INLINE bool tsIsValueEnd(const char *p) {
+  while (tsIsSpace(*p)) {
+    p++;
+  }
+
+  return *p == ',' || *p == ')' || *p == 0;
+}
+
+static bool tsFastParseInteger(const char *z, int64_t *value, const char **end) {
+  const char *p = z;
+  bool        neg = (*p == '-');
+  if (*p == '-' || *p == '+') {
+    p++;
+  }
+
+  const char *digits = p;
+  uint64_t    v = 0;
+  while (tsIsDigit(*p)) {
+    v = v * 10 + (*p - '0');
+    if (++p - digits > TS_FAST_MAX_INT_DIGITS) {
+      return false;
+    }
+  }
+
+  if (p == digits) {
+    return false;
+  }
+
+  *value = neg ? -(int64_t)v : (int64_t)v;
+  *end = p;
+  return true;
+}
+
+/*
+ * Only the mantissas and exponents that can be converted exactly by one multiplication or division are accepted,
+ * i.e., mantissa <= 2^53 and |exponent| <= 22, so the result is the correctly rounded value strtod produces.
+ */
+static bool tsFastParseDouble(const char *z, double *value, const char **end) {
+  const char *p = z;
+  bool        neg = (*p == '-');
+  if (*p == '-' || *p == '+') {
+    p++;
+  }
+
+  if (!tsIsDigit(*p)) {
+    return false;
+  }
+
+  uint64_t m = 0;
+  int32_t  numOfDigits = 0;
+  int32_t  exp10 = 0;
+
+  while (tsIsDigit(*p)) {
+    if (++numOfDigits > TS_FAST_MAX_DBL_DIGITS) {
+      return false;
+    }
+    m = m * 10 + (*p++ - '0');
+  }
+
+  if (*p == '.') {
+    if (!tsIsDigit(*(++p))) {
+      return false;
+    }
+
+    while (tsIsDigit(*p)) {
+      if (++numOfDigits > TS_FAST_MAX_DBL_DIGITS) {
+        return false;
+      }
+      m = m * 10 + (*p++ - '0');
+      exp10--;
+    }
+  }
+
+  if (*p == 'e' || *p == 'E') {
+    p++;
+    bool negExp = (*p == '-');
+    if (*p == '-' || *p == '+') {
+      p++;
+    }
+
+    if (!tsIsDigit(*p)) {
+      return false;
+    }
+
+    int32_t e = 0;
+    while (tsIsDigit(*p)) {
+      if (e < 10000) {
+        e = e * 10 + (*p - '0');
+      }
+      p++;
+    }
+
+    exp10 += negExp ? -e : e;
+  }
+
+  if (m > (1ULL << 53) || exp10 < -22 || exp10 > 22) {
+    return false;
+  }
+
+  double dv = (double)m;
+  dv = (exp10 < 0) ? dv / tsFastPow10[-exp10] : dv * tsFastPow10[exp10];
+
+  *value = neg ? -dv : dv;
+  *end = p;
+  return true;
+}
+
+// quoted string without any escape characters
+static bool tsFastParseString(const char *z, const char **content, int32_t *len, const char **end) {
+  char delim = z[0];
+  if (delim != '\'' && delim != '"') {
+    return false;
+  }
+
+  const char *close = strchr(z + 1, delim);
+  if (close == NULL || close[1] == delim) {
+    return false;
+  }
+
+  if (memchr(z + 1, '\\', close - z - 1) != NULL) {
+    return false;
+  }
+
+  *content = z + 1;
+  *len = close - z - 1;
+  *end = close + 1;
+  return true;
+}
+
+/*
+ * Only the strict 'YYYY-MM-DD HH:MM:SS[.fraction]' form is handled here. The timestamp of the leading
+ * 'YYYY-MM-DD HH:MM' part is resolved by taosParseTime and cached, since consecutive rows normally
+ * share the same minute, and the seconds and the fraction are added on top of it.
+ */
+static bool tsFastParseTimeStr(const char *z, int32_t len, int16_t timePrec, STimeParseCache *pCache, int64_t *time) {
+  const int32_t PREFIX_LEN = sizeof(pCache->prefix);
+  const int32_t TIME_LEN = 19;
+
+  if (len < TIME_LEN || z[4] != '-' || z[7] != '-' || z[10] != ' ' || z[13] != ':' || z[16] != ':') {
+    return false;
+  }
+
+  for (int32_t i = 0; i < TIME_LEN; ++i) {
+    if (i != 4 && i != 7 && i != 10 && i != 13 && i != 16 && !tsIsDigit(z[i])) {
+      return false;
+    }
+  }
+
+  int64_t seconds = (z[17] - '0') * 10 + (z[18] - '0');
+  if (seconds > 59) {
+    return false;
+  }
+
+  int64_t factor = (timePrec == TSDB_TIME_PRECISION_MILLI) ? 1000 : 1000000;
+  int32_t fractionLen = (timePrec == TSDB_TIME_PRECISION_MILLI) ? 3 : 6;
+  int64_t fraction = 0;
+
+  if (len > TIME_LEN) {
+    if (z[TIME_LEN] != '.' || len == TIME_LEN + 1) {
+      return false;
+    }
+
+    // the digits beyond the precision are ignored, the same as parseFraction
+    int32_t i = 0;
+    for (const char *p = z + TIME_LEN + 1; p < z + len; ++p, ++i) {
+      if (!tsIsDigit(*p)) {
+        return false;
+      }
+
+      if (i < fractionLen) {
+        fraction = fraction * 10 + (*p - '0');
+      }
+    }
+
+    for (; i < fractionLen; ++i) {
+      fraction *= 10;
+    }
+  }
+
+  if (!pCache->valid || pCache->timePrec != timePrec || memcmp(pCache->prefix, z, PREFIX_LEN) != 0) {
+    char buf[32] = {0};
+    memcpy(buf, z, PREFIX_LEN);
+    strcat(buf, ":00");
+
+    if (taosParseTime(buf, &pCache->base, strlen(buf), timePrec) != TSDB_CODE_SUCCESS) {
+      pCache->valid = false;
+      return false;
+    }
+
+    memcpy(pCache->prefix, z, PREFIX_LEN);
+    pCache->timePrec = timePrec;
+    pCache->valid = true;
+  }
+
+  *time = pCache->base + seconds * factor + fraction;
+  return true;
+}
+
+static bool tsFastParseOneColumnData(SSchema *pSchema, char **str, char *payload, bool primaryKey, int16_t timePrec,
+                                     STimeParseCache *pCache) {
+  const char *p = *str;
+  const char *end = NULL;
+
+  // skip the separators in the same way as tStrGetToken: white spaces and at most one comma
+  bool hasComma = false;
+  while (tsIsSpace(*p) || *p == ',') {
+    if (*p == ',') {
+      if (hasComma) {
+        return false;
+      }
+      hasComma = true;
+    }
+    p++;
+  }
+
+  if ((p[0] == 'n' || p[0] == 'N') && strncasecmp(p, TSDB_DATA_NULL_STR_L, 4) == 0 && !isalnum((unsigned char)p[4]) &&
+      p[4] != '_') {
+    // null primary timestamp is turned into server time in tsParseOneColumnData
+    if (primaryKey || !tsIsValueEnd(p + 4)) {
+      return false;
+    }
+
+    setNull(payload, pSchema->type, pSchema->bytes);
+    *str = (char *)p + 4;
+    return true;
+  }
+
+  switch (pSchema->type) {
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_BIGINT: {
+      int64_t iv;
+      if (!tsFastParseInteger(p, &iv, &end) || !tsIsValueEnd(end)) {
+        return false;
+      }
+
+      // the minimum value of each type is reserved for null, out of range values go to the normal path for the error
+      if (pSchema->type == TSDB_DATA_TYPE_TINYINT) {
+        if (iv > INT8_MAX || iv <= INT8_MIN) return false;
+        *((int8_t *)payload) = (int8_t)iv;
+      } else if (pSchema->type == TSDB_DATA_TYPE_SMALLINT) {
+        if (iv > INT16_MAX || iv <= INT16_MIN) return false;
+        *((int16_t *)payload) = (int16_t)iv;
+      } else if (pSchema->type == TSDB_DATA_TYPE_INT) {
+        if (iv > INT32_MAX || iv <= INT32_MIN) return false;
+        *((int32_t *)payload) = (int32_t)iv;
+      } else {
+        *((int64_t *)payload) = iv;
+      }
+      break;
+    }
+
+    case TSDB_DATA_TYPE_FLOAT:
+    case TSDB_DATA_TYPE_DOUBLE: {
+      double dv;
+      if (!tsFastParseDouble(p, &dv, &end) || !tsIsValueEnd(end)) {
+        return false;
+      }
+
+      if (pSchema->type == TSDB_DATA_TYPE_FLOAT) {
+        *((float *)payload) = (float)dv;
+      } else {
+        *((double *)payload) = dv;
+      }
+      break;
+    }
+
+    case TSDB_DATA_TYPE_BINARY:
+    case TSDB_DATA_TYPE_NCHAR: {
+      const char *content = NULL;
+      int32_t     len = 0;
+      if (!tsFastParseString(p, &content, &len, &end) || !tsIsValueEnd(end)) {
+        return false;
+      }
+
+      if (pSchema->type == TSDB_DATA_TYPE_BINARY) {
+        if (len > pSchema->bytes) {
+          return false;
+        }
+        strncpy(payload, content, len);
+      } else if (!taosMbsToUcs4((char *)content, len, payload, pSchema->bytes)) {
+        return false;
+      }
+      break;
+    }
+
+    case TSDB_DATA_TYPE_TIMESTAMP: {
+      int64_t     ts;
+      const char *content = NULL;
+      int32_t     len = 0;
+
+      if (tsFastParseString(p, &content, &len, &end)) {
+        if (!tsIsValueEnd(end) || !tsFastParseTimeStr(content, len, timePrec, pCache, &ts)) {
+          return false;
+        }
+      } else if (!tsFastParseInteger(p, &ts, &end) || !tsIsValueEnd(end)) {
+        return false;
+      }
+
+      *((int64_t *)payload) = ts;
+      break;
+    }
+
+    default:
+      return false;
+  }
+
+  *str = (char *)end;
+  return true;
+}
+
 int tsParseOneRowData(char **str, STableDataBlocks *pDataBlocks, SSchema schema[], SParsedDataColInfo *spd, char *error,
-                      int16_t timePrec, int32_t *code, char* tmpTokenBuf) {
+                      int16_t timePrec, int32_t *code, char* tmpTokenBuf, STimeParseCache *pTimeCache) {
   int32_t   index = 0;
   //bool      isPrevOptr; //fang, never used
   SSQLToken sToken = {0};
@@ -407,6 +747,16 @@ int tsParseOneRowData(char **str, STableDataBlocks *pDataBlocks, SSchema schema[
     SSchema *pSchema = schema + colIndex;
     rowSize += pSchema->bytes;
 
+    bool isPrimaryKey = (colIndex == PRIMARYKEY_TIMESTAMP_COL_INDEX);
+    if (tsFastParseOneColumnData(pSchema, str, start, isPrimaryKey, timePrec, pTimeCache)) {
+      if (isPrimaryKey && tsCheckTimestamp(pDataBlocks, start) != TSDB_CODE_SUCCESS) {
+        tscInvalidSQLErrMsg(error, "client time/server time can not be mixed up", *str);
+        *code = TSDB_CODE_INVALID_TIME_STAMP;
+        return -1;
+      }
+      continue;
+    }
+
     index = 0;
     sToken = tStrGetToken(*str, &index, true, 0, NULL);
     *str += index;
@@ -444,7 +794,7 @@ int tsParseOneRowData(char **str, STableDataBlocks *pDataBlocks, SSchema schema[
           }
         }
       
-        tmpTokenBuf[j] = sToken.z[i];
+        tmpTokenBuf[j] = sToken.z[k];
         j++;
       }
       tmpTokenBuf[j] = 0; 
@@ -452,7 +802,6 @@ int tsParseOneRowData(char **str, STableDataBlocks *pDataBlocks, SSchema schema[
       sToken.n -= 2 + cnt;    
     }
 
-    bool    isPrimaryKey = (colIndex == PRIMARYKEY_TIMESTAMP_COL_INDEX);
     int32_t ret = tsParseOneColumnData(pSchema, &sToken, start, error, str, isPrimaryKey, timePrec);
     if (ret != TSDB_CODE_SUCCESS) {
       *code = TSDB_CODE_INVALID_SQL;
@@ -505,6 +854,8 @@ int tsParseValues(char **str, STableDataBlocks *pDataBlock, SMeterMeta *pMeterMe
   SSchema *pSchema = tsGetSchema(pMeterMeta);
   int32_t  precision = pMeterMeta->precision;
 
+  STimeParseCache timeCache = {0};
+
   if (spd->hasVal[0] == false) {
     strcpy(error, "primary timestamp column can not be null");
     *code = TSDB_CODE_INVALID_SQL;
@@ -528,7 +879,7 @@ int tsParseValues(char **str, STableDataBlocks *pDataBlock, SMeterMeta *pMeterMe
       maxRows += tSize;
     }
 
-    int32_t len = tsParseOneRowData(str, pDataBlock, pSchema, spd, error, precision, code, tmpTokenBuf);
+    int32_t len = tsParseOneRowData(str, pDataBlock, pSchema, spd, error, precision, code, tmpTokenBuf, &timeCache);
     if (len <= 0) { // error message has been set in tsParseOneRowData
       return -1;
     }
@@ -696,6 +1047,71 @@ static int32_t doParseInsertStatement(SSqlObj *pSql, void *pTableHashList, char
   return TSDB_CODE_SUCCESS;
 }
 
+/*
+ * parse "TAGS (v1, v2, ...)" of super table pMeterMeta, the values are written into tagVal and the
+ * total length of them is returned by len if it is not NULL
+ */
+static int32_t tscParseTagValues(char **sqlstr, SSqlCmd *pCmd, SMeterMeta *pMeterMeta, char *tagVal, int32_t *len) {
+  int32_t   index = 0;
+  int32_t   code = TSDB_CODE_SUCCESS;
+  SSQLToken sToken;
+  char *    sql = *sqlstr;
+  char *    start = tagVal;
+  SSchema * pTagSchema = tsGetTagSchema(pMeterMeta);
+
+  sToken = tStrGetToken(sql, &index, false, 0, NULL);
+  sql += index;
+  if (sToken.type != TK_TAGS) {
+    return tscInvalidSQLErrMsg(pCmd->payload, "keyword TAGS expected", sql);
+  }
+
+  int32_t  numOfTagValues = 0;
+  uint32_t ignoreTokenTypes = TK_LP;
+  uint32_t numOfIgnoreToken = 1;
+  while (1) {
+    index = 0;
+    sToken = tStrGetToken(sql, &index, true, numOfIgnoreToken, &ignoreTokenTypes);
+    sql += index;
+    if (sToken.n == 0) {
+      break;
+    } else if (sToken.type == TK_RP) {
+      break;
+    }
+
+    // Remove quotation marks
+    if (TK_STRING == sToken.type) {
+      sToken.z++;
+      sToken.n -= 2;
+    }
+
+    if (numOfTagValues >= pMeterMeta->numOfTags) {
+      return tscInvalidSQLErrMsg(pCmd->payload, "number of tags mismatch", sql);
+    }
+
+    code = tsParseOneColumnData(&pTagSchema[numOfTagValues], &sToken, tagVal, pCmd->payload, &sql, false,
+                                pMeterMeta->precision);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+
+    if ((pTagSchema[numOfTagValues].type == TSDB_DATA_TYPE_BINARY ||
+         pTagSchema[numOfTagValues].type == TSDB_DATA_TYPE_NCHAR) && sToken.n > pTagSchema[numOfTagValues].bytes) {
+      return tscInvalidSQLErrMsg(pCmd->payload, "string too long", sToken.z);
+    }
+
+    tagVal += pTagSchema[numOfTagValues++].bytes;
+  }
+
+  if (numOfTagValues != pMeterMeta->numOfTags) {
+    return tscInvalidSQLErrMsg(pCmd->payload, "number of tags mismatch", sql);
+  }
+
+  if (len != NULL) *len = (int32_t)(tagVal - start);
+  *sqlstr = sql;
+
+  return TSDB_CODE_SUCCESS;
+}
+
 static int32_t tscParseSqlForCreateTableOnDemand(char **sqlstr, SSqlObj *pSql) {
   int32_t   index = 0;
   SSQLToken sToken;
@@ -762,51 +1178,9 @@ static int32_t tscParseSqlForCreateTableOnDemand(char **sqlstr, SSqlObj *pSql) {
       return tscInvalidSQLErrMsg(pCmd->payload, "create table only from super table is allowed", sToken.z);
     }
 
-    char *   tagVal = pTag->data;
-    SSchema *pTagSchema = tsGetTagSchema(pMeterMetaInfo->pMeterMeta);
-
-    index = 0;
-    sToken = tStrGetToken(sql, &index, false, 0, NULL);
-    sql += index;
-    if (sToken.type != TK_TAGS) {
-      return tscInvalidSQLErrMsg(pCmd->payload, "keyword TAGS expected", sql);
-    }
-
-    int32_t  numOfTagValues = 0;
-    uint32_t ignoreTokenTypes = TK_LP;
-    uint32_t numOfIgnoreToken = 1;
-    while (1) {
-      index = 0;
-      sToken = tStrGetToken(sql, &index, true, numOfIgnoreToken, &ignoreTokenTypes);
-      sql += index;
-      if (sToken.n == 0) {
-        break;
-      } else if (sToken.type == TK_RP) {
-        break;
-      }
-
-      // Remove quotation marks
-      if (TK_STRING == sToken.type) {
-        sToken.z++;
-        sToken.n -= 2;
-      }
-
-      code = tsParseOneColumnData(&pTagSchema[numOfTagValues], &sToken, tagVal, pCmd->payload, &sql, false,
-                                  pMeterMetaInfo->pMeterMeta->precision);
-      if (code != TSDB_CODE_SUCCESS) {
-        return code;
-      }
-
-      if ((pTagSchema[numOfTagValues].type == TSDB_DATA_TYPE_BINARY ||
-           pTagSchema[numOfTagValues].type == TSDB_DATA_TYPE_NCHAR) && sToken.n > pTagSchema[numOfTagValues].bytes) {
-        return tscInvalidSQLErrMsg(pCmd->payload, "string too long", sToken.z);
-      }
-
-      tagVal += pTagSchema[numOfTagValues++].bytes;
-    }
-
-    if (numOfTagValues != pMeterMetaInfo->pMeterMeta->numOfTags) {
-      return tscInvalidSQLErrMsg(pCmd->payload, "number of tags mismatch", sql);
+    code = tscParseTagValues(&sql, pCmd, pMeterMetaInfo->pMeterMeta, pTag->data, NULL);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
     }
 
     if (tscValidateName(&tableToken) != TSDB_CODE_SUCCESS) {
@@ -851,6 +1225,118 @@ int validateTableName(char *tblName, int len) {
   return tscValidateName(&token);
 }
 
+static SSQLToken tscNextToken(char **str) {
+  int32_t   index = 0;
+  SSQLToken sToken = tStrGetToken(*str, &index, false, 0, NULL);
+  *str += index;
+  return sToken;
+}
+
+/*
+ * Create the tables of all "tb USING stb TAGS(...)" clauses that are not in the local cache with one
+ * message, instead of one round trip for each table in tscParseSqlForCreateTableOnDemand. It is best
+ * effort, the sql string is not changed and the tables left are created one by one as before.
+ */
+static void tscCreateTablesOnDemandInBatch(SSqlObj *pSql, char *str) {
+  SSqlCmd *       pCmd = &pSql->cmd;
+  SMeterMetaInfo *pMeterMetaInfo = tscGetMeterMetaInfo(pCmd, 0);
+  SSQLToken       sToken;
+  STagData        tagData;
+  char *          sql = str;
+  char *          items = NULL;
+  int32_t         len = 0, numOfTables = 0, tagLen = 0;
+
+  // the batch only pays off when several tables may be created
+  char *p = strstr(sql, "using");
+  if (p == NULL || strstr(p + 5, "using") == NULL) return;
+
+  int32_t itemSize = sizeof(SCreateTableItem) + sizeof(STagData);
+  items = malloc(itemSize * TSDB_MULTI_CREATE_TABLE_MAX_NUM);
+  if (items == NULL) return;
+
+  while (1) {
+    SSQLToken tableToken = tscNextToken(&sql);
+    if (tableToken.n == 0) break;
+
+    sToken = tscNextToken(&sql);
+    if (sToken.type == TK_LP) {  // skip the column list
+      do {
+        sToken = tscNextToken(&sql);
+      } while (sToken.n > 0 && sToken.type != TK_RP);
+      sToken = tscNextToken(&sql);
+    }
+
+    if (sToken.type == TK_USING) {
+      // only plain names, a quoted name is modified in place during validation
+      if (tableToken.type != TK_ID || validateTableName(tableToken.z, tableToken.n) != TSDB_CODE_SUCCESS) break;
+
+      sToken = tscNextToken(&sql);
+      if (setMeterID(pSql, &sToken, 0) != TSDB_CODE_SUCCESS) break;
+      if (tscGetMeterMetaEx(pSql, pMeterMetaInfo->name, false) != TSDB_CODE_SUCCESS) break;
+      if (!UTIL_METER_IS_METRIC(pMeterMetaInfo)) break;
+
+      memset(&tagData, 0, sizeof(STagData));
+      strncpy(tagData.name, pMeterMetaInfo->name, TSDB_METER_ID_LEN);
+      if (tscParseTagValues(&sql, pCmd, pMeterMetaInfo->pMeterMeta, tagData.data, &tagLen) != TSDB_CODE_SUCCESS) break;
+
+      if (setMeterID(pSql, &tableToken, 0) != TSDB_CODE_SUCCESS) break;
+
+      SMeterMeta *pMeterMeta = (SMeterMeta *)taosGetDataFromCache(tscCacheHandle, pMeterMetaInfo->name);
+      if (pMeterMeta != NULL) {
+        taosRemoveDataFromCache(tscCacheHandle, (void **)&pMeterMeta, false);
+      } else {
+        SCreateTableItem *pItem = (SCreateTableItem *)(items + len);
+        tagLen += TSDB_METER_ID_LEN;
+
+        memset(pItem->meterId, 0, TSDB_METER_ID_LEN);
+        strncpy(pItem->meterId, pMeterMetaInfo->name, TSDB_METER_ID_LEN - 1);
+        pItem->tagLen = htons(tagLen);
+        memcpy(pItem->tags, &tagData, tagLen);
+
+        len += sizeof(SCreateTableItem) + tagLen;
+        if (++numOfTables >= TSDB_MULTI_CREATE_TABLE_MAX_NUM) {
+          if (tscCreateTablesInBatch(pSql, items, len, numOfTables) != TSDB_CODE_SUCCESS) {
+            numOfTables = 0;
+            break;
+          }
+          len = 0;
+          numOfTables = 0;
+        }
+      }
+
+      sToken = tscNextToken(&sql);
+    }
+
+    if (sToken.type == TK_VALUES) {  // skip the rows
+      while (1) {
+        char *    next = sql;
+        SSQLToken lp = tscNextToken(&next);
+        if (lp.type != TK_LP) break;
+
+        int32_t depth = 1;
+        while (depth > 0) {
+          sToken = tscNextToken(&next);
+          if (sToken.n == 0) break;
+          if (sToken.type == TK_LP) depth++;
+          if (sToken.type == TK_RP) depth--;
+        }
+        sql = next;
+        if (depth > 0) break;
+      }
+    } else if (sToken.type == TK_FILE) {
+      tscNextToken(&sql);
+    } else {
+      break;
+    }
+  }
+
+  if (numOfTables > 1) {
+    tscCreateTablesInBatch(pSql, items, len, numOfTables);
+  }
+
+  tfree(items);
+}
+
 /**
  * usage: insert into table1 values() () table2 values()()
  *
@@ -874,9 +1360,17 @@ int doParserInsertSql(SSqlObj *pSql, char *str) {
 
   void *pTableHashList = taosInitIntHash(128, POINTER_BYTES, taosHashInt);
 
+  // column indices of the previous "tb(c1, c2, ...)" column list
+  int16_t prevColIndex[TSDB_MAX_COLUMNS] = {0};
+  int32_t numOfPrevCols = 0;
+
   pSql->cmd.pDataBlocks = tscCreateBlockArrayList();
   tscTrace("%p create data block list for submit data, %p", pSql, pSql->cmd.pDataBlocks);
 
+  if (pSql->fp == NULL) {
+    tscCreateTablesOnDemandInBatch(pSql, str);
+  }
+
   while (1) {
     int32_t index = 0;
     SSQLToken sToken = tStrGetToken(str, &index, false, 0, NULL);
@@ -1027,8 +1521,19 @@ int doParserInsertSql(SSqlObj *pSql, char *str) {
 
         bool findColumnIndex = false;
 
-        // todo speedup by using hash list
-        for (int32_t t = 0; t < pMeterMeta->numOfColumns; ++t) {
+        /*
+         * the tables in one multi-table insert usually share the same column list, so the column at the same
+         * position of the previous list is tried first, before scanning the whole schema
+         */
+        int32_t pos = spd.numOfAssignedCols;
+        int32_t hint = (pos < numOfPrevCols) ? prevColIndex[pos] : -1;
+
+        for (int32_t k = -1; k < pMeterMeta->numOfColumns; ++k) {
+          int32_t t = (k < 0) ? hint : k;
+          if (t < 0 || t >= pMeterMeta->numOfColumns) {
+            continue;
+          }
+
           if (strncmp(sToken.z, pSchema[t].name, sToken.n) == 0 && strlen(pSchema[t].name) == sToken.n) {
             SParsedColElem *pElem = &spd.elems[spd.numOfAssignedCols++];
             pElem->offset = offset[t];
@@ -1056,6 +1561,11 @@ int doParserInsertSql(SSqlObj *pSql, char *str) {
         goto _error_clean;
       }
 
+      numOfPrevCols = spd.numOfAssignedCols;
+      for (int32_t t = 0; t < numOfPrevCols; ++t) {
+        prevColIndex[t] = spd.elems[t].colIndex;
+      }
+
       index = 0;
       sToken = tStrGetToken(str, &index, false, 0, NULL);
       str += index;
@@ -1236,6 +1746,7 @@ static int tscInsertDataFromFile(SSqlObj *pSql, FILE *fp, char *tmpTokenBuf) {
 
   tscSetAssignedColumnInfo(&spd, pSchema, pMeterMetaInfo->pMeterMeta->numOfColumns);
 
+  STimeParseCache timeCache = {0};
   while ((readLen = getline(&line, &n, fp)) != -1) {
     // line[--readLen] = '\0';
     if (('\r' == line[readLen - 1]) || ('\n' == line[readLen - 1])) line[--readLen] = 0;
@@ -1250,7 +1761,7 @@ static int tscInsertDataFromFile(SSqlObj *pSql, FILE *fp, char *tmpTokenBuf) {
       maxRows += tSize;    
     }
 
-    len = tsParseOneRowData(&lineptr, pTableDataBlock, pSchema, &spd, pCmd->payload, pMeterMeta->precision, &code, tmpTokenBuf);
+    len = tsParseOneRowData(&lineptr, pTableDataBlock, pSchema, &spd, pCmd->payload, pMeterMeta->precision, &code, tmpTokenBuf, &timeCache);
     if (len <= 0 || pTableDataBlock->numOfParams > 0) {
       pSql->res.code = code;
       return (-code);
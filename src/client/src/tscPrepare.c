@@ -19,6 +19,7 @@
 #include "tscUtil.h"
 #include "ttimer.h"
 #include "taosmsg.h"
+#include "tschemautil.h"
 #include "tstrbuild.h"
 
 
@@ -52,6 +53,7 @@ typedef struct STscStmt {
   STscObj* taos;
   SSqlObj* pSql;
   SNormalStmt normal;
+  SDataBlockList* templates;  // data blocks of insert statement before binding, restored after execution
 } STscStmt;
 
 
@@ -377,6 +379,299 @@ static int insertStmtBindParam(STscStmt* stmt, TAOS_BIND* bind) {
   return TSDB_CODE_SUCCESS;
 }
 
+#define BIND_BATCH_COPY(dst, dataSize, src, step, size, num) \
+  do {                                                      \
+    for (int32_t _r = 0; _r < (num); ++_r) {                \
+      memcpy((dst) + _r * (dataSize), (src), (size));       \
+      (src) += (step);                                      \
+    }                                                       \
+  } while (0)
+
+#define BIND_BATCH_IS_NULL(bind, r) ((bind)->is_null != NULL && ((bind)->is_null[(r) >> 3] & (1u << ((r) & 7u))))
+
+/*
+ * bind the values of num rows of one parameter, row r of the parameter is in unit r of data, the type is checked
+ * only once for all rows.
+ */
+static int doBindBatchParam(char* data, uint32_t dataSize, SParamInfo* param, TAOS_MULTI_BIND* bind) {
+  if (bind->buffer_type != param->type) {
+    return TSDB_CODE_INVALID_VALUE;
+  }
+
+  char*       dst = data + param->offset;
+  const char* src = bind->buffer;
+  int32_t     num = bind->num;
+
+  switch (param->type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT: {
+      uintptr_t step = (bind->buffer_length > 0) ? bind->buffer_length : 1;
+      BIND_BATCH_COPY(dst, dataSize, src, step, 1, num);
+      break;
+    }
+    case TSDB_DATA_TYPE_SMALLINT: {
+      uintptr_t step = (bind->buffer_length > 0) ? bind->buffer_length : 2;
+      BIND_BATCH_COPY(dst, dataSize, src, step, 2, num);
+      break;
+    }
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_FLOAT: {
+      uintptr_t step = (bind->buffer_length > 0) ? bind->buffer_length : 4;
+      BIND_BATCH_COPY(dst, dataSize, src, step, 4, num);
+      break;
+    }
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_DOUBLE:
+    case TSDB_DATA_TYPE_TIMESTAMP: {
+      uintptr_t step = (bind->buffer_length > 0) ? bind->buffer_length : 8;
+      BIND_BATCH_COPY(dst, dataSize, src, step, 8, num);
+      break;
+    }
+    case TSDB_DATA_TYPE_BINARY:
+      if (bind->length == NULL || bind->buffer_length == 0) {
+        return TSDB_CODE_INVALID_VALUE;
+      }
+
+      for (int32_t r = 0; r < num; ++r, src += bind->buffer_length) {
+        if (BIND_BATCH_IS_NULL(bind, r)) {
+          continue;
+        }
+        if (bind->length[r] < 0 || bind->length[r] > param->bytes || bind->length[r] > bind->buffer_length) {
+          return TSDB_CODE_INVALID_VALUE;
+        }
+
+        char* pDst = dst + r * dataSize;
+        memcpy(pDst, src, bind->length[r]);
+        memset(pDst + bind->length[r], 0, param->bytes - bind->length[r]);
+      }
+      break;
+
+    case TSDB_DATA_TYPE_NCHAR:
+      if (bind->length == NULL || bind->buffer_length == 0) {
+        return TSDB_CODE_INVALID_VALUE;
+      }
+
+      for (int32_t r = 0; r < num; ++r, src += bind->buffer_length) {
+        if (BIND_BATCH_IS_NULL(bind, r)) {
+          continue;
+        }
+        if (bind->length[r] < 0 || bind->length[r] > bind->buffer_length ||
+            !taosMbsToUcs4((char*)src, bind->length[r], dst + r * dataSize, param->bytes)) {
+          return TSDB_CODE_INVALID_VALUE;
+        }
+      }
+      break;
+
+    default:
+      assert(false);
+      return TSDB_CODE_INVALID_VALUE;
+  }
+
+  if (bind->is_null != NULL) {
+    for (int32_t r = 0; r < num; ++r) {
+      if (BIND_BATCH_IS_NULL(bind, r)) {
+        setNull(dst + r * dataSize, param->type, param->bytes);
+      }
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+/*
+ * bind num rows at once, it works as calling taos_stmt_bind_param and taos_stmt_add_batch for each row. The rows
+ * bound by taos_stmt_bind_param but not added yet are overwritten.
+ */
+static int insertStmtBindParamBatch(STscStmt* stmt, TAOS_MULTI_BIND* bind) {
+  SSqlCmd* pCmd = &stmt->pSql->cmd;
+
+  int32_t num = (pCmd->numOfParams > 0) ? bind[0].num : 0;
+  if (num <= 0) {
+    return TSDB_CODE_INVALID_VALUE;
+  }
+
+  for (int32_t i = 1; i < pCmd->numOfParams; ++i) {
+    if (bind[i].num != num) {
+      tscTrace("param %d: number of rows:%d is different from:%d", i, bind[i].num, num);
+      return TSDB_CODE_INVALID_VALUE;
+    }
+  }
+
+  int32_t alloced = 1, binded = 0;
+  if (pCmd->batchSize > 0) {
+    alloced = (pCmd->batchSize + 1) / 2;
+    binded = pCmd->batchSize / 2;
+  }
+
+  int32_t total = binded + num;
+  int32_t newAlloced = MAX(alloced, total);
+
+  // allocate memory for all data blocks first
+  for (int32_t i = 0; i < pCmd->pDataBlocks->nSize; ++i) {
+    STableDataBlocks* pBlock = pCmd->pDataBlocks->pData[i];
+    uint32_t          dataSize = (pBlock->size - sizeof(SShellSubmitBlock)) / alloced;
+
+    uint64_t totalDataSize = sizeof(SShellSubmitBlock) + (uint64_t)dataSize * newAlloced;
+    if (totalDataSize > pBlock->nAllocSize) {
+      const double factor = 1.5;
+      void* tmp = realloc(pBlock->pData, (uint32_t)(totalDataSize * factor));
+      if (tmp == NULL) {
+        return TSDB_CODE_CLI_OUT_OF_MEMORY;
+      }
+      pBlock->pData = (char*)tmp;
+      pBlock->nAllocSize = (uint32_t)(totalDataSize * factor);
+    }
+  }
+
+  for (int32_t i = 0; i < pCmd->pDataBlocks->nSize; ++i) {
+    STableDataBlocks* pBlock = pCmd->pDataBlocks->pData[i];
+    uint32_t          dataSize = (pBlock->size - sizeof(SShellSubmitBlock)) / alloced;
+    char*             pUnit = pBlock->pData + sizeof(SShellSubmitBlock);
+
+    // the values out of parameters are copied from the first one
+    for (int32_t j = alloced; j < newAlloced; ++j) {
+      memcpy(pUnit + dataSize * j, pUnit, dataSize);
+    }
+
+    char* data = pUnit + dataSize * binded;
+    for (uint32_t j = 0; j < pBlock->numOfParams; ++j) {
+      SParamInfo* param = pBlock->params + j;
+      int code = doBindBatchParam(data, dataSize, param, bind + param->idx);
+      if (code != TSDB_CODE_SUCCESS) {
+        tscTrace("param %d: type mismatch or invalid", param->idx);
+        return code;
+      }
+    }
+  }
+
+  for (int32_t i = 0; i < pCmd->pDataBlocks->nSize; ++i) {
+    STableDataBlocks* pBlock = pCmd->pDataBlocks->pData[i];
+    uint32_t          dataSize = (pBlock->size - sizeof(SShellSubmitBlock)) / alloced;
+
+    pBlock->size = sizeof(SShellSubmitBlock) + dataSize * newAlloced;
+
+    SShellSubmitBlock* pSubmit = (SShellSubmitBlock*)pBlock->pData;
+    pSubmit->numOfRows = (pSubmit->numOfRows / alloced) * newAlloced;
+  }
+
+  pCmd->batchSize = total * 2;
+  return TSDB_CODE_SUCCESS;
+}
+
+static STableDataBlocks* stmtCloneDataBlock(STableDataBlocks* pBlock) {
+  STableDataBlocks* pNew = malloc(sizeof(STableDataBlocks));
+  if (pNew == NULL) {
+    return NULL;
+  }
+
+  *pNew = *pBlock;
+  pNew->pData = malloc(pBlock->nAllocSize);
+  pNew->params = malloc(sizeof(SParamInfo) * pBlock->numOfAllocedParams);
+  if (pNew->pData == NULL || (pNew->params == NULL && pBlock->numOfAllocedParams > 0)) {
+    tfree(pNew->pData);
+    tfree(pNew->params);
+    free(pNew);
+    return NULL;
+  }
+
+  memcpy(pNew->pData, pBlock->pData, pBlock->size);
+  memcpy(pNew->params, pBlock->params, sizeof(SParamInfo) * pBlock->numOfAllocedParams);
+  return pNew;
+}
+
+static SDataBlockList* stmtCloneDataBlockList(SDataBlockList* pList) {
+  SDataBlockList* pNew = tscCreateBlockArrayList();
+  if (pNew == NULL) {
+    return NULL;
+  }
+
+  for (int32_t i = 0; i < pList->nSize; ++i) {
+    STableDataBlocks* pBlock = stmtCloneDataBlock(pList->pData[i]);
+    if (pBlock == NULL) {
+      return tscDestroyBlockArrayList(pNew);
+    }
+    tscAppendDataBlock(pNew, pBlock);
+  }
+
+  return pNew;
+}
+
+static void stmtSetBlockTable(STableDataBlocks* pBlock, SMeterMetaInfo* pMeterMetaInfo) {
+  SMeterMeta*        pMeterMeta = pMeterMetaInfo->pMeterMeta;
+  SShellSubmitBlock* pSubmit = (SShellSubmitBlock*)pBlock->pData;
+
+  strncpy(pBlock->meterId, pMeterMetaInfo->name, TSDB_METER_ID_LEN);
+  pBlock->vgid = pMeterMeta->vgid;
+
+  pSubmit->sid = pMeterMeta->sid;
+  pSubmit->uid = pMeterMeta->uid;
+  pSubmit->sversion = pMeterMeta->sversion;
+}
+
+/*
+ * switch the target table of a statement inserting into one table, the new table shall have the same schema, e.g.,
+ * another sub-table of the same super table. The SQL is not parsed again.
+ */
+static int insertStmtSetTableName(STscStmt* stmt, const char* name) {
+  SSqlObj* pSql = stmt->pSql;
+  SSqlCmd* pCmd = &pSql->cmd;
+
+  if (pCmd->batchSize != 0 || stmt->templates == NULL || stmt->templates->nSize != 1 || pCmd->pDataBlocks == NULL) {
+    tscError("%p table can only be switched before binding for the statement of one table", pSql);
+    return TSDB_CODE_OPS_NOT_SUPPORT;
+  }
+
+  char tbname[TSDB_METER_ID_LEN] = {0};
+  strncpy(tbname, name, TSDB_METER_ID_LEN - 1);
+
+  SSQLToken token = {.z = tbname, .n = (uint32_t)strlen(tbname), .type = TK_ID};
+  if (tscValidateName(&token) != TSDB_CODE_SUCCESS) {
+    return TSDB_CODE_INVALID_TABLE_ID;
+  }
+
+  int32_t code = setMeterID(pSql, &token, 0);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  SMeterMetaInfo* pMeterMetaInfo = tscGetMeterMetaInfo(pCmd, 0);
+  if ((code = tscGetMeterMeta(pSql, pMeterMetaInfo->name, 0)) != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  SMeterMeta*       pMeterMeta = pMeterMetaInfo->pMeterMeta;
+  STableDataBlocks* pTemplate = stmt->templates->pData[0];
+  if (UTIL_METER_IS_METRIC(pMeterMetaInfo) || pMeterMeta->rowSize != pTemplate->rowSize) {
+    tscError("%p table:%s does not match the statement", pSql, pMeterMetaInfo->name);
+    return TSDB_CODE_INVALID_TABLE;
+  }
+
+  // the parameters shall be bound to columns of the same type
+  SSchema* pSchema = tsGetSchema(pMeterMeta);
+  for (uint32_t i = 0; i < pTemplate->numOfParams; ++i) {
+    SParamInfo* param = pTemplate->params + i;
+    uint32_t    offset = param->offset % pTemplate->rowSize;
+
+    int32_t  col = 0;
+    uint32_t colOffset = 0;
+    for (; col < pMeterMeta->numOfColumns && colOffset < offset; ++col) {
+      colOffset += pSchema[col].bytes;
+    }
+
+    if (col >= pMeterMeta->numOfColumns || colOffset != offset || pSchema[col].type != param->type ||
+        pSchema[col].bytes != param->bytes) {
+      tscError("%p table:%s does not match parameter:%d of the statement", pSql, pMeterMetaInfo->name, param->idx);
+      return TSDB_CODE_INVALID_TABLE;
+    }
+  }
+
+  stmtSetBlockTable(pTemplate, pMeterMetaInfo);
+  stmtSetBlockTable(pCmd->pDataBlocks->pData[0], pMeterMetaInfo);
+
+  tscTrace("%p statement is switched to table:%s", pSql, pMeterMetaInfo->name);
+  return TSDB_CODE_SUCCESS;
+}
+
 static int insertStmtAddBatch(STscStmt* stmt) {
   SSqlCmd* pCmd = &stmt->pSql->cmd;
   if ((pCmd->batchSize % 2) == 1) {
@@ -388,10 +683,19 @@ static int insertStmtAddBatch(STscStmt* stmt) {
 static int insertStmtPrepare(STscStmt* stmt) {
   STscObj* taos = stmt->taos;
   SSqlObj *pSql = stmt->pSql;
-  pSql->cmd.numOfParams = 0;
-  pSql->cmd.batchSize = 0;
 
-  return tsParseInsertSql(pSql, pSql->sqlstr, taos->acctId, taos->db);
+  // the statement may be prepared again, release the command and blocks of the previous SQL
+  tscRemoveAllMeterMetaInfo(&pSql->cmd, false);
+  tscCleanSqlCmd(&pSql->cmd);
+  stmt->templates = tscDestroyBlockArrayList(stmt->templates);
+
+  int code = tsParseInsertSql(pSql, pSql->sqlstr, taos->acctId, taos->db);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  stmt->templates = stmtCloneDataBlockList(pSql->cmd.pDataBlocks);
+  return (stmt->templates != NULL) ? TSDB_CODE_SUCCESS : TSDB_CODE_CLI_OUT_OF_MEMORY;
 }
 
 static int insertStmtReset(STscStmt* pStmt) {
@@ -415,6 +719,85 @@ static int insertStmtReset(STscStmt* pStmt) {
   return TSDB_CODE_SUCCESS;
 }
 
+/*
+ * data blocks are released or merged after being sent, the statement is reused from the blocks before binding, no
+ * matter whether the execution succeeds or not.
+ */
+static int insertStmtRestoreDataBlocks(STscStmt* stmt) {
+  SSqlCmd* pCmd = &stmt->pSql->cmd;
+
+  pCmd->pDataBlocks = tscDestroyBlockArrayList(pCmd->pDataBlocks);
+  pCmd->pDataBlocks = stmtCloneDataBlockList(stmt->templates);
+  pCmd->batchSize = 0;
+  pCmd->columnar = false;
+
+  SMeterMetaInfo* pMeterMetaInfo = tscGetMeterMetaInfo(pCmd, 0);
+  if (pMeterMetaInfo != NULL) {
+    pMeterMetaInfo->vnodeIndex = 0;
+  }
+
+  if (pCmd->pDataBlocks == NULL) {
+    tscError("%p failed to restore data blocks of statement", stmt->pSql);
+    return TSDB_CODE_CLI_OUT_OF_MEMORY;
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+/*
+ * transpose the rows of a table block into column-major, the values of a column are stored one after another, so the
+ * vnode copies each column into cache at once.
+ */
+static int stmtTransposeDataBlock(STableDataBlocks* pBlock, SMeterMeta* pMeterMeta) {
+  SShellSubmitBlock* pSubmit = (SShellSubmitBlock*)pBlock->pData;
+  if (pMeterMeta == NULL || pMeterMeta->rowSize != pBlock->rowSize) {
+    return TSDB_CODE_INVALID_VALUE;
+  }
+
+  size_t dataSize = (size_t)pSubmit->numOfRows * pBlock->rowSize;
+  char*  pCols = malloc(dataSize);
+  if (pCols == NULL) {
+    return TSDB_CODE_CLI_OUT_OF_MEMORY;
+  }
+
+  SSchema* pSchema = tsGetSchema(pMeterMeta);
+  char*    dst = pCols;
+  int32_t  offset = 0;
+  for (int32_t col = 0; col < pMeterMeta->numOfColumns; ++col) {
+    int32_t     bytes = pSchema[col].bytes;
+    const char* src = pSubmit->payLoad + offset;
+
+    for (int32_t r = 0; r < pSubmit->numOfRows; ++r) {
+      memcpy(dst, src, bytes);
+      dst += bytes;
+      src += pBlock->rowSize;
+    }
+
+    offset += bytes;
+  }
+
+  memcpy(pSubmit->payLoad, pCols, dataSize);
+  free(pCols);
+  return TSDB_CODE_SUCCESS;
+}
+
+/*
+ * the vnode advertises its features in the submit response, so the first batch of a statement is always sent row by
+ * row. Only the vnode which has sent the last submit response is known to accept the rows column by column.
+ */
+static bool stmtVnodeAcceptsColumnar(STscStmt* stmt, SMeterMeta* pMeterMeta) {
+  SSqlObj* pSql = stmt->pSql;
+  if (pMeterMeta == NULL || (pSql->vnodeFeatures & TSDB_VNODE_FEATURE_COLUMNAR_SUBMIT) == 0) {
+    return false;
+  }
+
+#ifdef CLUSTER
+  SVPeerDesc* pDesc = &pMeterMeta->vpeerDesc[pMeterMeta->index];
+  return pDesc->ip == pSql->ip && pDesc->vnode == pSql->vnode;
+#else
+  return pMeterMeta->vpeerDesc[0].vnode == pSql->vnode;
+#endif
+}
+
 static int insertStmtExecute(STscStmt* stmt) {
   SSqlCmd* pCmd = &stmt->pSql->cmd;
   if (pCmd->batchSize == 0) {
@@ -427,15 +810,27 @@ static int insertStmtExecute(STscStmt* stmt) {
   SMeterMetaInfo* pMeterMetaInfo = tscGetMeterMetaInfo(pCmd, 0);
   
   if (pCmd->pDataBlocks->nSize > 0) {
+    // the rows of a statement of one table are sent column by column, if its vnode accepts it
+    if (stmtVnodeAcceptsColumnar(stmt, pMeterMetaInfo->pMeterMeta) && !pCmd->import &&
+        pCmd->pDataBlocks->nSize == 1) {
+      STableDataBlocks* pBlock = pCmd->pDataBlocks->pData[0];
+
+      // rows are sorted before transposed, they are not sorted again during merging
+      sortRemoveDuplicates(pBlock);
+      pCmd->columnar = (stmtTransposeDataBlock(pBlock, pMeterMetaInfo->pMeterMeta) == TSDB_CODE_SUCCESS);
+    }
+
     // merge according to vgid
     int code = tscMergeTableDataBlocks(stmt->pSql, pCmd->pDataBlocks);
     if (code != TSDB_CODE_SUCCESS) {
+      insertStmtRestoreDataBlocks(stmt);
       return code;
     }
 
     STableDataBlocks *pDataBlock = pCmd->pDataBlocks->pData[0];
     code = tscCopyDataBlockToPayload(stmt->pSql, pDataBlock);
     if (code != TSDB_CODE_SUCCESS) {
+      insertStmtRestoreDataBlocks(stmt);
       return code;
     }
 
@@ -456,10 +851,11 @@ static int insertStmtExecute(STscStmt* stmt) {
 
   // tscTrace("%p SQL result:%d, %s pObj:%p", pSql, pRes->code, taos_errstr(taos), pObj);
   if (pRes->code != TSDB_CODE_SUCCESS) {
-    tscFreeSqlObjPartial(pSql);
+    tscError("%p failed to execute statement, code:%d", pSql, pRes->code);
   }
 
-  return pRes->code;
+  int code = insertStmtRestoreDataBlocks(stmt);
+  return (pRes->code != TSDB_CODE_SUCCESS) ? pRes->code : code;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -493,6 +889,7 @@ TAOS_STMT* taos_stmt_init(TAOS* taos) {
   pSql->signature = pSql;
   pSql->pTscObj = pObj;
 
+  pStmt->taos = pObj;
   pStmt->pSql = pSql;
   return pStmt;
 }
@@ -511,6 +908,7 @@ int taos_stmt_prepare(TAOS_STMT* stmt, const char* sql, unsigned long length) {
   sqlstr[length] = 0;
   strtolower(sqlstr, sqlstr);
 
+  tfree(pStmt->pSql->sqlstr);
   pStmt->pSql->sqlstr = sqlstr;
   if (tscIsInsertOrImportData(sqlstr)) {
     pStmt->isInsert = true;
@@ -533,6 +931,8 @@ int taos_stmt_close(TAOS_STMT* stmt) {
     }
     free(normal->parts);
     free(normal->sql);
+  } else {
+    tscDestroyBlockArrayList(pStmt->templates);
   }
 
   tscFreeSqlObj(pStmt->pSql);
@@ -548,6 +948,22 @@ int taos_stmt_bind_param(TAOS_STMT* stmt, TAOS_BIND* bind) {
   return normalStmtBindParam(pStmt, bind);
 }
 
+int taos_stmt_bind_param_batch(TAOS_STMT* stmt, TAOS_MULTI_BIND* bind) {
+  STscStmt* pStmt = (STscStmt*)stmt;
+  if (pStmt->isInsert && pStmt->pSql->cmd.pDataBlocks != NULL) {
+    return insertStmtBindParamBatch(pStmt, bind);
+  }
+  return TSDB_CODE_OPS_NOT_SUPPORT;
+}
+
+int taos_stmt_set_tbname(TAOS_STMT* stmt, const char* name) {
+  STscStmt* pStmt = (STscStmt*)stmt;
+  if (pStmt->isInsert) {
+    return insertStmtSetTableName(pStmt, name);
+  }
+  return TSDB_CODE_OPS_NOT_SUPPORT;
+}
+
 int taos_stmt_add_batch(TAOS_STMT* stmt) {
   STscStmt* pStmt = (STscStmt*)stmt;
   if (pStmt->isInsert) {
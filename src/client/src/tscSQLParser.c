@@ -5652,8 +5652,10 @@ int32_t doLocalQueryProcess(SQuerySQL* pQuerySql, SSqlCmd* pCmd) {
 int32_t tscCheckCreateDbParams(SSqlCmd* pCmd, SCreateDbMsg *pCreate) {
   char msg[512] = {0};
   
-  if (pCreate->commitLog != -1 && (pCreate->commitLog < 0 || pCreate->commitLog > 1)) {
-    snprintf(msg, tListLen(msg), "invalid db option commitLog: %d, only 0 or 1 allowed", pCreate->commitLog);
+  if (pCreate->commitLog != -1 &&
+      (pCreate->commitLog < TSDB_MIN_COMMIT_LOG_LEVEL || pCreate->commitLog > TSDB_MAX_COMMIT_LOG_LEVEL)) {
+    snprintf(msg, tListLen(msg), "invalid db option commitLog: %d, valid range: [%d, %d]", pCreate->commitLog,
+             TSDB_MIN_COMMIT_LOG_LEVEL, TSDB_MAX_COMMIT_LOG_LEVEL);
     return invalidSqlErrMsg(pCmd, msg);
   }
   
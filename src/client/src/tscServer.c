@@ -30,6 +30,7 @@
 #include "tutil.h"
 
 #define TSC_MGMT_VNODE 999
+#define TSC_SUBMIT_PACE_MS 100  // wait before the next submit once the vnode has no credits left
 
 #ifdef CLUSTER
   SIpStrList tscMgmtIpList;
@@ -157,7 +158,7 @@ void tscGetConnToMgmt(SSqlObj *pSql, uint8_t *pCode) {
     *pCode = 0;
     pSql->retry++;
     pSql->index = pSql->index % tscMgmtIpList.numOfIps;
-    if (pSql->cmd.command > TSDB_SQL_READ && pSql->index == 0) pSql->index = 1;
+    if (!TSC_IS_MGMT_WRITE_CMD(pSql->cmd.command) && pSql->index == 0) pSql->index = 1;
     void *thandle = taosGetConnFromCache(tscConnCache, tscMgmtIpList.ip[pSql->index], TSC_MGMT_VNODE, pTscObj->user);
 #else
   if (pSql->retry < tscGetMgmtConnMaxRetryTimes()) {
@@ -318,6 +319,7 @@ void tscGetConnToVnode(SSqlObj *pSql, uint8_t *pCode) {
 int tscSendMsgToServer(SSqlObj *pSql) {
   uint8_t code = TSDB_CODE_NETWORK_UNAVAIL;
 
+  pSql->vnodeFeatures = 0;
   if (pSql->thandle == NULL) {
     if (pSql->cmd.command < TSDB_SQL_MGMT)
       tscGetConnToVnode(pSql, &code);
@@ -377,7 +379,7 @@ void tscProcessMgmtRedirect(SSqlObj *pSql, uint8_t *cont) {
     tscTrace("Update mgmt Ip, index:%d ip:%s", i, tscMgmtIpList.ipstr[i]);
   }
 
-  if (pSql->cmd.command < TSDB_SQL_READ) {
+  if (pSql->cmd.command < TSDB_SQL_MGMT || TSC_IS_MGMT_WRITE_CMD(pSql->cmd.command)) {
     tsMasterIndex = 0;
     pSql->index = 0;
   } else {
@@ -532,10 +534,10 @@ void *tscProcessMsgFromServer(char *msg, void *ahandle, void *thandle) {
         pVnodeSidList->index = pSql->index;
       }
     } else {
-      if (pCmd->command > TSDB_SQL_READ)
-        tsSlaveIndex = pSql->index;
-      else
+      if (TSC_IS_MGMT_WRITE_CMD(pCmd->command))
         tsMasterIndex = pSql->index;
+      else
+        tsSlaveIndex = pSql->index;
     }
   }
 
@@ -574,10 +576,23 @@ void *tscProcessMsgFromServer(char *msg, void *ahandle, void *thandle) {
      * The actual inserted number of points is the first number.
      */
     if (pMsg->msgType == TSDB_MSG_TYPE_SUBMIT_RSP) {
-      pRes->numOfRows += *(int32_t *)pRes->pRsp;
+      int32_t numOfPoints = *(int32_t *)pRes->pRsp;
+      pRes->numOfRows += numOfPoints;
+
+      // the number of submits the vnode can still park and the vnode features follow in network order, they are not
+      // sent by old servers
+      int32_t credits = -1;
+      if (pRes->rspLen >= 1 + sizeof(int32_t) * 2) {
+        credits = (int32_t)ntohl(*(int32_t *)(pRes->pRsp + sizeof(int32_t)));
+      }
+      pObj->submitCredits = credits;
 
-      tscTrace("%p cmd:%d code:%d, inserted rows:%d, rsp len:%d", pSql, pCmd->command, pRes->code,
-               *(int32_t *)pRes->pRsp, pRes->rspLen);
+      if (pRes->rspLen >= 1 + sizeof(int32_t) * 3) {
+        pSql->vnodeFeatures = ntohl(*(uint32_t *)(pRes->pRsp + sizeof(int32_t) * 2));
+      }
+
+      tscTrace("%p cmd:%d code:%d, inserted rows:%d, rsp len:%d, credits:%d features:0x%x", pSql, pCmd->command,
+               pRes->code, numOfPoints, pRes->rspLen, credits, pSql->vnodeFeatures);
     } else {
       tscTrace("%p cmd:%d code:%d rsp len:%d", pSql, pCmd->command, pRes->code, pRes->rspLen);
     }
@@ -714,6 +729,38 @@ int32_t tscLaunchJoinSubquery(SSqlObj *pSql, int16_t tableIndex, SJoinSubquerySu
   return tscProcessSql(pNew);
 }
 
+static void tscSendPacedSubmit(void *param, void *tmrId) {
+  SSqlObj *pSql = (SSqlObj *)param;
+
+  int32_t code = tscSendMsgToServer(pSql);
+  if (code == TSDB_CODE_SUCCESS) {
+    return;
+  }
+
+  // the caller is waiting for the response, report the error in the same way as a response
+  pSql->res.code = code;
+  if (pSql->fp != NULL) {
+    tscQueueAsyncRes(pSql);
+  } else {
+    tsem_wait(&pSql->emptyRspSem);
+    tsem_post(&pSql->rspSem);
+  }
+}
+
+/*
+ * the vnode parks no more submits once the credits run out and bounces them back to be retried, so the submit is
+ * sent by timer after a while to let the commit free the cache, instead of blocking the caller thread.
+ */
+static bool tscPaceSubmit(SSqlObj *pSql) {
+  STscObj *pObj = pSql->pTscObj;
+  if (pSql->cmd.command != TSDB_SQL_INSERT || pObj->submitCredits != 0) {
+    return false;
+  }
+
+  tscTrace("%p no submit credits left, submit after %dms", pSql, TSC_SUBMIT_PACE_MS);
+  return taosTmrStart(tscSendPacedSubmit, TSC_SUBMIT_PACE_MS, pSql, tscTmr) != NULL;
+}
+
 int doProcessSql(SSqlObj *pSql) {
   SSqlCmd *pCmd = &pSql->cmd;
   SSqlRes *pRes = &pSql->res;
@@ -723,7 +770,7 @@ int doProcessSql(SSqlObj *pSql) {
   void *asyncFp = pSql->fp;
   if (tscBuildMsg[pCmd->command](pSql) < 0) {  // build msg failed
     code = TSDB_CODE_APP_ERROR;
-  } else {
+  } else if (!tscPaceSubmit(pSql)) {
     code = tscSendMsgToServer(pSql);
   }
   if (asyncFp) {
@@ -782,8 +829,8 @@ int tscProcessSql(SSqlObj *pSql) {
         pSql->index = pSidList->index;
       }
     }
-  } else if (pSql->cmd.command < TSDB_SQL_LOCAL) {
-    pSql->index = pSql->cmd.command < TSDB_SQL_READ ? tsMasterIndex : tsSlaveIndex;
+  } else if (TSC_IS_MGMT_CMD(pSql->cmd.command)) {
+    pSql->index = TSC_IS_MGMT_WRITE_CMD(pSql->cmd.command) ? tsMasterIndex : tsSlaveIndex;
   } else {  // local handler
     return (*tscProcessMsgRsp[pCmd->command])(pSql);
   }
@@ -1384,6 +1431,9 @@ int tscBuildRetrieveMsg(SSqlObj *pSql) {
   *((uint16_t*)pMsg) = htons(pSql->cmd.type);
   pMsg += sizeof(pSql->cmd.type);
 
+  *((uint16_t *)pMsg) = htons((uint16_t)tsRetrieveWindow);
+  pMsg += sizeof(uint16_t);
+
   msgLen = pMsg - pStart;
   pSql->cmd.payloadLen = msgLen;
   pSql->cmd.msgType = TSDB_MSG_TYPE_RETRIEVE;
@@ -1417,7 +1467,7 @@ int tscBuildSubmitMsg(SSqlObj *pSql) {
   pMsg = pStart;
 
   pShellMsg = (SShellSubmitMsg *)pMsg;
-  pShellMsg->import = pSql->cmd.import;
+  pShellMsg->import = pSql->cmd.import | (pSql->cmd.columnar ? TSDB_SUBMIT_COLUMNAR : 0);
   pShellMsg->vnode = htons(pMeterMeta->vpeerDesc[pMeterMeta->index].vnode);
   pShellMsg->numOfSid = htonl(pSql->cmd.count);  // number of meters to be inserted
 
@@ -2737,6 +2787,40 @@ int tscBuildMultiMeterMetaMsg(SSqlObj *pSql) {
   return pCmd->payloadLen;
 }
 
+/*
+ * payload holds pCmd->count SCreateTableItem one after another, items are in network byte order already
+ */
+int tscBuildMultiCreateTableMsg(SSqlObj *pSql) {
+  SSqlCmd *pCmd = &pSql->cmd;
+
+  if (pCmd->payloadLen <= 0 || pCmd->count <= 0) return -1;
+
+  char *tmpData = calloc(1, pCmd->payloadLen);
+  if (NULL == tmpData) return -1;
+  memcpy(tmpData, pCmd->payload, pCmd->payloadLen);
+
+  // all tables are in the same db, get it from the first one
+  SMgmtHead *pMgmt = (SMgmtHead *)(pCmd->payload + tsRpcHeadSize);
+  memset(pMgmt->db, 0, TSDB_METER_ID_LEN);
+  tscGetDBInfoFromMeterId(((SCreateTableItem *)tmpData)->meterId, pMgmt->db);
+
+  SMultiCreateTableMsg *pMulti = (SMultiCreateTableMsg *)(pCmd->payload + tsRpcHeadSize + sizeof(SMgmtHead));
+  pMulti->numOfTables = htonl((int32_t)pCmd->count);
+  memcpy(pMulti->data, tmpData, pCmd->payloadLen);
+
+  tfree(tmpData);
+
+  pCmd->payloadLen += sizeof(SMgmtHead) + sizeof(SMultiCreateTableMsg);
+  pCmd->msgType = TSDB_MSG_TYPE_MULTI_CREATE_TABLE;
+
+  assert(pCmd->payloadLen + minMsgSize() <= pCmd->allocSize);
+
+  tscTrace("%p build multi-create-table msg completed, numOfTables:%d, msg size:%d", pSql, pCmd->count,
+           pCmd->payloadLen);
+
+  return pCmd->payloadLen;
+}
+
 static int32_t tscEstimateMetricMetaMsgSize(SSqlCmd *pCmd) {
   const int32_t defaultSize =
       minMsgSize() + sizeof(SMetricMetaMsg) + sizeof(SMgmtHead) + sizeof(int16_t) * TSDB_MAX_TAGS;
@@ -2768,6 +2852,9 @@ int tscBuildMetricMetaMsg(SSqlObj *pSql) {
   SSqlCmd * pCmd = &pSql->cmd;
   STagCond *pTagCond = &pCmd->tagCond;
 
+  // the delta format is only asked for when mgmt node supports it
+  bool delta = (pSql->pTscObj->features & TSDB_CONN_FEATURE_METRIC_META_DELTA) != 0;
+
   SMeterMetaInfo *pMeterMetaInfo = tscGetMeterMetaInfo(pCmd, tableIndex);
 
   int32_t size = tscEstimateMetricMetaMsgSize(pCmd);
@@ -2887,13 +2974,17 @@ int tscBuildMetricMetaMsg(SSqlObj *pSql) {
     strcpy(pElem->meterId, pMeterMetaInfo->name);
     pElem->numOfTags = htons(pMeterMetaInfo->numOfTags);
 
+    // ask for the changes since the cached version only, not available for join query
+    SMetricMeta *pCached = pMeterMetaInfo->pMetricMeta;
+    pElem->version = (delta && pCmd->numOfTables == 1 && pCached != NULL) ? htobe64(pCached->version) : 0;
+
     int16_t len = pMsg - (char *)pElem;
     pElem->elemLen = htons(len);  // redundant data for integrate check
   }
 
   msgLen = pMsg - pStart;
   pCmd->payloadLen = msgLen;
-  pCmd->msgType = TSDB_MSG_TYPE_METRIC_META;
+  pCmd->msgType = delta ? TSDB_MSG_TYPE_METRIC_META_DELTA : TSDB_MSG_TYPE_METRIC_META;
   assert(msgLen + minMsgSize() <= size);
   return msgLen;
 }
@@ -3178,6 +3269,172 @@ int tscProcessMultiMeterMetaRsp(SSqlObj *pSql) {
   return TSDB_CODE_SUCCESS;
 }
 
+/*
+ * The metric meta is refreshed after metricMetaKeepTimer, but it is retained in cache for a longer time, so that
+ * only the changes since its version are retrieved from mgmt node.
+ */
+#define TSC_METRIC_META_RETAIN_TIME (tsMetricMetaKeepTimer * 2)
+
+static bool tscIsMetricMetaExpired(SMetricMeta *pMeta) {
+  return taosGetTimestampMs() - pMeta->fetchTime >= tsMetricMetaKeepTimer * 1000L;
+}
+
+static int32_t tscMeterSidRemovedComparator(const void *pLeft, const void *pRight) {
+  const SMeterSidRemoved *p1 = (const SMeterSidRemoved *)pLeft;
+  const SMeterSidRemoved *p2 = (const SMeterSidRemoved *)pRight;
+
+  if (p1->vgId != p2->vgId) {
+    return p1->vgId > p2->vgId ? 1 : -1;
+  }
+
+  if (p1->sid != p2->sid) {
+    return p1->sid > p2->sid ? 1 : -1;
+  }
+
+  return 0;
+}
+
+static bool tscIsMeterSidRemoved(SMeterSidRemoved *pRemoved, int32_t numOfRemoved, int32_t vgId, int32_t sid) {
+  SMeterSidRemoved key = {.vgId = vgId, .sid = sid};
+  return bsearch(&key, pRemoved, numOfRemoved, sizeof(SMeterSidRemoved), tscMeterSidRemovedComparator) != NULL;
+}
+
+static char *tscCopyVnodeSidList(SMetricMeta *pNewMeta, SVnodeSidList *pSrc, int32_t numOfSids, char *pStr) {
+  SVnodeSidList *pList = (SVnodeSidList *)pStr;
+  memcpy(pList, pSrc, sizeof(SVnodeSidList));
+  pList->numOfSids = 0;
+
+  pNewMeta->list[pNewMeta->numOfVnodes++] = pStr - (char *)pNewMeta;
+  return pStr + sizeof(SVnodeSidList) + sizeof(SMeterSidExtInfo *) * numOfSids;
+}
+
+static char *tscCopyMeterSidInfo(SMetricMeta *pNewMeta, SVnodeSidList *pList, SMeterSidExtInfo *pInfo, char *pStr) {
+  size_t sidSize = sizeof(SMeterSidExtInfo) + pNewMeta->tagLen;
+
+  pList->pSidExtInfoList[pList->numOfSids++] = pStr - (char *)pList;
+  memcpy(pStr, pInfo, sidSize);
+  pNewMeta->numOfMeters++;
+
+  return pStr + sidSize;
+}
+
+/*
+ * Build the new metric meta from the cached one and the changes since its version. In the response, the vnode lists
+ * of the tables added or re-tagged are followed by the tables removed, which are removed from the cached one first.
+ */
+static SMetricMeta *tscApplyMetricMetaDelta(SMetricMeta *pBase, SMetricMeta *pDelta, char **pRsp, int32_t *size) {
+  char * rsp = *pRsp;
+  size_t sidSize = sizeof(SMeterSidExtInfo) + pDelta->tagLen;
+
+  SVnodeSidList **pDeltaLists = calloc(pDelta->numOfVnodes + 1, POINTER_BYTES);
+  bool *          used = calloc(pDelta->numOfVnodes + 1, sizeof(bool));
+  if (pDeltaLists == NULL || used == NULL) {
+    tfree(pDeltaLists);
+    tfree(used);
+    return NULL;
+  }
+
+  for (int32_t i = 0; i < pDelta->numOfVnodes; ++i) {
+    pDeltaLists[i] = (SVnodeSidList *)rsp;
+    rsp += sizeof(SVnodeSidList) + sidSize * pDeltaLists[i]->numOfSids;
+  }
+
+  SMeterSidRemoved *pRemoved = (SMeterSidRemoved *)rsp;
+  rsp += sizeof(SMeterSidRemoved) * pDelta->numOfRemoved;
+  *pRsp = rsp;
+
+  // the tag columns are identical, since the cache key is built from them
+  if (pBase == NULL || pBase->tagLen != pDelta->tagLen) {
+    tscError("invalid metric meta delta, no cached metric meta of identical tags");
+    free(pDeltaLists);
+    free(used);
+    return NULL;
+  }
+
+  qsort(pRemoved, pDelta->numOfRemoved, sizeof(SMeterSidRemoved), tscMeterSidRemovedComparator);
+
+  int32_t maxVnodes = pBase->numOfVnodes + pDelta->numOfVnodes;
+  int32_t maxMeters = pBase->numOfMeters + pDelta->numOfMeters;
+  size_t  bufSize = sizeof(SMetricMeta) + maxVnodes * (sizeof(SVnodeSidList *) + sizeof(SVnodeSidList)) +
+                   maxMeters * (sizeof(SMeterSidExtInfo *) + sidSize);
+
+  char *pStr = calloc(1, bufSize);
+  if (pStr == NULL) {
+    free(pDeltaLists);
+    free(used);
+    return NULL;
+  }
+
+  SMetricMeta *pNewMeta = (SMetricMeta *)pStr;
+  pNewMeta->tagLen = pDelta->tagLen;
+  pNewMeta->version = pDelta->version;
+  pNewMeta->fetchTime = taosGetTimestampMs();
+
+  pStr += sizeof(SMetricMeta) + maxVnodes * sizeof(SVnodeSidList *);
+
+  // the cached vnode lists, with the changed tables of the same vnode group appended
+  for (int32_t i = 0; i < pBase->numOfVnodes; ++i) {
+    SVnodeSidList *pBaseList = (SVnodeSidList *)(pBase->list[i] + (char *)pBase);
+    SVnodeSidList *pDeltaList = NULL;
+
+    for (int32_t j = 0; j < pDelta->numOfVnodes; ++j) {
+      if (!used[j] && pDeltaLists[j]->vgId == pBaseList->vgId) {
+        pDeltaList = pDeltaLists[j];
+        used[j] = true;
+        break;
+      }
+    }
+
+    int32_t numOfSids = (pDeltaList != NULL) ? pDeltaList->numOfSids : 0;
+    for (int32_t j = 0; j < pBaseList->numOfSids; ++j) {
+      SMeterSidExtInfo *pInfo = (SMeterSidExtInfo *)(pBaseList->pSidExtInfoList[j] + (char *)pBaseList);
+      numOfSids += tscIsMeterSidRemoved(pRemoved, pDelta->numOfRemoved, pBaseList->vgId, pInfo->sid) ? 0 : 1;
+    }
+
+    if (numOfSids == 0) {
+      continue;
+    }
+
+    // the vnode peers carried by the delta are more recent
+    SVnodeSidList *pList = (SVnodeSidList *)pStr;
+    pStr = tscCopyVnodeSidList(pNewMeta, (pDeltaList != NULL) ? pDeltaList : pBaseList, numOfSids, pStr);
+
+    for (int32_t j = 0; j < pBaseList->numOfSids; ++j) {
+      SMeterSidExtInfo *pInfo = (SMeterSidExtInfo *)(pBaseList->pSidExtInfoList[j] + (char *)pBaseList);
+      if (!tscIsMeterSidRemoved(pRemoved, pDelta->numOfRemoved, pBaseList->vgId, pInfo->sid)) {
+        pStr = tscCopyMeterSidInfo(pNewMeta, pList, pInfo, pStr);
+      }
+    }
+
+    char *pSids = (pDeltaList != NULL) ? (char *)pDeltaList + sizeof(SVnodeSidList) : NULL;
+    for (int32_t j = 0; pDeltaList != NULL && j < pDeltaList->numOfSids; ++j) {
+      pStr = tscCopyMeterSidInfo(pNewMeta, pList, (SMeterSidExtInfo *)(pSids + sidSize * j), pStr);
+    }
+  }
+
+  // the vnode groups not in the cached one
+  for (int32_t i = 0; i < pDelta->numOfVnodes; ++i) {
+    if (used[i] || pDeltaLists[i]->numOfSids == 0) {
+      continue;
+    }
+
+    SVnodeSidList *pList = (SVnodeSidList *)pStr;
+    pStr = tscCopyVnodeSidList(pNewMeta, pDeltaLists[i], pDeltaLists[i]->numOfSids, pStr);
+
+    char *pSids = (char *)pDeltaLists[i] + sizeof(SVnodeSidList);
+    for (int32_t j = 0; j < pDeltaLists[i]->numOfSids; ++j) {
+      pStr = tscCopyMeterSidInfo(pNewMeta, pList, (SMeterSidExtInfo *)(pSids + sidSize * j), pStr);
+    }
+  }
+
+  *size = pStr - (char *)pNewMeta;
+  assert(*size <= bufSize);
+
+  free(pDeltaLists);
+  free(used);
+  return pNewMeta;
+}
+
 int tscProcessMetricMetaRsp(SSqlObj *pSql) {
   SMetricMeta *pMeta;
   uint8_t      ieType;
@@ -3209,17 +3466,48 @@ int tscProcessMetricMetaRsp(SSqlObj *pSql) {
     return pSql->res.code;
   }
 
+  // old servers answer in the legacy layout without delta
+  bool legacy = (pSql->res.rspType == TSDB_MSG_TYPE_METRIC_META_RSP);
+
   for (int32_t k = 0; k < num; ++k) {
-    pMeta = (SMetricMeta *)rsp;
+    SMetricMeta meta = {0};
+    pMeta = &meta;
+
+    if (legacy) {
+      SLegacyMetricMeta *pLegacy = (SLegacyMetricMeta *)rsp;
+      pMeta->numOfMeters = htonl(pLegacy->numOfMeters);
+      pMeta->numOfVnodes = htonl(pLegacy->numOfVnodes);
+      pMeta->tagLen = htons(pLegacy->tagLen);
+      rsp = rsp + sizeof(SLegacyMetricMeta);
+    } else {
+      SMetricMeta *pRspMeta = (SMetricMeta *)rsp;
+      pMeta->numOfMeters = htonl(pRspMeta->numOfMeters);
+      pMeta->numOfVnodes = htonl(pRspMeta->numOfVnodes);
+      pMeta->tagLen = htons(pRspMeta->tagLen);
+      pMeta->delta = pRspMeta->delta;
+      pMeta->numOfRemoved = htonl(pRspMeta->numOfRemoved);
+      pMeta->version = htobe64(pRspMeta->version);
+      rsp = rsp + sizeof(SMetricMeta);
+    }
 
-    size_t size = (size_t)pSql->res.rspLen - 1;
-    rsp = rsp + sizeof(SMetricMeta);
+    if (pMeta->delta) {
+      SMeterMetaInfo *pMeterMetaInfo = tscGetMeterMetaInfo(&pSql->cmd, k);
+
+      metricMetaList[k] = tscApplyMetricMetaDelta(pMeterMetaInfo->pMetricMeta, pMeta, &rsp, &sizes[k]);
+      if (metricMetaList[k] == NULL) {
+        pSql->res.code = (pMeterMetaInfo->pMetricMeta == NULL) ? TSDB_CODE_APP_ERROR : TSDB_CODE_CLI_OUT_OF_MEMORY;
+        goto _error_clean;
+      }
 
-    pMeta->numOfMeters = htonl(pMeta->numOfMeters);
-    pMeta->numOfVnodes = htonl(pMeta->numOfVnodes);
-    pMeta->tagLen = htons(pMeta->tagLen);
+      tscTrace("%p metricmeta delta, changed:%d, removed:%d, total:%d, version:%lld", pSql, pMeta->numOfMeters,
+               pMeta->numOfRemoved, ((SMetricMeta *)metricMetaList[k])->numOfMeters, pMeta->version);
+      continue;
+    }
 
-    size += pMeta->numOfVnodes * sizeof(SVnodeSidList *) + pMeta->numOfMeters * sizeof(SMeterSidExtInfo *);
+    // the header and vnode lists kept locally are larger than the legacy ones in response
+    size_t size = (size_t)pSql->res.rspLen - 1 + sizeof(SMetricMeta) +
+                  pMeta->numOfVnodes * (sizeof(SVnodeSidList *) + sizeof(SVnodeSidList)) +
+                  pMeta->numOfMeters * sizeof(SMeterSidExtInfo *);
 
     char *pStr = calloc(1, size);
     if (pStr == NULL) {
@@ -3233,23 +3521,33 @@ int tscProcessMetricMetaRsp(SSqlObj *pSql) {
     pNewMetricMeta->numOfMeters = pMeta->numOfMeters;
     pNewMetricMeta->numOfVnodes = pMeta->numOfVnodes;
     pNewMetricMeta->tagLen = pMeta->tagLen;
+    pNewMetricMeta->version = pMeta->version;
+    pNewMetricMeta->fetchTime = taosGetTimestampMs();
 
     pStr = pStr + sizeof(SMetricMeta) + pNewMetricMeta->numOfVnodes * sizeof(SVnodeSidList *);
 
     for (int32_t i = 0; i < pMeta->numOfVnodes; ++i) {
-      SVnodeSidList *pSidLists = (SVnodeSidList *)rsp;
-      memcpy(pStr, pSidLists, sizeof(SVnodeSidList));
+      SVnodeSidList *pLists = (SVnodeSidList *)pStr;
+
+      if (legacy) {
+        SLegacyVnodeSidList *pSidLists = (SLegacyVnodeSidList *)rsp;
+        memcpy(pLists->vpeerDesc, pSidLists->vpeerDesc, sizeof(pLists->vpeerDesc));
+        pLists->index = pSidLists->index;
+        pLists->numOfSids = pSidLists->numOfSids;
+        rsp += sizeof(SLegacyVnodeSidList);
+      } else {
+        memcpy(pLists, rsp, sizeof(SVnodeSidList));
+        rsp += sizeof(SVnodeSidList);
+      }
 
       pNewMetricMeta->list[i] = pStr - (char *)pNewMetricMeta;  // offset value
-      SVnodeSidList *pLists = (SVnodeSidList *)pStr;
 
       tscTrace("%p metricmeta:vid:%d,numOfMeters:%d", pSql, i, pLists->numOfSids);
 
-      pStr += sizeof(SVnodeSidList) + sizeof(SMeterSidExtInfo *) * pSidLists->numOfSids;
-      rsp += sizeof(SVnodeSidList);
+      pStr += sizeof(SVnodeSidList) + sizeof(SMeterSidExtInfo *) * pLists->numOfSids;
 
       size_t sidSize = sizeof(SMeterSidExtInfo) + pNewMetricMeta->tagLen;
-      for (int32_t j = 0; j < pSidLists->numOfSids; ++j) {
+      for (int32_t j = 0; j < pLists->numOfSids; ++j) {
         pLists->pSidExtInfoList[j] = pStr - (char *)pLists;
         memcpy(pStr, rsp, sidSize);
 
@@ -3275,7 +3573,7 @@ int tscProcessMetricMetaRsp(SSqlObj *pSql) {
     taosRemoveDataFromCache(tscCacheHandle, (void **)&(pMeterMetaInfo->pMetricMeta), false);
 
     pMeterMetaInfo->pMetricMeta = (SMetricMeta *)taosAddDataIntoCache(tscCacheHandle, name, (char *)metricMetaList[i],
-                                                                      sizes[i], tsMetricMetaKeepTimer);
+                                                                      sizes[i], TSC_METRIC_META_RETAIN_TIME);
     tfree(metricMetaList[i]);
 
     // failed to put into cache
@@ -3373,7 +3671,16 @@ int tscProcessConnectRsp(SSqlObj *pSql) {
   rsp += sizeof(SIpList) + sizeof(int32_t) * pIpList->numOfIps;
 
   tscPrintMgmtIp();
+#else
+  char *rsp = pRes->pRsp + sizeof(SConnectRsp);
 #endif
+  // the features follow the time precision, not sent by old servers
+  rsp += sizeof(uint32_t);
+  pObj->features = 0;
+  if (rsp + sizeof(uint32_t) <= pRes->pRsp + pRes->rspLen - 1) {
+    pObj->features = ntohl(*(uint32_t *)rsp);
+  }
+
   strcpy(pObj->sversion, pConnect->version);
   pObj->writeAuth = pConnect->writeAuth;
   pObj->superAuth = pConnect->superAuth;
@@ -3599,6 +3906,73 @@ int tscGetMeterMetaEx(SSqlObj *pSql, char *meterId, bool createIfNotExists) {
   return tscGetMeterMeta(pSql, meterId, 0);
 }
 
+static SSqlObj *tscCreateMgmtSqlObj(SSqlObj *pSql, int32_t command, int32_t payloadSize) {
+  SSqlObj *pNew = calloc(1, sizeof(SSqlObj));
+  if (NULL == pNew) return NULL;
+
+  pNew->pTscObj = pSql->pTscObj;
+  pNew->signature = pNew;
+  pNew->cmd.command = command;
+
+  if (TSDB_CODE_SUCCESS != tscAllocPayload(&pNew->cmd, payloadSize)) {
+    free(pNew);
+    return NULL;
+  }
+
+  tscAddEmptyMeterMetaInfo(&pNew->cmd);
+
+  tsem_init(&pNew->rspSem, 0, 0);
+  tsem_init(&pNew->emptyRspSem, 0, 1);
+
+  return pNew;
+}
+
+/*
+ * Create numOfTables tables with one message, items holds SCreateTableItem in network byte order.
+ * On success, the meters meta are loaded into cache with one multi-meta message, so the insertion
+ * does not need to get them one by one. Only used in synchronous mode.
+ */
+int tscCreateTablesInBatch(SSqlObj *pSql, char *items, int32_t len, int32_t numOfTables) {
+  int32_t extra = minMsgSize() + sizeof(SMgmtHead) + sizeof(SMultiCreateTableMsg);
+
+  SSqlObj *pNew = tscCreateMgmtSqlObj(pSql, TSDB_SQL_MULTI_CREATE_TABLE, MAX(len + extra, TSDB_DEFAULT_PAYLOAD_SIZE));
+  if (pNew == NULL) return TSDB_CODE_CLI_OUT_OF_MEMORY;
+
+  memcpy(pNew->cmd.payload, items, len);
+  pNew->cmd.payloadLen = len;
+  pNew->cmd.count = numOfTables;
+
+  int32_t code = tscProcessSql(pNew);
+  tscTrace("%p create %d tables in batch, code:%d", pSql, numOfTables, code);
+  tscFreeSqlObj(pNew);
+
+  if (code != TSDB_CODE_SUCCESS) return code;
+
+  // meter names are separated by comma, see tscBuildMultiMeterMetaMsg
+  int32_t size = numOfTables * (TSDB_METER_ID_LEN + 1) + 1;
+  extra = minMsgSize() + sizeof(SMgmtHead) + sizeof(SMultiMeterInfoMsg);
+
+  pNew = tscCreateMgmtSqlObj(pSql, TSDB_SQL_MULTI_META, MAX(size + extra, TSDB_DEFAULT_PAYLOAD_SIZE));
+  if (pNew == NULL) return TSDB_CODE_CLI_OUT_OF_MEMORY;
+
+  char *pMsg = pNew->cmd.payload;
+  char *pItem = items;
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    SCreateTableItem *pCreate = (SCreateTableItem *)pItem;
+    pMsg += sprintf(pMsg, "%s,", pCreate->meterId);
+    pItem = pCreate->tags + htons(pCreate->tagLen);
+  }
+
+  pNew->cmd.payloadLen = (int32_t)(pMsg - pNew->cmd.payload) + 1;
+  pNew->cmd.count = numOfTables;
+
+  code = tscProcessSql(pNew);
+  tscTrace("%p load meter meta of %d tables created in batch, code:%d", pSql, numOfTables, code);
+  tscFreeSqlObj(pNew);
+
+  return code;
+}
+
 /*
  * in handling the renew metermeta problem during insertion,
  *
@@ -3678,6 +4052,10 @@ int tscGetMetricMeta(SSqlObj *pSql) {
       break;
     } else {
       pMeterMetaInfo->pMetricMeta = ppMeta;
+      if (tscIsMetricMetaExpired(ppMeta)) {
+        reqMetricMeta = true;
+        break;
+      }
     }
   }
 
@@ -3696,7 +4074,17 @@ int tscGetMetricMeta(SSqlObj *pSql) {
     SMeterMetaInfo *pMMInfo = tscGetMeterMetaInfo(&pSql->cmd, i);
 
     SMeterMeta *pMeterMeta = taosGetDataFromCache(tscCacheHandle, pMMInfo->name);
-    tscAddMeterMetaInfo(&pNew->cmd, pMMInfo->name, pMeterMeta, NULL, pMMInfo->numOfTags, pMMInfo->tagColumnIndex);
+
+    // the expired metric meta is the base to apply the changes since its version
+    SMetricMeta *pMetricMeta = NULL;
+    if (pSql->cmd.numOfTables == 1) {
+      char tagstr[TSDB_MAX_TAGS_LEN + 1] = {0};
+      tscGetMetricMetaCacheKey(pCmd, tagstr, pMMInfo->pMeterMeta->uid);
+      pMetricMeta = (SMetricMeta *)taosGetDataFromCache(tscCacheHandle, tagstr);
+    }
+
+    tscAddMeterMetaInfo(&pNew->cmd, pMMInfo->name, pMeterMeta, pMetricMeta, pMMInfo->numOfTags,
+                        pMMInfo->tagColumnIndex);
   }
 
   if ((code = tscAllocPayload(&pNew->cmd, TSDB_DEFAULT_PAYLOAD_SIZE)) != TSDB_CODE_SUCCESS) {
@@ -3763,6 +4151,7 @@ void tscInitMsgs() {
   tscBuildMsg[TSDB_SQL_ALTER_ACCT] = tscBuildAlterAcctMsg;
 
   tscBuildMsg[TSDB_SQL_CREATE_TABLE] = tscBuildCreateTableMsg;
+  tscBuildMsg[TSDB_SQL_MULTI_CREATE_TABLE] = tscBuildMultiCreateTableMsg;
   tscBuildMsg[TSDB_SQL_DROP_USER] = tscBuildDropUserMsg;
   tscBuildMsg[TSDB_SQL_DROP_ACCT] = tscBuildDropAcctMsg;
   tscBuildMsg[TSDB_SQL_DROP_DB] = tscBuildDropDbMsg;
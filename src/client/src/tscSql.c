@@ -84,6 +84,7 @@ TAOS *taos_connect_imp(const char *ip, const char *user, const char *pass, const
 
   memset(pObj, 0, sizeof(STscObj));
   pObj->signature = pObj;
+  pObj->submitCredits = -1;
 
   strncpy(pObj->user, user, TSDB_USER_LEN);
   taosEncryptPass((uint8_t *)pass, strlen(pass), pObj->pass);
@@ -868,7 +869,7 @@ void taos_stop_query(TAOS_RES *res) {
     return;
   }
 
-  if (pSql->cmd.command >= TSDB_SQL_LOCAL) {
+  if (pSql->cmd.command >= TSDB_SQL_LOCAL && !TSC_IS_MGMT_CMD(pSql->cmd.command)) {
     return;
   }
 
@@ -1720,7 +1720,7 @@ void tscDoQuery(SSqlObj* pSql) {
   SSqlCmd* pCmd = &pSql->cmd;
   void*    fp = pSql->fp;
 
-  if (pCmd->command > TSDB_SQL_LOCAL) {
+  if (pCmd->command > TSDB_SQL_LOCAL && !TSC_IS_MGMT_CMD(pCmd->command)) {
     tscProcessLocalCmd(pSql);
   } else {
     if (pCmd->command == TSDB_SQL_SELECT) {
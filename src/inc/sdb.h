@@ -112,6 +112,8 @@ void *sdbGetRow(void *handle, void *key);
 
 int64_t sdbInsertRow(void *handle, void *row, int rowSize);
 
+int sdbBatchInsertRows(void *handle, void *rows[], int numOfRows);
+
 int sdbDeleteRow(void *handle, void *key);
 
 int sdbUpdateRow(void *handle, void *row, int updateSize, char isUpdated);
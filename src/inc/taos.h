@@ -72,9 +72,21 @@ typedef struct TAOS_BIND {
   int *          error;        // unused
 } TAOS_BIND;
 
+// values of one parameter for num rows
+typedef struct TAOS_MULTI_BIND {
+  int            buffer_type;
+  void *         buffer;         // value of row i is at buffer + i * buffer_length
+  unsigned long  buffer_length;  // bytes of each value in buffer, 0 for the size of fixed length types
+  int *          length;         // actual length of each binary/nchar value
+  char *         is_null;        // null bitmap, row i is null if bit (i % 8) of is_null[i / 8] is set, may be NULL
+  int            num;            // number of rows, the same for all parameters
+} TAOS_MULTI_BIND;
+
 TAOS_STMT *taos_stmt_init(TAOS *taos);
 int        taos_stmt_prepare(TAOS_STMT *stmt, const char *sql, unsigned long length);
 int        taos_stmt_bind_param(TAOS_STMT *stmt, TAOS_BIND *bind);
+int        taos_stmt_bind_param_batch(TAOS_STMT *stmt, TAOS_MULTI_BIND *bind);
+int        taos_stmt_set_tbname(TAOS_STMT *stmt, const char *name);
 int        taos_stmt_add_batch(TAOS_STMT *stmt);
 int        taos_stmt_execute(TAOS_STMT *stmt);
 TAOS_RES * taos_stmt_use_result(TAOS_STMT *stmt);
@@ -120,6 +120,10 @@ extern "C" {
 
 #define TSDB_MSG_TYPE_MULTI_METERINFO  85
 #define TSDB_MSG_TYPE_MULTI_METERINFO_RSP 86
+#define TSDB_MSG_TYPE_MULTI_CREATE_TABLE     87
+#define TSDB_MSG_TYPE_MULTI_CREATE_TABLE_RSP 88
+#define TSDB_MSG_TYPE_MULTI_CREATE     89
+#define TSDB_MSG_TYPE_MULTI_CREATE_RSP 90
 
 #define TSDB_MSG_TYPE_HEARTBEAT        91
 #define TSDB_MSG_TYPE_HEARTBEAT_RSP    92
@@ -131,6 +135,10 @@ extern "C" {
 #define TSDB_MSG_TYPE_ALTER_ACCT       97
 #define TSDB_MSG_TYPE_ALTER_ACCT_RSP   98
 
+// metric meta in the delta format, only sent when mgmt node advertises TSDB_CONN_FEATURE_METRIC_META_DELTA
+#define TSDB_MSG_TYPE_METRIC_META_DELTA     99
+#define TSDB_MSG_TYPE_METRIC_META_DELTA_RSP 100
+
 #define TSDB_MSG_TYPE_MAX              101
 
 // IE type
@@ -271,6 +279,19 @@ typedef struct {
   char     payLoad[];
 } SShellSubmitBlock;
 
+/*
+ * flags in SShellSubmitMsg.import. If TSDB_SUBMIT_COLUMNAR is set, the payload of each block is column-major:
+ * numOfRows values of the first column, then numOfRows values of the second column, and so on.
+ */
+#define TSDB_SUBMIT_IMPORT   0x1
+#define TSDB_SUBMIT_COLUMNAR 0x2
+
+/*
+ * features of vnode, sent as an uint32_t in network order after the credits in the submit response.
+ * It is absent from old servers, then no feature is supported.
+ */
+#define TSDB_VNODE_FEATURE_COLUMNAR_SUBMIT 0x1  // the vnode accepts TSDB_SUBMIT_COLUMNAR
+
 typedef struct {
   short   import;
   short   vnode;
@@ -309,6 +330,12 @@ typedef struct {
   SMColumn schema[];
 } SCreateMsg;
 
+typedef struct {
+  short   vnode;
+  int32_t numOfMeters;
+  char    data[];  // SCreateMsg one after another
+} SMultiCreateMsg;
+
 typedef struct {
   char  db[TSDB_METER_ID_LEN];
   short ignoreNotExists;
@@ -336,6 +363,17 @@ typedef struct {
   SSchema schema[];
 } SCreateTableMsg;
 
+typedef struct {
+  char    meterId[TSDB_METER_ID_LEN];
+  int16_t tagLen;  // the leading part of STagData: super table name and tag values
+  char    tags[];
+} SCreateTableItem;
+
+typedef struct {
+  int32_t numOfTables;
+  char    data[];  // SCreateTableItem one after another
+} SMultiCreateTableMsg;
+
 typedef struct {
   char meterId[TSDB_METER_ID_LEN];
   char igNotExists;
@@ -391,6 +429,12 @@ typedef struct {
   char superAuth;
 } SConnectRsp;
 
+/*
+ * features of mgmt node, sent as an uint32_t after the time precision in the connect response.
+ * It is absent from old servers, then no feature is supported.
+ */
+#define TSDB_CONN_FEATURE_METRIC_META_DELTA 0x1
+
 typedef struct {
   short    vnode;
   int32_t  sid;
@@ -563,6 +607,7 @@ typedef struct {
 typedef struct {
   uint64_t qhandle;
   uint16_t free;
+  uint16_t window;  // pages of results the vnode may compute ahead of the next retrieve, absent from old clients
 } SRetrieveMeterMsg;
 
 typedef struct {
@@ -718,6 +763,8 @@ typedef struct {
 
   int16_t numOfGroupCols;  // num of group by columns
   int32_t groupbyTagColumnList;
+
+  int64_t version;  // version of the metric meta cached by client, only read in TSDB_MSG_TYPE_METRIC_META_DELTA
 } SMetricMetaElemMsg;
 
 typedef struct {
@@ -732,17 +779,49 @@ typedef struct {
 typedef struct {
   SVPeerDesc vpeerDesc[TSDB_VNODES_SUPPORT];
   int16_t    index;  // used locally
+  int32_t    vgId;
   int32_t    numOfSids;
   int32_t    pSidExtInfoList[];  // offset value of SMeterSidExtInfo
 } SVnodeSidList;
 
+typedef struct {
+  int32_t vgId;
+  int32_t sid;
+} SMeterSidRemoved;
+
+/*
+ * If delta is set, the vnode lists carry only the tables added or re-tagged since the version of client,
+ * and numOfRemoved SMeterSidRemoved records follow them, which should be removed from the cached one first.
+ */
 typedef struct {
   int32_t  numOfMeters;
   int32_t  numOfVnodes;
   uint16_t tagLen; /* tag value length */
-  int32_t  list[]; /* offset of SVnodeSidList, compared to the SMetricMeta struct */
+  int8_t   delta;
+  int32_t  numOfRemoved;
+  int64_t  version;   /* change version of metric, when the metric meta is built */
+  int64_t  fetchTime; /* used locally */
+  int32_t  list[];    /* offset of SVnodeSidList, compared to the SMetricMeta struct */
 } SMetricMeta;
 
+/*
+ * SMetricMeta and SVnodeSidList above are sent in TSDB_MSG_TYPE_METRIC_META_DELTA_RSP only,
+ * TSDB_MSG_TYPE_METRIC_META_RSP keeps the layout below for the peers not supporting the delta format.
+ */
+typedef struct {
+  SVPeerDesc vpeerDesc[TSDB_VNODES_SUPPORT];
+  int16_t    index;
+  int32_t    numOfSids;
+  int32_t    pSidExtInfoList[];
+} SLegacyVnodeSidList;
+
+typedef struct {
+  int32_t  numOfMeters;
+  int32_t  numOfVnodes;
+  uint16_t tagLen;
+  int32_t  list[];
+} SLegacyMetricMeta;
+
 typedef struct SMeterMeta {
   uint8_t numOfTags : 6;
   uint8_t precision : 2;
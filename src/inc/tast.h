@@ -40,6 +40,10 @@ enum {
 
 typedef bool (*__result_filter_fn_t)(const void *, void *);
 typedef void (*__do_filter_suppl_fn_t)(void *, void *);
+typedef struct tSkipList *(*__get_tag_index_fn_t)(void *, int32_t);
+struct tQueryResultset;
+typedef int32_t (*__merge_result_fn_t)(void *, struct tQueryResultset *, struct tQueryResultset *,
+                                      struct tQueryResultset *);
 
 /**
  * this structure is used to filter data in tags, so the offset of filtered tag column in tagdata string is required
@@ -57,6 +61,8 @@ typedef struct tQueryInfo {
 typedef struct SBinaryFilterSupp {
   __result_filter_fn_t   fp;
   __do_filter_suppl_fn_t setupInfoFn;
+  __get_tag_index_fn_t   getIndexFn;  // secondary index of tag columns other than the first one, optional
+  __merge_result_fn_t    mergeFn;     // union of two partial results, optional, merge by address if not set
   void *                 pExtInfo;
 } SBinaryFilterSupp;
 
@@ -72,7 +78,7 @@ typedef struct tSQLSyntaxNode {
 
 typedef struct tSQLBinaryExpr {
   uint8_t         nSQLBinaryOptr;      // filter operator
-  uint8_t         filterOnPrimaryKey;  // 0: do not contain primary filter, 1: contain
+  uint8_t         filterOnPrimaryKey;  // 0: do not contain filter on indexed tag columns, 1: contain
 
   /*
    * provide the information to support filter operation on this expression
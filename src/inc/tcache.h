@@ -86,6 +86,16 @@ void taosCleanUpDataCache(void *handle);
  */
 void taosClearDataCache(void *handle);
 
+/**
+ * get the hit and miss counters of each shard of the cache
+ * @param handle      cache object
+ * @param hitCount    hit count of each shard
+ * @param missCount   miss count of each shard
+ * @param maxShards   size of hitCount and missCount
+ * @return            number of shards returned
+ */
+int32_t taosGetDataCacheStatis(void *handle, int64_t *hitCount, int64_t *missCount, int32_t maxShards);
+
 #ifdef __cplusplus
 }
 #endif
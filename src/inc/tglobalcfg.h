@@ -73,6 +73,14 @@ extern int tsMetricMetaKeepTimer;
 
 extern float tsNumOfThreadsPerCore;
 extern float tsRatioOfQueryThreads;
+extern int   tsNumOfCommitThreads;
+extern int   tsQueryReadAheadBlocks;
+extern int   tsQueryBlockCacheSize;
+extern int   tsMaxPendingSubmits;
+extern int   tsRetrieveWindow;
+extern int   tsNumOfWriteLanes;
+extern int   tsTagIndexMinTables;
+extern int   tsMetricMetaDeltaLogSize;
 extern char  tsPublicIp[];
 extern char  tsInternalIp[];
 extern char  tsPrivateIp[];
@@ -92,8 +100,11 @@ extern float tsFileBlockMinPercent;
 extern short tsNumOfBlocksPerMeter;
 extern short tsCommitTime;  // seconds
 extern short tsCommitLog;
+extern int   tsCommitLogSyncWindow;  // milliseconds
+extern int   tsCommitLogSyncBytes;
 extern short tsAsyncLog;
 extern short tsCompression;
+extern short tsColumnCodec;
 extern short tsDaysPerFile;
 extern int   tsDaysToKeep;
 extern int   tsReplications;
@@ -252,7 +263,7 @@ extern int            tsGlobalConfigNum;
 extern char *         tsCfgStatusStr[];
 SGlobalConfig *tsGetConfigOption(const char *option);
 
-#define TSDB_CFG_MAX_NUM    110
+#define TSDB_CFG_MAX_NUM    128
 #define TSDB_CFG_PRINT_LEN  23
 #define TSDB_CFG_OPTION_LEN 24
 #define TSDB_CFG_VALUE_LEN  41
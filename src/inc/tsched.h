@@ -20,6 +20,9 @@
 extern "C" {
 #endif
 
+#define TSCHED_PRIORITY_NORMAL 0
+#define TSCHED_PRIORITY_URGENT 1
+
 typedef struct _sched_msg {
   void (*fp)(struct _sched_msg *);
 
@@ -34,6 +37,18 @@ void *taosInitScheduler(int queueSize, int numOfThreads, const char *label);
 
 int taosScheduleTask(void *qhandle, SSchedMsg *pMsg);
 
+/*
+ * urgent tasks are taken by workers before any normal task, it is used for short requests which shall not
+ * wait behind the long running tasks in the same queue
+ */
+int taosScheduleTaskWithPriority(void *qhandle, SSchedMsg *pMsg, int priority);
+
+/*
+ * enqueue the task only if the queue is not full, it returns -1 instead of blocking. A worker of the queue shall use
+ * it to schedule tasks into its own queue, since blocking there may wait for itself
+ */
+int taosTryScheduleTask(void *qhandle, SSchedMsg *pMsg);
+
 void taosCleanUpScheduler(void *param);
 
 #ifdef __cplusplus
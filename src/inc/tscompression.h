@@ -32,6 +32,30 @@ extern "C" {
 #define ONE_STAGE_COMP 1
 #define TWO_STAGE_COMP 2
 
+// Column codec, saved with each column of a file block. The legacy codec is 0, so old files are still readable
+#define TSDB_CODEC_DEFAULT 0
+#define TSDB_CODEC_BITPACK 1  // delta(-of-delta), zigzag and frame-of-reference bit-packing for integers/timestamps
+#define TSDB_CODEC_GORILLA 2  // XOR with leading/trailing-zero windows for float/double
+#define TSDB_CODEC_MAX     3
+
+#define TSDB_CODEC_SAMPLE_SIZE 256  // number of values trial-compressed to select the codec of a column block
+
+typedef int (*__compress_fn_t)(const char* const input, int inputSize, const int nelements, char* const output,
+                               int outputSize, char algorithm, char* const buffer, int bufferSize);
+typedef int (*__decompress_fn_t)(const char* const input, int compressedSize, const int nelements, char* const output,
+                                 int outputSize, char algorithm, char* const buffer, int bufferSize);
+
+typedef struct {
+  char*             name;
+  __compress_fn_t   compFunc[TSDB_DATA_TYPE_NCHAR + 1];    // NULL if the data type is not supported by the codec
+  __decompress_fn_t decompFunc[TSDB_DATA_TYPE_NCHAR + 1];
+} SCompCodec;
+
+extern SCompCodec tsCompCodecs[TSDB_CODEC_MAX];
+
+// codec and type are read from data files, NULL is returned for a corrupted pair
+__decompress_fn_t tsGetColumnDecompFunc(int codec, int type);
+
 int tsCompressTinyint(const char* const input, int inputSize, const int nelements, char* const output, int outputSize, char algorithm,
                       char* const buffer, int bufferSize);
 int tsCompressSmallint(const char* const input, int inputSize, const int nelements, char* const output, int outputSize, char algorith,
@@ -70,6 +94,19 @@ int tsDecompressDouble(const char* const input, int compressedSize, const int ne
 int tsDecompressTimestamp(const char* const input, int compressedSize, const int nelements, char* const output,
                           int outputSize, char algorithm, char* const buffer, int bufferSize);
 
+int tsCompressBitpack(const char* const input, int inputSize, const int nelements, char* const output, int outputSize,
+                      char algorithm, char* const buffer, int bufferSize, char type);
+int tsDecompressBitpack(const char* const input, int compressedSize, const int nelements, char* const output,
+                        int outputSize, char algorithm, char* const buffer, int bufferSize, char type);
+
+int tsCompressGorilla(const char* const input, int inputSize, const int nelements, char* const output, int outputSize,
+                      char algorithm, char* const buffer, int bufferSize, char type);
+int tsDecompressGorilla(const char* const input, int compressedSize, const int nelements, char* const output,
+                        int outputSize, char algorithm, char* const buffer, int bufferSize, char type);
+
+/* trial-compress the leading values with each codec supporting the data type, return the one with the smallest output */
+int tsSelectColumnCodec(const char* const input, const int nelements, int type);
+
 #ifdef __cplusplus
 }
 #endif
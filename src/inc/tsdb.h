@@ -155,6 +155,7 @@ extern "C" {
 
 #define TSDB_TBNAME_COLUMN_INDEX       (-1)
 #define TSDB_MULTI_METERMETA_MAX_NUM    100000  // maximum batch size allowed to load metermeta
+#define TSDB_MULTI_CREATE_TABLE_MAX_NUM 1000    // maximum number of tables created by one message
 
 //default value == 10
 #define TSDB_FILE_MIN_PARTITION_RANGE   1         //minimum partition range of vnode file in days
@@ -166,6 +167,10 @@ extern "C" {
 #define TSDB_MIN_COMPRESSION_LEVEL      0
 #define TSDB_MAX_COMPRESSION_LEVEL      2
 
+#define TSDB_MIN_COMMIT_LOG_LEVEL       0
+#define TSDB_MAX_COMMIT_LOG_LEVEL       2
+#define TSDB_COMMIT_LOG_SYNC            2  // group commit, each write is fsynced before response
+
 #define TSDB_MIN_COMMIT_TIME_INTERVAL   30
 #define TSDB_MAX_COMMIT_TIME_INTERVAL   40960
 
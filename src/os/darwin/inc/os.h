@@ -166,6 +166,7 @@
 
 int tsem_init(dispatch_semaphore_t *sem, int pshared, unsigned int value);
 int tsem_wait(dispatch_semaphore_t *sem);
+int tsem_trywait(dispatch_semaphore_t *sem);
 int tsem_post(dispatch_semaphore_t *sem);
 int tsem_destroy(dispatch_semaphore_t *sem);
 
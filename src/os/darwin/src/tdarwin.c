@@ -403,6 +403,13 @@ int tsem_wait(dispatch_semaphore_t *sem) {
   return 0;
 }
 
+int tsem_trywait(dispatch_semaphore_t *sem) {
+  if (dispatch_semaphore_wait(*sem, DISPATCH_TIME_NOW) == 0) return 0;
+
+  errno = EAGAIN;
+  return -1;
+}
+
 int tsem_post(dispatch_semaphore_t *sem) {
   dispatch_semaphore_signal(*sem);
   return 0;
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _rpc_msg_buf_header_
+#define _rpc_msg_buf_header_
+
+/*
+ * Size-classed buffers for the messages received by the transports. Freed
+ * buffers are kept in a small per-thread cache backed by a shared pool, so
+ * the receive path does not go to the allocator once it is warmed up.
+ * A buffer allocated here must be released by taosMsgBufFree.
+ */
+char *taosMsgBufMalloc(int size);
+void taosMsgBufFree(char *pBuf);
+
+#endif
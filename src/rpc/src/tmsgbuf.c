@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+#include "tlog.h"
+#include "tmsgbuf.h"
+#include "tutil.h"
+
+#define RPC_MSG_BUF_MIN_SHIFT 8   // the smallest class is 256 bytes
+#define RPC_MSG_BUF_CLASSES   9   // the largest class is 64KB, enough for one UDP packet
+#define RPC_MSG_BUF_CACHE     16  // max buffers of a class cached by one thread
+#define RPC_MSG_BUF_POOL      256 // max buffers of a class kept in the shared pool
+
+typedef struct _msg_buf {
+  struct _msg_buf *next;
+  int32_t          cls;   // size class, -1 if the buffer is too large to be pooled
+  int32_t          size;  // usable bytes after the head
+} SMsgBuf;
+
+typedef struct {
+  SMsgBuf *list[RPC_MSG_BUF_CLASSES];
+  int      num[RPC_MSG_BUF_CLASSES];
+} SMsgBufCache;
+
+typedef struct {
+  pthread_mutex_t mutex;
+  SMsgBuf *       list;
+  int             num;
+} SMsgBufPool;
+
+// keep the payload aligned as malloc would
+#define RPC_MSG_BUF_HEAD_SIZE ((sizeof(SMsgBuf) + 15) & ~((size_t)15))
+
+static SMsgBufPool    msgBufPool[RPC_MSG_BUF_CLASSES];
+static pthread_key_t  msgBufKey;
+static pthread_once_t msgBufOnce = PTHREAD_ONCE_INIT;
+
+static void taosReleaseMsgBufs(SMsgBuf *pList, int cls, int num) {
+  SMsgBufPool *pPool = msgBufPool + cls;
+  SMsgBuf *    pDrop = NULL;
+
+  pthread_mutex_lock(&pPool->mutex);
+  while (pList && num > 0) {
+    SMsgBuf *pBuf = pList;
+    pList = pList->next;
+    num--;
+
+    if (pPool->num < RPC_MSG_BUF_POOL) {
+      pBuf->next = pPool->list;
+      pPool->list = pBuf;
+      pPool->num++;
+    } else {
+      pBuf->next = pDrop;
+      pDrop = pBuf;
+    }
+  }
+  pthread_mutex_unlock(&pPool->mutex);
+
+  while (pDrop) {
+    SMsgBuf *pBuf = pDrop;
+    pDrop = pDrop->next;
+    free(pBuf);
+  }
+}
+
+// a thread is gone, hand its cached buffers back to the shared pool
+static void taosFreeMsgBufCache(void *param) {
+  SMsgBufCache *pCache = (SMsgBufCache *)param;
+
+  for (int i = 0; i < RPC_MSG_BUF_CLASSES; ++i) {
+    taosReleaseMsgBufs(pCache->list[i], i, pCache->num[i]);
+  }
+
+  free(pCache);
+}
+
+static void taosInitMsgBufPool() {
+  for (int i = 0; i < RPC_MSG_BUF_CLASSES; ++i) {
+    pthread_mutex_init(&msgBufPool[i].mutex, NULL);
+  }
+
+  pthread_key_create(&msgBufKey, taosFreeMsgBufCache);
+}
+
+static SMsgBufCache *taosGetMsgBufCache() {
+  pthread_once(&msgBufOnce, taosInitMsgBufPool);
+
+  SMsgBufCache *pCache = (SMsgBufCache *)pthread_getspecific(msgBufKey);
+  if (pCache == NULL) {
+    pCache = (SMsgBufCache *)calloc(1, sizeof(SMsgBufCache));
+    if (pCache != NULL) pthread_setspecific(msgBufKey, pCache);
+  }
+
+  return pCache;
+}
+
+static int taosGetMsgBufClass(int size) {
+  int cls = 0;
+  while (cls < RPC_MSG_BUF_CLASSES && (1 << (cls + RPC_MSG_BUF_MIN_SHIFT)) < size) cls++;
+
+  return (cls < RPC_MSG_BUF_CLASSES) ? cls : -1;
+}
+
+char *taosMsgBufMalloc(int size) {
+  SMsgBuf *     pBuf = NULL;
+  SMsgBufCache *pCache = NULL;
+  int           cls = taosGetMsgBufClass(size);
+
+  if (cls >= 0) {
+    pCache = taosGetMsgBufCache();
+    size = 1 << (cls + RPC_MSG_BUF_MIN_SHIFT);
+  }
+
+  if (pCache != NULL) {
+    if (pCache->list[cls] == NULL) {
+      // refill half of the thread cache from the shared pool in one go
+      SMsgBufPool *pPool = msgBufPool + cls;
+      pthread_mutex_lock(&pPool->mutex);
+      while (pPool->list && pCache->num[cls] < RPC_MSG_BUF_CACHE / 2) {
+        SMsgBuf *pNode = pPool->list;
+        pPool->list = pNode->next;
+        pPool->num--;
+
+        pNode->next = pCache->list[cls];
+        pCache->list[cls] = pNode;
+        pCache->num[cls]++;
+      }
+      pthread_mutex_unlock(&pPool->mutex);
+    }
+
+    pBuf = pCache->list[cls];
+    if (pBuf) {
+      pCache->list[cls] = pBuf->next;
+      pCache->num[cls]--;
+    }
+  }
+
+  if (pBuf == NULL) {
+    pBuf = (SMsgBuf *)malloc(RPC_MSG_BUF_HEAD_SIZE + (size_t)size);
+    if (pBuf == NULL) {
+      tError("failed to allocate msg buffer, size:%d, reason:%s", size, strerror(errno));
+      return NULL;
+    }
+
+    pBuf->cls = (pCache != NULL) ? cls : -1;
+    pBuf->size = size;
+  }
+
+  pBuf->next = NULL;
+  return (char *)pBuf + RPC_MSG_BUF_HEAD_SIZE;
+}
+
+void taosMsgBufFree(char *p) {
+  if (p == NULL) return;
+
+  SMsgBuf *pBuf = (SMsgBuf *)(p - RPC_MSG_BUF_HEAD_SIZE);
+  int      cls = pBuf->cls;
+
+  SMsgBufCache *pCache = (cls >= 0) ? taosGetMsgBufCache() : NULL;
+  if (pCache == NULL) {
+    free(pBuf);
+    return;
+  }
+
+  pBuf->next = pCache->list[cls];
+  pCache->list[cls] = pBuf;
+  pCache->num[cls]++;
+
+  if (pCache->num[cls] > RPC_MSG_BUF_CACHE) {
+    // keep half of the cache, the rest goes back to the shared pool
+    SMsgBuf *pLast = pCache->list[cls];
+    for (int i = 1; i < RPC_MSG_BUF_CACHE / 2; ++i) pLast = pLast->next;
+
+    SMsgBuf *pRest = pLast->next;
+    int      num = pCache->num[cls] - RPC_MSG_BUF_CACHE / 2;
+    pLast->next = NULL;
+    pCache->num[cls] = RPC_MSG_BUF_CACHE / 2;
+
+    taosReleaseMsgBufs(pRest, cls, num);
+  }
+}
@@ -20,6 +20,7 @@
 #include "tlog.h"
 #include "tmd5.h"
 #include "tmempool.h"
+#include "tmsgbuf.h"
 #include "trpc.h"
 #include "tsdb.h"
 #include "tsocket.h"
@@ -146,7 +147,7 @@ static int32_t taosCompressRpcMsg(char* pCont, int32_t contLen) {
     return contLen;
   }
   
-  char *buf = malloc (contLen + overhead + 8);  // 16 extra bytes
+  char *buf = taosMsgBufMalloc(contLen + overhead + 8);  // 16 extra bytes
   if (buf == NULL) {
     tError("failed to allocate memory for rpc msg compression, contLen:%d, reason:%s", contLen, strerror(errno));
     return contLen;
@@ -177,7 +178,7 @@ static int32_t taosCompressRpcMsg(char* pCont, int32_t contLen) {
     finalLen = contLen;
   }
 
-  free(buf);
+  taosMsgBufFree(buf);
   return finalLen;
 }
 
@@ -196,7 +197,7 @@ static STaosHeader* taosDecompressRpcMsg(STaosHeader* pHeader, SSchedMsg* pSched
   int contLen = htonl(GET_INT32_VAL(pHeader->content + sizeof(int32_t)));
   
   // prepare the temporary buffer to decompress message
-  char *buf = malloc(sizeof(STaosHeader) + contLen);
+  char *buf = taosMsgBufMalloc((int)sizeof(STaosHeader) + contLen);
   
   //tDump(pHeader->content, msgLen);
   
@@ -205,7 +206,7 @@ static STaosHeader* taosDecompressRpcMsg(STaosHeader* pHeader, SSchedMsg* pSched
         msgLen - overhead, contLen);
     
     memcpy(buf, pHeader, sizeof(STaosHeader));
-    free(pHeader); // free the compressed message buffer
+    taosMsgBufFree((char *)pHeader); // free the compressed message buffer
   
     STaosHeader* pNewHeader = (STaosHeader *) buf;
     pNewHeader->msgLen = originalLen + (int) sizeof(SIntMsg);
@@ -219,7 +220,7 @@ static STaosHeader* taosDecompressRpcMsg(STaosHeader* pHeader, SSchedMsg* pSched
     pSchedMsg->msg = NULL;
   }
 
-  return NULL;
+  return pHeader;
 }
 
 char *taosBuildReqHeader(void *param, char type, char *msg) {
@@ -1131,7 +1132,7 @@ void *taosProcessDataFromPeer(char *data, int dataLen, uint32_t ip, uint16_t por
       pConn->chandle = NULL;
       taosReportDisconnection(pChann, pConn);
     }
-    tfree(data);
+    taosMsgBufFree(data);
     return NULL;
   }
 
@@ -1153,7 +1154,7 @@ void *taosProcessDataFromPeer(char *data, int dataLen, uint32_t ip, uint16_t por
     tTrace("%s cid:%d sid:%d id:%s, %s wont be processed, source:0x%08x dest:0x%08x tranId:%d pConn:%p", pServer->label,
            chann, sid, pHeader->meterId, taosMsg[pHeader->msgType], pHeader->sourceId, htonl(pHeader->destId),
            pHeader->tranId, pConn);
-    free(data);
+    taosMsgBufFree(data);
     return pConn;
   }
 
@@ -1180,7 +1181,7 @@ void *taosProcessDataFromPeer(char *data, int dataLen, uint32_t ip, uint16_t por
              pHeader->meterId, taosMsg[pHeader->msgType], code, pConn);
     }
 
-    free(data);
+    taosMsgBufFree(data);
   } else {
     // parsing OK
 
@@ -1205,6 +1206,9 @@ void *taosProcessDataFromPeer(char *data, int dataLen, uint32_t ip, uint16_t por
     schedMsg.ahandle = pConn->ahandle;
     schedMsg.thandle = pConn;
     taosScheduleTask(pChann->qhandle, &schedMsg);
+
+    // nothing is handed over to the queue, the message buffer is not needed anymore
+    if (schedMsg.msg == NULL) taosMsgBufFree((char *)pHeader);
   }
 
   return pConn;
@@ -1439,7 +1443,7 @@ void taosProcessSchedMsg(SSchedMsg *pMsg) {
     if (pHeader && ((pHeader->msgType & 1) == 0)) taosProcessResponse(pConn);
   }
 
-  if (pMsg->msg) free(pMsg->msg - sizeof(STaosHeader) + sizeof(SIntMsg));
+  if (pMsg->msg) taosMsgBufFree(pMsg->msg - sizeof(STaosHeader) + sizeof(SIntMsg));
 }
 
 void taosStopRpcConn(void *thandle) {
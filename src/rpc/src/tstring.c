@@ -108,10 +108,10 @@ char *taosMsg[] = {"null",
                    "",
                    "",
                    "",
-                   "",
-                   "",
-                   "",
-                   "",
+                   "multi-create-table",  // 87
+                   "multi-create-table-rsp",
+                   "multi-create",
+                   "multi-create-rsp",
 
                    "heart-beat",           // 91
                    "heart-beat-rsp",
@@ -121,6 +121,8 @@ char *taosMsg[] = {"null",
                    "grant-rsp",
                    "alter-acct",
                    "alter-acct-rsp",
+                   "metric-meta-delta",  // 99
+                   "metric-meta-delta-rsp",
                    "invalid"};
 
 char *tsError[] = {"success",
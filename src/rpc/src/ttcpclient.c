@@ -16,6 +16,7 @@
 #include "os.h"
 #include "taosmsg.h"
 #include "tlog.h"
+#include "tmsgbuf.h"
 #include "tsocket.h"
 #include "ttcpclient.h"
 #include "tutil.h"
@@ -145,33 +146,23 @@ static void *taosReadTcpData(void *param) {
         continue;
       }
 
-      void *buffer = malloc(1024);
-      if (NULL == buffer) {
-        tTrace("%s TCP malloc(size:1024) fail\n", pTcp->label);
-        taosCleanUpTcpFdObj(pFdObj);
-        continue;
-      }
-
-      int headLen = taosReadMsg(pFdObj->fd, buffer, sizeof(STaosHeader));
+      STaosHeader head;
+      int         headLen = taosReadMsg(pFdObj->fd, &head, sizeof(STaosHeader));
       if (headLen != sizeof(STaosHeader)) {
         tError("%s read error, headLen:%d", pTcp->label, headLen);
-        tfree(buffer);
         taosCleanUpTcpFdObj(pFdObj);
         continue;
       }
 
-      int dataLen = (int32_t)htonl((uint32_t)((STaosHeader *)buffer)->msgLen);
-      if (dataLen > 1024) {
-        void *b = realloc(buffer, (size_t)dataLen);
-        if (NULL == b) {
-          tTrace("%s TCP malloc(size:%d) fail\n", pTcp->label, dataLen);
-          tfree(buffer);
-          taosCleanUpTcpFdObj(pFdObj);
-          continue;
-        }
-        buffer = b;
+      int   dataLen = (int32_t)htonl((uint32_t)head.msgLen);
+      char *buffer = (dataLen >= headLen) ? taosMsgBufMalloc(dataLen) : NULL;
+      if (NULL == buffer) {
+        tTrace("%s TCP malloc(size:%d) fail\n", pTcp->label, dataLen);
+        taosCleanUpTcpFdObj(pFdObj);
+        continue;
       }
 
+      memcpy(buffer, &head, sizeof(STaosHeader));
       int leftLen = dataLen - headLen;
       int retLen = taosReadMsg(pFdObj->fd, buffer + headLen, leftLen);
 
@@ -179,7 +170,7 @@ static void *taosReadTcpData(void *param) {
 
       if (leftLen != retLen) {
         tError("%s read error, leftLen:%d retLen:%d", pTcp->label, leftLen, retLen);
-        tfree(buffer);
+        taosMsgBufFree(buffer);
         taosCleanUpTcpFdObj(pFdObj);
         continue;
       }
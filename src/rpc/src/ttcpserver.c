@@ -17,6 +17,7 @@
 #include "taosmsg.h"
 #include "tlog.h"
 #include "tlog.h"
+#include "tmsgbuf.h"
 #include "tsocket.h"
 #include "ttcpserver.h"
 #include "tutil.h"
@@ -183,19 +184,24 @@ static void taosProcessTcpData(void *param) {
         continue;
       }
 
-      void *buffer = malloc(1024);
-      int   headLen = taosReadMsg(pFdObj->fd, buffer, sizeof(STaosHeader));
+      STaosHeader head;
+      int         headLen = taosReadMsg(pFdObj->fd, &head, sizeof(STaosHeader));
 
       if (headLen != sizeof(STaosHeader)) {
         tError("%s read error, headLen:%d, errno:%d", pThreadObj->label, headLen, errno);
         taosCleanUpFdObj(pFdObj);
-        tfree(buffer);
         continue;
       }
 
-      int dataLen = (int32_t)htonl((uint32_t)((STaosHeader *)buffer)->msgLen);
-      if (dataLen > 1024) buffer = realloc(buffer, (size_t)dataLen);
+      int   dataLen = (int32_t)htonl((uint32_t)head.msgLen);
+      char *buffer = (dataLen >= headLen) ? taosMsgBufMalloc(dataLen) : NULL;
+      if (NULL == buffer) {
+        tError("%s failed to allocate buffer for msg, dataLen:%d", pThreadObj->label, dataLen);
+        taosCleanUpFdObj(pFdObj);
+        continue;
+      }
 
+      memcpy(buffer, &head, sizeof(STaosHeader));
       int leftLen = dataLen - headLen;
       int retLen = taosReadMsg(pFdObj->fd, buffer + headLen, leftLen);
 
@@ -205,7 +211,7 @@ static void taosProcessTcpData(void *param) {
       if (leftLen != retLen) {
         tError("%s read error, leftLen:%d retLen:%d", pThreadObj->label, leftLen, retLen);
         taosCleanUpFdObj(pFdObj);
-        tfree(buffer);
+        taosMsgBufFree(buffer);
         continue;
       }
 
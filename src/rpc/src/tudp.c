@@ -18,6 +18,7 @@
 #include "thash.h"
 #include "thaship.h"
 #include "tlog.h"
+#include "tmsgbuf.h"
 #include "tsocket.h"
 #include "tsystem.h"
 #include "ttimer.h"
@@ -46,7 +47,7 @@ typedef struct {
   void *          pSet;
   void *(*processData)(char *data, int dataLen, unsigned int ip, uint16_t port, void *shandle, void *thandle,
                        void *chandle);
-  char buffer[RPC_MAX_UDP_SIZE];  // buffer to receive data
+  char *          buffer;  // pooled buffer to receive data, handed over for a large message
 } SUdpConn;
 
 typedef struct {
@@ -121,7 +122,7 @@ void taosProcessMonitorTimer(void *param, void *tmrId) {
   pMonitor->pTimer = NULL;
 
   if (pSet) {
-    char *data = malloc((size_t)pMonitor->dataLen);
+    char *data = taosMsgBufMalloc(pMonitor->dataLen);
     memcpy(data, pMonitor->data, (size_t)pMonitor->dataLen);
 
     tTrace("%s monitor timer is expired, update the link status", pSet->label);
@@ -163,7 +164,7 @@ void *taosReadTcpData(void *argv) {
     pMonitor->pSet = NULL;
   } else {
     tTrace("%s handle:0x%x is sent to server", pSet->label, pInfo->handle);
-    char *buffer = malloc((size_t)pInfo->msgLen);
+    char *buffer = taosMsgBufMalloc(pInfo->msgLen);
     if (NULL == buffer) {
       tError("%s failed to malloc(size:%d) for recv server data", pSet->label, pInfo->msgLen);
       retLen = 0;
@@ -178,7 +179,7 @@ void *taosReadTcpData(void *argv) {
 
     if (retLen != pInfo->msgLen) {
       tError("%s failed to read data from server, msgLen:%d retLen:%d", pSet->label, pInfo->msgLen, retLen);
-      tfree(buffer);
+      taosMsgBufFree(buffer);
     } else {
       (*pSet->fp)(buffer, pInfo->msgLen, pMonitor->ip, pInfo->port, pSet->shandle, NULL, pMonitor->pConn);
     }
@@ -233,7 +234,7 @@ void *taosRecvUdpData(void *param) {
 
   while (1) {
     dataLen =
-        (uint32_t)recvfrom(pConn->fd, pConn->buffer, sizeof(pConn->buffer), 0, (struct sockaddr *)&sourceAdd, &addLen);
+        (uint32_t)recvfrom(pConn->fd, pConn->buffer, RPC_MAX_UDP_SIZE, 0, (struct sockaddr *)&sourceAdd, &addLen);
     tTrace("%s msg is recv from 0x%x:%hu len:%d", pConn->label, sourceAdd.sin_addr.s_addr, ntohs(sourceAdd.sin_port),
            dataLen);
 
@@ -261,9 +262,26 @@ void *taosRecvUdpData(void *param) {
       if (pHead->tcp == 1) {
         taosReceivePacketViaTcp(sourceAdd.sin_addr.s_addr, (STaosHeader *)msg, pConn);
       } else {
-        char *data = malloc((size_t)msgLen);
-        memcpy(data, msg, (size_t)msgLen);
-        (*(pConn->processData))(data, msgLen, sourceAdd.sin_addr.s_addr, port, pConn->shandle, NULL, pConn);
+        char *data = NULL;
+        if (msgLen == (int)dataLen && msgLen > RPC_MAX_UDP_SIZE / 2) {
+          // a large packet fills the receive buffer anyway, hand it over instead of copying
+          char *buffer = taosMsgBufMalloc(RPC_MAX_UDP_SIZE);
+          if (buffer) {
+            data = pConn->buffer;
+            pConn->buffer = buffer;
+          }
+        }
+
+        if (data == NULL) {
+          data = taosMsgBufMalloc(msgLen);
+          if (data) memcpy(data, msg, (size_t)msgLen);
+        }
+
+        if (data) {
+          (*(pConn->processData))(data, msgLen, sourceAdd.sin_addr.s_addr, port, pConn->shandle, NULL, pConn);
+        } else {
+          tError("%s failed to allocate buffer for msg, msgLen:%d", pConn->label, msgLen);
+        }
       }
 
       processedLen += msgLen;
@@ -329,7 +347,7 @@ void *taosTransferDataViaTcp(void *argv) {
       taosTmrReset(taosProcessMonitorTimer, 0, pMonitor, pSet->tmrCtrl, &pMonitor->pTimer);
 
       msgLen = (int32_t)htonl((uint32_t)head.msgLen);
-      char *buffer = malloc((size_t)msgLen);
+      char *buffer = taosMsgBufMalloc(msgLen);
       if (NULL == buffer) {
         tError("%s malloc failed for msg by TransferViaTcp", pSet->label);
         taosCloseSocket(connFd);
@@ -344,6 +362,7 @@ void *taosTransferDataViaTcp(void *argv) {
       if (retLen != leftLen) {
         tError("%s failed to read data from client, leftLen:%d retLen:%d, error:%s", pSet->label, leftLen, retLen,
                strerror(errno));
+        taosMsgBufFree(buffer);
       } else {
         tTrace("%s data is received from client via TCP from 0x%x:%hu, msgLen:%d", pSet->label, pTransfer->ip,
                pTransfer->port, msgLen);
@@ -509,9 +528,18 @@ void *taosInitUdpConnection(char *ip, uint16_t port, char *label, int threads, v
 
     strcpy(pConn->label, label);
 
+    pConn->buffer = taosMsgBufMalloc(RPC_MAX_UDP_SIZE);
+    if (pConn->buffer == NULL) {
+      tError("%s failed to allocate UDP receive buffer", label);
+      taosCloseSocket(pConn->fd);
+      taosCleanUpUdpConnection(pSet);
+      return NULL;
+    }
+
     if (pthread_create(&pConn->thread, &thAttr, taosRecvUdpData, pConn) != 0) {
       tError("%s failed to create thread to process UDP data, reason:%s", label, strerror(errno));
       taosCloseSocket(pConn->fd);
+      taosMsgBufFree(pConn->buffer);
       taosCleanUpUdpConnection(pSet);
       return NULL;
     }
@@ -583,6 +611,7 @@ void taosCleanUpUdpConnection(void *handle) {
   for (int i = 0; i < pSet->threads; ++i) {
     pConn = pSet->udpConn + i;
     pthread_join(pConn->thread, NULL);
+    taosMsgBufFree(pConn->buffer);
     tTrace("chandle:%p is closed", pConn);
   }
 
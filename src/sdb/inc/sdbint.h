@@ -56,10 +56,24 @@
 #define SDB_DELIMITER 0xFFF00F00
 #define SDB_ENDCOMMIT 0xAFFFAAAF
 
+#define SDB_SEGMENT_SIZE       (16 * 1024 * 1024)  // the active log segment is sealed beyond this size
+#define SDB_COMPACT_SEGMENTS   4                   // sealed segments that trigger a background compaction
+#define SDB_COMPACT_INTERVAL   30                  // seconds, the compaction thread also wakes up periodically
+#define SDB_READ_BUFFER_SIZE   (4 * 1024 * 1024)
+#define SDB_DECODE_BATCH_ROWS  65536
+#define SDB_DECODE_BATCH_SIZE  (32 * 1024 * 1024)
+#define SDB_MAX_DECODE_THREADS 8
+
+/*
+ * <name>.db is the snapshot file, it is only rewritten by compaction. Writes are appended
+ * to the log segments <name>.db.<seq>, each with its own header.
+ */
 typedef struct {
   uint64_t swVersion;
   int16_t  sdbFileVersion;
-  char     reserved[6];
+  uint8_t  compacted;  // keys in the snapshot are unique and there is no deleted row
+  char     reserved;
+  uint32_t segment;    // snapshot: last segment merged into it; segment: its sequence
   TSCKSUM  checkSum;
 } SSdbHeader;
 
@@ -88,6 +102,8 @@ typedef struct {
   int64_t    size;
   void *     iHandle;
   int        fd;
+  uint32_t   segment;       // active log segment, appended by writers
+  uint32_t   firstSegment;  // first log segment not merged into the snapshot
   void *(*appTool)(char, void *, char *, int, int *);
   pthread_mutex_t mutex;
   SSdbUpdate *    update;
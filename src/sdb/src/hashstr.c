@@ -15,6 +15,7 @@
 
 #include "os.h"
 #include "tsdb.h"
+#include "tutil.h"
 
 #define MAX_STR_LEN 40
 
@@ -32,30 +33,11 @@ typedef struct {
   int         dataSize;
 } SHashObj;
 
+// keys like meter names share long prefixes and differ in a few digits, an additive hash of them
+// falls into a narrow range of slots
 int sdbHashString(void *handle, char *string) {
-  SHashObj *   pObj = (SHashObj *)handle;
-  unsigned int hash = 0, hashv;
-  char *       c;
-  int          len = strlen(string);
-
-  c = string;
-
-  while (len >= 4) {
-    hash += *((int *)c);
-    c += 4;
-    len -= 4;
-  }
-
-  while (len > 0) {
-    hash += *c;
-    c++;
-    len--;
-  }
-
-  hashv = hash / pObj->maxSessions;
-  hash = (hashv + hash % pObj->maxSessions) % pObj->maxSessions;
-
-  return hash;
+  SHashObj *pObj = (SHashObj *)handle;
+  return (int)(MurmurHash3_32(string, (int32_t)strlen(string)) % (uint32_t)pObj->maxSessions);
 }
 
 void *sdbAddStrHash(void *handle, void *key, void *pData) {
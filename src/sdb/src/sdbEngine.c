@@ -17,6 +17,8 @@
 
 #include "sdb.h"
 #include "sdbint.h"
+#include "tglobalcfg.h"
+#include "ttime.h"
 #include "tutil.h"
 
 #define abs(x) (((x) < 0) ? -(x) : (x))
@@ -51,6 +53,72 @@ SSdbTable *tableList[20];
 int        sdbNumOfTables;
 int64_t    sdbVersion;
 
+static pthread_t       sdbCompactThread;
+static pthread_mutex_t sdbCompactMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  sdbCompactCond = PTHREAD_COND_INITIALIZER;
+static bool            sdbCompactStarted = false;
+static bool            sdbCompactStopped = false;
+
+typedef struct {
+  int     fd;
+  char *  fn;
+  char *  buffer;
+  int32_t capacity;
+  int32_t pos;
+  int32_t len;
+  bool    eof;
+  bool    error;
+} SSdbReader;
+
+typedef struct {
+  int     fd;
+  char *  buffer;
+  int32_t capacity;
+  int32_t len;
+} SSdbWriter;
+
+typedef struct {
+  int64_t id;
+  int32_t size;
+  char *  record;  // the row in file format, head, data and checksum
+} SSdbCompactRow;
+
+typedef struct {
+  SSdbTable *pTable;
+  SRowHead **rows;
+  void **    objs;
+  int32_t    start;
+  int32_t    end;
+} SSdbDecodeSupp;
+
+static int sdbOpenSegment(SSdbTable *pTable, uint32_t seq, int64_t *pSize);
+
+static void sdbGetSegmentName(SSdbTable *pTable, uint32_t seq, char *fn) { sprintf(fn, "%s.%u", pTable->fn, seq); }
+
+static void sdbGetTmpName(SSdbTable *pTable, char *fn) {
+  char *dirc = strdup(pTable->fn);
+  char *basec = strdup(pTable->fn);
+  sprintf(fn, "%s/.%s", dirname(dirc), basename(basec));
+  tfree(dirc);
+  tfree(basec);
+}
+
+// seal the active segment and switch writers to a new one, called with the table mutex held
+static void sdbRollSegment(SSdbTable *pTable) {
+  int64_t size = 0;
+  int     fd = sdbOpenSegment(pTable, pTable->segment + 1, &size);
+  if (fd < 0) return;  // keep appending to the current segment
+
+  fdatasync(pTable->fd);
+  tclose(pTable->fd);
+  pTable->fd = fd;
+  pTable->size = size;
+  pTable->segment++;
+
+  sdbTrace("table:%s, log segment:%u is sealed, active segment:%u", pTable->name, pTable->segment - 1, pTable->segment);
+  if (pTable->segment - pTable->firstSegment >= SDB_COMPACT_SEGMENTS) pthread_cond_signal(&sdbCompactCond);
+}
+
 void sdbFinishCommit(void *handle) {
   SSdbTable *pTable = (SSdbTable *)handle;
   uint32_t   sdbEcommit = SDB_ENDCOMMIT;
@@ -59,13 +127,19 @@ void sdbFinishCommit(void *handle) {
   assert(offset == pTable->size);
   twrite(pTable->fd, &sdbEcommit, sizeof(sdbEcommit));
   pTable->size += sizeof(sdbEcommit);
+
+  if (pTable->size >= SDB_SEGMENT_SIZE) sdbRollSegment(pTable);
 }
 
-int sdbOpenSdbFile(SSdbTable *pTable) {
-  struct stat fstat, ofstat;
-  uint64_t    size;
-  char *      dirc = NULL;
-  char *      basec = NULL;
+/*
+ * Open a sdb file. A new file is initialized with pHeader, an existing one is truncated after
+ * the last end commit symbol and its header is read into pHeader. On return the fd is
+ * positioned at the first row.
+ */
+static int sdbOpenFile(SSdbTable *pTable, char *fn, SSdbHeader *pHeader) {
+  struct stat fstat;
+  uint32_t    sdbEcommit = SDB_ENDCOMMIT;
+  uint64_t    size = sizeof(SSdbHeader);
   union {
     char     cversion[64];
     uint64_t iversion;
@@ -73,82 +147,211 @@ int sdbOpenSdbFile(SSdbTable *pTable) {
 
   memcpy(swVersion.cversion, version, sizeof(uint64_t));
 
-  // check sdb.db and .sdb.db status
-  char fn[128] = "\0";
-  dirc = strdup(pTable->fn);
-  basec = strdup(pTable->fn);
-  sprintf(fn, "%s/.%s", dirname(dirc), basename(basec));
-  tfree(dirc);
-  tfree(basec);
-  if (stat(fn, &ofstat) == 0) {  // .sdb.db file exists
-    if (stat(pTable->fn, &fstat) == 0) {
-      remove(fn);
-    } else {
-      remove(pTable->fn);
-      rename(fn, pTable->fn);
-    }
-  }
-
-  pTable->fd = open(pTable->fn, O_RDWR | O_CREAT, S_IRWXU | S_IRWXG | S_IRWXO);
-  if (pTable->fd < 0) {
-    sdbError("failed to open file:%s", pTable->fn);
+  int fd = open(fn, O_RDWR | O_CREAT, S_IRWXU | S_IRWXG | S_IRWXO);
+  if (fd < 0) {
+    sdbError("failed to open file:%s", fn);
     return -1;
   }
 
-  pTable->size = 0;
-  stat(pTable->fn, &fstat);
-  size = sizeof(pTable->header);
+  stat(fn, &fstat);
 
   if (fstat.st_size == 0) {
-    pTable->header.swVersion = swVersion.iversion;
-    pTable->header.sdbFileVersion = sdbFileVersion;
-    if (taosCalcChecksumAppend(0, (uint8_t *)(&pTable->header), size) < 0) {
-      sdbError("failed to get file header checksum, file:%s", pTable->fn);
-      tclose(pTable->fd);
+    pHeader->swVersion = swVersion.iversion;
+    pHeader->sdbFileVersion = sdbFileVersion;
+    if (taosCalcChecksumAppend(0, (uint8_t *)pHeader, size) < 0) {
+      sdbError("failed to get file header checksum, file:%s", fn);
+      tclose(fd);
       return -1;
     }
-    twrite(pTable->fd, &(pTable->header), size);
-    pTable->size += size;
-    sdbFinishCommit(pTable);
+    twrite(fd, pHeader, size);
+    twrite(fd, &sdbEcommit, sizeof(sdbEcommit));
   } else {
-    uint32_t sdbEcommit = 0;
-    off_t    offset = lseek(pTable->fd, -(sizeof(sdbEcommit)), SEEK_END);
+    off_t offset = lseek(fd, -(sizeof(sdbEcommit)), SEEK_END);
     while (offset > 0) {
-      read(pTable->fd, &sdbEcommit, sizeof(sdbEcommit));
+      read(fd, &sdbEcommit, sizeof(sdbEcommit));
       if (sdbEcommit == SDB_ENDCOMMIT) {
-        ftruncate(pTable->fd, offset + sizeof(sdbEcommit));
+        ftruncate(fd, offset + sizeof(sdbEcommit));
         break;
       }
-      offset = lseek(pTable->fd, -(sizeof(sdbEcommit) + 1), SEEK_CUR);
+      offset = lseek(fd, -(sizeof(sdbEcommit) + 1), SEEK_CUR);
     }
-    lseek(pTable->fd, 0, SEEK_SET);
+    lseek(fd, 0, SEEK_SET);
 
-    ssize_t tsize = read(pTable->fd, &(pTable->header), size);
+    ssize_t tsize = read(fd, pHeader, size);
     if (tsize < size) {
-      sdbError("failed to read sdb file header, file:%s", pTable->fn);
-      tclose(pTable->fd);
+      sdbError("failed to read sdb file header, file:%s", fn);
+      tclose(fd);
       return -1;
     }
 
-    if (pTable->header.swVersion != swVersion.iversion) {
-      sdbWarn("sdb file:%s version not match software version", pTable->fn);
+    if (pHeader->swVersion != swVersion.iversion) {
+      sdbWarn("sdb file:%s version not match software version", fn);
     }
 
-    if (!taosCheckChecksumWhole((uint8_t *)(&pTable->header), size)) {
-      sdbError("sdb file header is broken since checksum mismatch, file:%s", pTable->fn);
-      tclose(pTable->fd);
+    if (!taosCheckChecksumWhole((uint8_t *)pHeader, size)) {
+      sdbError("sdb file header is broken since checksum mismatch, file:%s", fn);
+      tclose(fd);
       return -1;
     }
 
-    pTable->size += size;
     // skip end commit symbol
-    lseek(pTable->fd, sizeof(sdbEcommit), SEEK_CUR);
-    pTable->size += sizeof(sdbEcommit);
+    lseek(fd, sizeof(sdbEcommit), SEEK_CUR);
+  }
+
+  return fd;
+}
+
+// open the snapshot file, the header is kept in pTable->header
+int sdbOpenSdbFile(SSdbTable *pTable) {
+  struct stat fstat, ofstat;
+
+  // check sdb.db and .sdb.db status
+  char fn[128] = "\0";
+  sdbGetTmpName(pTable, fn);
+  if (stat(fn, &ofstat) == 0) {  // .sdb.db file exists
+    if (stat(pTable->fn, &fstat) == 0) {
+      remove(fn);
+    } else {
+      remove(pTable->fn);
+      rename(fn, pTable->fn);
+    }
+  }
+
+  // a new snapshot file holds no row, so it is compacted
+  memset(&pTable->header, 0, sizeof(SSdbHeader));
+  pTable->header.compacted = 1;
+
+  return sdbOpenFile(pTable, pTable->fn, &pTable->header);
+}
+
+static int sdbOpenSegment(SSdbTable *pTable, uint32_t seq, int64_t *pSize) {
+  char       fn[TSDB_FILENAME_LEN];
+  SSdbHeader header;
+
+  memset(&header, 0, sizeof(SSdbHeader));
+  header.segment = seq;
+  sdbGetSegmentName(pTable, seq, fn);
+
+  int fd = sdbOpenFile(pTable, fn, &header);
+  if (fd < 0) return -1;
+
+  if (header.segment != seq) {
+    sdbWarn("sdb segment:%s sequence:%u not match its header:%u", fn, seq, header.segment);
+  }
+
+  if (pSize != NULL) *pSize = lseek(fd, 0, SEEK_END);
+  return fd;
+}
+
+static int sdbInitReader(SSdbTable *pTable, SSdbReader *pReader) {
+  memset(pReader, 0, sizeof(SSdbReader));
+  pReader->fd = -1;
+  pReader->capacity = 2 * (sizeof(SRowHead) + pTable->maxRowSize + sizeof(TSCKSUM));
+  if (pReader->capacity < SDB_READ_BUFFER_SIZE) pReader->capacity = SDB_READ_BUFFER_SIZE;
+
+  pReader->buffer = (char *)malloc(pReader->capacity);
+  if (pReader->buffer == NULL) {
+    sdbError("failed to allocate read buffer, sdb:%s", pTable->name);
+    return -1;
+  }
+
+  return 0;
+}
+
+static void sdbResetReader(SSdbReader *pReader, int fd, char *fn) {
+  pReader->fd = fd;
+  pReader->fn = fn;
+  pReader->pos = 0;
+  pReader->len = 0;
+  pReader->eof = false;
+  pReader->error = false;
+}
+
+// make sure at least bytes are buffered unless the file ends, return the buffered bytes
+static int32_t sdbFillReader(SSdbReader *pReader, int32_t bytes) {
+  int32_t avail = pReader->len - pReader->pos;
+  if (avail >= bytes || pReader->eof) return avail;
+
+  memmove(pReader->buffer, pReader->buffer + pReader->pos, avail);
+  pReader->pos = 0;
+  pReader->len = avail;
+
+  while (pReader->len < pReader->capacity) {
+    ssize_t ret = read(pReader->fd, pReader->buffer + pReader->len, pReader->capacity - pReader->len);
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret <= 0) {
+      if (ret < 0) {
+        sdbError("failed to read sdb file:%s, reason:%s", pReader->fn, strerror(errno));
+        pReader->error = true;
+      }
+      pReader->eof = true;
+      break;
+    }
+    pReader->len += ret;
+  }
+
+  return pReader->len - pReader->pos;
+}
+
+// return the next valid row of the file, the row is valid until the next call
+static SRowHead *sdbReadRow(SSdbTable *pTable, SSdbReader *pReader, int32_t *pSize) {
+  while (1) {
+    int32_t avail = sdbFillReader(pReader, sizeof(SRowHead));
+    if (avail <= 0) return NULL;
+
+    SRowHead *rowHead = (SRowHead *)(pReader->buffer + pReader->pos);
+    if (avail < sizeof(SRowHead) || rowHead->delimiter != SDB_DELIMITER) {
+      pReader->pos++;
+      continue;
+    }
+
+    if (rowHead->rowSize < 0 || rowHead->rowSize > pTable->maxRowSize) {
+      sdbError("error row size in sdb file:%s, id:%ld rowSize:%d maxRowSize:%d", pReader->fn, rowHead->id,
+               rowHead->rowSize, pTable->maxRowSize);
+      pReader->pos += sizeof(SRowHead);
+      continue;
+    }
+
+    int32_t size = sizeof(SRowHead) + rowHead->rowSize + sizeof(TSCKSUM);
+    if (sdbFillReader(pReader, size) < size) {
+      rowHead = (SRowHead *)(pReader->buffer + pReader->pos);
+      sdbError("failed to read sdb file:%s id:%ld rowSize:%d", pReader->fn, rowHead->id, rowHead->rowSize);
+      pReader->pos = pReader->len;
+      return NULL;
+    }
+
+    rowHead = (SRowHead *)(pReader->buffer + pReader->pos);
+    pReader->pos += size;
+    if (!taosCheckChecksumWhole((uint8_t *)rowHead, size)) {
+      sdbError("error sdb checksum, sdb:%s  id:%ld, skip", pTable->name, rowHead->id);
+      continue;
+    }
+
+    *pSize = size;
+    return rowHead;
+  }
+}
+
+static int sdbWriteRecord(SSdbWriter *pWriter, void *record, int32_t size) {
+  uint32_t sdbEcommit = SDB_ENDCOMMIT;
+
+  if (pWriter->len + size + sizeof(sdbEcommit) > pWriter->capacity) {
+    if (twrite(pWriter->fd, pWriter->buffer, pWriter->len) != pWriter->len) return -1;
+    pWriter->len = 0;
   }
 
-  pTable->numOfRows = 0;
+  memcpy(pWriter->buffer + pWriter->len, record, size);
+  pWriter->len += size;
+  memcpy(pWriter->buffer + pWriter->len, &sdbEcommit, sizeof(sdbEcommit));
+  pWriter->len += sizeof(sdbEcommit);
+
+  return 0;
+}
 
-  return pTable->fd;
+static int sdbFlushWriter(SSdbWriter *pWriter) {
+  if (pWriter->len > 0 && twrite(pWriter->fd, pWriter->buffer, pWriter->len) != pWriter->len) return -1;
+  pWriter->len = 0;
+  return 0;
 }
 
 // TODO: Change here
@@ -163,128 +366,475 @@ void sdbAddIntoUpdateList(SSdbTable *pTable, char type, char *row) {
   pTable->update[pTable->updatePos].row = row;
 }
 
-int sdbInitTableByFile(SSdbTable *pTable) {
+/*
+ * Apply a row read from file. At startup existing objects are reset, while a live table
+ * (resynced from a peer) is notified with insert and update actions.
+ */
+static void sdbApplyRow(SSdbTable *pTable, SRowHead *rowHead, bool live, int *numOfDels, int *maxAutoIndex) {
   SRowMeta rowMeta;
-  int      numOfDels = 0;
-  int      bytes = 0;
-  int64_t  oldId = 0;
-  void *   pMetaRow = NULL;
-  int      total_size = 0;
-  int      real_size = 0;
-  int      maxAutoIndex = 0;
+  void *   pMetaRow = sdbGetRow(pTable, rowHead->data);
+
+  if (pMetaRow == NULL) {  // New object
+    if (rowHead->id < 0) {
+      sdbError("error sdb negative id:%ld, sdb:%s, skip", rowHead->id, pTable->name);
+    } else {
+      rowMeta.id = rowHead->id;
+      // TODO: Get rid of the rowMeta.offset and rowSize
+      rowMeta.offset = 0;
+      rowMeta.rowSize = rowHead->rowSize;
+      rowMeta.row = (*(pTable->appTool))(SDB_TYPE_DECODE, NULL, rowHead->data, rowHead->rowSize, NULL);
+      (*sdbAddIndexFp[pTable->keyType])(pTable->iHandle, rowMeta.row, &rowMeta);
+      pTable->numOfRows++;
+
+      if (live) (*pTable->appTool)(SDB_TYPE_INSERT, rowMeta.row, NULL, 0, NULL);
+    }
+  } else {                  // already exists
+    if (rowHead->id < 0) {  // Delete the object
+      (*sdbDeleteIndexFp[pTable->keyType])(pTable->iHandle, rowHead->data);
+      (*(pTable->appTool))(SDB_TYPE_DESTROY, pMetaRow, NULL, 0, NULL);
+      pTable->numOfRows--;
+      (*numOfDels)++;
+    } else if (live) {
+      (*(pTable->appTool))(SDB_TYPE_UPDATE, pMetaRow, rowHead->data, rowHead->rowSize, NULL);
+    } else {  // Reset the object TODO: is it possible to merge reset and update ??
+      (*(pTable->appTool))(SDB_TYPE_RESET, pMetaRow, rowHead->data, rowHead->rowSize, NULL);
+    }
+    (*numOfDels)++;
+  }
+
+  if (!live && pTable->keyType == SDB_KEYTYPE_AUTO) {
+    *maxAutoIndex = MAX(*maxAutoIndex, *(int32_t *)rowHead->data);
+  }
+}
 
-  oldId = pTable->id;
-  if (sdbOpenSdbFile(pTable) < 0) return -1;
+// replay a file row by row, rows with id not larger than skipId are applied already
+static int sdbReplayFile(SSdbTable *pTable, int fd, char *fn, bool live, int64_t skipId, int *numOfDels,
+                         int *maxAutoIndex) {
+  SSdbReader reader;
+  SRowHead * pRow = NULL;
+  int32_t    size = 0;
 
-  total_size = sizeof(SRowHead) + pTable->maxRowSize + sizeof(TSCKSUM);
-  SRowHead *rowHead = (SRowHead *)malloc(total_size);
+  if (sdbInitReader(pTable, &reader) < 0) return -1;
+  sdbResetReader(&reader, fd, fn);
+
+  SRowHead *rowHead = (SRowHead *)malloc(sizeof(SRowHead) + pTable->maxRowSize + sizeof(TSCKSUM));
   if (rowHead == NULL) {
     sdbError("failed to allocate row head memory, sdb:%s", pTable->name);
+    tfree(reader.buffer);
     return -1;
   }
 
-  sdbTrace("open sdb file:%s for read", pTable->fn);
+  while ((pRow = sdbReadRow(pTable, &reader, &size)) != NULL) {
+    memcpy(rowHead, pRow, size);  // keep the row aligned
+    if (abs(rowHead->id) > skipId) sdbApplyRow(pTable, rowHead, live, numOfDels, maxAutoIndex);
+    if (pTable->id < abs(rowHead->id)) pTable->id = abs(rowHead->id);
+  }
 
-  // Loop to read sdb file row by row
-  while (1) {
-    memset(rowHead, 0, total_size);
+  tfree(rowHead);
+  tfree(reader.buffer);
 
-    bytes = read(pTable->fd, rowHead, sizeof(SRowHead));
-    if (bytes < 0) {
-      sdbError("failed to read sdb file:%s", pTable->fn);
-      goto sdb_exit1;
-    }
+  return reader.error ? -1 : 0;
+}
 
-    if (bytes == 0) break;
+static void *sdbDecodeRows(void *param) {
+  SSdbDecodeSupp *pSupp = (SSdbDecodeSupp *)param;
+  SSdbTable *     pTable = pSupp->pTable;
 
-    if (bytes < sizeof(SRowHead) || rowHead->delimiter != SDB_DELIMITER) {
-      pTable->size++;
-      lseek(pTable->fd, -(bytes - 1), SEEK_CUR);
-      continue;
-    }
+  for (int32_t i = pSupp->start; i < pSupp->end; ++i) {
+    SRowHead *rowHead = pSupp->rows[i];
+    pSupp->objs[i] = (*(pTable->appTool))(SDB_TYPE_DECODE, NULL, rowHead->data, rowHead->rowSize, NULL);
+  }
 
-    if (rowHead->rowSize < 0 || rowHead->rowSize > pTable->maxRowSize) {
-      sdbError("error row size in sdb file:%s, id:%d rowSize:%d maxRowSize:%d",
-              pTable->fn, rowHead->id, rowHead->rowSize, pTable->maxRowSize);
-      pTable->size += sizeof(SRowHead);
+  return NULL;
+}
+
+// decode a batch of snapshot rows in parallel, then index them in file order
+static void sdbLoadRows(SSdbTable *pTable, SRowHead **rows, void **objs, int32_t numOfRows, int *maxAutoIndex) {
+  SSdbDecodeSupp supp[SDB_MAX_DECODE_THREADS];
+  pthread_t      threads[SDB_MAX_DECODE_THREADS];
+  bool           launched[SDB_MAX_DECODE_THREADS] = {0};
+  SRowMeta       rowMeta;
+
+  int32_t numOfThreads = MIN(tsNumOfCores, SDB_MAX_DECODE_THREADS);
+  if (numOfThreads < 1 || numOfRows < 1024) numOfThreads = 1;
+
+  int32_t step = (numOfRows + numOfThreads - 1) / numOfThreads;
+  for (int32_t t = 0; t < numOfThreads; ++t) {
+    supp[t].pTable = pTable;
+    supp[t].rows = rows;
+    supp[t].objs = objs;
+    supp[t].start = MIN(t * step, numOfRows);
+    supp[t].end = MIN((t + 1) * step, numOfRows);
+  }
+
+  for (int32_t t = 1; t < numOfThreads; ++t) {
+    launched[t] = (pthread_create(&threads[t], NULL, sdbDecodeRows, &supp[t]) == 0);
+    if (!launched[t]) sdbDecodeRows(&supp[t]);
+  }
+
+  sdbDecodeRows(&supp[0]);
+
+  for (int32_t t = 1; t < numOfThreads; ++t) {
+    if (launched[t]) pthread_join(threads[t], NULL);
+  }
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    SRowHead *rowHead = rows[i];
+    if (objs[i] == NULL) {
+      sdbError("failed to decode row, sdb:%s id:%ld, skip", pTable->name, rowHead->id);
       continue;
     }
 
-    // sdbTrace("%s id:%ld rowSize:%d", pTable->name, rowHead->id,
-    // rowHead->rowSize);
+    void *pMetaRow = sdbGetRow(pTable, rowHead->data);
+    if (pMetaRow != NULL) {  // not expected in a compacted snapshot
+      (*(pTable->appTool))(SDB_TYPE_RESET, pMetaRow, rowHead->data, rowHead->rowSize, NULL);
+      (*(pTable->appTool))(SDB_TYPE_DESTROY, objs[i], NULL, 0, NULL);
+    } else {
+      rowMeta.id = rowHead->id;
+      rowMeta.offset = 0;
+      rowMeta.rowSize = rowHead->rowSize;
+      rowMeta.row = objs[i];
+      (*sdbAddIndexFp[pTable->keyType])(pTable->iHandle, rowMeta.row, &rowMeta);
+      pTable->numOfRows++;
+    }
 
-    bytes = read(pTable->fd, rowHead->data, rowHead->rowSize + sizeof(TSCKSUM));
-    if (bytes < rowHead->rowSize + sizeof(TSCKSUM)) {
-      // TODO: Here may cause pTable->size not end of the file
-      sdbError("failed to read sdb file:%s id:%d rowSize:%d", pTable->fn, rowHead->id, rowHead->rowSize);
-      break;
+    if (pTable->keyType == SDB_KEYTYPE_AUTO) {
+      *maxAutoIndex = MAX(*maxAutoIndex, *(int32_t *)rowHead->data);
     }
+    if (pTable->id < rowHead->id) pTable->id = rowHead->id;
+  }
+}
 
-    real_size = sizeof(SRowHead) + rowHead->rowSize + sizeof(TSCKSUM);
-    if (!taosCheckChecksumWhole((uint8_t *)rowHead, real_size)) {
-      sdbError("error sdb checksum, sdb:%s  id:%d, skip", pTable->name, rowHead->id);
-      pTable->size += real_size;
-      continue;
+// load a compacted snapshot, keys are unique so rows are decoded in parallel batches
+static int sdbLoadSnapshot(SSdbTable *pTable, int fd, int *maxAutoIndex) {
+  SSdbReader reader;
+  SRowHead * pRow = NULL;
+  int32_t    size = 0;
+  int32_t    numOfRows = 0;
+  int32_t    used = 0;
+  int        code = -1;
+
+  if (sdbInitReader(pTable, &reader) < 0) return -1;
+  sdbResetReader(&reader, fd, pTable->fn);
+
+  char *     arena = (char *)malloc(SDB_DECODE_BATCH_SIZE);
+  SRowHead **rows = (SRowHead **)malloc(sizeof(SRowHead *) * SDB_DECODE_BATCH_ROWS);
+  void **    objs = (void **)malloc(sizeof(void *) * SDB_DECODE_BATCH_ROWS);
+  if (arena == NULL || rows == NULL || objs == NULL) {
+    sdbError("failed to allocate decode buffer, sdb:%s", pTable->name);
+    goto _over;
+  }
+
+  while (1) {
+    pRow = sdbReadRow(pTable, &reader, &size);
+
+    int32_t aligned = (size + 7) & ~7;
+    if (numOfRows > 0 && (pRow == NULL || numOfRows >= SDB_DECODE_BATCH_ROWS || used + aligned > SDB_DECODE_BATCH_SIZE)) {
+      sdbLoadRows(pTable, rows, objs, numOfRows, maxAutoIndex);
+      numOfRows = 0;
+      used = 0;
     }
 
-    // Check if the the object exists already
+    if (pRow == NULL) break;
 
-    pMetaRow = sdbGetRow(pTable, rowHead->data);
-    if (pMetaRow == NULL) {  // New object
-      if (rowHead->id < 0) {
-        /* assert(0); */
-        sdbError("error sdb negative id:%d, sdb:%s, skip", rowHead->id, pTable->name);
-      } else {
-        rowMeta.id = rowHead->id;
-        // TODO: Get rid of the rowMeta.offset and rowSize
-        rowMeta.offset = pTable->size;
-        rowMeta.rowSize = rowHead->rowSize;
-        rowMeta.row = (*(pTable->appTool))(SDB_TYPE_DECODE, NULL, rowHead->data, rowHead->rowSize, NULL);
-        (*sdbAddIndexFp[pTable->keyType])(pTable->iHandle, rowMeta.row, &rowMeta);
-        if (pTable->keyType == SDB_KEYTYPE_AUTO) {
-          pTable->autoIndex++;
-          maxAutoIndex = MAX(maxAutoIndex, *(int32_t*)rowHead->data);
-        }
-        pTable->numOfRows++;
-      }
-    } else {                  // already exists
-      if (pTable->keyType == SDB_KEYTYPE_AUTO) {
-        pTable->autoIndex++;
-        maxAutoIndex = MAX(maxAutoIndex, *(int32_t *) rowHead->data);
-      }
+    rows[numOfRows] = (SRowHead *)(arena + used);
+    memcpy(rows[numOfRows], pRow, size);
+    numOfRows++;
+    used += aligned;
+  }
 
-      if (rowHead->id < 0) {  // Delete the object
-        (*sdbDeleteIndexFp[pTable->keyType])(pTable->iHandle, rowHead->data);
-        (*(pTable->appTool))(SDB_TYPE_DESTROY, pMetaRow, NULL, 0, NULL);
-        pTable->numOfRows--;
-        numOfDels++;
-      } else {  // Reset the object TODO: is it possible to merge reset and
-                // update ??
-        (*(pTable->appTool))(SDB_TYPE_RESET, pMetaRow, rowHead->data, rowHead->rowSize, NULL);
-      }
-      numOfDels++;
+  code = reader.error ? -1 : 0;
+
+_over:
+  tfree(objs);
+  tfree(rows);
+  tfree(arena);
+  tfree(reader.buffer);
+  return code;
+}
+
+/*
+ * Load the snapshot and replay the log segments after it, the last segment is kept open for
+ * writers.
+ */
+static int sdbLoadFiles(SSdbTable *pTable, bool live, int64_t skipId, int *numOfDels, int *maxAutoIndex) {
+  char fn[TSDB_FILENAME_LEN];
+  int  code = 0;
+
+  int fd = sdbOpenSdbFile(pTable);
+  if (fd < 0) return -1;
+
+  sdbTrace("open sdb file:%s for read, compacted:%d segment:%u", pTable->fn, pTable->header.compacted,
+           pTable->header.segment);
+
+  if (pTable->header.compacted && !live) {
+    code = sdbLoadSnapshot(pTable, fd, maxAutoIndex);
+  } else {
+    code = sdbReplayFile(pTable, fd, pTable->fn, live, skipId, numOfDels, maxAutoIndex);
+  }
+  tclose(fd);
+  if (code < 0) return -1;
+
+  // segments merged into the snapshot are left behind if a compaction is interrupted
+  for (uint32_t seq = pTable->header.segment; seq > 0; --seq) {
+    sdbGetSegmentName(pTable, seq, fn);
+    if (remove(fn) != 0) break;
+  }
+
+  pTable->firstSegment = pTable->header.segment + 1;
+  pTable->segment = pTable->firstSegment;
+
+  // segments are replayed in order since a row may update or delete rows of earlier segments
+  while (1) {
+    sdbGetSegmentName(pTable, pTable->segment, fn);
+    bool exist = (access(fn, F_OK) == 0);
+
+    fd = sdbOpenSegment(pTable, pTable->segment, NULL);
+    if (fd < 0) return -1;
+
+    if (exist && sdbReplayFile(pTable, fd, fn, live, skipId, numOfDels, maxAutoIndex) < 0) {
+      tclose(fd);
+      return -1;
     }
 
-    pTable->size += real_size;
-    if (pTable->id < abs(rowHead->id)) pTable->id = abs(rowHead->id);
+    sdbGetSegmentName(pTable, pTable->segment + 1, fn);
+    if (exist && access(fn, F_OK) == 0) {
+      tclose(fd);
+      pTable->segment++;
+      continue;
+    }
+
+    pTable->fd = fd;
+    pTable->size = lseek(fd, 0, SEEK_END);
+    break;
   }
 
+  return 0;
+}
+
+int sdbInitTableByFile(SSdbTable *pTable) {
+  int     numOfDels = 0;
+  int     maxAutoIndex = 0;
+  int64_t oldId = pTable->id;
+  int64_t st = taosGetTimestampMs();
+
+  if (sdbLoadFiles(pTable, false, oldId, &numOfDels, &maxAutoIndex) < 0) return -1;
+
   if (pTable->keyType == SDB_KEYTYPE_AUTO) {
     pTable->autoIndex = maxAutoIndex;
   }
 
   sdbVersion += (pTable->id - oldId);
-  if (numOfDels > pTable->maxRows / 4) sdbSaveSnapShot(pTable);
+
+  // a file of the old format is converted once, later compactions run in background
+  if (!pTable->header.compacted) sdbSaveSnapShot(pTable);
 
   pTable->numOfUpdates = 0;
   pTable->updatePos = 0;
 
-  tfree(rowHead);
+  sdbTrace("table:%s is loaded, numOfRows:%ld segments:%u-%u numOfDels:%d, %ld ms", pTable->name, pTable->numOfRows,
+           pTable->firstSegment, pTable->segment, numOfDels, taosGetTimestampMs() - st);
   return 0;
+}
 
-sdb_exit1:
-  tfree(rowHead);
-  return -1;
+static void sdbFreeCompactRows(SSdbTable *pTable, void *handle) {
+  SSdbCompactRow *pRow = NULL;
+  void *          pNode = NULL;
+
+  while (1) {
+    pNode = (*sdbFetchRowFp[pTable->keyType])(handle, pNode, (void **)&pRow);
+    if (pRow == NULL) break;
+    tfree(pRow->record);
+  }
+
+  (*sdbCleanUpIndexFp[pTable->keyType])(handle);
+}
+
+/*
+ * Merge the sealed segments up to lastSegment into the snapshot. Writers keep appending to the
+ * active segment meanwhile, only the switch of firstSegment takes the table mutex.
+ */
+static int sdbCompactTable(SSdbTable *pTable, uint32_t lastSegment) {
+  char           fn[TSDB_FILENAME_LEN];
+  char           tfn[TSDB_FILENAME_LEN];
+  SSdbReader     reader;
+  SSdbWriter     writer = {.fd = -1};
+  SSdbHeader     header;
+  SSdbCompactRow crow;
+  SSdbCompactRow *pRow = NULL;
+  SRowHead *     rowHead = NULL;
+  void *         pNode = NULL;
+  uint32_t       intKey = 0;
+  int32_t        size = 0;
+  int32_t        numOfMerged = 0;
+  int32_t        numOfRows = 0;
+  int            fd = -1;
+  int            code = -1;
+  uint32_t       firstSegment = pTable->firstSegment;
+  int64_t        st = taosGetTimestampMs();
+
+  void *handle = (*sdbInitIndexFp[pTable->keyType])(pTable->maxRows, sizeof(SSdbCompactRow));
+  if (handle == NULL) return -1;
+
+  sdbGetTmpName(pTable, tfn);
+  if (sdbInitReader(pTable, &reader) < 0) goto _over;
+
+  // the latest row of each key in the sealed segments, a deleted key is kept as a tombstone
+  for (uint32_t seq = firstSegment; seq <= lastSegment; ++seq) {
+    sdbGetSegmentName(pTable, seq, fn);
+    fd = open(fn, O_RDONLY);
+    if (fd < 0) {
+      sdbError("failed to open sdb segment:%s for compaction", fn);
+      goto _over;
+    }
+    lseek(fd, sizeof(SSdbHeader) + sizeof(uint32_t), SEEK_SET);
+    sdbResetReader(&reader, fd, fn);
+
+    while ((rowHead = sdbReadRow(pTable, &reader, &size)) != NULL) {
+      void *key = rowHead->data;
+      if (pTable->keyType != SDB_KEYTYPE_STRING) {
+        memcpy(&intKey, rowHead->data, sizeof(intKey));
+        key = &intKey;
+      }
+
+      pRow = (*sdbGetIndexFp[pTable->keyType])(handle, key);
+      if (pRow == NULL) {
+        // the int hash is backed by a pool of maxRows nodes
+        if (pTable->keyType != SDB_KEYTYPE_STRING && numOfMerged >= pTable->maxRows) {
+          sdbError("table:%s, too many keys in segments for compaction", pTable->name);
+          goto _over;
+        }
+        memset(&crow, 0, sizeof(crow));
+        pRow = (*sdbAddIndexFp[pTable->keyType])(handle, key, &crow);
+        if (pRow == NULL) goto _over;
+        numOfMerged++;
+      }
+
+      char *record = realloc(pRow->record, size);
+      if (record == NULL) goto _over;
+      memcpy(record, rowHead, size);
+      pRow->record = record;
+      pRow->size = size;
+      pRow->id = rowHead->id;
+    }
+
+    tclose(fd);
+    if (reader.error) goto _over;
+  }
+
+  writer.capacity = reader.capacity;
+  writer.buffer = (char *)malloc(writer.capacity);
+  if (writer.buffer == NULL) goto _over;
+
+  writer.fd = open(tfn, O_WRONLY | O_CREAT | O_TRUNC, S_IRWXU | S_IRWXG | S_IRWXO);
+  if (writer.fd < 0) {
+    sdbError("failed to open file:%s for compaction", tfn);
+    goto _over;
+  }
+
+  header = pTable->header;
+  header.compacted = 1;
+  header.segment = lastSegment;
+  taosCalcChecksumAppend(0, (uint8_t *)&header, sizeof(SSdbHeader));
+  if (sdbWriteRecord(&writer, &header, sizeof(SSdbHeader)) < 0) goto _over;
+
+  // rows of the snapshot are copied unless updated or deleted in the segments
+  fd = open(pTable->fn, O_RDONLY);
+  if (fd < 0) {
+    sdbError("failed to open sdb file:%s for compaction", pTable->fn);
+    goto _over;
+  }
+  lseek(fd, sizeof(SSdbHeader) + sizeof(uint32_t), SEEK_SET);
+  sdbResetReader(&reader, fd, pTable->fn);
+
+  while ((rowHead = sdbReadRow(pTable, &reader, &size)) != NULL) {
+    void *key = rowHead->data;
+    if (pTable->keyType != SDB_KEYTYPE_STRING) {
+      memcpy(&intKey, rowHead->data, sizeof(intKey));
+      key = &intKey;
+    }
+
+    if ((*sdbGetIndexFp[pTable->keyType])(handle, key) != NULL) continue;
+    if (sdbWriteRecord(&writer, rowHead, size) < 0) goto _over;
+    numOfRows++;
+  }
+
+  tclose(fd);
+  if (reader.error) goto _over;
+
+  while (1) {
+    pNode = (*sdbFetchRowFp[pTable->keyType])(handle, pNode, (void **)&pRow);
+    if (pRow == NULL) break;
+    if (pRow->id < 0) continue;
+    if (sdbWriteRecord(&writer, pRow->record, pRow->size) < 0) goto _over;
+    numOfRows++;
+  }
+
+  if (sdbFlushWriter(&writer) < 0) {
+    sdbError("failed to write file:%s for compaction", tfn);
+    goto _over;
+  }
+
+  fdatasync(writer.fd);
+  tclose(writer.fd);
+
+  if (rename(tfn, pTable->fn) != 0) {
+    sdbError("failed to rename %s to %s, reason:%s", tfn, pTable->fn, strerror(errno));
+    goto _over;
+  }
+
+  pthread_mutex_lock(&pTable->mutex);
+  pTable->header = header;
+  pTable->firstSegment = lastSegment + 1;
+  pthread_mutex_unlock(&pTable->mutex);
+
+  for (uint32_t seq = firstSegment; seq <= lastSegment; ++seq) {
+    sdbGetSegmentName(pTable, seq, fn);
+    remove(fn);
+  }
+
+  sdbTrace("table:%s, segments:%u-%u are compacted, numOfRows:%d, %ld ms", pTable->name, firstSegment, lastSegment,
+           numOfRows, taosGetTimestampMs() - st);
+  code = 0;
+
+_over:
+  if (fd >= 0) tclose(fd);
+  if (writer.fd >= 0) {
+    tclose(writer.fd);
+    remove(tfn);
+  }
+  tfree(writer.buffer);
+  tfree(reader.buffer);
+  sdbFreeCompactRows(pTable, handle);
+
+  if (code < 0) sdbError("table:%s, failed to compact segments:%u-%u", pTable->name, firstSegment, lastSegment);
+  return code;
+}
+
+static void *sdbCompactMain(void *param) {
+  pthread_mutex_lock(&sdbCompactMutex);
+
+  while (!sdbCompactStopped) {
+    for (int i = 0; i < tListLen(tableList); ++i) {
+      SSdbTable *pTable = tableList[i];
+      if (pTable == NULL || !pTable->header.compacted) continue;
+
+      pthread_mutex_lock(&pTable->mutex);
+      uint32_t numOfSealed = pTable->segment - pTable->firstSegment;
+      uint32_t lastSegment = pTable->segment - 1;
+      pthread_mutex_unlock(&pTable->mutex);
+
+      if (numOfSealed >= SDB_COMPACT_SEGMENTS) sdbCompactTable(pTable, lastSegment);
+    }
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += SDB_COMPACT_INTERVAL;
+    pthread_cond_timedwait(&sdbCompactCond, &sdbCompactMutex, &ts);
+  }
+
+  pthread_mutex_unlock(&sdbCompactMutex);
+  return NULL;
 }
 
 void *sdbOpenTable(int maxRows, int32_t maxRowSize, char *name, uint8_t keyType, char *directory,
@@ -314,8 +864,18 @@ void *sdbOpenTable(int maxRows, int32_t maxRowSize, char *name, uint8_t keyType,
 
   if (sdbInitTableByFile(pTable) < 0) return NULL;
 
+  pthread_mutex_lock(&sdbCompactMutex);
   pTable->dbId = sdbNumOfTables++;
   tableList[pTable->dbId] = pTable;
+  if (!sdbCompactStarted) {
+    sdbCompactStopped = false;
+    if (pthread_create(&sdbCompactThread, NULL, sdbCompactMain, NULL) == 0) {
+      sdbCompactStarted = true;
+    } else {
+      sdbError("failed to create sdb compaction thread, reason:%s", strerror(errno));
+    }
+  }
+  pthread_mutex_unlock(&sdbCompactMutex);
 
   sdbTrace("table:%s is initialized, numOfRows:%d, numOfTables:%d", pTable->name, pTable->numOfRows, sdbNumOfTables);
 
@@ -484,6 +1044,118 @@ int64_t sdbInsertRow(void *handle, void *row, int rowSize) {
   return id;
 }
 
+/*
+ * Insert a group of objects with one write and one commit symbol, so the group is replayed
+ * all or nothing. Objects whose key already exists are skipped and their entries in rows are
+ * set to NULL. Returns the number of inserted objects, or -1 on error.
+ */
+int sdbBatchInsertRows(void *handle, void *rows[], int numOfRows) {
+  SSdbTable *pTable = (SSdbTable *)handle;
+  SRowMeta   rowMeta;
+  SRowHead * rowHead;
+  char *     buffer = NULL;
+  int64_t    bufSize = 0, bufLen = 0;
+  int        real_size = 0, numOfInserted = 0;
+
+  if (pTable == NULL) {
+    sdbError("sdb tables is null");
+    return -1;
+  }
+
+  rowHead = (SRowHead *)malloc(sizeof(SRowHead) + pTable->maxRowSize + sizeof(TSCKSUM));
+  if (rowHead == NULL) {
+    sdbError("failed to allocate row head memory, sdb: %s", pTable->name);
+    return -1;
+  }
+
+  pthread_mutex_lock(&pTable->mutex);
+
+  for (int i = 0; i < numOfRows; ++i) {
+    void *pObj = rows[i];
+
+    if ((pTable->keyType != SDB_KEYTYPE_AUTO || *((int64_t *)pObj)) &&
+        (*sdbGetIndexFp[pTable->keyType])(pTable->iHandle, pObj) != NULL) {
+      sdbError("table:%s, failed to insert record in batch, already exist, sdbVersion:%ld id:%ld", pTable->name,
+               sdbVersion, pTable->id);
+      rows[i] = NULL;
+      continue;
+    }
+
+    memset(rowHead, 0, sizeof(SRowHead));
+    (*(pTable->appTool))(SDB_TYPE_ENCODE, pObj, rowHead->data, pTable->maxRowSize, &(rowHead->rowSize));
+    assert(rowHead->rowSize > 0 && rowHead->rowSize <= pTable->maxRowSize);
+
+    if (sdbForwardDbReqToPeer(pTable, SDB_TYPE_INSERT, rowHead->data, rowHead->rowSize) != 0) {
+      sdbError("table:%s, failed to forward record in batch", pTable->name);
+      rows[i] = NULL;
+      continue;
+    }
+
+    pTable->id++;
+    sdbVersion++;
+    if (pTable->keyType == SDB_KEYTYPE_AUTO) {
+      *((uint32_t *)pObj) = ++pTable->autoIndex;
+      (*(pTable->appTool))(SDB_TYPE_ENCODE, pObj, rowHead->data, pTable->maxRowSize, &(rowHead->rowSize));
+    }
+
+    real_size = sizeof(SRowHead) + rowHead->rowSize + sizeof(TSCKSUM);
+    rowHead->delimiter = SDB_DELIMITER;
+    rowHead->id = pTable->id;
+    taosCalcChecksumAppend(0, (uint8_t *)rowHead, real_size);
+
+    if (bufLen + real_size > bufSize) {
+      int64_t newSize = (bufSize == 0) ? (int64_t)real_size * numOfRows : bufSize * 2;
+      if (newSize < bufLen + real_size) newSize = bufLen + real_size;
+      char *tmp = realloc(buffer, newSize);
+      if (tmp == NULL) {
+        // the rows encoded so far are still written, the rest are reported as not inserted
+        sdbError("table:%s, failed to allocate batch buffer, %d rows are not inserted", pTable->name, numOfRows - i);
+        pTable->id--;
+        sdbVersion--;
+        for (int j = i; j < numOfRows; ++j) rows[j] = NULL;
+        break;
+      }
+      buffer = tmp;
+      bufSize = newSize;
+    }
+    memcpy(buffer + bufLen, rowHead, real_size);
+
+    rowMeta.id = pTable->id;
+    rowMeta.offset = pTable->size + bufLen;
+    rowMeta.rowSize = rowHead->rowSize;
+    rowMeta.row = pObj;
+    (*sdbAddIndexFp[pTable->keyType])(pTable->iHandle, pObj, &rowMeta);
+    sdbAddIntoUpdateList(pTable, SDB_TYPE_INSERT, pObj);
+
+    bufLen += real_size;
+    pTable->numOfRows++;
+    numOfInserted++;
+  }
+
+  if (bufLen > 0) {
+    twrite(pTable->fd, buffer, bufLen);
+    pTable->size += bufLen;
+    sdbFinishCommit(pTable);
+  }
+
+  sdbTrace("table:%s, %d of %d records are inserted in batch, sdbVersion:%ld id:%ld numOfRows:%d fileSize:%ld",
+           pTable->name, numOfInserted, numOfRows, sdbVersion, pTable->id, pTable->numOfRows, pTable->size);
+
+  pthread_mutex_unlock(&pTable->mutex);
+
+  tfree(buffer);
+  tfree(rowHead);
+
+  /* callback function to update the MGMT layer */
+  if (pTable->appTool) {
+    for (int i = 0; i < numOfRows; ++i) {
+      if (rows[i] != NULL) (*pTable->appTool)(SDB_TYPE_INSERT, rows[i], NULL, 0, NULL);
+    }
+  }
+
+  return numOfInserted;
+}
+
 // row here can be object or null-terminated string
 int sdbDeleteRow(void *handle, void *row) {
   SSdbTable *pTable = (SSdbTable *)handle;
@@ -788,13 +1460,25 @@ void sdbCloseTable(void *handle) {
     (*(pTable->appTool))(SDB_TYPE_DESTROY, row, NULL, 0, NULL);
   }
 
+  // wait for the running compaction
+  pthread_mutex_lock(&sdbCompactMutex);
+  if (tableList[pTable->dbId] == pTable) tableList[pTable->dbId] = NULL;
+  sdbNumOfTables--;
+  bool stopCompact = (sdbNumOfTables <= 0 && sdbCompactStarted);
+  if (stopCompact) {
+    sdbCompactStopped = true;
+    sdbCompactStarted = false;
+    pthread_cond_signal(&sdbCompactCond);
+  }
+  pthread_mutex_unlock(&sdbCompactMutex);
+  if (stopCompact) pthread_join(sdbCompactThread, NULL);
+
   if (sdbCleanUpIndexFp[pTable->keyType]) (*sdbCleanUpIndexFp[pTable->keyType])(pTable->iHandle);
 
-  if (pTable->fd) tclose(pTable->fd);
+  if (pTable->fd > 0) tclose(pTable->fd);
 
   pthread_mutex_destroy(&pTable->mutex);
 
-  sdbNumOfTables--;
   sdbTrace("table:%s is closed, id:%ld numOfTables:%d", pTable->name, pTable->id, sdbNumOfTables);
 
   tfree(pTable->update);
@@ -802,144 +1486,76 @@ void sdbCloseTable(void *handle) {
 }
 
 void sdbResetTable(SSdbTable *pTable) {
-  /* SRowHead rowHead; */
-  SRowMeta  rowMeta;
-  int       bytes;
-  int       total_size = 0;
-  int       real_size = 0;
-  int64_t   oldId;
-  SRowHead *rowHead = NULL;
-  void *    pMetaRow = NULL;
-
-  oldId = pTable->id;
-  if (sdbOpenSdbFile(pTable) < 0) return;
-
-  total_size = sizeof(SRowHead) + pTable->maxRowSize + sizeof(TSCKSUM);
-  rowHead = (SRowHead *)malloc(total_size);
-  if (rowHead == NULL) {
-    return;
-  }
-
-  sdbTrace("open sdb file:%s for update", pTable->fn);
-
-  while (1) {
-    memset(rowHead, 0, total_size);
-
-    bytes = read(pTable->fd, rowHead, sizeof(SRowHead));
-    if (bytes < 0) {
-      sdbError("failed to read sdb file:%s", pTable->fn);
-      tfree(rowHead);
-      return;
-    }
-
-    if (bytes == 0) break;
-
-    if (bytes < sizeof(SRowHead) || rowHead->delimiter != SDB_DELIMITER) {
-      pTable->size++;
-      lseek(pTable->fd, -(bytes - 1), SEEK_CUR);
-      continue;
-    }
+  int     numOfDels = 0;
+  int     maxAutoIndex = 0;
+  int64_t oldId = pTable->id;
 
-    if (rowHead->rowSize < 0 || rowHead->rowSize > pTable->maxRowSize) {
-      sdbError("error row size in sdb file:%s  rowSize:%d  maxRowSize:%d", pTable->fn, rowHead->rowSize,
-               pTable->maxRowSize);
-      pTable->size += sizeof(SRowHead);
-      continue;
-    }
+  // no compaction while the files are reloaded
+  pthread_mutex_lock(&sdbCompactMutex);
 
-    bytes = read(pTable->fd, rowHead->data, rowHead->rowSize + sizeof(TSCKSUM));
-    if (bytes < rowHead->rowSize + sizeof(TSCKSUM)) {
-      sdbError("failed to read sdb file:%s  id:%d  rowSize:%d", pTable->fn, rowHead->id, rowHead->rowSize);
-      break;
-    }
+  if (pTable->fd > 0) tclose(pTable->fd);
+  pTable->fd = -1;
 
-    real_size = sizeof(SRowHead) + rowHead->rowSize + sizeof(TSCKSUM);
-    if (!taosCheckChecksumWhole((uint8_t *)rowHead, real_size)) {
-      sdbError("error sdb checksum, sdb:%s  id:%d, skip", pTable->name, rowHead->id);
-      pTable->size += real_size;
-      continue;
-    }
-
-    if (abs(rowHead->id) > oldId) {  // not operated
-      pMetaRow = sdbGetRow(pTable, rowHead->data);
-      if (pMetaRow == NULL) {  // New object
-        if (rowHead->id < 0) {
-          sdbError("error sdb negative id:%d, sdb:%s, skip", rowHead->id, pTable->name);
-        } else {
-          rowMeta.id = rowHead->id;
-          // TODO:Get rid of the rowMeta.offset and rowSize
-          rowMeta.offset = pTable->size;
-          rowMeta.rowSize = rowHead->rowSize;
-          rowMeta.row = (*(pTable->appTool))(SDB_TYPE_DECODE, NULL, rowHead->data, rowHead->rowSize, NULL);
-          (*sdbAddIndexFp[pTable->keyType])(pTable->iHandle, rowMeta.row, &rowMeta);
-          pTable->numOfRows++;
-
-          (*pTable->appTool)(SDB_TYPE_INSERT, rowMeta.row, NULL, 0, NULL);
-        }
-      } else {                  // already exists
-        if (rowHead->id < 0) {  // Delete the object
-          (*sdbDeleteIndexFp[pTable->keyType])(pTable->iHandle, rowHead->data);
-          (*(pTable->appTool))(SDB_TYPE_DESTROY, pMetaRow, NULL, 0, NULL);
-          pTable->numOfRows--;
-        } else {  // update the object
-          (*(pTable->appTool))(SDB_TYPE_UPDATE, pMetaRow, rowHead->data, rowHead->rowSize, NULL);
-        }
-      }
-    }
-
-    pTable->size += real_size;
-    if (pTable->id < abs(rowHead->id)) pTable->id = abs(rowHead->id);
+  if (sdbLoadFiles(pTable, true, oldId, &numOfDels, &maxAutoIndex) < 0) {
+    pthread_mutex_unlock(&sdbCompactMutex);
+    return;
   }
 
+  pthread_mutex_unlock(&sdbCompactMutex);
+
   sdbVersion += (pTable->id - oldId);
   pTable->numOfUpdates = 0;
   pTable->updatePos = 0;
 
-  tfree(rowHead);
-
   sdbTrace("table:%s is updated, sdbVerion:%ld id:%ld", pTable->name, sdbVersion, pTable->id);
 }
 
+/*
+ * Write the snapshot from memory, it replaces all the log segments including the active one.
+ * It is used at startup when no writer is active, later snapshots are made by compaction.
+ */
 // TODO:A problem here :use snapshot file to sync another node will cause
 // problem
 void sdbSaveSnapShot(void *handle) {
-  SSdbTable *pTable = (SSdbTable *)handle;
-  SRowMeta * pMeta;
-  void *     pNode = NULL;
-  int        total_size = 0;
-  int        real_size = 0;
-  int        size = 0;
-  int        numOfRows = 0;
-  uint32_t   sdbEcommit = SDB_ENDCOMMIT;
-  char *     dirc = NULL;
-  char *     basec = NULL;
-  /* char       action = SDB_TYPE_INSERT; */
+  SSdbTable * pTable = (SSdbTable *)handle;
+  SRowMeta *  pMeta;
+  SSdbHeader  header;
+  SSdbWriter  writer;
+  void *      pNode = NULL;
+  int         real_size = 0;
+  int         numOfRows = 0;
+  int64_t     size = 0;
+  char        fn[128] = "\0";
+  char        sfn[TSDB_FILENAME_LEN];
 
   if (pTable == NULL) return;
 
   sdbTrace("Table:%s, save the snapshop", pTable->name);
 
-  char fn[128] = "\0";
-  dirc = strdup(pTable->fn);
-  basec = strdup(pTable->fn);
-  sprintf(fn, "%s/.%s", dirname(dirc), basename(basec));
-  int fd = open(fn, O_RDWR | O_CREAT, S_IRWXU | S_IRWXG | S_IRWXO);
-  tfree(dirc);
-  tfree(basec);
-
-  total_size = sizeof(SRowHead) + pTable->maxRowSize + sizeof(TSCKSUM);
-  SRowHead *rowHead = (SRowHead *)malloc(total_size);
-  if (rowHead == NULL) {
+  SRowHead *rowHead = (SRowHead *)malloc(sizeof(SRowHead) + pTable->maxRowSize + sizeof(TSCKSUM));
+  memset(&writer, 0, sizeof(writer));
+  writer.capacity = SDB_READ_BUFFER_SIZE + 2 * (sizeof(SRowHead) + pTable->maxRowSize + sizeof(TSCKSUM));
+  writer.buffer = (char *)malloc(writer.capacity);
+  if (rowHead == NULL || writer.buffer == NULL) {
     sdbError("failed to allocate memory while saving SDB snapshot, sdb:%s", pTable->name);
+    tfree(rowHead);
+    tfree(writer.buffer);
     return;
   }
-  memset(rowHead, 0, size);
 
-  // Write the header
-  twrite(fd, &(pTable->header), sizeof(SSdbHeader));
-  size += sizeof(SSdbHeader);
-  twrite(fd, &sdbEcommit, sizeof(sdbEcommit));
-  size += sizeof(sdbEcommit);
+  sdbGetTmpName(pTable, fn);
+  writer.fd = open(fn, O_WRONLY | O_CREAT | O_TRUNC, S_IRWXU | S_IRWXG | S_IRWXO);
+  if (writer.fd < 0) {
+    sdbError("failed to open file:%s to save snapshot", fn);
+    goto _over;
+  }
+
+  // Write the header, the snapshot covers the segments up to the active one
+  header = pTable->header;
+  header.compacted = 1;
+  header.segment = pTable->segment;
+  taosCalcChecksumAppend(0, (uint8_t *)&header, sizeof(SSdbHeader));
+  sdbWriteRecord(&writer, &header, sizeof(SSdbHeader));
 
   while (1) {
     pNode = (*sdbFetchRowFp[pTable->keyType])(pTable->iHandle, pNode, (void **)&pMeta);
@@ -951,31 +1567,54 @@ void sdbSaveSnapShot(void *handle) {
     real_size = sizeof(SRowHead) + rowHead->rowSize + sizeof(TSCKSUM);
     if (taosCalcChecksumAppend(0, (uint8_t *)rowHead, real_size) < 0) {
       sdbError("failed to get checksum while save sdb %s snapshot", pTable->name);
-      tfree(rowHead);
-      return;
+      goto _over;
     }
 
-    /* write(fd, &action, sizeof(action)); */
-    /* size += sizeof(action); */
-    twrite(fd, rowHead, real_size);
-    size += real_size;
-    twrite(fd, &sdbEcommit, sizeof(sdbEcommit));
-    size += sizeof(sdbEcommit);
+    if (sdbWriteRecord(&writer, rowHead, real_size) < 0) goto _over;
     numOfRows++;
   }
 
-  tfree(rowHead);
+  if (sdbFlushWriter(&writer) < 0) {
+    sdbError("failed to write sdb %s snapshot", pTable->name);
+    goto _over;
+  }
+  fdatasync(writer.fd);
+  tclose(writer.fd);
+  writer.fd = -1;
+
+  // switch writers to a new segment before the old ones are dropped
+  int fd = sdbOpenSegment(pTable, pTable->segment + 1, &size);
+  if (fd < 0) goto _over;
 
-  // Remove the old file
-  tclose(pTable->fd);
-  remove(pTable->fn);
   // Rename the .sdb.db file to sdb.db file
-  rename(fn, pTable->fn);
+  if (rename(fn, pTable->fn) != 0) {
+    sdbError("failed to rename %s to %s, reason:%s", fn, pTable->fn, strerror(errno));
+    tclose(fd);
+    sdbGetSegmentName(pTable, pTable->segment + 1, sfn);
+    remove(sfn);
+    goto _over;
+  }
+
+  if (pTable->fd > 0) tclose(pTable->fd);
+  for (uint32_t seq = pTable->firstSegment; seq <= pTable->segment; ++seq) {
+    sdbGetSegmentName(pTable, seq, sfn);
+    remove(sfn);
+  }
+
+  pTable->header = header;
+  pTable->segment++;
+  pTable->firstSegment = pTable->segment;
   pTable->fd = fd;
   pTable->size = size;
   pTable->numOfRows = numOfRows;
 
-  fdatasync(pTable->fd);
+_over:
+  if (writer.fd >= 0) {
+    tclose(writer.fd);
+    remove(fn);
+  }
+  tfree(writer.buffer);
+  tfree(rowHead);
 }
 
 void *sdbFetchRow(void *handle, void *pNode, void **ppRow) {
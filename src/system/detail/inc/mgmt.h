@@ -81,6 +81,10 @@ typedef struct {
   char       reserved[16];
   char       updateEnd[1];
   void *     thandle;
+  int64_t    blockCacheHits;    // from dnode status, query block cache statistics
+  int64_t    blockCacheMisses;
+  int32_t    pendingSubmits;    // submits parked in vnodes
+  int64_t    submitWaitTime;    // ms, average wait time of parked submits
 } SDnodeObj;
 
 typedef struct {
@@ -94,6 +98,24 @@ typedef struct {
   int32_t vgId;  // vnode group ID
 } SMeterGid;
 
+/*
+ * sub-tables of a metric added, removed or re-tagged after a version, used to answer the metric meta
+ * request of client with the changes since its cached version only
+ */
+typedef struct {
+  int64_t version;
+  int32_t vgId;
+  int32_t sid;
+} SMetricChange;
+
+typedef struct {
+  int64_t       baseVersion;  // all changes after this version are kept
+  int32_t       capacity;
+  int32_t       start;
+  int32_t       size;
+  SMetricChange changes[];
+} SMetricChangeLog;
+
 typedef struct _tab_obj {
   char      meterId[TSDB_METER_ID_LEN + 1];
   uint64_t  uid;
@@ -108,12 +130,19 @@ typedef struct _tab_obj {
   short   nextColId;
   char    meterType : 4;
   char    status : 3;
-  char    isDirty : 1;  // if the table change tag column 1 value
+  char    isDirty : 1;  // if the table change tag value, the indexes of metric need to be updated
   char    reserved[15];
   char    updateEnd[1];
 
   pthread_rwlock_t rwLock;
   tSkipList *      pSkipList;
+  tSkipList **     pTagIndex;  // for metric, secondary indexes on the other tag columns, built on demand
+  struct _tab_obj **pOrdMeters;  // for metric, meters by dense ordinal, used as the universe of tag filter bitmaps
+  int32_t           numOfOrdMeters;
+  int32_t           ordCapacity;
+  int32_t           ordinal;     // for meter, position in pOrdMeters of its metric
+  int64_t           metaVersion;  // for metric, bumped on every change of sub-table list or tag values
+  SMetricChangeLog *pChangeLog;   // for metric, created at the first metric meta request
   struct _tab_obj *pHead;  // for metric, a link list for all meters created
                            // according to this metric
   char *pTagData;          // TSDB_METER_ID_LEN(metric_name)+
@@ -261,6 +290,7 @@ extern SDnodeObj dnodeObj;
 int  mgmtInitDnodeInt();
 void mgmtCleanUpDnodeInt();
 int mgmtSendCreateMsgToVgroup(STabObj *pMeter, SVgObj *pVgroup);
+int mgmtSendMultiCreateMsgToVgroup(STabObj *pMeters[], int numOfMeters, SVgObj *pVgroup);
 int mgmtSendRemoveMeterMsgToDnode(STabObj *pMeter, SVgObj *pVgroup);
 int mgmtSendVPeersMsg(SVgObj *pVgroup);
 int mgmtSendFreeVnodeMsg(SVgObj *pVgroup);
@@ -303,6 +333,10 @@ void mgmtCleanUpUsers();
 // metric API
 int mgmtAddMeterIntoMetric(STabObj *pMetric, STabObj *pMeter);
 int mgmtRemoveMeterFromMetric(STabObj *pMetric, STabObj *pMeter);
+int mgmtBuildMetricTagIndex(STabObj *pMetric, int32_t col);
+void mgmtAddMetricChange(STabObj *pMetric, STabObj *pMeter);
+void mgmtResetMetricChangeLog(STabObj *pMetric);
+void mgmtDestroyMetricTagIndex(STabObj *pMetric);
 int mgmtGetMetricMeta(SMeterMeta *pMeta, SShowObj *pShow, SConnObj *pConn);
 int mgmtRetrieveMetrics(SShowObj *pShow, char *data, int rows, SConnObj *pConn);
 
@@ -343,8 +377,9 @@ void mgmtCleanUpVgroups();
 int      mgmtInitMeters();
 STabObj *mgmtGetMeter(char *meterId);
 STabObj *mgmtGetMeterInfo(char *src, char *tags[]);
-int mgmtRetrieveMetricMeta(void *thandle, char **pStart, SMetricMetaMsg *pInfo);
+int mgmtRetrieveMetricMeta(void *thandle, char **pStart, SMetricMetaMsg *pInfo, bool delta);
 int mgmtCreateMeter(SDbObj *pDb, SCreateTableMsg *pCreate);
+int mgmtCreateMeters(SDbObj *pDb, SMultiCreateTableMsg *pMulti);
 int mgmtDropMeter(SDbObj *pDb, char *meterId, int ignore);
 int mgmtAlterMeter(SDbObj *pDb, SAlterTableMsg *pAlter);
 int mgmtGetMeterMeta(SMeterMeta *pMeta, SShowObj *pShow, SConnObj *pConn);
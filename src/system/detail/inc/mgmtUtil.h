@@ -24,6 +24,7 @@ typedef struct SSyntaxTreeFilterSupporter {
   SSchema* pTagSchema;
   int32_t  numOfTags;
   int32_t  optr;
+  STabObj* pMetric;
 } SSyntaxTreeFilterSupporter;
 
 char*   mgmtMeterGetTag(STabObj* pMeter, int32_t col, SSchema* pTagColSchema);
@@ -47,7 +47,10 @@ extern "C" {
 #define TSDB_ACTION_IMPORT 1
 #define TSDB_ACTION_DELETE 2
 #define TSDB_ACTION_UPDATE 3
-#define TSDB_ACTION_MAX    4
+#define TSDB_ACTION_INSERT_COLUMNAR 4  // insert of a column-major block, see TSDB_SUBMIT_COLUMNAR
+#define TSDB_ACTION_MAX    5
+
+#define TSDB_MAX_WRITE_LANES 64
 
 enum _data_source {
   TSDB_DATA_SOURCE_METER,
@@ -143,6 +146,7 @@ typedef struct {
   char            logOFn[TSDB_FILENAME_LEN];
   int64_t         mappingSize;
   int64_t         mappingThreshold;
+  void *          pLogSync;  // group commit writer, only valid when commitLog is TSDB_COMMIT_LOG_SYNC
 
   void *         commitTimer;
   void **        meterList;
@@ -327,9 +331,13 @@ extern uint32_t   tsRebootTime;
 extern void **    rpcQhandle;
 extern void *     dmQhandle;
 extern void *     queryQhandle;
+extern int        tsNumOfQueryThreads;
+extern void *     commitQhandle;
 extern int        tsVnodePeers;
 extern int        tsMaxVnode;
 extern int        tsMaxQueues;
+extern void **    writeQhandle;
+extern int        tsMaxWriteQueues;
 extern int        tsOpenVnodes;
 extern SVnodeObj *vnodeList;
 extern void *     vnodeTmrCtrl;
@@ -363,7 +371,7 @@ int vnodeRetrieveQueryResult(void *handle, int *pNum, char *argv[]);
 
 int vnodeSaveQueryResult(void *handle, char *data, int32_t* size);
 
-int vnodeRetrieveQueryInfo(void *handle, int *numOfRows, int *rowSize, int16_t *timePrec);
+int vnodeRetrieveQueryInfo(void *handle, int32_t window, int *numOfRows, int *rowSize, int16_t *timePrec);
 
 void vnodeFreeQInfo(void *, bool);
 
@@ -382,10 +390,18 @@ void vnodeCloseMetersVnode(int vnode);
 
 int vnodeCreateMeterObj(SMeterObj *pNew, SConnSec *pSec);
 
+int vnodeCreateMeterObjNoSave(SMeterObj *pNew, SConnSec *pSec);
+
 int vnodeRemoveMeterObj(int vnode, int sid);
 
 int vnodeInsertPoints(SMeterObj *pObj, char *cont, int contLen, char source, void *, int sversion, int *numOfPoints, TSKEY now);
 
+int vnodeInsertColumnarPoints(SMeterObj *pObj, char *cont, int contLen, char source, void *, int sversion,
+                              int *numOfPoints, TSKEY now);
+
+// convert a column-major block from shell into a new row-major one
+SShellSubmitBlock *vnodeConvertColumnarBlock(SMeterObj *pObj, SShellSubmitBlock *pBlock);
+
 int vnodeImportPoints(SMeterObj *pObj, char *cont, int contLen, char source, void *, int sversion, int *numOfPoints, TSKEY now);
 
 int vnodeInsertBufferedPoints(int vnode);
@@ -394,6 +410,8 @@ int vnodeSaveAllMeterObjToFile(int vnode);
 
 int vnodeSaveMeterObjToFile(SMeterObj *pObj);
 
+int vnodeSaveMeterObjsToFile(int vnode, SMeterObj *pObjs[], int numOfMeters);
+
 int vnodeSaveVnodeCfg(int vnode, SVnodeCfg *pCfg, SVPeerDesc *pDesc);
 
 int vnodeSaveVnodeInfo(int vnode);
@@ -411,6 +429,8 @@ void vnodeSetCommitQuery(SMeterObj *pObj, SQuery *pQuery);
 
 int vnodeInsertPointToCache(SMeterObj *pObj, char *pData);
 
+int vnodeInsertColumnsToCache(SMeterObj *pObj, char *payload, int numOfRows, int start, int rows);
+
 int vnodeQueryFromCache(SMeterObj *pObj, SQuery *pQuery);
 
 uint64_t vnodeGetPoolCount(SVnodeObj *pVnode);
@@ -439,6 +459,8 @@ int vnodeAllocateCacheBlock(SMeterObj *pObj);
 
 int vnodeFreeCacheBlock(SCacheBlock *pCacheBlock);
 
+void vnodeGetCacheInfoSnapshot(SCacheInfo *pInfo, int32_t *currentSlot, int32_t *numOfBlocks);
+
 int vnodeIsCacheCommitted(SMeterObj *pObj);
 
 // file API
@@ -523,6 +545,10 @@ int vnodeOpenShellVnode(int vnode);
 
 void vnodeCloseShellVnode(int vnode);
 
+void vnodeResumePendingSubmits(int vnode);
+
+void vnodeGetPendingSubmitStatis(int32_t *numOfSubmits, int64_t *avgWaitTime);
+
 // memter mgmt
 int  vnodeInitMeterMgmt();
 
@@ -576,13 +602,11 @@ void vnodeRemoveCommitLog(int vnode);
 
 int vnodeWriteToCommitLog(SMeterObj *pObj, char action, char *cont, int contLen, int sversion);
 
-extern int (*vnodeProcessAction[])(SMeterObj *, char *, int, char, void *, int, int *, TSKEY);
+uint64_t vnodeGetCommitLogLsn(SVnodeObj *pVnode);
 
-extern int (*pCompFunc[])(const char *const input, int inputSize, const int elements, char *const output,
-                          int outputSize, char algorithm, char *const buffer, int bufferSize);
+int vnodeWaitForCommitLog(SVnodeObj *pVnode, uint64_t startLsn);
 
-extern int (*pDecompFunc[])(const char *const input, int compressedSize, const int elements, char *const output,
-                            int outputSize, char algorithm, char *const buffer, int bufferSize);
+extern int (*vnodeProcessAction[])(SMeterObj *, char *, int, char, void *, int, int *, TSKEY);
 
 // global variable and APIs provided by mgmt
 extern char          mgmtStatus;
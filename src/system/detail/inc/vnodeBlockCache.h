@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_VNODEBLOCKCACHE_H
+#define TDENGINE_VNODEBLOCKCACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * dnode wide cache of the decompressed column data of file blocks, shared by all queries.
+ * The cached column is identified by the file it is read from and its offset in that file.
+ */
+typedef struct {
+  int32_t vnode;
+  int32_t fileId;
+  int64_t fileIno;  // inode of the data/last file, a rewritten last file gets a new one
+  int64_t offset;   // offset of the column data in file
+  int16_t colId;
+} SBlockCacheKey;
+
+int32_t vnodeInitBlockCache();
+
+void vnodeCleanUpBlockCache();
+
+/*
+ * copy the column data into dst if it is cached, the entry is referenced during the copy so that it can not be
+ * evicted or freed by other threads
+ */
+bool vnodeGetColumnFromBlockCache(SBlockCacheKey *pKey, char *dst, int32_t size);
+
+void vnodePutColumnIntoBlockCache(SBlockCacheKey *pKey, const char *data, int32_t size);
+
+/* drop all cached columns of the file, or of all files of the vnode if fileId < 0 */
+void vnodeInvalidateBlockCache(int32_t vnode, int32_t fileId);
+
+void vnodeGetBlockCacheStatis(int64_t *hits, int64_t *misses, int64_t *usedBytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_VNODEBLOCKCACHE_H
@@ -39,12 +39,15 @@ typedef struct {
   int32_t       commitSlot;   // which slot is committed
   int32_t       commitPoint;  // starting point for next commit
   SCacheBlock **cacheBlocks;  // cache block list, circular list
+  uint32_t      version;      // odd while currentSlot/numOfBlocks are being changed, readers retry on mismatch
 } SCacheInfo;
 
 typedef struct {
   int             vnode;
   char **         pMem;
   int64_t         freeSlot;
+  int64_t         freeHead;  // lock-free stack of free blocks, low 32 bits: index + 1, high 32 bits: ABA tag
+  int32_t *       freeNext;  // next free block index for each block in the stack
   pthread_mutex_t vmutex;
   uint64_t        count;  // kind of transcation ID
   int64_t         notFreeSlots;
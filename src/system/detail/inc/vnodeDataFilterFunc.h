@@ -28,6 +28,16 @@ __filter_func_t *vnodeGetValueFilterFuncArray(int32_t type);
 
 bool vnodeSupportPrefilter(int32_t type);
 
+/* check if all values between minval and maxval satisfy the filter, the statistics are saved in SField */
+bool vnodeFilterAllQualified(SColumnFilterElem *pFilter, int32_t type, int64_t *minval, int64_t *maxval);
+
+/*
+ * evaluate the filters of all filter columns over the rows [start, start + numOfRows) of current block, res[i] is set
+ * to 1 if row start + i is qualified, otherwise 0. buf is the working space of numOfRows bytes.
+ * return the number of qualified rows.
+ */
+int32_t vnodeFilterDataBlock(SQuery *pQuery, int32_t start, int32_t numOfRows, uint8_t *res, uint8_t *buf);
+
 #ifdef __cplusplus
 }
 #endif
@@ -38,7 +38,9 @@ typedef struct {
   int64_t min;
   int16_t maxIndex;
   int16_t minIndex;
-  char    reserved[20];
+  char    reserved1[6];  // old versions spilled the float/double min/max index into it, do not reuse
+  uint8_t codec;         // column codec, TSDB_CODEC_DEFAULT for files written by old versions
+  char    reserved[13];
 } SField;
 
 typedef struct {
@@ -29,6 +29,7 @@ typedef struct {
 } SMgmtObj;
 
 int vnodeProcessCreateMeterRequest(char *pMsg, int msgLen, SMgmtObj *pMgmtObj);
+int vnodeProcessMultiCreateMeterRequest(char *pMsg, int msgLen, SMgmtObj *pMgmtObj);
 int vnodeProcessRemoveMeterRequest(char *pMsg, int msgLen, SMgmtObj *pMgmtObj);
 
 #ifdef __cplusplus
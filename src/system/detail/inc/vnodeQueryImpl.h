@@ -119,6 +119,7 @@ typedef enum {
 typedef int (*__block_search_fn_t)(char* data, int num, int64_t key, int order);
 typedef int32_t (*__read_data_fn_t)(int fd, SQInfo* pQInfo, SQueryFilesInfo* pQueryFile, char* buf, uint64_t offset,
                                     int32_t size);
+typedef SCompBlock* (*__get_comp_block_fn_t)(void* pBlockList, int32_t index);
 
 static FORCE_INLINE SMeterObj* getMeterObj(void* hashHandle, int32_t sid) {
   return *(SMeterObj**)taosGetIntHashData(hashHandle, sid);
@@ -146,6 +147,10 @@ void forwardCtxOutputBuf(SQueryRuntimeEnv* pRuntimeEnv, int64_t output);
 bool needPrimaryTimestampCol(SQuery* pQuery, SBlockInfo* pBlockInfo);
 void vnodeScanAllData(SQueryRuntimeEnv* pRuntimeEnv);
 
+void vnodeResetReadAhead(SQueryRuntimeEnv* pRuntimeEnv);
+void vnodeReadAheadDataBlocks(SQueryRuntimeEnv* pRuntimeEnv, void* pBlockList, int32_t numOfBlocks, int32_t current,
+                              int32_t step, __get_comp_block_fn_t getBlockFn);
+
 int32_t vnodeQueryResultInterpolate(SQInfo* pQInfo, tFilePage** pDst, tFilePage** pDataSrc, int32_t numOfRows,
                                     int32_t* numOfInterpo);
 void copyResToQueryResultBuf(SMeterQuerySupportObj* pSupporter, SQuery* pQuery);
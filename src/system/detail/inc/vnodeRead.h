@@ -25,6 +25,15 @@ extern "C" {
 #include "tinterpolation.h"
 #include "vnodeTagMgmt.h"
 
+// minimum number of meters scanned by one sub query of an interval query on super table
+#define TSDB_MIN_METERS_OF_SUB_QUERY 64
+
+// maximum number of result pages a query keeps computed ahead of the retrieve of client
+#define TSDB_MAX_RETRIEVE_WINDOW 16
+
+#define TSDB_QROUND_DONE    0
+#define TSDB_QROUND_RUNNING 1
+
 /*
  * use to keep the first point position, consisting of position in blk and block
  * id, file id
@@ -105,6 +114,8 @@ typedef struct SQueryFilesInfo {
   int64_t          headFileSize;
   int32_t          dataFd;
   int32_t          lastFd;
+  int64_t          dataFileIno;  // inode of the opened data/last file, part of the key of the query block cache
+  int64_t          lastFileIno;
   
   char             headerFilePath[PATH_MAX];  // current opened header file name
   char             dataFilePath[PATH_MAX];    // current opened data file name
@@ -129,6 +140,7 @@ typedef struct RuntimeEnvironment {
   SQueryLoadBlockInfo loadBlockInfo;         /* record current block load information */
   SQueryLoadCompBlockInfo loadCompBlockInfo; /* record current compblock information in SQuery */
   SQueryFilesInfo         vnodeFileInfo;
+  int32_t            readAheadIndex;  // the last data block that has been read ahead, -1: none
   int16_t            numOfRowsPerPage;
   int16_t            offset[TSDB_MAX_COLUMNS];
   int16_t            scanFlag;  // denotes reversed scan of data or not
@@ -217,8 +229,23 @@ typedef struct SMeterQuerySupportObj {
   TSKEY*  tsList;
   int32_t tsNum;
 
+  /*
+   * sub queries on disjoint subsets of meters, which are scanned in parallel on the query threads. The intermediate
+   * results of each meter are moved into this query when the scan is completed, and merged into groups here.
+   */
+  struct _qinfo** pSubQInfo;
+  int32_t         numOfSubQueries;
+
 } SMeterQuerySupportObj;
 
+// results of one round, in the format of retrieve rsp, waiting for the retrieve of client
+typedef struct _qres_page {
+  struct _qres_page* next;
+  int32_t            numOfRows;
+  int64_t            offset;  // limit offset when the round is completed
+  char               data[];
+} SQueryResultPage;
+
 typedef struct _qinfo {
   uint64_t signature;
 
@@ -230,6 +257,7 @@ typedef struct _qinfo {
   uint64_t       startTime;
   int64_t        useconds;
   int            killed;
+  int            freeInRound;  // the QInfo is freed by the round holding the query flag, when the round ends
   struct _qinfo *prev, *next;
 
   SQuery     query;
@@ -249,6 +277,19 @@ typedef struct _qinfo {
   sem_t                  dataReady;
   SMeterQuerySupportObj* pMeterQuerySupporter;
 
+  /*
+   * when a round is completed, its results are moved into a page and the next round is launched, until the window
+   * advertised by client is full. Retrieves take the pages in order before the results in sdata.
+   */
+  pthread_mutex_t   resultLock;
+  pthread_cond_t    roundDone;
+  int8_t            roundState;
+  int16_t           window;
+  int32_t           numOfPages;
+  SQueryResultPage* pPageHead;
+  SQueryResultPage* pPageTail;
+  SQueryResultPage* pRetrievePage;  // page returned by the ongoing retrieve
+
 } SQInfo;
 
 int32_t vnodeQuerySingleMeterPrepare(SQInfo* pQInfo, SMeterObj* pMeterObj, SMeterQuerySupportObj* pSMultiMeterObj,
@@ -260,6 +301,14 @@ bool vnodeParametersSafetyCheck(SQuery* pQuery);
 
 int32_t vnodeMultiMeterQueryPrepare(SQInfo* pQInfo, SQuery* pQuery, void* param);
 
+/**
+ * move the intermediate results of all meters in sub queries into the disk-based buffer of the query, and release
+ * the sub queries
+ * @param pQInfo
+ * @return
+ */
+int32_t vnodeMoveSubQueryResults(SQInfo* pQInfo);
+
 /**
  * decrease the numofQuery of each table that is queried, enable the
  * remove/close operation can be executed
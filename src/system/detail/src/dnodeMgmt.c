@@ -33,6 +33,7 @@ extern uint64_t tsCreatedTime;
 
 int vnodeProcessVPeersMsg(char *msg, int msgLen, SMgmtObj *pMgmtObj);
 int vnodeProcessCreateMeterMsg(char *pMsg, int msgLen);
+static int vnodeProcessCreateMeterMsgImp(char *pMsg, int msgLen, bool save, SMeterObj **ppObj);
 int vnodeProcessFreeVnodeRequest(char *pMsg, int msgLen, SMgmtObj *pMgmtObj);
 int vnodeProcessVPeerCfgRsp(char *msg, int msgLen, SMgmtObj *pMgmtObj);
 int vnodeProcessMeterCfgRsp(char *msg, int msgLen, SMgmtObj *pMgmtObj);
@@ -54,6 +55,8 @@ int   taosSendMsgToMnode(SMgmtObj *pObj, char *msg, int msgLen);
 void vnodeProcessMsgFromMgmt(char *content, int msgLen, int msgType, SMgmtObj *pObj) {
   if (msgType == TSDB_MSG_TYPE_CREATE) {
     vnodeProcessCreateMeterRequest(content, msgLen, pObj);
+  } else if (msgType == TSDB_MSG_TYPE_MULTI_CREATE) {
+    vnodeProcessMultiCreateMeterRequest(content, msgLen, pObj);
   } else if (msgType == TSDB_MSG_TYPE_VPEERS) {
     vnodeProcessVPeersMsg(content, msgLen, pObj);
   } else if (msgType == TSDB_MSG_TYPE_VPEER_CFG_RSP) {
@@ -129,6 +132,78 @@ _over:
   return code;
 }
 
+static int vnodeGetCreateMsgLen(SCreateMsg *pCreate) {
+  return sizeof(SCreateMsg) + htons(pCreate->numOfColumns) * sizeof(SMColumn) + htons(pCreate->sqlLen);
+}
+
+/*
+ * create a batch of meters in one vnode, all new meter objects are saved into file at once
+ */
+int vnodeProcessMultiCreateMeterRequest(char *pMsg, int msgLen, SMgmtObj *pObj) {
+  SMultiCreateMsg *pMulti;
+  SMeterObj **     pObjs = NULL;
+  int              code = 0;
+  int              vid, numOfMeters, numOfSaved = 0;
+  SVnodeObj *      pVnode;
+
+  pMulti = (SMultiCreateMsg *)pMsg;
+  vid = htons(pMulti->vnode);
+  numOfMeters = htonl(pMulti->numOfMeters);
+
+  if (vid >= TSDB_MAX_VNODES || vid < 0) {
+    dError("vid:%d, vnode is out of range", vid);
+    code = TSDB_CODE_INVALID_VNODE_ID;
+    goto _over;
+  }
+
+  pVnode = vnodeList + vid;
+  if (pVnode->cfg.maxSessions <= 0) {
+    dError("vid:%d, not activated", vid);
+    code = TSDB_CODE_NOT_ACTIVE_VNODE;
+    goto _over;
+  }
+
+  char *pCont = pMulti->data;
+
+  if (pVnode->syncStatus == TSDB_VN_SYNC_STATUS_SYNCING) {
+    for (int i = 0; i < numOfMeters; ++i) {
+      int len = vnodeGetCreateMsgLen((SCreateMsg *)pCont);
+      code = vnodeSaveCreateMsgIntoQueue(pVnode, pCont, len);
+      if (code != TSDB_CODE_SUCCESS) break;
+      pCont += len;
+    }
+    dTrace("vid:%d, %d create msgs are saved into sync queue", vid, numOfMeters);
+    goto _over;
+  }
+
+  pObjs = (SMeterObj **)calloc(numOfMeters, sizeof(SMeterObj *));
+  if (pObjs == NULL) {
+    code = TSDB_CODE_SERV_OUT_OF_MEMORY;
+    goto _over;
+  }
+
+  for (int i = 0; i < numOfMeters; ++i) {
+    SMeterObj *pMeterObj = NULL;
+    int        len = vnodeGetCreateMsgLen((SCreateMsg *)pCont);
+
+    // the failure of one meter does not stop the others, the first error is reported to mnode
+    int ret = vnodeProcessCreateMeterMsgImp(pCont, len, false, &pMeterObj);
+    if (ret != TSDB_CODE_SUCCESS && ret != -1 && code == TSDB_CODE_SUCCESS) code = ret;
+    if (pMeterObj != NULL) pObjs[numOfSaved++] = pMeterObj;
+
+    pCont += len;
+  }
+
+  vnodeSaveMeterObjsToFile(vid, pObjs, numOfSaved);
+  dTrace("vid:%d, %d of %d meters are created in batch", vid, numOfSaved, numOfMeters);
+
+_over:
+  tfree(pObjs);
+  taosSendSimpleRspToMnode(pObj, TSDB_MSG_TYPE_MULTI_CREATE_RSP, code);
+
+  return code;
+}
+
 int vnodeProcessAlterStreamRequest(char *pMsg, int msgLen, SMgmtObj *pObj) {
   SAlterStreamMsg *pAlter;
   int              code = 0;
@@ -182,7 +257,11 @@ _over:
   return code;
 }
 
-int vnodeProcessCreateMeterMsg(char *pMsg, int msgLen) {
+/*
+ * When save is false, the new meter object is not saved to file but returned through ppObj if it is
+ * installed into the vnode, and the caller shall save it to file.
+ */
+static int vnodeProcessCreateMeterMsgImp(char *pMsg, int msgLen, bool save, SMeterObj **ppObj) {
   int         code;
   SMeterObj * pObj = NULL;
   SConnSec    connSec;
@@ -273,7 +352,12 @@ int vnodeProcessCreateMeterMsg(char *pMsg, int msgLen) {
   memcpy(connSec.secret, pCreate->secret, TSDB_KEY_LEN);
   memcpy(connSec.cipheringKey, pCreate->cipheringKey, TSDB_KEY_LEN);
 
-  code = vnodeCreateMeterObj(pObj, &connSec);
+  if (save) {
+    code = vnodeCreateMeterObj(pObj, &connSec);
+  } else {
+    code = vnodeCreateMeterObjNoSave(pObj, &connSec);
+    if (code == TSDB_CODE_SUCCESS && vnodeList[pObj->vnode].meterList[pObj->sid] == pObj) *ppObj = pObj;
+  }
 
 _create_over:
   if (code != TSDB_CODE_SUCCESS) {
@@ -284,6 +368,8 @@ _create_over:
   return code;
 }
 
+int vnodeProcessCreateMeterMsg(char *pMsg, int msgLen) { return vnodeProcessCreateMeterMsgImp(pMsg, msgLen, true, NULL); }
+
 int vnodeProcessRemoveMeterRequest(char *pMsg, int msgLen, SMgmtObj *pMgmtObj) {
   SMeterObj *      pObj;
   SRemoveMeterMsg *pRemove;
@@ -499,6 +499,8 @@ int mgmtRemoveMetricFromDb(SDbObj *pDb, STabObj *pMetric) {
   if (pMetric->pSkipList != NULL) {
     pMetric->pSkipList = tSkipListDestroy(pMetric->pSkipList);
   }
+
+  mgmtDestroyMetricTagIndex(pMetric);
   return 0;
 }
 
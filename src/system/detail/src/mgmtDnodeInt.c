@@ -26,6 +26,8 @@ int   mgmtSendVPeersMsg(SVgObj *pVgroup);
 char *mgmtBuildVpeersIe(char *pMsg, SVgObj *pVgroup, int vnode);
 char *mgmtBuildCreateMeterIe(STabObj *pMeter, char *pMsg, int vnode);
 
+#define MGMT_MULTI_CREATE_MSG_SIZE (1024 * 1024)
+
 /*
  * functions for communicate between dnode and mnode
  */
@@ -174,7 +176,7 @@ void mgmtProcessMsgFromDnode(char *content, int msgLen, int msgType, SDnodeObj *
     mgmtProcessMeterCfgMsg(content, msgLen - sizeof(SIntMsg), pObj);
   } else if (msgType == TSDB_MSG_TYPE_VPEER_CFG) {
     mgmtProcessVpeerCfgMsg(content, msgLen - sizeof(SIntMsg), pObj);
-  } else if (msgType == TSDB_MSG_TYPE_CREATE_RSP) {
+  } else if (msgType == TSDB_MSG_TYPE_CREATE_RSP || msgType == TSDB_MSG_TYPE_MULTI_CREATE_RSP) {
     mgmtProcessCreateRsp(content, msgLen - sizeof(SIntMsg), pObj);
   } else if (msgType == TSDB_MSG_TYPE_REMOVE_RSP) {
     // do nothing
@@ -259,6 +261,62 @@ int mgmtSendCreateMsgToVgroup(STabObj *pMeter, SVgObj *pVgroup) {
   return 0;
 }
 
+static int mgmtGetCreateMeterIeLen(STabObj *pMeter) {
+  int len = sizeof(SCreateMsg) + pMeter->numOfColumns * sizeof(SMColumn);
+  if (pMeter->pSql) len += strlen(pMeter->pSql) + 1;
+  return len;
+}
+
+/*
+ * send the meters of one vgroup to each of its vnodes, a message carries as many meters as
+ * MGMT_MULTI_CREATE_MSG_SIZE allows
+ */
+int mgmtSendMultiCreateMsgToVgroup(STabObj *pMeters[], int numOfMeters, SVgObj *pVgroup) {
+  char *           pMsg, *pStart;
+  SMultiCreateMsg *pMulti;
+  SDnodeObj *      pObj;
+  uint64_t         timeStamp;
+
+  timeStamp = taosGetTimestampMs();
+
+  for (int i = 0; i < pVgroup->numOfVnodes; ++i) {
+    pObj = mgmtGetDnode(pVgroup->vnodeGid[i].ip);
+    if (pObj == NULL) continue;
+
+    int start = 0;
+    while (start < numOfMeters) {
+      int size = sizeof(SMultiCreateMsg);
+      int end = start;
+      while (end < numOfMeters) {
+        int len = mgmtGetCreateMeterIeLen(pMeters[end]);
+        if (end > start && size + len > MGMT_MULTI_CREATE_MSG_SIZE) break;
+        size += len;
+        end++;
+      }
+
+      pStart = taosBuildReqMsgToDnodeWithSize(pObj, TSDB_MSG_TYPE_MULTI_CREATE, size + 256);
+      if (pStart == NULL) break;
+
+      pMulti = (SMultiCreateMsg *)pStart;
+      pMulti->vnode = htons(pVgroup->vnodeGid[i].vnode);
+      pMulti->numOfMeters = htonl(end - start);
+      pMsg = pMulti->data;
+      for (int k = start; k < end; ++k) {
+        pMsg = mgmtBuildCreateMeterIe(pMeters[k], pMsg, pVgroup->vnodeGid[i].vnode);
+      }
+
+      taosSendMsgToDnode(pObj, pStart, pMsg - pStart);
+      mTrace("vgroup:%d, vnode:%d, %d meters are sent in one create msg", pVgroup->vgId, pVgroup->vnodeGid[i].vnode,
+             end - start);
+      start = end;
+    }
+  }
+
+  pVgroup->lastCreate = timeStamp;
+
+  return 0;
+}
+
 int mgmtSendRemoveMeterMsgToDnode(STabObj *pMeter, SVgObj *pVgroup) {
   SRemoveMeterMsg *pRemove;
   char *           pMsg, *pStart;
@@ -35,6 +35,9 @@ extern int64_t sdbVersion;
   do {                                      \
     tfree(pMeter->schema);                  \
     pMeter->pSkipList = tSkipListDestroy((pMeter)->pSkipList); \
+    mgmtDestroyMetricTagIndex(pMeter);      \
+    tfree(pMeter->pOrdMeters);              \
+    tfree(pMeter->pChangeLog);              \
     tfree(pMeter);                          \
   } while (0)
 
@@ -215,6 +218,14 @@ void *mgmtMeterActionInsert(void *row, char *str, int size, int *ssize) {
     // insert a metric
     pMeter->pHead = NULL;
     pMeter->pSkipList = NULL;
+    pMeter->pTagIndex = NULL;
+    pMeter->pOrdMeters = NULL;
+    pMeter->numOfOrdMeters = 0;
+    pMeter->ordCapacity = 0;
+
+    // start from the clock, so the versions cached by clients before mnode restarts are never matched
+    pMeter->metaVersion = taosGetTimestampUs();
+    pMeter->pChangeLog = NULL;
     pDb = mgmtGetDbByMeterId(pMeter->meterId);
     if (pDb) {
       mgmtAddMetricIntoDb(pDb, pMeter);
@@ -285,12 +296,15 @@ void *mgmtMeterActionUpdate(void *row, char *str, int size, int *ssize) {
 
   if (pNew->isDirty) {
     pMetric = mgmtGetMeter(pMeter->pTagData);
+    pthread_rwlock_wrlock(&(pMetric->rwLock));
     removeMeterFromMetricIndex(pMetric, pMeter);
   }
   mgmtMeterActionReset(pMeter, str, size, NULL);
   pMeter->pTagData = pMeter->schema;
   if (pNew->isDirty) {
     addMeterIntoMetricIndex(pMetric, pMeter);
+    mgmtAddMetricChange(pMetric, pMeter);
+    pthread_rwlock_unlock(&(pMetric->rwLock));
     pMeter->isDirty = 0;
   }
 
@@ -375,6 +389,10 @@ void *mgmtMeterActionBatchUpdate(void *row, char *str, int size, int *ssize) {
       pMeter->schema = realloc(pMeter->schema, pMeter->schemaSize);
     }
 
+    // positions of tag columns are changed, secondary indexes will be built again on demand
+    mgmtDestroyMetricTagIndex(pMeter);
+    mgmtResetMetricChangeLog(pMeter);
+
     return pMeter->pHead;
 
   } else if (mgmtMeterCreateFromMetric(pMeter)) {
@@ -525,14 +543,22 @@ int mgmtInitMeters() {
 
 STabObj *mgmtGetMeter(char *meterId) { return (STabObj *)sdbGetRow(meterSdb, meterId); }
 
-int mgmtCreateMeter(SDbObj *pDb, SCreateTableMsg *pCreate) {
+/*
+ * Build the table object and allocate its sid, numOfPending is the number of tables built but not
+ * yet inserted into sdb. *ppMeter is NULL if the table exists and igExists is set.
+ */
+static int mgmtBuildMeter(SDbObj *pDb, SCreateTableMsg *pCreate, int numOfPending, STabObj **ppMeter,
+                          SVgObj **ppVgroup) {
   STabObj * pMeter = NULL;
   STabObj * pMetric = NULL;
   SVgObj *  pVgroup = NULL;
   int       size = 0;
   SAcctObj *pAcct = NULL;
 
-  int numOfTables = sdbGetNumOfRows(meterSdb);
+  *ppMeter = NULL;
+  *ppVgroup = NULL;
+
+  int numOfTables = sdbGetNumOfRows(meterSdb) + numOfPending;
   if (numOfTables >= tsMaxTables) {
     mError("table:%s, numOfTables:%d exceed maxTables:%d", pCreate->meterId, numOfTables, tsMaxTables);
     return TSDB_CODE_TOO_MANY_TABLES;
@@ -697,6 +723,18 @@ int mgmtCreateMeter(SDbObj *pDb, SCreateTableMsg *pCreate) {
     pMeter->uid = (((uint64_t)pMeter->createdTime) << 16) + ((uint64_t)sdbVersion & ((1ul << 16) - 1ul));
   }
 
+  *ppMeter = pMeter;
+  *ppVgroup = pVgroup;
+  return TSDB_CODE_SUCCESS;
+}
+
+int mgmtCreateMeter(SDbObj *pDb, SCreateTableMsg *pCreate) {
+  STabObj *pMeter = NULL;
+  SVgObj * pVgroup = NULL;
+
+  int code = mgmtBuildMeter(pDb, pCreate, 0, &pMeter, &pVgroup);
+  if (code != TSDB_CODE_SUCCESS || pMeter == NULL) return code;
+
   if (sdbInsertRow(meterSdb, pMeter, 0) < 0) {
     mError("table:%s, update sdb error", pCreate->meterId);
     return TSDB_CODE_SDB_ERROR;
@@ -714,6 +752,108 @@ int mgmtCreateMeter(SDbObj *pDb, SCreateTableMsg *pCreate) {
   return 0;
 }
 
+/*
+ * Create a batch of tables from super tables. The tables are inserted into sdb as one group, and
+ * each vgroup receives one create message carrying all of its new tables. Tables are created in
+ * order until the first failure, whose code is returned.
+ */
+int mgmtCreateMeters(SDbObj *pDb, SMultiCreateTableMsg *pMulti) {
+  STabObj **        pMeters = NULL;
+  SVgObj **         pVgroups = NULL;
+  void **           rows = NULL;
+  SCreateTableMsg * pCreate = NULL;
+  SCreateTableItem *pItem;
+  int               numOfMeters = 0;
+  int               code = TSDB_CODE_SUCCESS;
+
+  int numOfTables = pMulti->numOfTables;
+  if (numOfTables <= 0) return TSDB_CODE_SUCCESS;
+
+  pMeters = (STabObj **)calloc(numOfTables, sizeof(STabObj *));
+  pVgroups = (SVgObj **)calloc(numOfTables, sizeof(SVgObj *));
+  rows = (void **)calloc(numOfTables, sizeof(void *));
+  pCreate = (SCreateTableMsg *)calloc(1, sizeof(SCreateTableMsg) + sizeof(STagData));
+  if (pMeters == NULL || pVgroups == NULL || rows == NULL || pCreate == NULL) {
+    code = TSDB_CODE_SERV_OUT_OF_MEMORY;
+    goto _over;
+  }
+
+  pCreate->igExists = 1;
+  pItem = (SCreateTableItem *)pMulti->data;
+  for (int i = 0; i < numOfTables; ++i) {
+    if (pItem->tagLen <= 0 || pItem->tagLen > sizeof(STagData)) {
+      code = TSDB_CODE_INVALID_MSG_LEN;
+      break;
+    }
+
+    strncpy(pCreate->meterId, pItem->meterId, TSDB_METER_ID_LEN - 1);
+    memset(pCreate->schema, 0, sizeof(STagData));
+    memcpy(pCreate->schema, pItem->tags, pItem->tagLen);
+
+    STabObj *pMeter = NULL;
+    SVgObj * pVgroup = NULL;
+    code = mgmtBuildMeter(pDb, pCreate, numOfMeters, &pMeter, &pVgroup);
+    if (code != TSDB_CODE_SUCCESS) break;
+
+    if (pMeter != NULL) {
+      pMeters[numOfMeters] = pMeter;
+      pVgroups[numOfMeters] = pVgroup;
+      numOfMeters++;
+    }
+
+    pItem = (SCreateTableItem *)(pItem->tags + pItem->tagLen);
+  }
+
+  if (numOfMeters == 0) goto _over;
+
+  memcpy(rows, pMeters, numOfMeters * sizeof(void *));
+  if (sdbBatchInsertRows(meterSdb, rows, numOfMeters) < 0) {
+    mError("failed to insert %d tables into sdb", numOfMeters);
+    memset(rows, 0, numOfMeters * sizeof(void *));
+    code = TSDB_CODE_SDB_ERROR;
+  }
+
+  // release the tables not inserted, e.g. a duplicated name in the batch
+  int numOfInserted = 0;
+  for (int i = 0; i < numOfMeters; ++i) {
+    if (rows[i] == NULL) {
+      taosFreeId(pVgroups[i]->idPool, pMeters[i]->gid.sid);
+      mgmtDestroyMeter(pMeters[i]);
+      continue;
+    }
+
+    grantAddTimeSeries(pMeters[i]->numOfColumns - 1);
+    pMeters[numOfInserted] = pMeters[i];
+    pVgroups[numOfInserted] = pVgroups[i];
+    numOfInserted++;
+  }
+
+  // group the tables by vgroup, tables of one vgroup are usually adjacent
+  for (int i = 0; i < numOfInserted; ++i) {
+    SVgObj *pVgroup = pVgroups[i];
+    if (pVgroup == NULL) continue;
+
+    int num = 0;
+    for (int j = i; j < numOfInserted; ++j) {
+      if (pVgroups[j] != pVgroup) continue;
+      rows[num++] = pMeters[j];
+      pVgroups[j] = NULL;
+    }
+
+    mTrace("vgroup:%d, send create msg of %d tables to dnode, db:%s", pVgroup->vgId, num, pDb->name);
+    mgmtSendMultiCreateMsgToVgroup((STabObj **)rows, num, pVgroup);
+  }
+
+  mTrace("%d of %d tables are created in batch, db:%s code:%d", numOfInserted, numOfTables, pDb->name, code);
+
+_over:
+  tfree(pMeters);
+  tfree(pVgroups);
+  tfree(rows);
+  tfree(pCreate);
+  return code;
+}
+
 int mgmtDropMeter(SDbObj *pDb, char *meterId, int ignore) {
   STabObj * pMeter;
   SAcctObj *pAcct;
@@ -826,15 +966,45 @@ static void dropAllMetersOfMetric(SDbObj *pDb, STabObj * pMetric, SAcctObj *pAcc
 }
 
 /*
- * create key of each meter for skip list, which is generated from first tag
- * column
+ * create key of each meter for skip list, which is generated from the given tag column,
+ * the first tag column for the skip list of metric, the other columns for the secondary indexes
  */
-static void createKeyFromTagValue(STabObj *pMetric, STabObj *pMeter, tSkipListKey *pKey) {
-  SSchema *     pTagSchema = (SSchema *)(pMetric->schema + pMetric->numOfColumns * sizeof(SSchema));
-  const int16_t KEY_COLUMN_OF_TAGS = 0;
+static void createKeyFromTagValue(STabObj *pMetric, STabObj *pMeter, int32_t col, tSkipListKey *pKey) {
+  SSchema *pTagSchema = (SSchema *)(pMetric->schema + pMetric->numOfColumns * sizeof(SSchema));
+
+  char *tagVal = pMeter->pTagData + TSDB_METER_ID_LEN + mgmtGetTagsLength(pMetric, col);
+  *pKey = tSkipListCreateKey(pTagSchema[col].type, tagVal, pTagSchema[col].bytes);
+}
+
+/*
+ * the node of secondary index keeps the node of the metric's skip list, so that results from
+ * different indexes can be merged with each other
+ */
+static void addMeterIntoTagIndex(STabObj *pMetric, int32_t col, tSkipListNode *pMeterNode) {
+  tSkipListKey key = {0};
+  createKeyFromTagValue(pMetric, (STabObj *)pMeterNode->pData, col, &key);
+  tSkipListPut(pMetric->pTagIndex[col], pMeterNode, &key, 1);
+
+  tSkipListDestroyKey(&key);
+}
+
+static void removeMeterFromTagIndex(STabObj *pMetric, int32_t col, STabObj *pMeter) {
+  tSkipListKey key = {0};
+  createKeyFromTagValue(pMetric, pMeter, col, &key);
+  tSkipListNode **pRes = NULL;
 
-  char *tagVal = pMeter->pTagData + TSDB_METER_ID_LEN;  // tag start position
-  *pKey = tSkipListCreateKey(pTagSchema[KEY_COLUMN_OF_TAGS].type, tagVal, pTagSchema[KEY_COLUMN_OF_TAGS].bytes);
+  int32_t num = tSkipListGets(pMetric->pTagIndex[col], &key, &pRes);
+  for (int32_t i = 0; i < num; ++i) {
+    tSkipListNode *pMeterNode = (tSkipListNode *)pRes[i]->pData;
+    if ((STabObj *)pMeterNode->pData == pMeter) {
+      tSkipListRemoveNode(pMetric->pTagIndex[col], pRes[i]);
+    }
+  }
+
+  tSkipListDestroyKey(&key);
+  if (num != 0) {
+    free(pRes);
+  }
 }
 
 /*
@@ -851,10 +1021,16 @@ static void addMeterIntoMetricIndex(STabObj *pMetric, STabObj *pMeter) {
 
   if (pMetric->pSkipList) {
     tSkipListKey key = {0};
-    createKeyFromTagValue(pMetric, pMeter, &key);
-    tSkipListPut(pMetric->pSkipList, pMeter, &key, 1);
+    createKeyFromTagValue(pMetric, pMeter, KEY_COLUMN_OF_TAGS, &key);
+    tSkipListNode *pNode = tSkipListPut(pMetric->pSkipList, pMeter, &key, 1);
 
     tSkipListDestroyKey(&key);
+
+    for (int32_t col = 1; pNode != NULL && pMetric->pTagIndex != NULL && col < pMetric->numOfTags; ++col) {
+      if (pMetric->pTagIndex[col] != NULL) {
+        addMeterIntoTagIndex(pMetric, col, pNode);
+      }
+    }
   }
 }
 
@@ -863,8 +1039,15 @@ static void removeMeterFromMetricIndex(STabObj *pMetric, STabObj *pMeter) {
     return;
   }
 
+  // the nodes of secondary indexes refer to the node of skip list, so remove them first
+  for (int32_t col = 1; pMetric->pTagIndex != NULL && col < pMetric->numOfTags; ++col) {
+    if (pMetric->pTagIndex[col] != NULL) {
+      removeMeterFromTagIndex(pMetric, col, pMeter);
+    }
+  }
+
   tSkipListKey key = {0};
-  createKeyFromTagValue(pMetric, pMeter, &key);
+  createKeyFromTagValue(pMetric, pMeter, 0, &key);
   tSkipListNode **pRes = NULL;
 
   int32_t num = tSkipListGets(pMetric->pSkipList, &key, &pRes);
@@ -882,10 +1065,52 @@ static void removeMeterFromMetricIndex(STabObj *pMetric, STabObj *pMeter) {
   }
 }
 
+/*
+ * a meter without ordinal, due to out of memory, is still linked into the metric, tag filter results
+ * containing it are combined without bitmap
+ */
+static void mgmtAddMeterOrdinal(STabObj *pMetric, STabObj *pMeter) {
+  pMeter->ordinal = -1;
+
+  if (pMetric->numOfOrdMeters >= pMetric->ordCapacity) {
+    int32_t capacity = (pMetric->ordCapacity < 64) ? 64 : pMetric->ordCapacity * 2;
+    void *  tmp = realloc(pMetric->pOrdMeters, (size_t)capacity * POINTER_BYTES);
+    if (tmp == NULL) {
+      mError("meter:%s, failed to assign ordinal in metric:%s", pMeter->meterId, pMetric->meterId);
+      return;
+    }
+
+    pMetric->pOrdMeters = (STabObj **)tmp;
+    pMetric->ordCapacity = capacity;
+  }
+
+  pMeter->ordinal = pMetric->numOfOrdMeters++;
+  pMetric->pOrdMeters[pMeter->ordinal] = pMeter;
+}
+
+/*
+ * keep the ordinals dense, the last meter takes the position of the removed one
+ */
+static void mgmtRemoveMeterOrdinal(STabObj *pMetric, STabObj *pMeter) {
+  int32_t ord = pMeter->ordinal;
+  if (ord < 0 || ord >= pMetric->numOfOrdMeters || pMetric->pOrdMeters[ord] != pMeter) {
+    return;
+  }
+
+  STabObj *pLast = pMetric->pOrdMeters[--pMetric->numOfOrdMeters];
+  pMetric->pOrdMeters[ord] = pLast;
+  pLast->ordinal = ord;
+
+  pMetric->pOrdMeters[pMetric->numOfOrdMeters] = NULL;
+  pMeter->ordinal = -1;
+}
+
 int mgmtAddMeterIntoMetric(STabObj *pMetric, STabObj *pMeter) {
   if (pMeter == NULL || pMetric == NULL) return -1;
 
   pthread_rwlock_wrlock(&(pMetric->rwLock));
+  mgmtAddMeterOrdinal(pMetric, pMeter);
+
   // add meter into skip list
   pMeter->next = pMetric->pHead;
   pMeter->prev = NULL;
@@ -896,6 +1121,7 @@ int mgmtAddMeterIntoMetric(STabObj *pMetric, STabObj *pMeter) {
   pMetric->numOfMeters++;
 
   addMeterIntoMetricIndex(pMetric, pMeter);
+  mgmtAddMetricChange(pMetric, pMeter);
 
   pthread_rwlock_unlock(&(pMetric->rwLock));
 
@@ -911,15 +1137,108 @@ int mgmtRemoveMeterFromMetric(STabObj *pMetric, STabObj *pMeter) {
 
   if (pMeter->prev == NULL) pMetric->pHead = pMeter->next;
 
+  mgmtRemoveMeterOrdinal(pMetric, pMeter);
   pMetric->numOfMeters--;
 
   removeMeterFromMetricIndex(pMetric, pMeter);
+  mgmtAddMetricChange(pMetric, pMeter);
 
   pthread_rwlock_unlock(&(pMetric->rwLock));
 
   return 0;
 }
 
+/*
+ * record the change of a sub-table, invoked with the write lock of metric held
+ */
+void mgmtAddMetricChange(STabObj *pMetric, STabObj *pMeter) {
+  pMetric->metaVersion++;
+
+  SMetricChangeLog *pLog = pMetric->pChangeLog;
+  if (pLog == NULL) {
+    return;
+  }
+
+  int32_t pos = (pLog->start + pLog->size) % pLog->capacity;
+  if (pLog->size == pLog->capacity) {  // overwrite the oldest change
+    pLog->baseVersion = pLog->changes[pLog->start].version;
+    pLog->start = (pLog->start + 1) % pLog->capacity;
+  } else {
+    pLog->size++;
+  }
+
+  SMetricChange *pChange = &pLog->changes[pos];
+  pChange->version = pMetric->metaVersion;
+  pChange->vgId = pMeter->gid.vgId;
+  pChange->sid = pMeter->gid.sid;
+}
+
+/*
+ * the cached metric meta of clients can not be patched any more, e.g., the tag schema is changed
+ */
+void mgmtResetMetricChangeLog(STabObj *pMetric) {
+  pMetric->metaVersion++;
+
+  if (pMetric->pChangeLog != NULL) {
+    pMetric->pChangeLog->baseVersion = pMetric->metaVersion;
+    pMetric->pChangeLog->start = 0;
+    pMetric->pChangeLog->size = 0;
+  }
+}
+
+/*
+ * build the secondary index on a tag column other than the first one, which is indexed by the skip list
+ */
+int mgmtBuildMetricTagIndex(STabObj *pMetric, int32_t col) {
+  if (col <= 0 || col >= pMetric->numOfTags) {
+    return TSDB_CODE_APP_ERROR;
+  }
+
+  SSchema *pTagSchema = (SSchema *)(pMetric->schema + pMetric->numOfColumns * sizeof(SSchema));
+  int32_t  code = TSDB_CODE_SUCCESS;
+
+  pthread_rwlock_wrlock(&(pMetric->rwLock));
+
+  if (pMetric->pTagIndex == NULL) {
+    pMetric->pTagIndex = (tSkipList **)calloc(TSDB_MAX_TAGS, POINTER_BYTES);
+  }
+
+  if (pMetric->pTagIndex == NULL) {
+    code = TSDB_CODE_SERV_OUT_OF_MEMORY;
+  } else if (pMetric->pTagIndex[col] == NULL && pMetric->pSkipList != NULL) {
+    tSkipList *pIndex = tSkipListCreate(MAX_SKIP_LIST_LEVEL, pTagSchema[col].type, pTagSchema[col].bytes);
+    if (pIndex == NULL) {
+      code = TSDB_CODE_SERV_OUT_OF_MEMORY;
+    } else {
+      pMetric->pTagIndex[col] = pIndex;
+
+      SSkipListIterator iter = {0};
+      tSkipListIteratorReset(pMetric->pSkipList, &iter);
+      while (tSkipListIteratorNext(&iter)) {
+        addMeterIntoTagIndex(pMetric, col, tSkipListIteratorGet(&iter));
+      }
+
+      mTrace("metric:%s, secondary index on tag:%s is built, numOfMeters:%d", pMetric->meterId, pTagSchema[col].name,
+             pIndex->nSize);
+    }
+  }
+
+  pthread_rwlock_unlock(&(pMetric->rwLock));
+  return code;
+}
+
+void mgmtDestroyMetricTagIndex(STabObj *pMetric) {
+  if (pMetric->pTagIndex == NULL) {
+    return;
+  }
+
+  for (int32_t col = 0; col < TSDB_MAX_TAGS; ++col) {
+    tSkipListDestroy(pMetric->pTagIndex[col]);
+  }
+
+  tfree(pMetric->pTagIndex);
+}
+
 void mgmtCleanUpMeters() { sdbCloseTable(meterSdb); }
 
 int mgmtGetMeterMeta(SMeterMeta *pMeta, SShowObj *pShow, SConnObj *pConn) {
@@ -985,34 +1304,47 @@ SSchema *mgmtGetMeterSchema(STabObj *pMeter) {
 }
 
 /*
- * serialize SVnodeSidList to byte array
+ * serialize SVnodeSidList to byte array, or SLegacyVnodeSidList if not in the delta format
  */
-static char *mgmtBuildMetricMetaMsg(STabObj *pMeter, int32_t *ovgId, SVnodeSidList **pList, SMetricMeta *pMeta,
-                                    int32_t tagLen, int16_t numOfTags, int16_t *tagsId, int32_t maxNumOfMeters,
-                                    char *pMsg) {
-  if (pMeter->gid.vgId != *ovgId || ((*pList) != NULL && (*pList)->numOfSids >= maxNumOfMeters)) {
+static char *mgmtBuildMetricMetaMsg(STabObj *pMeter, int32_t *ovgId, int32_t **pNumOfSids, SMetricMeta *pMeta,
+                                    bool delta, int32_t tagLen, int16_t numOfTags, int16_t *tagsId,
+                                    int32_t maxNumOfMeters, char *pMsg) {
+  if (pMeter->gid.vgId != *ovgId || ((*pNumOfSids) != NULL && **pNumOfSids >= maxNumOfMeters)) {
     /*
      * here we construct a new vnode group for 2 reasons
      * 1. the query msg may be larger than 64k,
      * 2. the following meters belong to different vnodes
      */
+    SVPeerDesc *vpeerDesc = NULL;
+
+    if (delta) {
+      SVnodeSidList *pList = (SVnodeSidList *)pMsg;
+      pList->index = 0;
+      pList->vgId = pMeter->gid.vgId;
+      vpeerDesc = pList->vpeerDesc;
+      (*pNumOfSids) = &pList->numOfSids;
+      pMsg += sizeof(SVnodeSidList);
+    } else {
+      SLegacyVnodeSidList *pList = (SLegacyVnodeSidList *)pMsg;
+      pList->index = 0;
+      vpeerDesc = pList->vpeerDesc;
+      (*pNumOfSids) = &pList->numOfSids;
+      pMsg += sizeof(SLegacyVnodeSidList);
+    }
 
-    (*pList) = (SVnodeSidList *)pMsg;
-    (*pList)->numOfSids = 0;
-    (*pList)->index = 0;
+    **pNumOfSids = 0;
     pMeta->numOfVnodes++;
 
     SVgObj *pVgroup = mgmtGetVgroup(pMeter->gid.vgId);
     for (int i = 0; i < TSDB_VNODES_SUPPORT; ++i) {
-      (*pList)->vpeerDesc[i].ip = pVgroup->vnodeGid[i].publicIp;
-      (*pList)->vpeerDesc[i].vnode = pVgroup->vnodeGid[i].vnode;
+      vpeerDesc[i].ip = pVgroup->vnodeGid[i].publicIp;
+      vpeerDesc[i].vnode = pVgroup->vnodeGid[i].vnode;
     }
 
-    pMsg += sizeof(SVnodeSidList);
     (*ovgId) = pMeter->gid.vgId;
   }
   pMeta->numOfMeters++;
-  (*pList)->numOfSids++;
+  (**pNumOfSids)++;
 
   SMeterSidExtInfo *pSMeterTagInfo = (SMeterSidExtInfo *)pMsg;
   pSMeterTagInfo->sid = pMeter->gid.sid;
@@ -1070,7 +1402,7 @@ static int32_t mgmtGetMetricMetaMsgSize(tQueryResultset *pResult, int32_t tagLen
   return size;
 }
 
-static SMetricMetaElemMsg *doConvertMetricMetaMsg(SMetricMetaMsg *pMetricMetaMsg, int32_t tableIndex) {
+static SMetricMetaElemMsg *doConvertMetricMetaMsg(SMetricMetaMsg *pMetricMetaMsg, int32_t tableIndex, bool delta) {
   SMetricMetaElemMsg *pElem = (SMetricMetaElemMsg *)((char *)pMetricMetaMsg + pMetricMetaMsg->metaElem[tableIndex]);
 
   pElem->orderIndex = htons(pElem->orderIndex);
@@ -1094,6 +1426,9 @@ static SMetricMetaElemMsg *doConvertMetricMetaMsg(SMetricMetaMsg *pMetricMetaMsg
 
   pElem->groupbyTagColumnList = htonl(pElem->groupbyTagColumnList);
 
+  // the element from old clients ends before version
+  pElem->version = delta ? htobe64(pElem->version) : 0;
+
   int16_t *groupColIds = (int16_t*) (((char *)pMetricMetaMsg) + pElem->groupbyTagColumnList);
   for (int32_t i = 0; i < pElem->numOfGroupCols; ++i) {
     groupColIds[i] = htons(groupColIds[i]);
@@ -1102,10 +1437,105 @@ static SMetricMetaElemMsg *doConvertMetricMetaMsg(SMetricMetaMsg *pMetricMetaMsg
   return pElem;
 }
 
+typedef struct SMetricMetaDelta {
+  int64_t        version;  // version of metric when the result is built
+  bool           delta;    // only the changes since the version of client are sent
+  SMetricChange *pChanges;  // distinct sub-tables changed since the version of client, in order of vgId and sid
+  int32_t        numOfChanges;
+} SMetricMetaDelta;
+
+static int32_t metricChangeComparator(const void *pLeft, const void *pRight) {
+  const SMetricChange *p1 = (const SMetricChange *)pLeft;
+  const SMetricChange *p2 = (const SMetricChange *)pRight;
+
+  if (p1->vgId != p2->vgId) {
+    return p1->vgId > p2->vgId ? 1 : -1;
+  }
+
+  if (p1->sid != p2->sid) {
+    return p1->sid > p2->sid ? 1 : -1;
+  }
+
+  return 0;
+}
+
+/*
+ * Collect the sub-tables changed after the version cached by client. If the changes are not kept any more,
+ * or no version is provided, the full metric meta is sent.
+ */
+static void mgmtGetMetricMetaDelta(STabObj *pMetric, int64_t version, SMetricMetaDelta *pDelta) {
+  memset(pDelta, 0, sizeof(SMetricMetaDelta));
+
+  pthread_rwlock_wrlock(&(pMetric->rwLock));
+  pDelta->version = pMetric->metaVersion;
+
+  if (pMetric->pChangeLog == NULL && tsMetricMetaDeltaLogSize > 0) {
+    pMetric->pChangeLog = calloc(1, sizeof(SMetricChangeLog) + sizeof(SMetricChange) * tsMetricMetaDeltaLogSize);
+    if (pMetric->pChangeLog != NULL) {
+      pMetric->pChangeLog->baseVersion = pMetric->metaVersion;
+      pMetric->pChangeLog->capacity = tsMetricMetaDeltaLogSize;
+    }
+  }
+
+  SMetricChangeLog *pLog = pMetric->pChangeLog;
+  if (version > 0 && pLog != NULL && version >= pLog->baseVersion && version <= pMetric->metaVersion) {
+    // changes are kept in ascending order of version
+    int32_t num = 0;
+    while (num < pLog->size &&
+           pLog->changes[(pLog->start + pLog->size - 1 - num) % pLog->capacity].version > version) {
+      num++;
+    }
+
+    pDelta->pChanges = (num > 0) ? malloc(sizeof(SMetricChange) * num) : NULL;
+    if (num == 0 || pDelta->pChanges != NULL) {
+      for (int32_t i = 0; i < num; ++i) {
+        pDelta->pChanges[i] = pLog->changes[(pLog->start + pLog->size - num + i) % pLog->capacity];
+      }
+
+      pDelta->numOfChanges = num;
+      pDelta->delta = true;
+    }
+  }
+
+  pthread_rwlock_unlock(&(pMetric->rwLock));
+
+  if (pDelta->numOfChanges > 1) {
+    qsort(pDelta->pChanges, pDelta->numOfChanges, sizeof(SMetricChange), metricChangeComparator);
+
+    int32_t num = 1;
+    for (int32_t i = 1; i < pDelta->numOfChanges; ++i) {
+      if (metricChangeComparator(&pDelta->pChanges[i], &pDelta->pChanges[num - 1]) != 0) {
+        pDelta->pChanges[num++] = pDelta->pChanges[i];
+      }
+    }
+
+    pDelta->numOfChanges = num;
+  }
+}
+
+/*
+ * keep the sub-tables changed since the version of client in the result only
+ */
+static void mgmtFilterChangedMeters(tQueryResultset *pRes, SMetricMetaDelta *pDelta) {
+  int32_t num = 0;
+
+  for (int32_t i = 0; i < pRes->num; ++i) {
+    STabObj *     pMeter = pRes->pRes[i];
+    SMetricChange key = {.vgId = pMeter->gid.vgId, .sid = pMeter->gid.sid};
+
+    if (bsearch(&key, pDelta->pChanges, pDelta->numOfChanges, sizeof(SMetricChange), metricChangeComparator) != NULL) {
+      pRes->pRes[num++] = pMeter;
+    }
+  }
+
+  pRes->num = num;
+}
+
 static int32_t mgmtBuildMetricMetaRspMsg(void *thandle, SMetricMetaMsg *pMetricMetaMsg, tQueryResultset *pResult,
-                                         char **pStart, int32_t *tagLen, int32_t rspMsgSize, int32_t maxTablePerVnode,
-                                         int32_t code) {
-  *pStart = taosBuildRspMsgWithSize(thandle, TSDB_MSG_TYPE_METRIC_META_RSP, rspMsgSize);
+                                         SMetricMetaDelta *pDelta, bool delta, char **pStart, int32_t *tagLen,
+                                         int32_t rspMsgSize, int32_t maxTablePerVnode, int32_t code) {
+  char rspType = delta ? TSDB_MSG_TYPE_METRIC_META_DELTA_RSP : TSDB_MSG_TYPE_METRIC_META_RSP;
+  *pStart = taosBuildRspMsgWithSize(thandle, rspType, rspMsgSize);
   if (*pStart == NULL) {
     return 0;
   }
@@ -1128,29 +1558,53 @@ static int32_t mgmtBuildMetricMetaRspMsg(void *thandle, SMetricMetaMsg *pMetricM
   pMsg += sizeof(int16_t);
 
   for (int32_t j = 0; j < pMetricMetaMsg->numOfMeters; ++j) {
-    SVnodeSidList *pList = NULL;
-    int            ovgId = -1;
+    int32_t *pNumOfSids = NULL;
+    int      ovgId = -1;
 
-    SMetricMeta *pMeta = (SMetricMeta *)pMsg;
-
-    pMeta->numOfMeters = 0;
-    pMeta->numOfVnodes = 0;
-    pMeta->tagLen = htons((uint16_t)tagLen[j]);
-
-    pMsg = (char *)pMeta + sizeof(SMetricMeta);
+    // the header is filled after the vnode lists are built
+    SMetricMeta meta = {0};
+    char *      pHeader = pMsg;
+    pMsg += delta ? sizeof(SMetricMeta) : sizeof(SLegacyMetricMeta);
 
     SMetricMetaElemMsg *pElem = (SMetricMetaElemMsg *)((char *)pMetricMetaMsg + pMetricMetaMsg->metaElem[j]);
 
     for (int32_t i = 0; i < pResult[j].num; ++i) {
       STabObj *pMeter = pResult[j].pRes[i];
-      pMsg = mgmtBuildMetricMetaMsg(pMeter, &ovgId, &pList, pMeta, tagLen[j], pElem->numOfTags, pElem->tagCols,
-                                    maxTablePerVnode, pMsg);
+      pMsg = mgmtBuildMetricMetaMsg(pMeter, &ovgId, &pNumOfSids, &meta, delta, tagLen[j], pElem->numOfTags,
+                                    pElem->tagCols, maxTablePerVnode, pMsg);
+    }
+
+    if (!delta) {
+      SLegacyMetricMeta *pMeta = (SLegacyMetricMeta *)pHeader;
+      pMeta->numOfMeters = htonl(meta.numOfMeters);
+      pMeta->numOfVnodes = htonl(meta.numOfVnodes);
+      pMeta->tagLen = htons((uint16_t)tagLen[j]);
+
+      mTrace("metric:%s metric-meta tables:%d, vnode:%d", pElem->meterId, meta.numOfMeters, meta.numOfVnodes);
+      continue;
     }
 
-    mTrace("metric:%s metric-meta tables:%d, vnode:%d", pElem->meterId, pMeta->numOfMeters, pMeta->numOfVnodes);
+    // the sub-tables removed or re-tagged, the re-tagged ones still satisfied are sent in the vnode lists again
+    if (pDelta[j].delta) {
+      for (int32_t i = 0; i < pDelta[j].numOfChanges; ++i) {
+        SMeterSidRemoved *pRemoved = (SMeterSidRemoved *)pMsg;
+        pRemoved->vgId = pDelta[j].pChanges[i].vgId;
+        pRemoved->sid = pDelta[j].pChanges[i].sid;
+        pMsg += sizeof(SMeterSidRemoved);
+      }
+    }
+
+    SMetricMeta *pMeta = (SMetricMeta *)pHeader;
+    pMeta->numOfMeters = htonl(meta.numOfMeters);
+    pMeta->numOfVnodes = htonl(meta.numOfVnodes);
+    pMeta->tagLen = htons((uint16_t)tagLen[j]);
+    pMeta->delta = pDelta[j].delta ? 1 : 0;
+    pMeta->numOfRemoved = pDelta[j].delta ? htonl(pDelta[j].numOfChanges) : 0;
+    pMeta->version = htobe64(pDelta[j].version);
+    pMeta->fetchTime = 0;
 
-    pMeta->numOfMeters = htonl(pMeta->numOfMeters);
-    pMeta->numOfVnodes = htonl(pMeta->numOfVnodes);
+    mTrace("metric:%s metric-meta tables:%d, vnode:%d, delta:%d, removed:%d, version:%lld", pElem->meterId,
+           meta.numOfMeters, meta.numOfVnodes, pDelta[j].delta, pDelta[j].numOfChanges, pDelta[j].version);
   }
 
   msgLen = pMsg - (*pStart);
@@ -1159,7 +1613,7 @@ static int32_t mgmtBuildMetricMetaRspMsg(void *thandle, SMetricMetaMsg *pMetricM
   return msgLen;
 }
 
-int mgmtRetrieveMetricMeta(void *thandle, char **pStart, SMetricMetaMsg *pMetricMetaMsg) {
+int mgmtRetrieveMetricMeta(void *thandle, char **pStart, SMetricMetaMsg *pMetricMetaMsg, bool delta) {
   /*
    * naive method: Do not limit the maximum number of meters in each
    * vnode(subquery), split the result according to vnodes
@@ -1170,15 +1624,19 @@ int mgmtRetrieveMetricMeta(void *thandle, char **pStart, SMetricMetaMsg *pMetric
   int32_t          maxMetersPerVNodeForQuery = INT32_MAX;
   int              msgLen = 0;
   int              ret = TSDB_CODE_SUCCESS;
-  tQueryResultset *result = calloc(1, pMetricMetaMsg->numOfMeters * sizeof(tQueryResultset));
-  int32_t *        tagLen = calloc(1, sizeof(int32_t) * pMetricMetaMsg->numOfMeters);
-
-  if (result == NULL || tagLen == NULL) {
+  tQueryResultset * result = calloc(1, pMetricMetaMsg->numOfMeters * sizeof(tQueryResultset));
+  int32_t *         tagLen = calloc(1, sizeof(int32_t) * pMetricMetaMsg->numOfMeters);
+  SMetricMetaDelta *pDelta = calloc(1, sizeof(SMetricMetaDelta) * pMetricMetaMsg->numOfMeters);
+
+  if (result == NULL || tagLen == NULL || pDelta == NULL) {
+    tfree(result);
+    tfree(tagLen);
+    tfree(pDelta);
     return -1;
   }
 
   for (int32_t i = 0; i < pMetricMetaMsg->numOfMeters; ++i) {
-    SMetricMetaElemMsg *pElem = doConvertMetricMetaMsg(pMetricMetaMsg, i);
+    SMetricMetaElemMsg *pElem = doConvertMetricMetaMsg(pMetricMetaMsg, i, delta);
     STabObj *           pMetric = mgmtGetMeter(pElem->meterId);
 
     if (!mgmtIsMetric(pMetric)) {
@@ -1187,6 +1645,10 @@ int mgmtRetrieveMetricMeta(void *thandle, char **pStart, SMetricMetaMsg *pMetric
     }
 
     tagLen[i] = mgmtGetReqTagsLength(pMetric, (int16_t *)pElem->tagCols, pElem->numOfTags);
+
+    // the version is taken before retrieving, the changes during retrieving are sent again in the next delta
+    int64_t version = (pMetricMetaMsg->numOfMeters == 1) ? pElem->version : 0;
+    mgmtGetMetricMetaDelta(pMetric, version, &pDelta[i]);
   }
 
 #if 0
@@ -1207,7 +1669,14 @@ int mgmtRetrieveMetricMeta(void *thandle, char **pStart, SMetricMetaMsg *pMetric
 
   if (ret == TSDB_CODE_SUCCESS) {
     for (int32_t i = 0; i < pMetricMetaMsg->numOfMeters; ++i) {
+      if (pDelta[i].delta && pDelta[i].numOfChanges == 0) {  // not changed since the version of client
+        continue;
+      }
+
       ret = mgmtRetrieveMetersFromMetric(pMetricMetaMsg, i, &result[i]);
+      if (ret == TSDB_CODE_SUCCESS && pDelta[i].delta) {
+        mgmtFilterChangedMeters(&result[i], &pDelta[i]);
+      }
       // todo opt performance
       //      if (result[i].num <= 0) {//no result
       //      } else if (result[i].num < 10) {
@@ -1228,18 +1697,21 @@ int mgmtRetrieveMetricMeta(void *thandle, char **pStart, SMetricMetaMsg *pMetric
   if (ret == TSDB_CODE_SUCCESS) {
     for (int32_t i = 0; i < pMetricMetaMsg->numOfMeters; ++i) {
       msgLen += mgmtGetMetricMetaMsgSize(&result[i], tagLen[i], maxMetersPerVNodeForQuery);
+      msgLen += pDelta[i].numOfChanges * sizeof(SMeterSidRemoved);
     }
   } else {
     msgLen = 512;
   }
 
-  msgLen = mgmtBuildMetricMetaRspMsg(thandle, pMetricMetaMsg, result, pStart, tagLen, msgLen, maxMetersPerVNodeForQuery,
-                                     ret);
+  msgLen = mgmtBuildMetricMetaRspMsg(thandle, pMetricMetaMsg, result, pDelta, delta, pStart, tagLen, msgLen,
+                                     maxMetersPerVNodeForQuery, ret);
 
   for (int32_t i = 0; i < pMetricMetaMsg->numOfMeters; ++i) {
     tQueryResultClean(&result[i]);
+    tfree(pDelta[i].pChanges);
   }
 
+  free(pDelta);
   free(tagLen);
   free(result);
 
@@ -1493,14 +1965,14 @@ int32_t mgmtMeterModifyTagValueByCol(STabObj *pMeter, int col, const char *nCont
 
   SSchema *schema = (SSchema *)(pMetric->schema + (pMetric->numOfColumns + col) * sizeof(SSchema));
 
-  if (col == 0) {
-    pMeter->isDirty = 1;
-    removeMeterFromMetricIndex(pMetric, pMeter);
-  }
+  // the metric may have secondary index on any tag column, the slaves rebuild the index entries by isDirty
+  pMeter->isDirty = 1;
+  pthread_rwlock_wrlock(&(pMetric->rwLock));
+  removeMeterFromMetricIndex(pMetric, pMeter);
   memcpy(pMeter->pTagData + mgmtGetTagsLength(pMetric, col) + TSDB_METER_ID_LEN, nContent, schema->bytes);
-  if (col == 0) {
-    addMeterIntoMetricIndex(pMetric, pMeter);
-  }
+  addMeterIntoMetricIndex(pMetric, pMeter);
+  mgmtAddMetricChange(pMetric, pMeter);
+  pthread_rwlock_unlock(&(pMetric->rwLock));
 
   // Encode the string
   int   size = sizeof(STabObj) + TSDB_MAX_BYTES_PER_ROW + 1;
@@ -491,11 +491,16 @@ _exit_code:
   return msgLen;
 }
 
-int mgmtProcessMetricMetaMsg(char *pMsg, int msgLen, SConnObj *pConn) {
+/*
+ * TSDB_MSG_TYPE_METRIC_META is answered in the legacy layout without delta, for the clients not knowing the delta
+ * format. The others send TSDB_MSG_TYPE_METRIC_META_DELTA, after the connect response advertises it.
+ */
+static int mgmtDoProcessMetricMetaMsg(char *pMsg, int msgLen, SConnObj *pConn, bool delta) {
   SMetricMetaMsg *pMetricMetaMsg = (SMetricMetaMsg *)pMsg;
   STabObj *       pMetric;
   STaosRsp *      pRsp;
   char *          pStart;
+  char            rspType = delta ? TSDB_MSG_TYPE_METRIC_META_DELTA_RSP : TSDB_MSG_TYPE_METRIC_META_RSP;
 
   pMetricMetaMsg->numOfMeters = htonl(pMetricMetaMsg->numOfMeters);
 
@@ -513,9 +518,9 @@ int mgmtProcessMetricMetaMsg(char *pMsg, int msgLen, SConnObj *pConn) {
   if (pConn->pDb != NULL) pDb = mgmtGetDb(pConn->pDb->name);
 
   if (pMetric == NULL || (pDb != NULL && pDb->dropStatus != TSDB_DB_STATUS_READY)) {
-    pStart = taosBuildRspMsg(pConn->thandle, TSDB_MSG_TYPE_METRIC_META_RSP);
+    pStart = taosBuildRspMsg(pConn->thandle, rspType);
     if (pStart == NULL) {
-      taosSendSimpleRsp(pConn->thandle, TSDB_MSG_TYPE_METRIC_META_RSP, TSDB_CODE_SERV_OUT_OF_MEMORY);
+      taosSendSimpleRsp(pConn->thandle, rspType, TSDB_CODE_SERV_OUT_OF_MEMORY);
       return 0;
     }
 
@@ -529,9 +534,9 @@ int mgmtProcessMetricMetaMsg(char *pMsg, int msgLen, SConnObj *pConn) {
 
     msgLen = pMsg - pStart;
   } else {
-    msgLen = mgmtRetrieveMetricMeta(pConn->thandle, &pStart, pMetricMetaMsg);
+    msgLen = mgmtRetrieveMetricMeta(pConn->thandle, &pStart, pMetricMetaMsg, delta);
     if (msgLen <= 0) {
-      taosSendSimpleRsp(pConn->thandle, TSDB_MSG_TYPE_METRIC_META_RSP, TSDB_CODE_SERV_OUT_OF_MEMORY);
+      taosSendSimpleRsp(pConn->thandle, rspType, TSDB_CODE_SERV_OUT_OF_MEMORY);
       return 0;
     }
   }
@@ -541,6 +546,14 @@ int mgmtProcessMetricMetaMsg(char *pMsg, int msgLen, SConnObj *pConn) {
   return msgLen;
 }
 
+int mgmtProcessMetricMetaMsg(char *pMsg, int msgLen, SConnObj *pConn) {
+  return mgmtDoProcessMetricMetaMsg(pMsg, msgLen, pConn, false);
+}
+
+int mgmtProcessMetricMetaDeltaMsg(char *pMsg, int msgLen, SConnObj *pConn) {
+  return mgmtDoProcessMetricMetaMsg(pMsg, msgLen, pConn, true);
+}
+
 int mgmtProcessCreateDbMsg(char *pMsg, int msgLen, SConnObj *pConn) {
   SCreateDbMsg *pCreate = (SCreateDbMsg *)pMsg;
   int           code = 0;
@@ -998,6 +1011,60 @@ int mgmtProcessCreateTableMsg(char *pMsg, int msgLen, SConnObj *pConn) {
   return 0;
 }
 
+int mgmtProcessMultiCreateTableMsg(char *pMsg, int msgLen, SConnObj *pConn) {
+  SMultiCreateTableMsg *pMulti = (SMultiCreateTableMsg *)pMsg;
+  int                   code = TSDB_CODE_SUCCESS;
+
+  if (mgmtCheckRedirectMsg(pConn, TSDB_MSG_TYPE_MULTI_CREATE_TABLE_RSP) != 0) {
+    return 0;
+  }
+
+  if (!pConn->writeAuth) {
+    code = TSDB_CODE_NO_RIGHTS;
+  } else {
+    pMulti->numOfTables = htonl(pMulti->numOfTables);
+    if (pMulti->numOfTables < 0 || pMulti->numOfTables > TSDB_MULTI_CREATE_TABLE_MAX_NUM) {
+      code = TSDB_CODE_INVALID_MSG_LEN;
+    }
+
+    // convert the items and make sure they are all inside the message
+    char *pEnd = pMsg + msgLen;
+    char *pCont = pMulti->data;
+    for (int i = 0; i < pMulti->numOfTables && code == TSDB_CODE_SUCCESS; ++i) {
+      SCreateTableItem *pItem = (SCreateTableItem *)pCont;
+      if (pCont + sizeof(SCreateTableItem) > pEnd) {
+        code = TSDB_CODE_INVALID_MSG_LEN;
+        break;
+      }
+
+      pItem->tagLen = htons(pItem->tagLen);
+      pCont = pItem->tags + pItem->tagLen;
+      if (pItem->tagLen <= 0 || pCont > pEnd) code = TSDB_CODE_INVALID_MSG_LEN;
+    }
+
+    SDbObj *pDb = NULL;
+    if (pConn->pDb != NULL) pDb = mgmtGetDb(pConn->pDb->name);
+
+    if (code != TSDB_CODE_SUCCESS) {
+      mError("invalid multi create table msg, msgLen:%d", msgLen);
+    } else if (pDb) {
+      code = mgmtCreateMeters(pDb, pMulti);
+    } else {
+      code = TSDB_CODE_DB_NOT_SELECTED;
+    }
+  }
+
+  if (code != TSDB_CODE_SUCCESS && code != TSDB_CODE_ACTION_IN_PROGRESS) {
+    mError("failed to create %d tables in batch, code:%d", pMulti->numOfTables, code);
+  } else {
+    mTrace("%d tables are created in batch by %s, code:%d", pMulti->numOfTables, pConn->pUser->user, code);
+  }
+
+  taosSendSimpleRsp(pConn->thandle, TSDB_MSG_TYPE_MULTI_CREATE_TABLE_RSP, code);
+
+  return 0;
+}
+
 int mgmtProcessDropTableMsg(char *pMsg, int msgLen, SConnObj *pConn) {
   SDropTableMsg *pDrop = (SDropTableMsg *)pMsg;
   int            code;
@@ -1236,6 +1303,9 @@ _rsp:
     *((uint32_t *)pMsg) = tsTimePrecision;
     pMsg += sizeof(uint32_t);
 
+    *((uint32_t *)pMsg) = htonl(TSDB_CONN_FEATURE_METRIC_META_DELTA);
+    pMsg += sizeof(uint32_t);
+
   } else {
     pConn->pAcct = NULL;
     pConn->pUser = NULL;
@@ -1303,8 +1373,9 @@ void *mgmtProcessMsgFromShell(char *msg, void *ahandle, void *thandle) {
 
       // read-only request can be executed concurrently
       if ((pMsg->msgType == TSDB_MSG_TYPE_METERINFO && (!mgmtCheckMeterMetaMsgType(cont))) ||
-          pMsg->msgType == TSDB_MSG_TYPE_METRIC_META || pMsg->msgType == TSDB_MSG_TYPE_RETRIEVE ||
-          pMsg->msgType == TSDB_MSG_TYPE_SHOW || pMsg->msgType == TSDB_MSG_TYPE_MULTI_METERINFO) {
+          pMsg->msgType == TSDB_MSG_TYPE_METRIC_META || pMsg->msgType == TSDB_MSG_TYPE_METRIC_META_DELTA ||
+          pMsg->msgType == TSDB_MSG_TYPE_RETRIEVE || pMsg->msgType == TSDB_MSG_TYPE_SHOW ||
+          pMsg->msgType == TSDB_MSG_TYPE_MULTI_METERINFO) {
         (*mgmtProcessShellMsg[pMsg->msgType])(cont, contLen, pConn);
       } else {
         if (mgmtProcessShellMsg[pMsg->msgType]) {
@@ -1338,6 +1409,7 @@ void *mgmtProcessMsgFromShell(char *msg, void *ahandle, void *thandle) {
 void mgmtInitProcessShellMsg() {
   mgmtProcessShellMsg[TSDB_MSG_TYPE_METERINFO] = mgmtProcessMeterMetaMsg;
   mgmtProcessShellMsg[TSDB_MSG_TYPE_METRIC_META] = mgmtProcessMetricMetaMsg;
+  mgmtProcessShellMsg[TSDB_MSG_TYPE_METRIC_META_DELTA] = mgmtProcessMetricMetaDeltaMsg;
   mgmtProcessShellMsg[TSDB_MSG_TYPE_MULTI_METERINFO] = mgmtProcessMultiMeterMetaMsg;
   mgmtProcessShellMsg[TSDB_MSG_TYPE_CREATE_DB] = mgmtProcessCreateDbMsg;
   mgmtProcessShellMsg[TSDB_MSG_TYPE_ALTER_DB] = mgmtProcessAlterDbMsg;
@@ -1350,6 +1422,7 @@ void mgmtInitProcessShellMsg() {
   mgmtProcessShellMsg[TSDB_MSG_TYPE_ALTER_ACCT] = mgmtProcessAlterAcctMsg;
 
   mgmtProcessShellMsg[TSDB_MSG_TYPE_CREATE_TABLE] = mgmtProcessCreateTableMsg;
+  mgmtProcessShellMsg[TSDB_MSG_TYPE_MULTI_CREATE_TABLE] = mgmtProcessMultiCreateTableMsg;
   mgmtProcessShellMsg[TSDB_MSG_TYPE_DROP_TABLE] = mgmtProcessDropTableMsg;
   mgmtProcessShellMsg[TSDB_MSG_TYPE_ALTER_TABLE] = mgmtProcessAlterTableMsg;
 
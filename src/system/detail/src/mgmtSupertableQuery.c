@@ -437,10 +437,11 @@ static tQueryResultset* doSortIntersect(tQueryResultset* pRes1, tQueryResultset*
 
   int32_t num = 0;
   while (i < pRes1->num && j < pRes2->num) {
-    if (pRes1->pRes[i] == pRes2->pRes[j]) {
+    int32_t ret = tabObjPointerComparator(&pRes1->pRes[i], &pRes2->pRes[j]);
+    if (ret == 0) {
       j++;
       pRes1->pRes[num++] = pRes1->pRes[i++];
-    } else if (pRes1->pRes[i] < pRes2->pRes[j]) {
+    } else if (ret < 0) {
       i++;
     } else {
       j++;
@@ -454,18 +455,129 @@ static tQueryResultset* doSortIntersect(tQueryResultset* pRes1, tQueryResultset*
   return pRes1;
 }
 
-static void queryResultIntersect(tQueryResultset* pFinalRes, tQueryResultset* pRes) {
+/*
+ * Bitmap over the dense ordinals of the meters in a metric. Every tag filter result is a subset of
+ * pMetric->pOrdMeters, so the results are combined in time linear to their size, without sorting.
+ * The caller should hold the read lock of metric to keep the ordinals stable.
+ */
+typedef struct SMeterBitmap {
+  uint64_t* words;
+  int32_t   numOfWords;
+} SMeterBitmap;
+
+static bool meterBitmapInit(SMeterBitmap* pBitmap, STabObj* pMetric) {
+  pBitmap->numOfWords = (pMetric->numOfOrdMeters + 63) >> 6;
+  pBitmap->words = calloc((size_t)pBitmap->numOfWords + 1, sizeof(uint64_t));
+
+  return pBitmap->words != NULL;
+}
+
+static void meterBitmapDestroy(SMeterBitmap* pBitmap) { tfree(pBitmap->words); }
+
+static FORCE_INLINE bool meterBitmapTestAndSet(SMeterBitmap* pBitmap, int32_t ord) {
+  uint64_t mask = 1ULL << (ord & 63);
+  bool     set = (pBitmap->words[ord >> 6] & mask) != 0;
+
+  pBitmap->words[ord >> 6] |= mask;
+  return set;
+}
+
+static FORCE_INLINE bool meterBitmapTestAndClear(SMeterBitmap* pBitmap, int32_t ord) {
+  uint64_t mask = 1ULL << (ord & 63);
+  bool     set = (pBitmap->words[ord >> 6] & mask) != 0;
+
+  pBitmap->words[ord >> 6] &= ~mask;
+  return set;
+}
+
+// return -1 if the meter has no valid ordinal, and the bitmap can not be applied
+static FORCE_INLINE int32_t meterOrdinal(STabObj* pMetric, STabObj* pMeter) {
+  int32_t ord = pMeter->ordinal;
+  if (ord < 0 || ord >= pMetric->numOfOrdMeters || pMetric->pOrdMeters[ord] != pMeter) {
+    return -1;
+  }
+
+  return ord;
+}
+
+static bool doBitmapIntersect(STabObj* pMetric, tQueryResultset* pRes1, tQueryResultset* pRes2) {
+  SMeterBitmap bitmap = {0};
+  if (!meterBitmapInit(&bitmap, pMetric)) {
+    return false;
+  }
+
+  for (int32_t i = 0; i < pRes2->num; ++i) {
+    int32_t ord = meterOrdinal(pMetric, pRes2->pRes[i]);
+    if (ord < 0) {
+      meterBitmapDestroy(&bitmap);
+      return false;
+    }
+
+    meterBitmapTestAndSet(&bitmap, ord);
+  }
+
+  int32_t num = 0;
+  for (int32_t i = 0; i < pRes1->num; ++i) {
+    int32_t ord = meterOrdinal(pMetric, pRes1->pRes[i]);
+    if (ord < 0) {
+      meterBitmapDestroy(&bitmap);
+      return false;
+    }
+
+    // clear the bit, so duplicated items in pRes1 are reported only once
+    if (meterBitmapTestAndClear(&bitmap, ord)) {
+      pRes1->pRes[num++] = pRes1->pRes[i];
+    }
+  }
+
+  meterBitmapDestroy(&bitmap);
+  tQueryResultClean(pRes2);
+
+  memset(pRes1->pRes + num, 0, sizeof(void*) * (pRes1->num - num));
+  pRes1->num = num;
+  return true;
+}
+
+static void queryResultIntersect(STabObj* pMetric, tQueryResultset* pFinalRes, tQueryResultset* pRes) {
   const int32_t NUM_OF_RES_THRESHOLD = 20;
 
   // for small result, use nested loop join
   if (pFinalRes->num <= NUM_OF_RES_THRESHOLD && pRes->num <= NUM_OF_RES_THRESHOLD) {
     doNestedLoopIntersect(pFinalRes, pRes);
-  } else {  // for larger result, sort merge is employed
+  } else if (!doBitmapIntersect(pMetric, pFinalRes, pRes)) {  // sort merge if the bitmap is not available
     doSortIntersect(pFinalRes, pRes);
   }
 }
 
-static void queryResultUnion(tQueryResultset* pFinalRes, tQueryResultset* pRes) {
+/*
+ * remove the duplicated items in place, the order of the first occurrences is kept
+ */
+static bool doBitmapDistinct(STabObj* pMetric, void** pItems, int32_t total, int32_t* num) {
+  SMeterBitmap bitmap = {0};
+  if (!meterBitmapInit(&bitmap, pMetric)) {
+    return false;
+  }
+
+  for (int32_t i = 0; i < total; ++i) {
+    if (meterOrdinal(pMetric, pItems[i]) < 0) {
+      meterBitmapDestroy(&bitmap);
+      return false;
+    }
+  }
+
+  int32_t n = 0;
+  for (int32_t i = 0; i < total; ++i) {
+    if (!meterBitmapTestAndSet(&bitmap, ((STabObj*)pItems[i])->ordinal)) {
+      pItems[n++] = pItems[i];
+    }
+  }
+
+  meterBitmapDestroy(&bitmap);
+  *num = n;
+  return true;
+}
+
+static void queryResultUnion(STabObj* pMetric, tQueryResultset* pFinalRes, tQueryResultset* pRes) {
   if (pRes->num == 0) {
     tQueryResultClean(pRes);
     return;
@@ -479,12 +591,16 @@ static void queryResultUnion(tQueryResultset* pFinalRes, tQueryResultset* pRes)
   pFinalRes->pRes = tmp;
 
   memcpy(&pFinalRes->pRes[pFinalRes->num], pRes->pRes, POINTER_BYTES * pRes->num);
-  qsort(pFinalRes->pRes, total, POINTER_BYTES, tabObjPointerComparator);
 
-  int32_t num = 1;
-  for (int32_t i = 1; i < total; ++i) {
-    if (pFinalRes->pRes[i] != pFinalRes->pRes[i - 1]) {
-      pFinalRes->pRes[num++] = pFinalRes->pRes[i];
+  int32_t num = 0;
+  if (!doBitmapDistinct(pMetric, pFinalRes->pRes, total, &num)) {
+    qsort(pFinalRes->pRes, total, POINTER_BYTES, tabObjPointerComparator);
+
+    num = 1;
+    for (int32_t i = 1; i < total; ++i) {
+      if (pFinalRes->pRes[i] != pFinalRes->pRes[i - 1]) {
+        pFinalRes->pRes[num++] = pFinalRes->pRes[i];
+      }
     }
   }
 
@@ -497,6 +613,70 @@ static void queryResultUnion(tQueryResultset* pFinalRes, tQueryResultset* pRes)
   tQueryResultClean(pRes);
 }
 
+/*
+ * union of two partial results of the tag filter, both consist of the nodes of the skip list of metric,
+ * of which the data is the meter object. Invoked with the read lock of metric held.
+ */
+static int32_t nodePointerComparator(const void* pLeft, const void* pRight) {
+  uintptr_t p1 = (uintptr_t)(*(void**)pLeft);
+  uintptr_t p2 = (uintptr_t)(*(void**)pRight);
+
+  return (p1 == p2) ? 0 : ((p1 > p2) ? 1 : -1);
+}
+
+static int32_t mgmtMergeFilterResult(void* param, tQueryResultset* pLeft, tQueryResultset* pRight,
+                                     tQueryResultset* pFinalRes) {
+  STabObj* pMetric = ((SSyntaxTreeFilterSupporter*)param)->pMetric;
+  assert(pFinalRes->pRes == NULL);
+
+  pFinalRes->pRes = calloc((size_t)(pLeft->num + pRight->num), POINTER_BYTES);
+  pFinalRes->num = 0;
+  if (pFinalRes->pRes == NULL) {
+    return 0;
+  }
+
+  SMeterBitmap bitmap = {0};
+  bool         useBitmap = meterBitmapInit(&bitmap, pMetric);
+
+  tQueryResultset* pSrc[2] = {pLeft, pRight};
+  for (int32_t k = 0; k < 2 && useBitmap; ++k) {
+    for (int32_t i = 0; i < pSrc[k]->num; ++i) {
+      tSkipListNode* pNode = pSrc[k]->pRes[i];
+      int32_t        ord = meterOrdinal(pMetric, (STabObj*)pNode->pData);
+
+      if (ord < 0) {
+        useBitmap = false;
+        break;
+      }
+
+      if (!meterBitmapTestAndSet(&bitmap, ord)) {
+        pFinalRes->pRes[pFinalRes->num++] = pNode;
+      }
+    }
+  }
+
+  meterBitmapDestroy(&bitmap);
+  if (useBitmap) {
+    return pFinalRes->num;
+  }
+
+  // no bitmap available, sort by address and remove the duplicated nodes
+  memcpy(pFinalRes->pRes, pLeft->pRes, POINTER_BYTES * pLeft->num);
+  memcpy(pFinalRes->pRes + pLeft->num, pRight->pRes, POINTER_BYTES * pRight->num);
+
+  int32_t total = pLeft->num + pRight->num;
+  qsort(pFinalRes->pRes, total, POINTER_BYTES, nodePointerComparator);
+
+  pFinalRes->num = (total > 0) ? 1 : 0;
+  for (int32_t i = 1; i < total; ++i) {
+    if (pFinalRes->pRes[i] != pFinalRes->pRes[i - 1]) {
+      pFinalRes->pRes[pFinalRes->num++] = pFinalRes->pRes[i];
+    }
+  }
+
+  return pFinalRes->num;
+}
+
 static int32_t compareIntVal(const void* pLeft, const void* pRight) {
   DEFAULT_COMP(GET_INT64_VAL(pLeft), GET_INT64_VAL(pRight));
 }
@@ -677,6 +857,54 @@ void tSQLListTraverseDestroyInfo(void* param) {
   free(param);
 }
 
+static tSkipList* mgmtGetTagIndex(void* param, int32_t colIdx) {
+  STabObj* pMetric = ((SSyntaxTreeFilterSupporter*)param)->pMetric;
+  if (pMetric->pTagIndex == NULL || colIdx >= pMetric->numOfTags) {
+    return NULL;
+  }
+
+  return pMetric->pTagIndex[colIdx];
+}
+
+/*
+ * Mark the sub-expressions that can be filtered through an index, the skip list on the first tag column
+ * or the secondary index on the other tag columns. Secondary indexes are built at the first point or
+ * range query on the tag column, once the metric has tsTagIndexMinTables tables.
+ *
+ * It is called with the read lock of metric held, so a missing index is not built here. The column is
+ * returned in *pBuildCol instead, unless it is in buildMask which holds the columns already tried.
+ */
+static uint8_t mgmtMarkIndexedExpr(SSyntaxTreeFilterSupporter* pSupporter, tSQLBinaryExpr* pExpr, uint32_t buildMask,
+                                   int32_t* pBuildCol) {
+  tSQLSyntaxNode* pLeft = pExpr->pLeft;
+  tSQLSyntaxNode* pRight = pExpr->pRight;
+
+  if (pLeft->nodeType == TSQL_NODE_EXPR || pRight->nodeType == TSQL_NODE_EXPR) {
+    uint8_t left = mgmtMarkIndexedExpr(pSupporter, pLeft->pExpr, buildMask, pBuildCol);
+    uint8_t right = mgmtMarkIndexedExpr(pSupporter, pRight->pExpr, buildMask, pBuildCol);
+
+    pExpr->filterOnPrimaryKey = (left || right) ? 1 : 0;
+    return pExpr->filterOnPrimaryKey;
+  }
+
+  int32_t col = 0, offset = 0;
+  getTagColumnInfo(pSupporter, pLeft->pSchema, &col, &offset);
+  if (col <= 0 || col >= pSupporter->numOfTags || pExpr->nSQLBinaryOptr == TSDB_RELATION_LIKE) {
+    return pExpr->filterOnPrimaryKey;  // the first tag column is always indexed, TBNAME is never
+  }
+
+  STabObj* pMetric = pSupporter->pMetric;
+  bool     pointOrRange = (pExpr->nSQLBinaryOptr != TSDB_RELATION_NOT_EQUAL);
+
+  if (mgmtGetTagIndex(pSupporter, col) == NULL && pointOrRange && tsTagIndexMinTables > 0 &&
+      pMetric->numOfMeters >= tsTagIndexMinTables && (buildMask & (1u << col)) == 0 && *pBuildCol == 0) {
+    *pBuildCol = col;
+  }
+
+  pExpr->filterOnPrimaryKey = (mgmtGetTagIndex(pSupporter, col) != NULL) ? 1 : 0;
+  return pExpr->filterOnPrimaryKey;
+}
+
 static int32_t mgmtFilterMeterByIndex(STabObj* pMetric, tQueryResultset* pRes, char* pCond, int32_t condLen) {
   SSchema* pTagSchema = (SSchema*)(pMetric->schema + pMetric->numOfColumns * sizeof(SSchema));
 
@@ -690,10 +918,34 @@ static int32_t mgmtFilterMeterByIndex(STabObj* pMetric, tQueryResultset* pRes, c
 
     return TSDB_CODE_OPS_NOT_SUPPORT;
   } else {  // query according to the binary expression
-    SSyntaxTreeFilterSupporter s = {.pTagSchema = pTagSchema, .numOfTags = pMetric->numOfTags};
-    SBinaryFilterSupp          supp = {.fp = tSkipListNodeFilterCallback, .setupInfoFn = filterPrepare, .pExtInfo = &s};
+    SSyntaxTreeFilterSupporter s = {.pTagSchema = pTagSchema, .numOfTags = pMetric->numOfTags, .pMetric = pMetric};
+    SBinaryFilterSupp          supp = {.fp = tSkipListNodeFilterCallback,
+                              .setupInfoFn = filterPrepare,
+                              .getIndexFn = mgmtGetTagIndex,
+                              .mergeFn = mgmtMergeFilterResult,
+                              .pExtInfo = &s};
+
+    uint32_t buildMask = 0;
+    int32_t  buildCol = 0;
+
+    // secondary indexes are released when the tag schema of metric is changed, so they are used with the lock held
+    pthread_rwlock_rdlock(&(pMetric->rwLock));
+    mgmtMarkIndexedExpr(&s, pExpr, buildMask, &buildCol);
+
+    while (buildCol > 0) {
+      // the index is built with the write lock, indexes may be released meanwhile so the marks are done again
+      pthread_rwlock_unlock(&(pMetric->rwLock));
+      mgmtBuildMetricTagIndex(pMetric, buildCol);
+      buildMask |= (1u << buildCol);
+      buildCol = 0;
+
+      pthread_rwlock_rdlock(&(pMetric->rwLock));
+      mgmtMarkIndexedExpr(&s, pExpr, buildMask, &buildCol);
+    }
 
     tSQLBinaryExprTraverse(pExpr, pMetric->pSkipList, pRes, &supp);
+    pthread_rwlock_unlock(&(pMetric->rwLock));
+
     tSQLBinaryExprDestroy(&pExpr, tSQLListTraverseDestroyInfo);
   }
 
@@ -755,15 +1007,18 @@ int mgmtRetrieveMetersFromMetric(SMetricMetaMsg* pMsg, int32_t tableIndex, tQuer
       // union or intersect of two results
       assert(pElem->rel == TSDB_RELATION_AND || pElem->rel == TSDB_RELATION_OR);
 
+      // the ordinals of meters are kept unchanged during the combination
+      pthread_rwlock_rdlock(&(pMetric->rwLock));
       if (pElem->rel == TSDB_RELATION_AND) {
         if (filterRes.num == 0 || pRes->num == 0) {  // intersect two sets
           tQueryResultClean(pRes);
         } else {
-          queryResultIntersect(pRes, &filterRes);
+          queryResultIntersect(pMetric, pRes, &filterRes);
         }
       } else {  // union two sets
-        queryResultUnion(pRes, &filterRes);
+        queryResultUnion(pMetric, pRes, &filterRes);
       }
+      pthread_rwlock_unlock(&(pMetric->rwLock));
 
       tQueryResultClean(&filterRes);
     }
@@ -94,8 +94,9 @@ bool mgmtCheckIsMonitorDB(char *db, char *monitordb) {
 }
 
 int32_t mgmtCheckDBParams(SCreateDbMsg *pCreate) {
-  if (pCreate->commitLog < 0 || pCreate->commitLog > 1) {
-    mError("invalid db option commitLog: %d, only 0 or 1 allowed", pCreate->commitLog);
+  if (pCreate->commitLog < TSDB_MIN_COMMIT_LOG_LEVEL || pCreate->commitLog > TSDB_MAX_COMMIT_LOG_LEVEL) {
+    mError("invalid db option commitLog: %d valid range: [%d, %d]", pCreate->commitLog, TSDB_MIN_COMMIT_LOG_LEVEL,
+           TSDB_MAX_COMMIT_LOG_LEVEL);
     return TSDB_CODE_INVALID_OPTION;
   }
   
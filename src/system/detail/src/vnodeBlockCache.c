@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _DEFAULT_SOURCE
+#include "os.h"
+
+#include "tglobalcfg.h"
+#include "tlog.h"
+#include "tutil.h"
+#include "vnodeBlockCache.h"
+
+#define BLOCK_CACHE_MIN_BUCKETS 1024
+#define BLOCK_CACHE_MAX_BUCKETS (1 << 20)
+#define BLOCK_CACHE_AVG_COLUMN_SIZE 4096
+
+typedef struct SBlockCacheNode {
+  SBlockCacheKey          key;
+  struct SBlockCacheNode *hnext;  // next node in the same hash bucket
+  struct SBlockCacheNode *prev;   // lru list, head is the most recently used one
+  struct SBlockCacheNode *next;
+  int32_t                 refCount;
+  int32_t                 size;
+  bool                    removed;  // removed from cache, freed when the last reference is released
+  char                    data[];
+} SBlockCacheNode;
+
+typedef struct {
+  pthread_mutex_t   mutex;
+  SBlockCacheNode **buckets;
+  int32_t           numOfBuckets;
+  SBlockCacheNode * head;
+  SBlockCacheNode * tail;
+  int64_t           capacity;
+  int64_t           usedBytes;
+  int64_t           numOfNodes;
+  int64_t           hits;
+  int64_t           misses;
+} SBlockCache;
+
+static SBlockCache *pBlockCache = NULL;
+
+static uint32_t vnodeHashBlockCacheKey(SBlockCacheKey *pKey) {
+  uint64_t h = (uint64_t)pKey->offset * 0x9E3779B97F4A7C15ULL;
+  h ^= ((uint64_t)pKey->fileIno + ((uint64_t)pKey->vnode << 48) + ((uint64_t)pKey->fileId << 16)) * 0xC2B2AE3D27D4EB4FULL;
+  h ^= (uint64_t)pKey->colId;
+
+  return (uint32_t)(h ^ (h >> 32));
+}
+
+static bool vnodeIsSameBlockCacheKey(SBlockCacheKey *pKey1, SBlockCacheKey *pKey2) {
+  return pKey1->offset == pKey2->offset && pKey1->fileIno == pKey2->fileIno && pKey1->fileId == pKey2->fileId &&
+         pKey1->vnode == pKey2->vnode && pKey1->colId == pKey2->colId;
+}
+
+static SBlockCacheNode **vnodeGetBlockCacheBucket(SBlockCacheKey *pKey) {
+  return &pBlockCache->buckets[vnodeHashBlockCacheKey(pKey) & (pBlockCache->numOfBuckets - 1)];
+}
+
+static SBlockCacheNode *vnodeSearchBlockCache(SBlockCacheKey *pKey) {
+  SBlockCacheNode *pNode = *vnodeGetBlockCacheBucket(pKey);
+  while (pNode != NULL && !vnodeIsSameBlockCacheKey(&pNode->key, pKey)) {
+    pNode = pNode->hnext;
+  }
+
+  return pNode;
+}
+
+static void vnodeUnlinkBlockCacheLru(SBlockCacheNode *pNode) {
+  if (pNode->prev) {
+    pNode->prev->next = pNode->next;
+  } else {
+    pBlockCache->head = pNode->next;
+  }
+
+  if (pNode->next) {
+    pNode->next->prev = pNode->prev;
+  } else {
+    pBlockCache->tail = pNode->prev;
+  }
+
+  pNode->prev = pNode->next = NULL;
+}
+
+static void vnodeLinkBlockCacheLruHead(SBlockCacheNode *pNode) {
+  pNode->prev = NULL;
+  pNode->next = pBlockCache->head;
+
+  if (pBlockCache->head) {
+    pBlockCache->head->prev = pNode;
+  } else {
+    pBlockCache->tail = pNode;
+  }
+
+  pBlockCache->head = pNode;
+}
+
+/* remove the node from hash list and lru list, it is freed now if no one references it */
+static void vnodeRemoveBlockCacheNode(SBlockCacheNode *pNode) {
+  SBlockCacheNode **ppNode = vnodeGetBlockCacheBucket(&pNode->key);
+  while (*ppNode != pNode) {
+    ppNode = &(*ppNode)->hnext;
+  }
+  *ppNode = pNode->hnext;
+
+  vnodeUnlinkBlockCacheLru(pNode);
+
+  pBlockCache->usedBytes -= pNode->size;
+  pBlockCache->numOfNodes--;
+  pNode->removed = true;
+
+  if (pNode->refCount == 0) {
+    free(pNode);
+  }
+}
+
+int32_t vnodeInitBlockCache() {
+  if (tsQueryBlockCacheSize <= 0) {
+    dPrint("query block cache is disabled");
+    return 0;
+  }
+
+  pBlockCache = calloc(1, sizeof(SBlockCache));
+  if (pBlockCache == NULL) {
+    return -1;
+  }
+
+  pBlockCache->capacity = (int64_t)tsQueryBlockCacheSize * 1024 * 1024;
+
+  int64_t numOfBuckets = BLOCK_CACHE_MIN_BUCKETS;
+  while (numOfBuckets < BLOCK_CACHE_MAX_BUCKETS && numOfBuckets * BLOCK_CACHE_AVG_COLUMN_SIZE < pBlockCache->capacity) {
+    numOfBuckets <<= 1;
+  }
+
+  pBlockCache->numOfBuckets = (int32_t)numOfBuckets;
+  pBlockCache->buckets = calloc(numOfBuckets, sizeof(SBlockCacheNode *));
+  if (pBlockCache->buckets == NULL) {
+    tfree(pBlockCache);
+    return -1;
+  }
+
+  pthread_mutex_init(&pBlockCache->mutex, NULL);
+
+  dPrint("query block cache is initialized, size:%dMB buckets:%d", tsQueryBlockCacheSize, pBlockCache->numOfBuckets);
+  return 0;
+}
+
+void vnodeCleanUpBlockCache() {
+  if (pBlockCache == NULL) {
+    return;
+  }
+
+  SBlockCacheNode *pNode = pBlockCache->head;
+  while (pNode) {
+    SBlockCacheNode *pNext = pNode->next;
+    free(pNode);
+    pNode = pNext;
+  }
+
+  pthread_mutex_destroy(&pBlockCache->mutex);
+  tfree(pBlockCache->buckets);
+  tfree(pBlockCache);
+}
+
+bool vnodeGetColumnFromBlockCache(SBlockCacheKey *pKey, char *dst, int32_t size) {
+  if (pBlockCache == NULL) {
+    return false;
+  }
+
+  pthread_mutex_lock(&pBlockCache->mutex);
+
+  SBlockCacheNode *pNode = vnodeSearchBlockCache(pKey);
+  if (pNode == NULL || pNode->size != size) {
+    pBlockCache->misses++;
+    pthread_mutex_unlock(&pBlockCache->mutex);
+    return false;
+  }
+
+  pBlockCache->hits++;
+  pNode->refCount++;
+
+  vnodeUnlinkBlockCacheLru(pNode);
+  vnodeLinkBlockCacheLruHead(pNode);
+
+  pthread_mutex_unlock(&pBlockCache->mutex);
+
+  // the copy is done without lock, the reference keeps the node alive
+  memcpy(dst, pNode->data, size);
+
+  pthread_mutex_lock(&pBlockCache->mutex);
+  if (--pNode->refCount == 0 && pNode->removed) {
+    free(pNode);
+  }
+  pthread_mutex_unlock(&pBlockCache->mutex);
+
+  return true;
+}
+
+void vnodePutColumnIntoBlockCache(SBlockCacheKey *pKey, const char *data, int32_t size) {
+  // one column should not flush out most of the cache
+  if (pBlockCache == NULL || size <= 0 || size > (pBlockCache->capacity >> 3)) {
+    return;
+  }
+
+  SBlockCacheNode *pNew = malloc(sizeof(SBlockCacheNode) + size);
+  if (pNew == NULL) {
+    return;
+  }
+
+  pNew->key = *pKey;
+  pNew->refCount = 0;
+  pNew->size = size;
+  pNew->removed = false;
+  memcpy(pNew->data, data, size);
+
+  pthread_mutex_lock(&pBlockCache->mutex);
+
+  if (vnodeSearchBlockCache(pKey) != NULL) {  // loaded by another query at the same time
+    pthread_mutex_unlock(&pBlockCache->mutex);
+    free(pNew);
+    return;
+  }
+
+  // evict the least recently used ones, the nodes being copied are skipped
+  SBlockCacheNode *pNode = pBlockCache->tail;
+  while (pNode != NULL && pBlockCache->usedBytes + size > pBlockCache->capacity) {
+    SBlockCacheNode *pPrev = pNode->prev;
+    if (pNode->refCount == 0) {
+      vnodeRemoveBlockCacheNode(pNode);
+    }
+    pNode = pPrev;
+  }
+
+  if (pBlockCache->usedBytes + size > pBlockCache->capacity) {
+    pthread_mutex_unlock(&pBlockCache->mutex);
+    free(pNew);
+    return;
+  }
+
+  SBlockCacheNode **ppBucket = vnodeGetBlockCacheBucket(pKey);
+  pNew->hnext = *ppBucket;
+  *ppBucket = pNew;
+
+  vnodeLinkBlockCacheLruHead(pNew);
+
+  pBlockCache->usedBytes += size;
+  pBlockCache->numOfNodes++;
+
+  pthread_mutex_unlock(&pBlockCache->mutex);
+}
+
+void vnodeInvalidateBlockCache(int32_t vnode, int32_t fileId) {
+  if (pBlockCache == NULL) {
+    return;
+  }
+
+  int64_t numOfRemoved = 0;
+
+  pthread_mutex_lock(&pBlockCache->mutex);
+
+  SBlockCacheNode *pNode = pBlockCache->head;
+  while (pNode) {
+    SBlockCacheNode *pNext = pNode->next;
+    if (pNode->key.vnode == vnode && (fileId < 0 || pNode->key.fileId == fileId)) {
+      vnodeRemoveBlockCacheNode(pNode);
+      numOfRemoved++;
+    }
+    pNode = pNext;
+  }
+
+  pthread_mutex_unlock(&pBlockCache->mutex);
+
+  dTrace("vid:%d fileId:%d, %ld columns are removed from query block cache", vnode, fileId, numOfRemoved);
+}
+
+void vnodeGetBlockCacheStatis(int64_t *hits, int64_t *misses, int64_t *usedBytes) {
+  *hits = 0;
+  *misses = 0;
+  *usedBytes = 0;
+
+  if (pBlockCache == NULL) {
+    return;
+  }
+
+  pthread_mutex_lock(&pBlockCache->mutex);
+  *hits = pBlockCache->hits;
+  *misses = pBlockCache->misses;
+  *usedBytes = pBlockCache->usedBytes;
+  pthread_mutex_unlock(&pBlockCache->mutex);
+}
@@ -25,6 +25,49 @@
 void vnodeSearchPointInCache(SMeterObj *pObj, SQuery *pQuery);
 void vnodeProcessCommitTimer(void *param, void *tmrId);
 
+static void vnodePushFreeCacheBlock(SCachePool *pPool, int32_t index) {
+  int64_t oldHead, newHead;
+
+  do {
+    oldHead = atomic_load_64(&pPool->freeHead);
+    pPool->freeNext[index] = (int32_t)(oldHead & 0xFFFFFFFF) - 1;
+    newHead = (((oldHead >> 32) + 1) << 32) | (index + 1);
+  } while (atomic_val_compare_exchange_64(&pPool->freeHead, oldHead, newHead) != oldHead);
+}
+
+static int32_t vnodePopFreeCacheBlock(SCachePool *pPool) {
+  int64_t oldHead, newHead;
+  int32_t index;
+
+  do {
+    oldHead = atomic_load_64(&pPool->freeHead);
+    index = (int32_t)(oldHead & 0xFFFFFFFF) - 1;
+    if (index < 0) return -1;
+
+    newHead = (((oldHead >> 32) + 1) << 32) | (pPool->freeNext[index] + 1);
+  } while (atomic_val_compare_exchange_64(&pPool->freeHead, oldHead, newHead) != oldHead);
+
+  return index;
+}
+
+/*
+ * currentSlot and numOfBlocks are only changed with the pool mutex locked, the version is increased before and after
+ * the change, so readers get a consistent snapshot without acquiring the pool mutex.
+ */
+static FORCE_INLINE void vnodeBeginCacheInfoUpdate(SCacheInfo *pInfo) { atomic_add_fetch_32(&pInfo->version, 1); }
+static FORCE_INLINE void vnodeEndCacheInfoUpdate(SCacheInfo *pInfo) { atomic_add_fetch_32(&pInfo->version, 1); }
+
+void vnodeGetCacheInfoSnapshot(SCacheInfo *pInfo, int32_t *currentSlot, int32_t *numOfBlocks) {
+  while (1) {
+    uint32_t version = atomic_load_32(&pInfo->version);
+    if (version & 1) continue;
+
+    *currentSlot = atomic_load_32(&pInfo->currentSlot);
+    *numOfBlocks = atomic_load_32(&pInfo->numOfBlocks);
+    if (atomic_load_32(&pInfo->version) == version) break;
+  }
+}
+
 void *vnodeOpenCachePool(int vnode) {
   SCachePool *pCachePool;
   SVnodeCfg * pCfg = &vnodeList[vnode].cfg;
@@ -53,12 +96,23 @@ void *vnodeOpenCachePool(int vnode) {
   }
 
   memset(pCachePool->pMem, 0, size);
+
+  pCachePool->freeNext = malloc(sizeof(int32_t) * pCfg->cacheNumOfBlocks.totalBlocks);
+  if (pCachePool->freeNext == NULL) {
+    dError("no memory to allocate cache free list!");
+    pthread_mutex_destroy(&(pCachePool->vmutex));
+    tfree(pCachePool->pMem);
+    tfree(pCachePool);
+    return NULL;
+  }
+
   pCachePool->threshold = pCfg->cacheNumOfBlocks.totalBlocks * 0.6;
 
   int maxAllocBlock = (1024 * 1024 * 1024) / pCfg->cacheBlockSize;
   if (maxAllocBlock < 1) {
     dError("Cache block size is too large");
     pthread_mutex_destroy(&(pCachePool->vmutex));
+    tfree(pCachePool->freeNext);
     tfree(pCachePool->pMem);
     tfree(pCachePool);
     return NULL;
@@ -78,6 +132,11 @@ void *vnodeOpenCachePool(int vnode) {
     }
   }
 
+  // the first block is on the top of the free stack
+  for (blockId = pCfg->cacheNumOfBlocks.totalBlocks - 1; blockId >= 0; --blockId) {
+    vnodePushFreeCacheBlock(pCachePool, blockId);
+  }
+
   dPrint("vid:%d, cache pool is allocated:0x%x", vnode, pCachePool);
 
   return pCachePool;
@@ -90,6 +149,7 @@ _err_exit:
     tfree(pCachePool->pMem[blockId]);
     blockId = blockId + (MIN(maxAllocBlock, pCfg->cacheNumOfBlocks.totalBlocks - blockId));
   }
+  tfree(pCachePool->freeNext);
   tfree(pCachePool->pMem);
   tfree(pCachePool);
   return NULL;
@@ -110,6 +170,7 @@ void vnodeCloseCachePool(int vnode) {
     tfree(pCachePool->pMem[blockId]);
     blockId = blockId + (MIN(maxAllocBlock, pVnode->cfg.cacheNumOfBlocks.totalBlocks - blockId));
   }
+  tfree(pCachePool->freeNext);
   tfree(pCachePool->pMem);
   pthread_mutex_destroy(&(pCachePool->vmutex));
   tfree(pCachePool);
@@ -159,18 +220,22 @@ int vnodeFreeCacheBlock(SCacheBlock *pCacheBlock) {
   pInfo = (SCacheInfo *)pObj->pCache;
 
   if (pObj) {
+    vnodeBeginCacheInfoUpdate(pInfo);
     pInfo->numOfBlocks--;
+    vnodeEndCacheInfoUpdate(pInfo);
 
     if (pInfo->numOfBlocks < 0) {
       dError("vid:%d sid:%d id:%s, numOfBlocks:%d shall never be negative", pObj->vnode, pObj->sid, pObj->meterId,
            pInfo->numOfBlocks);
     }
 
-    if (pCacheBlock->blockId == 0) {
+    int32_t doubleFree = (pCacheBlock->blockId == 0);
+    if (doubleFree) {
       dError("vid:%d sid:%d id:%s, double free", pObj->vnode, pObj->sid, pObj->meterId);
     }
 
     SCachePool *pPool = (SCachePool *)vnodeList[pObj->vnode].pCachePool;
+    int32_t     index = pCacheBlock->index;
     if (pCacheBlock->notFree) {
       pPool->notFreeSlots--;
       pInfo->unCommittedBlocks--;
@@ -183,6 +248,7 @@ int vnodeFreeCacheBlock(SCacheBlock *pCacheBlock) {
            pPool->notFreeSlots);
 
     memset(pCacheBlock, 0, sizeof(SCacheBlock));
+    if (!doubleFree) vnodePushFreeCacheBlock(pPool, index);
 
   } else {
     dError("BUG, pObj is null");
@@ -340,6 +406,8 @@ void vnodeCommitOver(SVnodeObj *pVnode) {
   dTrace("vid:%d, commit is over, notFreeSlots:%d", pPool->vnode, pPool->notFreeSlots);
 
   pthread_mutex_unlock(&pPool->vmutex);
+
+  vnodeResumePendingSubmits(pPool->vnode);
 }
 
 static void vnodeWaitForCommitComplete(SVnodeObj *pVnode) {
@@ -378,13 +446,15 @@ SCacheBlock *vnodeGetFreeCacheBlock(SVnodeObj *pVnode) {
   SCachePool  *pPool = (SCachePool *)(pVnode->pCachePool);
   SVnodeCfg   *pCfg = &(pVnode->cfg);
   SCacheBlock *pCacheBlock = NULL;
+  int32_t      index = -1;
   int skipped = 0;
 
-  while (1) {
+  // no free block in the stack, release the committed blocks of other meters
+  while ((index = vnodePopFreeCacheBlock(pPool)) < 0) {
     pCacheBlock = (SCacheBlock *)(pPool->pMem[((int64_t)pPool->freeSlot)]);
-    if (pCacheBlock->blockId == 0) break;
 
-    if (pCacheBlock->notFree) {
+    // a free block is either in the stack, or taken by a writer without the lock
+    if (pCacheBlock->blockId == 0 || pCacheBlock->notFree) {
       pPool->freeSlot++;
       pPool->freeSlot = pPool->freeSlot % pCfg->cacheNumOfBlocks.totalBlocks;
       skipped++;
@@ -400,9 +470,8 @@ SCacheBlock *vnodeGetFreeCacheBlock(SVnodeObj *pVnode) {
       int firstSlot = (pRelInfo->currentSlot - pRelInfo->numOfBlocks + 1 + pRelInfo->maxBlocks) % pRelInfo->maxBlocks;
       pCacheBlock = pRelInfo->cacheBlocks[firstSlot];
       if (pCacheBlock) {
-        pPool->freeSlot = pCacheBlock->index;
+        // the released block is pushed into the free stack
         vnodeFreeCacheBlock(pCacheBlock);
-        break;
       } else {
         pPool->freeSlot = (pPool->freeSlot + 1) % pCfg->cacheNumOfBlocks.totalBlocks;
         skipped++;
@@ -410,15 +479,26 @@ SCacheBlock *vnodeGetFreeCacheBlock(SVnodeObj *pVnode) {
     }
   }
 
-  pCacheBlock = (SCacheBlock *)(pPool->pMem[pPool->freeSlot]);
-  pCacheBlock->index = pPool->freeSlot;
+  pCacheBlock = (SCacheBlock *)(pPool->pMem[index]);
+  pCacheBlock->index = index;
   pCacheBlock->notFree = 1;
-  pPool->freeSlot = (pPool->freeSlot + 1) % pCfg->cacheNumOfBlocks.totalBlocks;
   pPool->notFreeSlots++;
 
   return pCacheBlock;
 }
 
+static void vnodeReturnCacheBlock(SCachePool *pPool, SCacheBlock *pCacheBlock) {
+  int32_t index = pCacheBlock->index;
+  memset(pCacheBlock, 0, sizeof(SCacheBlock));
+  vnodePushFreeCacheBlock(pPool, index);
+}
+
+static void vnodeSetCacheBlockOffset(SMeterObj *pObj, SCacheBlock *pCacheBlock) {
+  pCacheBlock->offset[0] = ((char *)(pCacheBlock)) + sizeof(SCacheBlock) + pObj->numOfColumns * sizeof(char *);
+  for (int col = 1; col < pObj->numOfColumns; ++col)
+    pCacheBlock->offset[col] = pCacheBlock->offset[col - 1] + pObj->schema[col - 1].bytes * pObj->pointsPerBlock;
+}
+
 int vnodeAllocateCacheBlock(SMeterObj *pObj) {
   int          index;
   SCachePool * pPool;
@@ -433,9 +513,21 @@ int vnodeAllocateCacheBlock(SMeterObj *pObj) {
   SVnodeCfg *pCfg = &(vnodeList[pObj->vnode].cfg);
 
   if (pPool == NULL) return -1;
+
+  // take a block from the free stack and prepare it before acquiring the lock
+  pCacheBlock = NULL;
+  index = vnodePopFreeCacheBlock(pPool);
+  if (index >= 0) {
+    pCacheBlock = (SCacheBlock *)(pPool->pMem[(int64_t)index]);
+    pCacheBlock->index = index;
+    pCacheBlock->pMeterObj = pObj;
+    vnodeSetCacheBlockOffset(pObj, pCacheBlock);
+  }
+
   pthread_mutex_lock(&pPool->vmutex);
 
   if (pInfo == NULL || pInfo->cacheBlocks == NULL) {
+    if (pCacheBlock) vnodeReturnCacheBlock(pPool, pCacheBlock);
     pthread_mutex_unlock(&pPool->vmutex);
     dError("vid:%d sid:%d id:%s, meter is not there", pObj->vnode, pObj->sid, pObj->meterId);
     return -1;
@@ -447,33 +539,39 @@ int vnodeAllocateCacheBlock(SMeterObj *pObj) {
   }
 
   if (pInfo->unCommittedBlocks >= pInfo->maxBlocks-1) {
+    if (pCacheBlock) vnodeReturnCacheBlock(pPool, pCacheBlock);
     vnodeCreateCommitThread(pVnode);
     pthread_mutex_unlock(&pPool->vmutex);
     dError("vid:%d sid:%d id:%s, all blocks are not committed yet....", pObj->vnode, pObj->sid, pObj->meterId);
     return -1;
   }
 
-  if ((pCacheBlock = vnodeGetFreeCacheBlock(pVnode)) == NULL) return -1;
-
-  index = pCacheBlock->index;
-  pCacheBlock->pMeterObj = pObj;
+  if (pCacheBlock) {
+    pCacheBlock->notFree = 1;
+    pPool->notFreeSlots++;
+  } else {
+    // free stack is empty, committed blocks shall be released with the lock hold
+    if ((pCacheBlock = vnodeGetFreeCacheBlock(pVnode)) == NULL) return -1;
+    index = pCacheBlock->index;
+    pCacheBlock->pMeterObj = pObj;
+    vnodeSetCacheBlockOffset(pObj, pCacheBlock);
+  }
 
-  pCacheBlock->offset[0] = ((char *)(pCacheBlock)) + sizeof(SCacheBlock) + pObj->numOfColumns * sizeof(char *);
-  for (int col = 1; col < pObj->numOfColumns; ++col)
-    pCacheBlock->offset[col] = pCacheBlock->offset[col - 1] + pObj->schema[col - 1].bytes * pObj->pointsPerBlock;
+  // the oldest block is released first, so the version is not nested
+  int32_t slot = (pInfo->currentSlot + 1) % pInfo->maxBlocks;
+  if (pInfo->numOfBlocks + 1 > pInfo->maxBlocks) vnodeFreeCacheBlock(pInfo->cacheBlocks[slot]);
 
-  pInfo->numOfBlocks++;
   pInfo->blocks++;
   pInfo->unCommittedBlocks++;
-  pInfo->currentSlot = (pInfo->currentSlot + 1) % pInfo->maxBlocks;
   pCacheBlock->blockId = pInfo->blocks;
-  pCacheBlock->slot = pInfo->currentSlot;
-  if (pInfo->numOfBlocks > pInfo->maxBlocks) {
-    pCacheBlock = pInfo->cacheBlocks[pInfo->currentSlot];
-    vnodeFreeCacheBlock(pCacheBlock);
-  }
+  pCacheBlock->slot = slot;
+
+  vnodeBeginCacheInfoUpdate(pInfo);
+  pInfo->cacheBlocks[slot] = (SCacheBlock *)(pPool->pMem[(int64_t)index]);
+  pInfo->numOfBlocks++;
+  pInfo->currentSlot = slot;
+  vnodeEndCacheInfoUpdate(pInfo);
 
-  pInfo->cacheBlocks[pInfo->currentSlot] = (SCacheBlock *)(pPool->pMem[(int64_t)index]);
   dTrace("vid:%d sid:%d id:%s, allocate a cache block, numOfBlocks:%d, slot:%d, index:%d notFreeSlots:%d blocks:%d",
          pObj->vnode, pObj->sid, pObj->meterId, pInfo->numOfBlocks, pInfo->currentSlot, index, pPool->notFreeSlots,
          pInfo->blocks);
@@ -518,12 +616,58 @@ int vnodeInsertPointToCache(SMeterObj *pObj, char *pData) {
   }
 
   atomic_fetch_sub_32(&pObj->freePoints, 1);
-  pCacheBlock->numOfPoints++;
+
+  // publish the point after all columns are copied, readers load numOfPoints before accessing the columns
+  atomic_store_16(&pCacheBlock->numOfPoints, pCacheBlock->numOfPoints + 1);
   pPool->count++;
 
   return 0;
 }
 
+/*
+ * copy rows [start, start + rows) of a column-major payload with numOfRows rows into cache, a run of each column is
+ * copied at once. Return the number of rows copied, which is less than rows if no more cache block is available.
+ */
+int vnodeInsertColumnsToCache(SMeterObj *pObj, char *payload, int numOfRows, int start, int rows) {
+  SCacheBlock *pCacheBlock;
+  SCacheInfo * pInfo;
+  SCachePool * pPool;
+  int          copied = 0;
+
+  pInfo = (SCacheInfo *)pObj->pCache;
+  pPool = (SCachePool *)vnodeList[pObj->vnode].pCachePool;
+
+  while (copied < rows) {
+    if (pInfo->numOfBlocks == 0) {
+      if (vnodeAllocateCacheBlock(pObj) < 0) break;
+    }
+
+    if (pInfo->currentSlot < 0) break;
+    pCacheBlock = pInfo->cacheBlocks[pInfo->currentSlot];
+    if (pCacheBlock->numOfPoints >= pObj->pointsPerBlock) {
+      if (vnodeAllocateCacheBlock(pObj) < 0) break;
+      pCacheBlock = pInfo->cacheBlocks[pInfo->currentSlot];
+    }
+
+    int   num = MIN(rows - copied, pObj->pointsPerBlock - pCacheBlock->numOfPoints);
+    char *pCol = payload;
+    for (int col = 0; col < pObj->numOfColumns; ++col) {
+      int bytes = pObj->schema[col].bytes;
+      memcpy(pCacheBlock->offset[col] + pCacheBlock->numOfPoints * bytes, pCol + (start + copied) * bytes, num * bytes);
+      pCol += numOfRows * bytes;
+    }
+
+    atomic_fetch_sub_32(&pObj->freePoints, num);
+
+    // publish the points after all columns are copied
+    atomic_store_16(&pCacheBlock->numOfPoints, pCacheBlock->numOfPoints + num);
+    pPool->count += num;
+    copied += num;
+  }
+
+  return copied;
+}
+
 void vnodeUpdateQuerySlotPos(SCacheInfo *pInfo, SQuery *pQuery) {
   SCacheBlock *pCacheBlock;
 
@@ -573,7 +717,7 @@ int vnodeQueryFromCache(SMeterObj *pObj, SQuery *pQuery) {
 
   step = QUERY_IS_ASC_QUERY(pQuery) ? -1 : 1;
   pCacheBlock = pInfo->cacheBlocks[pQuery->slot];
-  numOfPoints = pCacheBlock->numOfPoints;
+  numOfPoints = atomic_load_16(&pCacheBlock->numOfPoints);
 
   int maxReads = QUERY_IS_ASC_QUERY(pQuery) ? numOfPoints - pQuery->pos : pQuery->pos + 1;
   if (maxReads <= 0) {
@@ -650,7 +794,7 @@ int vnodeQueryFromCache(SMeterObj *pObj, SQuery *pQuery) {
     numOfActualRead = 0;
 
     if (QUERY_IS_ASC_QUERY(pQuery)) {
-      for (int32_t j = startPos; j < pCacheBlock->numOfPoints; ++j) {
+      for (int32_t j = startPos; j < numOfPoints; ++j) {
         TSKEY key = vnodeGetTSInCacheBlock(pCacheBlock, j);
         if (key < startkey || key > endkey) {
           dError("vid:%d sid:%d id:%s, timestamp in cache slot is disordered. slot:%d, pos:%d, ts:%lld, block "
@@ -751,16 +895,12 @@ void vnodeSearchPointInCache(SMeterObj *pObj, SQuery *pQuery) {
   TSKEY        keyFirst, keyLast;
   SCacheBlock *pBlock;
   SCacheInfo * pInfo = (SCacheInfo *)pObj->pCache;
-  SCachePool * pPool = (SCachePool *)vnodeList[pObj->vnode].pCachePool;
 
   pQuery->slot = -1;
   pQuery->pos = -1;
 
   // save these variables first in case it may be changed by write operation
-  pthread_mutex_lock(&pPool->vmutex);
-  numOfBlocks = pInfo->numOfBlocks;
-  lastSlot = pInfo->currentSlot;
-  pthread_mutex_unlock(&pPool->vmutex);
+  vnodeGetCacheInfoSnapshot(pInfo, &lastSlot, &numOfBlocks);
   if (numOfBlocks <= 0) return;
 
   firstSlot = (lastSlot - numOfBlocks + 1 + pInfo->maxBlocks) % pInfo->maxBlocks;
@@ -770,7 +910,7 @@ void vnodeSearchPointInCache(SMeterObj *pObj, SQuery *pQuery) {
   keyFirst = vnodeGetTSInCacheBlock(pBlock, 0);
 
   pBlock = pInfo->cacheBlocks[lastSlot];
-  keyLast = vnodeGetTSInCacheBlock(pBlock, pBlock->numOfPoints - 1);
+  keyLast = vnodeGetTSInCacheBlock(pBlock, atomic_load_16(&pBlock->numOfPoints) - 1);
 
   pQuery->blockId = pBlock->blockId;
   pQuery->currentSlot = lastSlot;
@@ -905,7 +1045,6 @@ void vnodeSearchPointInCache(SMeterObj *pObj, SQuery *pQuery) {
 
 void vnodeSetCommitQuery(SMeterObj *pObj, SQuery *pQuery) {
   SCacheInfo *pInfo = (SCacheInfo *)pObj->pCache;
-  SCachePool *pPool = (SCachePool *)vnodeList[pObj->vnode].pCachePool;
   SVnodeObj * pVnode = vnodeList + pObj->vnode;
 
   pQuery->order.order = TSQL_SO_ASC;
@@ -931,10 +1070,7 @@ void vnodeSetCommitQuery(SMeterObj *pObj, SQuery *pQuery) {
   pQuery->pos = pInfo->commitPoint;
   pQuery->over = 0;
 
-  pthread_mutex_lock(&pPool->vmutex);
-  pQuery->currentSlot = pInfo->currentSlot;
-  pQuery->numOfBlocks = pInfo->numOfBlocks;
-  pthread_mutex_unlock(&pPool->vmutex);
+  vnodeGetCacheInfoSnapshot(pInfo, &pQuery->currentSlot, &pQuery->numOfBlocks);
 
   if (pQuery->numOfBlocks <= 0 || pQuery->firstSlot < 0) {
     pQuery->over = 1;
@@ -1105,7 +1241,9 @@ int vnodeSyncRestoreCache(int vnode, int fd) {
     if (vnodeList[pObj->vnode].lastKeyOnFile < pObj->lastKeyOnFile)
       vnodeList[pObj->vnode].lastKeyOnFile = pObj->lastKeyOnFile;
 
+    vnodeBeginCacheInfoUpdate(pInfo);
     pInfo->currentSlot = -1;
+    vnodeEndCacheInfoUpdate(pInfo);
     pInfo->commitSlot = 0;
     memset(pInfo->cacheBlocks, 0, sizeof(SCacheBlock *) * pInfo->maxBlocks);
     blocksReceived = 0;
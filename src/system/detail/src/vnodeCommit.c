@@ -28,6 +28,47 @@ typedef struct {
   int  simpleCheck:24;
 } SCommitHead;
 
+#define TSDB_CLOG_LATENCY_BUCKETS 16  // bucket i counts the batches synced in less than (128 << i) us
+#define TSDB_CLOG_MAX_IOV         1020
+
+typedef struct _clog_entry {
+  struct _clog_entry *next;
+  int64_t             offset;  // offset in log file
+  uint64_t            lsn;
+  SCommitHead         head;
+  int                 simpleCheck;
+  int                 contLen;
+  char                cont[];
+} SCommitLogEntry;
+
+typedef struct {
+  SVnodeObj *      pVnode;
+  int              stop;
+  int              urgent;
+  pthread_t        thread;
+  pthread_mutex_t  mutex;
+  pthread_cond_t   dataReady;  // signal the writer thread
+  pthread_cond_t   synced;     // broadcast to writers waiting for durable lsn
+  SCommitLogEntry *pHead;
+  SCommitLogEntry *pTail;
+  int64_t          pendingBytes;
+  int64_t          firstPendingUs;
+  uint64_t         lastLsn;
+  uint64_t         durableLsn;
+  uint64_t         failedLsn;  // last lsn of the latest batch failed to be written
+
+  int64_t batches;
+  int64_t entries;
+  int64_t bytes;
+  int64_t latency[TSDB_CLOG_LATENCY_BUCKETS];
+} SCommitLogSync;
+
+static int   vnodeOpenCommitLogSync(SVnodeObj *pVnode);
+static void  vnodeCloseCommitLogSync(SVnodeObj *pVnode);
+static void  vnodeSyncCommitLog(SVnodeObj *pVnode);
+static int   vnodeWriteToCommitLogSync(SVnodeObj *pVnode, SCommitHead *pHead, char *cont, int contLen);
+static void *vnodeCommitLogSyncThread(void *param);
+
 int vnodeOpenCommitLog(int vnode, uint64_t firstV) {
   SVnodeObj *pVnode = vnodeList + vnode;
   char *     fileName = pVnode->logFn;
@@ -81,6 +122,9 @@ int vnodeRenewCommitLog(int vnode) {
 
   pthread_mutex_lock(&(pVnode->logMutex));
 
+  // all reserved space shall be written and synced before the log file is renamed
+  vnodeSyncCommitLog(pVnode);
+
   if (FD_VALID(pVnode->logFd)) {
     munmap(pVnode->pMem, pVnode->mappingSize);
     close(pVnode->logFd);
@@ -147,7 +191,8 @@ size_t vnodeRestoreDataFromLog(int vnode, char *fileName, uint64_t *firstV) {
     simpleCheck = head.simpleCheck;
 
     // head.contLen validation is removed
-    if (head.sid >= pVnode->cfg.maxSessions || head.sid < 0 || head.action >= TSDB_ACTION_MAX) {
+    if (head.sid >= pVnode->cfg.maxSessions || head.sid < 0 || head.action >= TSDB_ACTION_MAX ||
+        vnodeProcessAction[head.action] == NULL) {
       dError("vid, invalid commit head, sid:%d contLen:%d action:%d", head.sid, head.contLen, head.action);
     } else {
       if (head.contLen > 0) {
@@ -235,6 +280,12 @@ int vnodeInitCommit(int vnode) {
   }
 
   pVnode->pWrite += size;
+
+  if (pVnode->cfg.commitLog == TSDB_COMMIT_LOG_SYNC && vnodeOpenCommitLogSync(pVnode) < 0) {
+    dError("vid:%d, commit log sync thread init failed", vnode);
+    return -1;
+  }
+
   dPrint("vid:%d, commit log is initialized", vnode);
 
   return 0;
@@ -243,6 +294,7 @@ int vnodeInitCommit(int vnode) {
 void vnodeCleanUpCommit(int vnode) {
   SVnodeObj *pVnode = vnodeList + vnode;
 
+  vnodeCloseCommitLogSync(pVnode);
   if (FD_VALID(pVnode->logFd)) close(pVnode->logFd);
 
   if (pVnode->cfg.commitLog && (pVnode->logFd > 0 && remove(pVnode->logFn) < 0)) {
@@ -265,6 +317,19 @@ int vnodeWriteToCommitLog(SMeterObj *pObj, char action, char *cont, int contLen,
   head.simpleCheck = (head.sversion+head.sid+head.contLen+head.action) & 0xFFFFFF;
   int simpleCheck = head.simpleCheck;
 
+  if (pVnode->pLogSync != NULL) {
+    int code = vnodeWriteToCommitLogSync(pVnode, &head, cont, contLen);
+    if (code != TSDB_CODE_SUCCESS) return code;
+
+    if (pVnode->pWrite - pVnode->pMem > pVnode->mappingThreshold) {
+      dTrace("vid:%d, mem mapping is close to limit, commit", pObj->vnode);
+      vnodeProcessCommitTimer(pVnode, NULL);
+    }
+
+    dTrace("vid:%d sid:%d, data is appended to commit log", pObj->vnode, pObj->sid);
+    return 0;
+  }
+
   pthread_mutex_lock(&(pVnode->logMutex));
   // 100 bytes redundant mem space
   if (pVnode->mappingSize - (pVnode->pWrite - pVnode->pMem) < contLen + sizeof(SCommitHead) + sizeof(simpleCheck) + 100) {
@@ -289,3 +354,298 @@ int vnodeWriteToCommitLog(SMeterObj *pObj, char action, char *cont, int contLen,
 
   return 0;
 }
+
+static int vnodeOpenCommitLogSync(SVnodeObj *pVnode) {
+  pthread_attr_t  thattr;
+  SCommitLogSync *pSync = calloc(1, sizeof(SCommitLogSync));
+  if (pSync == NULL) return -1;
+
+  pSync->pVnode = pVnode;
+  pthread_mutex_init(&pSync->mutex, NULL);
+  pthread_cond_init(&pSync->dataReady, NULL);
+  pthread_cond_init(&pSync->synced, NULL);
+
+  pthread_attr_init(&thattr);
+  pthread_attr_setdetachstate(&thattr, PTHREAD_CREATE_JOINABLE);
+  if (pthread_create(&pSync->thread, &thattr, vnodeCommitLogSyncThread, pSync) != 0) {
+    dError("vid:%d, failed to create commit log sync thread, reason:%s", pVnode->vnode, strerror(errno));
+    pthread_attr_destroy(&thattr);
+    pthread_cond_destroy(&pSync->synced);
+    pthread_cond_destroy(&pSync->dataReady);
+    pthread_mutex_destroy(&pSync->mutex);
+    free(pSync);
+    return -1;
+  }
+
+  pthread_attr_destroy(&thattr);
+  pVnode->pLogSync = pSync;
+
+  dTrace("vid:%d, commit log sync thread is created, window:%dms bytes:%d", pVnode->vnode, tsCommitLogSyncWindow,
+         tsCommitLogSyncBytes);
+  return 0;
+}
+
+static void vnodePrintCommitLogSyncStat(SCommitLogSync *pSync) {
+  char    buf[512] = {0};
+  int     len = 0;
+  int64_t upper = 128;
+
+  for (int i = 0; i < TSDB_CLOG_LATENCY_BUCKETS; ++i, upper <<= 1) {
+    if (pSync->latency[i] == 0) continue;
+    len += snprintf(buf + len, sizeof(buf) - len, " <%ld:%ld", upper, pSync->latency[i]);
+    if (len >= sizeof(buf)) break;
+  }
+
+  dPrint("vid:%d, commit log sync batches:%ld entries:%ld bytes:%ld, batch latency(us):%s", pSync->pVnode->vnode,
+         pSync->batches, pSync->entries, pSync->bytes, buf);
+}
+
+static void vnodeCloseCommitLogSync(SVnodeObj *pVnode) {
+  SCommitLogSync *pSync = (SCommitLogSync *)pVnode->pLogSync;
+  if (pSync == NULL) return;
+
+  pthread_mutex_lock(&pSync->mutex);
+  pSync->stop = 1;
+  pthread_cond_signal(&pSync->dataReady);
+  pthread_mutex_unlock(&pSync->mutex);
+
+  // the sync thread flushes all pending entries before it quits
+  pthread_join(pSync->thread, NULL);
+  vnodePrintCommitLogSyncStat(pSync);
+
+  pVnode->pLogSync = NULL;
+  pthread_cond_destroy(&pSync->synced);
+  pthread_cond_destroy(&pSync->dataReady);
+  pthread_mutex_destroy(&pSync->mutex);
+  free(pSync);
+}
+
+/*
+ * wait until all entries reserved in commit log are written and synced, logMutex shall be locked by caller,
+ * so no more entries can be appended during the waiting
+ */
+static void vnodeSyncCommitLog(SVnodeObj *pVnode) {
+  SCommitLogSync *pSync = (SCommitLogSync *)pVnode->pLogSync;
+  if (pSync == NULL) return;
+
+  pthread_mutex_lock(&pSync->mutex);
+  while (pSync->durableLsn < pSync->lastLsn) {
+    pSync->urgent = 1;
+    pthread_cond_signal(&pSync->dataReady);
+    pthread_cond_wait(&pSync->synced, &pSync->mutex);
+  }
+  vnodePrintCommitLogSyncStat(pSync);
+  pthread_mutex_unlock(&pSync->mutex);
+}
+
+/*
+ * the entry is appended to the pending batch only, the writer calls vnodeWaitForCommitLog once after all blocks of a
+ * submit are appended, so a submit of many meters waits for one sync instead of one for each meter
+ */
+static int vnodeWriteToCommitLogSync(SVnodeObj *pVnode, SCommitHead *pHead, char *cont, int contLen) {
+  SCommitLogSync * pSync = (SCommitLogSync *)pVnode->pLogSync;
+  SCommitLogEntry *pEntry = malloc(sizeof(SCommitLogEntry) + contLen);
+  int              totalLen = sizeof(SCommitHead) + contLen + sizeof(pEntry->simpleCheck);
+
+  if (pEntry == NULL) {
+    dError("vid:%d, failed to allocate commit log entry, len:%d", pVnode->vnode, contLen);
+    return TSDB_CODE_SERV_OUT_OF_MEMORY;
+  }
+
+  pEntry->next = NULL;
+  pEntry->head = *pHead;
+  pEntry->simpleCheck = pHead->simpleCheck;
+  pEntry->contLen = contLen;
+  memcpy(pEntry->cont, cont, contLen);
+
+  // reserve the space under logMutex, so the offset order is the same as the lsn order
+  pthread_mutex_lock(&(pVnode->logMutex));
+  if (pVnode->mappingSize - (pVnode->pWrite - pVnode->pMem) < totalLen + 100) {
+    pthread_mutex_unlock(&(pVnode->logMutex));
+    free(pEntry);
+    dTrace("vid:%d, mem mapping space is not enough, wait for commit", pVnode->vnode);
+    vnodeProcessCommitTimer(pVnode, NULL);
+    return TSDB_CODE_ACTION_IN_PROGRESS;
+  }
+
+  pEntry->offset = pVnode->pWrite - pVnode->pMem;
+  pVnode->pWrite += totalLen;
+
+  pthread_mutex_lock(&pSync->mutex);
+  pEntry->lsn = ++pSync->lastLsn;
+  if (pSync->pTail) {
+    pSync->pTail->next = pEntry;
+  } else {
+    pSync->pHead = pEntry;
+    pSync->firstPendingUs = taosGetTimestampUs();
+    pthread_cond_signal(&pSync->dataReady);
+  }
+  pSync->pTail = pEntry;
+  pSync->pendingBytes += totalLen;
+  if (pSync->pendingBytes >= tsCommitLogSyncBytes) pthread_cond_signal(&pSync->dataReady);
+  pthread_mutex_unlock(&pSync->mutex);
+
+  pthread_mutex_unlock(&(pVnode->logMutex));
+
+  return TSDB_CODE_SUCCESS;
+}
+
+uint64_t vnodeGetCommitLogLsn(SVnodeObj *pVnode) {
+  SCommitLogSync *pSync = (SCommitLogSync *)pVnode->pLogSync;
+  if (pSync == NULL) return 0;
+
+  pthread_mutex_lock(&pSync->mutex);
+  uint64_t lsn = pSync->lastLsn;
+  pthread_mutex_unlock(&pSync->mutex);
+
+  return lsn;
+}
+
+/*
+ * wait until the entries appended after startLsn, which is got by vnodeGetCommitLogLsn before appending, are durable.
+ * It fails if any batch holding these entries fails.
+ */
+int vnodeWaitForCommitLog(SVnodeObj *pVnode, uint64_t startLsn) {
+  SCommitLogSync *pSync = (SCommitLogSync *)pVnode->pLogSync;
+  if (pSync == NULL) return TSDB_CODE_SUCCESS;
+
+  pthread_mutex_lock(&pSync->mutex);
+  uint64_t lsn = pSync->lastLsn;
+  if (lsn <= startLsn) {  // nothing is appended
+    pthread_mutex_unlock(&pSync->mutex);
+    return TSDB_CODE_SUCCESS;
+  }
+
+  while (pSync->durableLsn < lsn) {
+    pthread_cond_wait(&pSync->synced, &pSync->mutex);
+  }
+  int code = (pSync->failedLsn > startLsn) ? TSDB_CODE_INVALID_COMMIT_LOG : TSDB_CODE_SUCCESS;
+  pthread_mutex_unlock(&pSync->mutex);
+
+  return code;
+}
+
+static int32_t vnodeWriteCommitLogBatch(SVnodeObj *pVnode, SCommitLogEntry *pEntry) {
+  struct iovec iov[TSDB_CLOG_MAX_IOV];
+  int          iovcnt = 0;
+  int64_t      offset = 0;
+  int64_t      len = 0;
+
+  while (pEntry) {
+    if (iovcnt == 0) {
+      offset = pEntry->offset;
+      len = 0;
+    }
+
+    iov[iovcnt].iov_base = &pEntry->head;
+    iov[iovcnt++].iov_len = sizeof(SCommitHead);
+    iov[iovcnt].iov_base = pEntry->cont;
+    iov[iovcnt++].iov_len = pEntry->contLen;
+    iov[iovcnt].iov_base = &pEntry->simpleCheck;
+    iov[iovcnt++].iov_len = sizeof(pEntry->simpleCheck);
+    len += sizeof(SCommitHead) + pEntry->contLen + sizeof(pEntry->simpleCheck);
+
+    SCommitLogEntry *pNext = pEntry->next;
+
+    // flush if the iov array is full or the next entry is not adjacent
+    if (pNext == NULL || iovcnt + 3 > TSDB_CLOG_MAX_IOV || pNext->offset != offset + len) {
+      int64_t written = 0;
+      int     start = 0;
+
+      while (written < len) {
+        ssize_t ret = pwritev(pVnode->logFd, iov + start, iovcnt - start, offset + written);
+        if (ret < 0) {
+          if (errno == EINTR) continue;
+          dError("vid:%d, failed to write commit log, offset:%ld len:%ld, reason:%s", pVnode->vnode, offset, len,
+                 strerror(errno));
+          return TSDB_CODE_INVALID_COMMIT_LOG;
+        }
+
+        // partial write, skip the written part of iov
+        written += ret;
+        while (ret > 0 && ret >= iov[start].iov_len) ret -= iov[start++].iov_len;
+        if (ret > 0) {
+          iov[start].iov_base = (char *)iov[start].iov_base + ret;
+          iov[start].iov_len -= ret;
+        }
+      }
+
+      iovcnt = 0;
+    }
+
+    pEntry = pNext;
+  }
+
+  if (fdatasync(pVnode->logFd) < 0) {
+    dError("vid:%d, failed to sync commit log, reason:%s", pVnode->vnode, strerror(errno));
+    return TSDB_CODE_INVALID_COMMIT_LOG;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static void *vnodeCommitLogSyncThread(void *param) {
+  SCommitLogSync *pSync = (SCommitLogSync *)param;
+  SVnodeObj *     pVnode = pSync->pVnode;
+
+  pthread_mutex_lock(&pSync->mutex);
+
+  while (1) {
+    while (!pSync->stop && pSync->pHead == NULL) {
+      pthread_cond_wait(&pSync->dataReady, &pSync->mutex);
+    }
+
+    if (pSync->pHead == NULL) break;
+
+    // gather more entries until the window expires or enough bytes are pending
+    while (!pSync->stop && !pSync->urgent && pSync->pendingBytes < tsCommitLogSyncBytes) {
+      int64_t deadline = pSync->firstPendingUs + tsCommitLogSyncWindow * 1000L;
+      if (taosGetTimestampUs() >= deadline) break;
+
+      struct timespec ts;
+      ts.tv_sec = deadline / 1000000;
+      ts.tv_nsec = (deadline % 1000000) * 1000;
+      pthread_cond_timedwait(&pSync->dataReady, &pSync->mutex, &ts);
+    }
+
+    SCommitLogEntry *pBatch = pSync->pHead;
+    int64_t          firstPendingUs = pSync->firstPendingUs;
+    int64_t          bytes = pSync->pendingBytes;
+    uint64_t         lastLsn = pSync->pTail->lsn;
+
+    pSync->pHead = NULL;
+    pSync->pTail = NULL;
+    pSync->pendingBytes = 0;
+    pSync->urgent = 0;
+    pthread_mutex_unlock(&pSync->mutex);
+
+    int32_t code = vnodeWriteCommitLogBatch(pVnode, pBatch);
+
+    pthread_mutex_lock(&pSync->mutex);
+
+    int64_t num = 0;
+    while (pBatch) {
+      SCommitLogEntry *pNext = pBatch->next;
+      free(pBatch);
+      pBatch = pNext;
+      num++;
+    }
+
+    int64_t elapsed = taosGetTimestampUs() - firstPendingUs;
+    int     bucket = 0;
+    while (bucket < TSDB_CLOG_LATENCY_BUCKETS - 1 && elapsed >= (128L << bucket)) bucket++;
+
+    pSync->latency[bucket]++;
+    pSync->batches++;
+    pSync->entries += num;
+    pSync->bytes += bytes;
+    pSync->durableLsn = lastLsn;
+    if (code != TSDB_CODE_SUCCESS) pSync->failedLsn = lastLsn;
+    pthread_cond_broadcast(&pSync->synced);
+  }
+
+  pthread_mutex_unlock(&pSync->mutex);
+  dTrace("vid:%d, commit log sync thread quits", pVnode->vnode);
+
+  return NULL;
+}
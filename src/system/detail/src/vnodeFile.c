@@ -19,6 +19,7 @@
 #include "tscompression.h"
 #include "tutil.h"
 #include "vnode.h"
+#include "vnodeBlockCache.h"
 #include "vnodeFile.h"
 #include "vnodeUtil.h"
 
@@ -26,32 +27,6 @@
 
 const int16_t vnodeFileVersion = 0;
 
-int (*pCompFunc[])(const char *const input, int inputSize, const int elements, char *const output, int outputSize,
-                   char algorithm, char *const buffer, int bufferSize) = {NULL,
-                                          tsCompressBool,
-                                          tsCompressTinyint,
-                                          tsCompressSmallint,
-                                          tsCompressInt,
-                                          tsCompressBigint,
-                                          tsCompressFloat,
-                                          tsCompressDouble,
-                                          tsCompressString,
-                                          tsCompressTimestamp,
-                                          tsCompressString};
-
-int (*pDecompFunc[])(const char *const input, int compressedSize, const int elements, char *const output,
-                     int outputSize, char algorithm, char *const buffer, int bufferSize) = {NULL,
-                                                            tsDecompressBool,
-                                                            tsDecompressTinyint,
-                                                            tsDecompressSmallint,
-                                                            tsDecompressInt,
-                                                            tsDecompressBigint,
-                                                            tsDecompressFloat,
-                                                            tsDecompressDouble,
-                                                            tsDecompressString,
-                                                            tsDecompressTimestamp,
-                                                            tsDecompressString};
-
 int vnodeUpdateFileMagic(int vnode, int fileId);
 int vnodeRecoverCompHeader(int vnode, int fileId);
 int vnodeRecoverHeadFile(int vnode, int fileId);
@@ -426,6 +401,8 @@ void vnodeRemoveFile(int vnode, int fileId) {
   remove(dDataName);
   remove(dLastName);
 
+  vnodeInvalidateBlockCache(vnode, fileId);
+
   dPrint("vid:%d fileId:%d on disk: %s is removed, numOfFiles:%d maxFiles:%d", vnode, fileId, path,
          pVnode->numOfFiles, pVnode->maxFiles);
 }
@@ -475,6 +452,7 @@ void vnodeCloseCommitFiles(SVnodeObj *pVnode) {
   pthread_mutex_unlock(&(pVnode->vmutex));
 
   pVnode->tfd = 0;
+  vnodeInvalidateBlockCache(pVnode->vnode, pVnode->commitFileId);
 
   dTrace("vid:%d, %s and %s is saved", pVnode->vnode, pVnode->cfn, pVnode->lfn);
   vnodeAdustVnodeFile(pVnode);
@@ -484,6 +462,385 @@ void vnodeCloseCommitFiles(SVnodeObj *pVnode) {
 }
 
 void vnodeBroadcastStatusToUnsyncedPeer(SVnodeObj *pVnode);
+static int vnodeCompressBlockColumns(SMeterObj *pObj, SData *data[], SData *cdata[], int points, SField *fields,
+                                     int32_t offset, char compression);
+
+typedef struct {
+  int32_t len;        // length of the whole block, SField part included
+  int32_t points;
+  int32_t newPoints;  // points read from cache, the points merged from the last block are excluded
+  TSKEY   keyFirst;
+  TSKEY   keyLast;
+  char *  pData;  // SField part followed by all columns, checksum appended
+} SCommitBlock;
+
+typedef struct {
+  SMeterObj *      pObj;
+  SQuery           query;
+  SColumnInfoEx    colList[TSDB_MAX_COLUMNS];
+  SSqlFunctionExpr pExprs[TSDB_MAX_COLUMNS];
+  SData *          data[TSDB_MAX_COLUMNS];
+  SData *          cdata[TSDB_MAX_COLUMNS];
+  char *           dmem;
+  char *           cmem;
+  char             compression;
+  int32_t          pointsReadLast;
+  int32_t          copyLast;  // the old last block is copied by the writer, not merged into the new block
+  int32_t          numOfBlocks;
+  int32_t          maxBlocks;
+  SCommitBlock *   pBlocks;
+  int32_t          code;
+  tsem_t           done;
+} SCommitJob;
+
+static int vnodeAddCommitBlock(SCommitJob *pJob, int32_t points, int32_t newPoints) {
+  SMeterObj *pObj = pJob->pObj;
+  int32_t    size = sizeof(SField) * pObj->numOfColumns + sizeof(TSCKSUM);
+
+  if (pJob->numOfBlocks >= pJob->maxBlocks) {
+    int32_t       maxBlocks = (pJob->maxBlocks == 0) ? 4 : pJob->maxBlocks * 2;
+    SCommitBlock *pBlocks = realloc(pJob->pBlocks, sizeof(SCommitBlock) * maxBlocks);
+    if (pBlocks == NULL) return -1;
+
+    pJob->pBlocks = pBlocks;
+    pJob->maxBlocks = maxBlocks;
+  }
+
+  SField *fields = (SField *)calloc(1, size);
+  if (fields == NULL) return -1;
+
+  int32_t len = vnodeCompressBlockColumns(pObj, pJob->data, pJob->cdata, points, fields, size, pJob->compression);
+  if (len < 0) {
+    tfree(fields);
+    return -1;
+  }
+
+  SCommitBlock *pBlock = pJob->pBlocks + pJob->numOfBlocks;
+  pBlock->pData = malloc(len);
+  if (pBlock->pData == NULL) {
+    tfree(fields);
+    return -1;
+  }
+
+  taosCalcChecksumAppend(0, (uint8_t *)fields, size);
+  memcpy(pBlock->pData, fields, size);
+
+  for (int i = 0; i < pObj->numOfColumns; ++i) {
+    SData *pCol = pJob->compression ? pJob->cdata[i] : pJob->data[i];
+    memcpy(pBlock->pData + fields[i].offset, pCol->data, fields[i].len + sizeof(TSCKSUM));
+  }
+
+  pBlock->len = len;
+  pBlock->points = points;
+  pBlock->newPoints = newPoints;
+  pBlock->keyFirst = *((TSKEY *)(pJob->data[0]->data));
+  pBlock->keyLast = *((TSKEY *)(pJob->data[0]->data + (points - 1) * pObj->schema[0].bytes));
+  pJob->numOfBlocks++;
+
+  tfree(fields);
+  return 0;
+}
+
+static void vnodeFreeCommitBlocks(SCommitJob *pJob) {
+  for (int i = 0; i < pJob->numOfBlocks; ++i) {
+    tfree(pJob->pBlocks[i].pData);
+  }
+
+  pJob->numOfBlocks = 0;
+}
+
+/*
+ * executed by the commit workers: read the points of one meter from cache, and compress them into blocks
+ */
+static void vnodeProcessCommitJob(SSchedMsg *pMsg) {
+  SCommitJob *pJob = (SCommitJob *)pMsg->ahandle;
+  SMeterObj * pObj = pJob->pObj;
+  SQuery *    pQuery = &pJob->query;
+  int64_t     pointsRead = 0;
+  int64_t     pointsReadLast = pJob->pointsReadLast;
+
+  while (pQuery->over == 0) {
+    pointsRead += pointsReadLast;
+
+    while (pointsRead < pObj->pointsPerFileBlock) {
+      pQuery->pointsToRead = pObj->pointsPerFileBlock - pointsRead;
+      pQuery->pointsOffset = pointsRead;
+      pointsRead += vnodeQueryFromCache(pObj, pQuery);
+      if (pQuery->over) break;
+    }
+
+    if (pointsRead == 0) break;
+
+    if (vnodeAddCommitBlock(pJob, pointsRead, pointsRead - pointsReadLast) < 0) {
+      dError("vid:%d sid:%d id:%s, failed to compress block for commit", pObj->vnode, pObj->sid, pObj->meterId);
+      pJob->code = -1;
+      break;
+    }
+
+    if (pointsRead < pObj->pointsPerFileBlock || pQuery->keyIsMet) break;
+
+    pointsRead = 0;
+    pointsReadLast = 0;
+  }
+
+  tsem_post(&pJob->done);
+}
+
+/*
+ * executed by the commit thread before the job is scheduled, the old last block is loaded here, since all file
+ * operations shall be done by the commit thread
+ */
+static int vnodePrepareCommitJob(SVnodeObj *pVnode, SCommitJob *pJob, SMeterObj *pObj, SMeterInfo *pMeter,
+                                 SVnodeHeadInfo *pHeadInfo) {
+  SQuery *pQuery = &pJob->query;
+
+  pJob->pObj = pObj;
+  pJob->compression = pVnode->cfg.compression;
+  pJob->pointsReadLast = 0;
+  pJob->copyLast = 0;
+  pJob->numOfBlocks = 0;
+  pJob->code = 0;
+
+  pJob->data[0] = (SData *)pJob->dmem;
+  pJob->cdata[0] = (SData *)pJob->cmem;
+  for (int col = 1; col < pObj->numOfColumns; ++col) {
+    pJob->data[col] = (SData *)(((char *)pJob->data[col - 1]) + sizeof(SData) +
+                                pObj->pointsPerFileBlock * pObj->schema[col - 1].bytes + EXTRA_BYTES + sizeof(TSCKSUM));
+    pJob->cdata[col] = (SData *)(((char *)pJob->cdata[col - 1]) + sizeof(SData) +
+                                 pObj->pointsPerFileBlock * pObj->schema[col - 1].bytes + EXTRA_BYTES + sizeof(TSCKSUM));
+  }
+
+  memset(pQuery, 0, sizeof(SQuery));
+  pQuery->colList = pJob->colList;
+  pQuery->pSelectExpr = pJob->pExprs;
+
+  pQuery->ekey = pVnode->commitLastKey;
+  pQuery->skey = pVnode->commitFirstKey;
+  pQuery->lastKey = pQuery->skey;
+
+  pQuery->sdata = pJob->data;
+  vnodeSetCommitQuery(pObj, pQuery);
+
+  dTrace("vid:%d sid:%d id:%s, start to commit, startKey:%lld slot:%d pos:%d", pObj->vnode, pObj->sid, pObj->meterId,
+         pObj->lastKeyOnFile, pQuery->slot, pQuery->pos);
+
+  if (pMeter->last) {
+    if ((pMeter->lastBlock.sversion != pObj->sversion) || (pQuery->over)) {
+      pJob->copyLast = 1;
+    } else {
+      // read last block into memory
+      if (vnodeReadLastBlockToMem(pObj, &pMeter->lastBlock, pJob->data) < 0) return -1;
+      pMeter->last = 0;
+      pJob->pointsReadLast = pMeter->lastBlock.numOfPoints;
+      pQuery->over = 0;
+      pHeadInfo->totalStorage -= (pJob->pointsReadLast * pObj->bytesPerPoint);
+
+      dTrace("vid:%d sid:%d id:%s, points:%d in last block will be merged to new block",
+             pObj->vnode, pObj->sid, pObj->meterId, pJob->pointsReadLast);
+    }
+
+    pMeter->changed = 1;
+    pMeter->oldNumOfBlocks--;
+  }
+
+  return 0;
+}
+
+static int vnodeWriteCommitBlock(SMeterObj *pObj, SCompBlock *pCompBlock, SCommitBlock *pBlock) {
+  SVnodeObj *pVnode = &vnodeList[pObj->vnode];
+  int        dfd = pVnode->dfd;
+
+  if (pBlock->points < pObj->pointsPerFileBlock * tsFileBlockMinPercent) {
+    dTrace("vid:%d sid:%d id:%s, points:%d are written to last block, block stime: %ld, block etime: %ld",
+           pObj->vnode, pObj->sid, pObj->meterId, pBlock->points, pBlock->keyFirst, pBlock->keyLast);
+    pCompBlock->last = 1;
+    dfd = pVnode->tfd > 0 ? pVnode->tfd : pVnode->lfd;
+  } else {
+    pCompBlock->last = 0;
+  }
+
+  pCompBlock->offset = lseek(dfd, 0, SEEK_END);
+
+  int wlen = twrite(dfd, pBlock->pData, pBlock->len);
+  if (wlen <= 0) {
+    dError("vid:%d sid:%d id:%s, failed to write block, wlen:%d points:%d reason:%s",
+           pObj->vnode, pObj->sid, pObj->meterId, wlen, pBlock->points, strerror(errno));
+    return vnodeRecoverFromPeer(pVnode, pVnode->commitFileId);
+  }
+
+  pVnode->vnodeStatistic.compStorage += wlen;
+  pVnode->dfSize += wlen;
+
+  pCompBlock->len = wlen;
+  pCompBlock->algorithm = pVnode->cfg.compression;
+  pCompBlock->numOfPoints = pBlock->points;
+  pCompBlock->numOfCols = pObj->numOfColumns;
+  pCompBlock->keyFirst = pBlock->keyFirst;
+  pCompBlock->keyLast = pBlock->keyLast;
+  pCompBlock->sversion = pObj->sversion;
+
+  return 0;
+}
+
+/*
+ * executed by the commit thread in the order of sid, so the file layout is the same as the serial commit
+ */
+static int vnodeWriteCommitJob(SVnodeObj *pVnode, SCommitJob *pJob, SMeterInfo *pMeter, char *hmem, int hmsize,
+                               int *headLen, SVnodeHeadInfo *pHeadInfo, int ssid) {
+  SMeterObj * pObj = pJob->pObj;
+  SCompBlock *pCompBlock = NULL;
+
+  pMeter->tempHeadOffset = *headLen;
+
+  if (pJob->copyLast) {
+    pCompBlock = (SCompBlock *)(hmem + *headLen);
+    assert(hmsize - *headLen >= sizeof(SCompBlock));
+    *pCompBlock = pMeter->lastBlock;
+    if (pMeter->lastBlock.sversion != pObj->sversion) {
+      pCompBlock->last = 0;
+      pCompBlock->offset = lseek(pVnode->dfd, 0, SEEK_END);
+      pMeter->last = 0;
+      lseek(pVnode->lfd, pMeter->lastBlock.offset, SEEK_SET);
+      tsendfile(pVnode->dfd, pVnode->lfd, NULL, pMeter->lastBlock.len);
+      pVnode->dfSize = pCompBlock->offset + pMeter->lastBlock.len;
+    } else {
+      if (ssid == 0) {
+        assert(pCompBlock->last && pVnode->tfd != -1);
+        pCompBlock->offset = lseek(pVnode->tfd, 0, SEEK_END);
+        lseek(pVnode->lfd, pMeter->lastBlock.offset, SEEK_SET);
+        tsendfile(pVnode->tfd, pVnode->lfd, NULL, pMeter->lastBlock.len);
+        pVnode->lfSize = pCompBlock->offset + pMeter->lastBlock.len;
+      } else {
+        assert(pVnode->tfd == -1);
+      }
+    }
+
+    *headLen += sizeof(SCompBlock);
+    pMeter->newNumOfBlocks++;
+  }
+
+  for (int i = 0; i < pJob->numOfBlocks; ++i) {
+    SCommitBlock *pBlock = pJob->pBlocks + i;
+
+    pCompBlock = (SCompBlock *)(hmem + *headLen);
+    assert(hmsize - *headLen >= sizeof(SCompBlock));
+
+    pHeadInfo->totalStorage += (pBlock->newPoints * pObj->bytesPerPoint);
+    if (vnodeWriteCommitBlock(pObj, pCompBlock, pBlock) < 0) return -1;
+    if (pCompBlock->keyLast > pObj->lastKeyOnFile) pObj->lastKeyOnFile = pCompBlock->keyLast;
+    pMeter->last = pCompBlock->last;
+
+    *headLen += sizeof(SCompBlock);
+    pMeter->newNumOfBlocks++;
+    pMeter->committedPoints += pBlock->newPoints;
+  }
+
+  dTrace("vid:%d sid:%d id:%s, %d points are committed, lastKey:%lld slot:%d pos:%d newNumOfBlocks:%d",
+      pObj->vnode, pObj->sid, pObj->meterId, pMeter->committedPoints, pObj->lastKeyOnFile, pJob->query.slot,
+      pJob->query.pos, pMeter->newNumOfBlocks);
+
+  if (pMeter->committedPoints > 0) {
+    pMeter->commitSlot = pJob->query.slot;
+    pMeter->commitPos = pJob->query.pos;
+  }
+
+  TSKEY nextKey = 0;
+  if (pObj->lastKey > pVnode->commitLastKey)
+    nextKey = pVnode->commitLastKey + 1;
+  else if (pObj->lastKey > pObj->lastKeyOnFile)
+    nextKey = pObj->lastKeyOnFile + 1;
+
+  pthread_mutex_lock(&(pVnode->vmutex));
+  if (nextKey < pVnode->firstKey && nextKey > 1) pVnode->firstKey = nextKey;
+  pthread_mutex_unlock(&(pVnode->vmutex));
+
+  return 0;
+}
+
+/*
+ * Meters are dispatched to the commit workers, which read the cache and compress the blocks in parallel. The
+ * compressed blocks are written by the commit thread in the order of sid. At most two jobs per worker are in
+ * flight, each of them holds the buffers for one meter.
+ */
+static int vnodeCommitMetersInParallel(SVnodeObj *pVnode, int ssid, int esid, SMeterInfo *meterInfo, char *hmem,
+                                       int hmsize, int *headLen, SVnodeHeadInfo *pHeadInfo, int dmsize, int cmsize) {
+  int          numOfJobs = tsNumOfCommitThreads * 2;
+  SCommitJob **pJobs = (SCommitJob **)calloc(numOfJobs, sizeof(SCommitJob *));
+  int          code = 0, created = 0;
+  int          head = 0, tail = 0;
+  int          sid = ssid;
+
+  if (pJobs == NULL) return -1;
+
+  for (created = 0; created < numOfJobs; ++created) {
+    SCommitJob *pJob = (SCommitJob *)calloc(1, sizeof(SCommitJob));
+    if (pJob == NULL) {
+      code = -1;
+      break;
+    }
+
+    tsem_init(&pJob->done, 0, 0);
+    pJobs[created] = pJob;
+
+    pJob->dmem = malloc(dmsize);
+    pJob->cmem = malloc(cmsize);
+    if (pJob->dmem == NULL || pJob->cmem == NULL) {
+      code = -1;
+      created++;
+      break;
+    }
+  }
+
+  if (code != 0) dError("vid:%d, no enough memory for committing buffer of %d jobs", pVnode->vnode, numOfJobs);
+
+  while (1) {
+    while (code == 0 && tail - head < numOfJobs && sid <= esid) {
+      SMeterObj * pObj = (SMeterObj *)(pVnode->meterList[sid]);
+      SMeterInfo *pMeter = meterInfo + sid;
+      sid++;
+
+      if ((pObj == NULL) || (pObj->pCache == NULL)) continue;
+
+      SCommitJob *pJob = pJobs[tail % numOfJobs];
+      if (vnodePrepareCommitJob(pVnode, pJob, pObj, pMeter, pHeadInfo) < 0) {
+        code = -1;
+        break;
+      }
+
+      SSchedMsg schedMsg = {0};
+      schedMsg.fp = vnodeProcessCommitJob;
+      schedMsg.ahandle = pJob;
+      taosScheduleTask(commitQhandle, &schedMsg);
+      tail++;
+    }
+
+    if (head == tail) break;
+
+    // jobs shall be waited even if error occurs, since the buffers are still used by the workers
+    SCommitJob *pJob = pJobs[head % numOfJobs];
+    tsem_wait(&pJob->done);
+    head++;
+
+    if (pJob->code != 0) code = -1;
+    if (code == 0) {
+      SMeterInfo *pMeter = meterInfo + pJob->pObj->sid;
+      code = vnodeWriteCommitJob(pVnode, pJob, pMeter, hmem, hmsize, headLen, pHeadInfo, ssid);
+    }
+
+    vnodeFreeCommitBlocks(pJob);
+  }
+
+  for (int i = 0; i < created; ++i) {
+    tsem_destroy(&pJobs[i]->done);
+    tfree(pJobs[i]->pBlocks);
+    tfree(pJobs[i]->dmem);
+    tfree(pJobs[i]->cmem);
+    tfree(pJobs[i]);
+  }
+
+  tfree(pJobs);
+  return code;
+}
 
 void *vnodeCommitMultiToFile(SVnodeObj *pVnode, int ssid, int esid) {
   int              vnode = pVnode->vnode;
@@ -655,6 +1012,14 @@ _again:
       }
     }
   }
+  if (commitQhandle != NULL) {
+    if (vnodeCommitMetersInParallel(pVnode, ssid, esid, meterInfo, hmem, hmsize, &headLen, &headInfo, dmsize,
+                                    cmsize) < 0) {
+      goto _over;
+    }
+    goto _meters_committed;
+  }
+
   // Loop To write data to fileId
   for (sid = ssid; sid <= esid; ++sid) {
     pObj = (SMeterObj *)(pVnode->meterList[sid]);
@@ -791,6 +1156,7 @@ _again:
     pthread_mutex_unlock(&(pVnode->vmutex));
   }
 
+_meters_committed:
   if (pVnode->lastKey > pVnode->commitLastKey) commitAgain = 1;
 
   dTrace("vid:%d, finish appending the data file", vnode);
@@ -1054,8 +1420,7 @@ int vnodeReadColumnToMem(int fd, SCompBlock *pBlock, SField **fields, int col, c
   if (*fields == NULL) {
     size = sizeof(SField) * (pBlock->numOfCols) + sizeof(TSCKSUM);
     *fields = (SField *)calloc(1, size);
-    lseek(fd, pBlock->offset, SEEK_SET);
-    read(fd, *fields, size);
+    pread(fd, *fields, size, pBlock->offset);
     if (!taosCheckChecksumWhole((uint8_t *)(*fields), size)) {
       dError("SField checksum error, col: %d", col);
       taosLogError("SField checksum error, col: %d", col);
@@ -1068,23 +1433,30 @@ int vnodeReadColumnToMem(int fd, SCompBlock *pBlock, SField **fields, int col, c
   /* If data is NULL, that means only to read SField content. So no need to read data part. */
   if (data == NULL) return 0;
 
-  lseek(fd, pBlock->offset + tfields[col].offset, SEEK_SET);
+  /* positional reads, the file offset of fd is left untouched */
+  int64_t offset = pBlock->offset + tfields[col].offset;
 
   if (pBlock->algorithm) {
-    len = read(fd, temp, tfields[col].len);
-    read(fd, &chksum, sizeof(TSCKSUM));
+    len = pread(fd, temp, tfields[col].len, offset);
+    pread(fd, &chksum, sizeof(TSCKSUM), offset + tfields[col].len);
     if (chksum != taosCalcChecksum(0, (uint8_t *)temp, tfields[col].len)) {
       dError("data column checksum error, col: %d", col);
       taosLogError("data column checksum error, col: %d", col);
       return -1;
     }
 
-    (*pDecompFunc[tfields[col].type])(temp, tfields[col].len, pBlock->numOfPoints, data, dataSize,
-                                      pBlock->algorithm, buffer, bufferSize);
+    __decompress_fn_t decompFunc = tsGetColumnDecompFunc(tfields[col].codec, tfields[col].type);
+    if (decompFunc == NULL) {
+      dError("invalid column codec:%d type:%d, col: %d", tfields[col].codec, tfields[col].type, col);
+      taosLogError("invalid column codec:%d type:%d, col: %d", tfields[col].codec, tfields[col].type, col);
+      return -TSDB_CODE_FILE_CORRUPTED;
+    }
+
+    (*decompFunc)(temp, tfields[col].len, pBlock->numOfPoints, data, dataSize, pBlock->algorithm, buffer, bufferSize);
 
   } else {
-    len = read(fd, data, tfields[col].len);
-    read(fd, &chksum, sizeof(TSCKSUM));
+    len = pread(fd, data, tfields[col].len, offset);
+    pread(fd, &chksum, sizeof(TSCKSUM), offset + tfields[col].len);
     if (chksum != taosCalcChecksum(0, (uint8_t *)data, tfields[col].len)) {
       dError("data column checksum error, col: %d", col);
       taosLogError("data column checksum error, col: %d", col);
@@ -1205,38 +1577,20 @@ int vnodeReadLastBlockToMem(SMeterObj *pObj, SCompBlock *pBlock, SData *sdata[])
   return code;
 }
 
-int vnodeWriteBlockToFile(SMeterObj *pObj, SCompBlock *pCompBlock, SData *data[], SData *cdata[], int points) {
-  SVnodeObj *pVnode = &vnodeList[pObj->vnode];
-  SVnodeCfg *pCfg = &pVnode->cfg;
-  int        wlen = 0;
-  SField *   fields = NULL;
-  int        size = sizeof(SField) * pObj->numOfColumns + sizeof(TSCKSUM);
-  int32_t    offset = size;
-  char *     buffer = NULL;
-  int        bufferSize = 0;
-
-  int dfd = pVnode->dfd;
-
-  if (pCompBlock->last && (points < pObj->pointsPerFileBlock * tsFileBlockMinPercent)) {
-    dTrace("vid:%d sid:%d id:%s, points:%d are written to last block, block stime: %ld, block etime: %ld",
-           pObj->vnode, pObj->sid, pObj->meterId, points, *((TSKEY *)(data[0]->data)),
-           *((TSKEY * )(data[0]->data + (points - 1) * pObj->schema[0].bytes)));
-    pCompBlock->last = 1;
-    dfd = pVnode->tfd > 0 ? pVnode->tfd : pVnode->lfd;
-  } else {
-    pCompBlock->last = 0;
-  }
-
-  pCompBlock->offset = lseek(dfd, 0, SEEK_END);
-  pCompBlock->len = 0;
-
-  fields = (SField *)calloc(1, size);
-  if (fields == NULL) return -1;
+/*
+ * compress all columns of a block into cdata[], or append the checksum to data[] if compression is off, and fill
+ * the SField of each column. It does not touch any file, so it can be called by the commit workers in parallel.
+ */
+static int vnodeCompressBlockColumns(SMeterObj *pObj, SData *data[], SData *cdata[], int points, SField *fields,
+                                     int32_t offset, char compression) {
+  char *buffer = NULL;
+  int   bufferSize = 0;
 
-  if (pCfg->compression == TWO_STAGE_COMP){
+  if (compression == TWO_STAGE_COMP) {
     bufferSize = pObj->maxBytes * points + EXTRA_BYTES;
     buffer = (char *)malloc(bufferSize);
-  } 
+    if (buffer == NULL) return -1;
+  }
 
   for (int i = 0; i < pObj->numOfColumns; ++i) {
     fields[i].colId = pObj->schema[i].colId;
@@ -1245,10 +1599,11 @@ int vnodeWriteBlockToFile(SMeterObj *pObj, SCompBlock *pCompBlock, SData *data[]
     fields[i].offset = offset;
     // assert(data[i]->len == points*pObj->schema[i].bytes);
 
-    if (pCfg->compression) {
-      cdata[i]->len = (*pCompFunc[pObj->schema[i].type])(data[i]->data, points * pObj->schema[i].bytes, points,
-                                                         cdata[i]->data, pObj->schema[i].bytes*pObj->pointsPerFileBlock+EXTRA_BYTES, 
-                                                         pCfg->compression, buffer, bufferSize);
+    if (compression) {
+      fields[i].codec = tsColumnCodec ? tsSelectColumnCodec(data[i]->data, points, pObj->schema[i].type) : 0;
+      cdata[i]->len = (*tsCompCodecs[fields[i].codec].compFunc[pObj->schema[i].type])(
+          data[i]->data, points * pObj->schema[i].bytes, points, cdata[i]->data,
+          pObj->schema[i].bytes * pObj->pointsPerFileBlock + EXTRA_BYTES, compression, buffer, bufferSize);
       fields[i].len = cdata[i]->len;
       taosCalcChecksumAppend(0, (uint8_t *)(cdata[i]->data), cdata[i]->len + sizeof(TSCKSUM));
       offset += (cdata[i]->len + sizeof(TSCKSUM));
@@ -1265,6 +1620,39 @@ int vnodeWriteBlockToFile(SMeterObj *pObj, SCompBlock *pCompBlock, SData *data[]
   }
 
   tfree(buffer);
+  return offset;
+}
+
+int vnodeWriteBlockToFile(SMeterObj *pObj, SCompBlock *pCompBlock, SData *data[], SData *cdata[], int points) {
+  SVnodeObj *pVnode = &vnodeList[pObj->vnode];
+  SVnodeCfg *pCfg = &pVnode->cfg;
+  int        wlen = 0;
+  SField *   fields = NULL;
+  int        size = sizeof(SField) * pObj->numOfColumns + sizeof(TSCKSUM);
+  int32_t    offset = size;
+
+  int dfd = pVnode->dfd;
+
+  if (pCompBlock->last && (points < pObj->pointsPerFileBlock * tsFileBlockMinPercent)) {
+    dTrace("vid:%d sid:%d id:%s, points:%d are written to last block, block stime: %ld, block etime: %ld",
+           pObj->vnode, pObj->sid, pObj->meterId, points, *((TSKEY *)(data[0]->data)),
+           *((TSKEY * )(data[0]->data + (points - 1) * pObj->schema[0].bytes)));
+    pCompBlock->last = 1;
+    dfd = pVnode->tfd > 0 ? pVnode->tfd : pVnode->lfd;
+  } else {
+    pCompBlock->last = 0;
+  }
+
+  pCompBlock->offset = lseek(dfd, 0, SEEK_END);
+  pCompBlock->len = 0;
+
+  fields = (SField *)calloc(1, size);
+  if (fields == NULL) return -1;
+
+  if (vnodeCompressBlockColumns(pObj, data, cdata, points, fields, offset, pCfg->compression) < 0) {
+    tfree(fields);
+    return -1;
+  }
 
   // Write SField part
   taosCalcChecksumAppend(0, (uint8_t *)fields, size);
@@ -556,3 +556,213 @@ __filter_func_t* vnodeGetValueFilterFuncArray(int32_t type) {
 }
 
 bool vnodeSupportPrefilter(int32_t type) { return type != TSDB_DATA_TYPE_BINARY && type != TSDB_DATA_TYPE_NCHAR; }
+
+#define FILTER_ALL_QUALIFIED(_info, _min, _max, _lower, _upper)                    \
+  do {                                                                             \
+    switch ((_info)->lowerRelOptr) {                                               \
+      case TSDB_RELATION_INVALID:                                                  \
+        break;                                                                     \
+      case TSDB_RELATION_LARGE:                                                    \
+        if (!((_min) > (_lower))) return false;                                    \
+        break;                                                                     \
+      case TSDB_RELATION_LARGE_EQUAL:                                              \
+        if (!((_min) >= (_lower))) return false;                                   \
+        break;                                                                     \
+      case TSDB_RELATION_EQUAL:                                                    \
+        if (!((_min) == (_lower) && (_max) == (_lower))) return false;             \
+        break;                                                                     \
+      case TSDB_RELATION_NOT_EQUAL:                                                \
+        if (!((_lower) < (_min) || (_lower) > (_max))) return false;               \
+        break;                                                                     \
+      default:                                                                     \
+        return false;                                                              \
+    }                                                                              \
+    switch ((_info)->upperRelOptr) {                                               \
+      case TSDB_RELATION_INVALID:                                                  \
+        break;                                                                     \
+      case TSDB_RELATION_LESS:                                                     \
+        if (!((_max) < (_upper))) return false;                                    \
+        break;                                                                     \
+      case TSDB_RELATION_LESS_EQUAL:                                               \
+        if (!((_max) <= (_upper))) return false;                                   \
+        break;                                                                     \
+      default:                                                                     \
+        return false;                                                              \
+    }                                                                              \
+  } while (0)
+
+bool vnodeFilterAllQualified(SColumnFilterElem *pFilter, int32_t type, int64_t *minval, int64_t *maxval) {
+  SColumnFilterInfo *pInfo = &pFilter->filterInfo;
+
+  if (!vnodeSupportPrefilter(type)) {
+    return false;
+  }
+
+  // the min/max of float column are saved as float in the low 4 bytes of the field
+  if (type == TSDB_DATA_TYPE_FLOAT) {
+    float min = *(float *)minval;
+    float max = *(float *)maxval;
+    FILTER_ALL_QUALIFIED(pInfo, min, max, pInfo->lowerBndd, pInfo->upperBndd);
+  } else if (type == TSDB_DATA_TYPE_DOUBLE) {
+    double min = *(double *)minval;
+    double max = *(double *)maxval;
+    FILTER_ALL_QUALIFIED(pInfo, min, max, pInfo->lowerBndd, pInfo->upperBndd);
+  } else {
+    FILTER_ALL_QUALIFIED(pInfo, *minval, *maxval, pInfo->lowerBndi, pInfo->upperBndi);
+  }
+
+  return true;
+}
+
+/*
+ * Batch filter kernels. Each kernel evaluates one filter element over a column of a data block and ORs the result
+ * into a selection vector of one byte per row. The loops are free of branches and calls, so that they can be
+ * vectorized by compiler, instead of calling a filter function through pointer for each value.
+ */
+#define BATCH_FILTER_LOOP(_res, _n, _expr)  \
+  do {                                      \
+    for (int32_t i = 0; i < (_n); ++i) {    \
+      (_res)[i] |= (uint8_t)(_expr);        \
+    }                                       \
+  } while (0)
+
+#define DEFINE_BATCH_FILTER(_name, _type, _bndType, _lowerBnd, _upperBnd, _equal)                  \
+  static bool _name(SColumnFilterInfo *pInfo, const char *pData, int32_t numOfRows, uint8_t *res) { \
+    const _type *p = (const _type *)pData;                                                         \
+    _bndType     lower = (_bndType)pInfo->_lowerBnd;                                               \
+    _bndType     upper = (_bndType)pInfo->_upperBnd;                                               \
+    int32_t      lowerOptr = pInfo->lowerRelOptr;                                                  \
+    int32_t      upperOptr = pInfo->upperRelOptr;                                                  \
+                                                                                                   \
+    if ((lowerOptr == TSDB_RELATION_LARGE_EQUAL || lowerOptr == TSDB_RELATION_LARGE) &&            \
+        (upperOptr == TSDB_RELATION_LESS_EQUAL || upperOptr == TSDB_RELATION_LESS)) {              \
+      if (lowerOptr == TSDB_RELATION_LARGE_EQUAL) {                                                \
+        if (upperOptr == TSDB_RELATION_LESS_EQUAL) {                                               \
+          BATCH_FILTER_LOOP(res, numOfRows, (p[i] >= lower) & (p[i] <= upper));                    \
+        } else {                                                                                   \
+          BATCH_FILTER_LOOP(res, numOfRows, (p[i] >= lower) & (p[i] < upper));                     \
+        }                                                                                          \
+      } else {                                                                                     \
+        if (upperOptr == TSDB_RELATION_LESS_EQUAL) {                                               \
+          BATCH_FILTER_LOOP(res, numOfRows, (p[i] > lower) & (p[i] <= upper));                     \
+        } else {                                                                                   \
+          BATCH_FILTER_LOOP(res, numOfRows, (p[i] > lower) & (p[i] < upper));                      \
+        }                                                                                          \
+      }                                                                                            \
+      return true;                                                                                 \
+    }                                                                                              \
+                                                                                                   \
+    switch ((lowerOptr != TSDB_RELATION_INVALID) ? lowerOptr : upperOptr) {                        \
+      case TSDB_RELATION_LESS:                                                                     \
+        BATCH_FILTER_LOOP(res, numOfRows, p[i] < upper);                                           \
+        break;                                                                                     \
+      case TSDB_RELATION_LESS_EQUAL:                                                               \
+        BATCH_FILTER_LOOP(res, numOfRows, p[i] <= upper);                                          \
+        break;                                                                                     \
+      case TSDB_RELATION_LARGE:                                                                    \
+        BATCH_FILTER_LOOP(res, numOfRows, p[i] > lower);                                           \
+        break;                                                                                     \
+      case TSDB_RELATION_LARGE_EQUAL:                                                              \
+        BATCH_FILTER_LOOP(res, numOfRows, p[i] >= lower);                                          \
+        break;                                                                                     \
+      case TSDB_RELATION_EQUAL:                                                                    \
+        BATCH_FILTER_LOOP(res, numOfRows, _equal);                                                 \
+        break;                                                                                     \
+      case TSDB_RELATION_NOT_EQUAL:                                                                \
+        BATCH_FILTER_LOOP(res, numOfRows, p[i] != lower);                                          \
+        break;                                                                                     \
+      default:                                                                                     \
+        return false;                                                                              \
+    }                                                                                              \
+    return true;                                                                                   \
+  }
+
+DEFINE_BATCH_FILTER(batchFilter_i8, int8_t, int64_t, lowerBndi, upperBndi, p[i] == lower)
+DEFINE_BATCH_FILTER(batchFilter_i16, int16_t, int64_t, lowerBndi, upperBndi, p[i] == lower)
+DEFINE_BATCH_FILTER(batchFilter_i32, int32_t, int64_t, lowerBndi, upperBndi, p[i] == lower)
+DEFINE_BATCH_FILTER(batchFilter_i64, int64_t, int64_t, lowerBndi, upperBndi, p[i] == lower)
+DEFINE_BATCH_FILTER(batchFilter_ds, float, double, lowerBndd, upperBndd, fabs(p[i] - lower) <= FLT_EPSILON)
+DEFINE_BATCH_FILTER(batchFilter_dd, double, double, lowerBndd, upperBndd, p[i] == lower)
+
+typedef bool (*__batch_filter_func_t)(SColumnFilterInfo *pInfo, const char *pData, int32_t numOfRows, uint8_t *res);
+
+static __batch_filter_func_t vnodeGetBatchFilterFunc(int32_t type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:       return batchFilter_i8;
+    case TSDB_DATA_TYPE_TINYINT:    return batchFilter_i8;
+    case TSDB_DATA_TYPE_SMALLINT:   return batchFilter_i16;
+    case TSDB_DATA_TYPE_INT:        return batchFilter_i32;
+    case TSDB_DATA_TYPE_TIMESTAMP:
+    case TSDB_DATA_TYPE_BIGINT:     return batchFilter_i64;
+    case TSDB_DATA_TYPE_FLOAT:      return batchFilter_ds;
+    case TSDB_DATA_TYPE_DOUBLE:     return batchFilter_dd;
+    default: return NULL;
+  }
+}
+
+#define BATCH_MASK_NULL(_type, _null, _pData, _n, _res)         \
+  do {                                                         \
+    const _type *p = (const _type *)(_pData);                  \
+    for (int32_t i = 0; i < (_n); ++i) {                       \
+      (_res)[i] &= (uint8_t)(p[i] != (_type)(_null));          \
+    }                                                          \
+  } while (0)
+
+/* clear the rows of null value, the null values of numeric types are compared with their bit patterns */
+static void batchMaskNullRows(const char *pData, int32_t type, int32_t bytes, int32_t numOfRows, uint8_t *res) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:       BATCH_MASK_NULL(uint8_t, TSDB_DATA_BOOL_NULL, pData, numOfRows, res); break;
+    case TSDB_DATA_TYPE_TINYINT:    BATCH_MASK_NULL(uint8_t, TSDB_DATA_TINYINT_NULL, pData, numOfRows, res); break;
+    case TSDB_DATA_TYPE_SMALLINT:   BATCH_MASK_NULL(uint16_t, TSDB_DATA_SMALLINT_NULL, pData, numOfRows, res); break;
+    case TSDB_DATA_TYPE_INT:        BATCH_MASK_NULL(uint32_t, TSDB_DATA_INT_NULL, pData, numOfRows, res); break;
+    case TSDB_DATA_TYPE_TIMESTAMP:
+    case TSDB_DATA_TYPE_BIGINT:     BATCH_MASK_NULL(uint64_t, TSDB_DATA_BIGINT_NULL, pData, numOfRows, res); break;
+    case TSDB_DATA_TYPE_FLOAT:      BATCH_MASK_NULL(uint32_t, TSDB_DATA_FLOAT_NULL, pData, numOfRows, res); break;
+    case TSDB_DATA_TYPE_DOUBLE:     BATCH_MASK_NULL(uint64_t, TSDB_DATA_DOUBLE_NULL, pData, numOfRows, res); break;
+    default:
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        res[i] &= (uint8_t)(!isNull(pData + bytes * i, type));
+      }
+  }
+}
+
+int32_t vnodeFilterDataBlock(SQuery *pQuery, int32_t start, int32_t numOfRows, uint8_t *res, uint8_t *buf) {
+  memset(res, 1, numOfRows);
+
+  for (int32_t k = 0; k < pQuery->numOfFilterCols; ++k) {
+    SSingleColumnFilterInfo *pFilterInfo = &pQuery->pFilterInfo[k];
+
+    int32_t type = pFilterInfo->info.data.type;
+    int32_t bytes = pFilterInfo->info.data.bytes;
+    char *  pData = pFilterInfo->pData + bytes * start;
+
+    __batch_filter_func_t batchFilterFn = vnodeGetBatchFilterFunc(type);
+
+    // filters of the same column are OR'ed
+    memset(buf, 0, numOfRows);
+    for (int32_t j = 0; j < pFilterInfo->numOfFilters; ++j) {
+      SColumnFilterElem *pFilterElem = &pFilterInfo->pFilters[j];
+
+      if (batchFilterFn == NULL || !batchFilterFn(&pFilterElem->filterInfo, pData, numOfRows, buf)) {
+        for (int32_t i = 0; i < numOfRows; ++i) {
+          char *pElem = pData + bytes * i;
+          buf[i] |= (uint8_t)pFilterElem->fp(pFilterElem, pElem, pElem);
+        }
+      }
+    }
+
+    batchMaskNullRows(pData, type, bytes, numOfRows, buf);
+
+    // filter columns are AND'ed
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      res[i] &= buf[i];
+    }
+  }
+
+  int32_t numOfQualified = 0;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    numOfQualified += res[i];
+  }
+
+  return numOfQualified;
+}
@@ -17,6 +17,7 @@
 #include "os.h"
 
 #include "vnode.h"
+#include "vnodeBlockCache.h"
 #include "vnodeUtil.h"
 
 extern void         vnodeGetHeadTname(char *nHeadName, char *nLastName, int vnode, int fileId);
@@ -646,6 +647,7 @@ static int vnodeCloseImportFiles(SMeterObj *pObj, SImportHandle *pHandle) {
     remove(dpath);
   }
 
+  vnodeInvalidateBlockCache(pVnode->vnode, pVnode->commitFileId);
   return 0;
 }
 
@@ -34,8 +34,8 @@ int  tsMeterSizeOnFile;
 void vnodeUpdateMeter(void *param, void *tmdId);
 void vnodeRecoverMeterObjectFile(int vnode);
 
-int (*vnodeProcessAction[])(SMeterObj *, char *, int, char, void *, int, int *, TSKEY) = {vnodeInsertPoints,
-                                                                                   vnodeImportPoints};
+int (*vnodeProcessAction[])(SMeterObj *, char *, int, char, void *, int, int *, TSKEY) = {
+    vnodeInsertPoints, vnodeImportPoints, NULL, NULL, vnodeInsertColumnarPoints};
 
 void vnodeFreeMeterObj(SMeterObj *pObj) {
   if (pObj == NULL) return;
@@ -187,6 +187,92 @@ int vnodeSaveMeterObjToFile(SMeterObj *pObj) {
   return 0;
 }
 
+/*
+ * Save a batch of newly created meters of one vnode. Objects appended to the file end are written
+ * with one fwrite, the touched index slots with another, and the file is synced only once.
+ */
+int vnodeSaveMeterObjsToFile(int vnode, SMeterObj *pObjs[], int numOfMeters) {
+  int64_t    offset, length, new_length, end, totalLen = 0, appendLen = 0;
+  int        minSid = INT32_MAX, maxSid = -1;
+  FILE *     fp;
+  SMeterObj *pObj;
+  SVnodeObj *pVnode = &vnodeList[vnode];
+  char *     buffer = NULL;
+
+  if (numOfMeters <= 0) return 0;
+
+  fp = vnodeOpenMeterObjFile(vnode);
+  if (fp == NULL) return -1;
+
+  for (int i = 0; i < numOfMeters; ++i) {
+    pObj = pObjs[i];
+    totalLen += offsetof(SMeterObj, reserved) + pObj->numOfColumns * sizeof(SColumn) + pObj->sqlLen + sizeof(TSCKSUM);
+  }
+
+  buffer = (char *)malloc(totalLen);
+  if (buffer == NULL) {
+    dError("vid:%d, failed to allocate memory while saving %d meter objects to file", vnode, numOfMeters);
+    fclose(fp);
+    return -1;
+  }
+
+  fseek(fp, 0, SEEK_END);
+  end = ftell(fp);
+
+  for (int i = 0; i < numOfMeters; ++i) {
+    pObj = pObjs[i];
+    char *pos = buffer + appendLen;
+
+    offset = pVnode->meterIndex[pObj->sid].offset;
+    length = pVnode->meterIndex[pObj->sid].length;
+
+    new_length = offsetof(SMeterObj, reserved) + pObj->numOfColumns * sizeof(SColumn) + pObj->sqlLen + sizeof(TSCKSUM);
+
+    memcpy(pos, pObj, offsetof(SMeterObj, reserved));
+    memcpy(pos + offsetof(SMeterObj, reserved), pObj->schema, pObj->numOfColumns * sizeof(SColumn));
+    memcpy(pos + offsetof(SMeterObj, reserved) + pObj->numOfColumns * sizeof(SColumn), pObj->pSql, pObj->sqlLen);
+    taosCalcChecksumAppend(0, (uint8_t *)pos, new_length);
+
+    if (offset == 0 || length < new_length) {  // New, append to file end
+      pVnode->meterIndex[pObj->sid].offset = end + appendLen;
+      appendLen += new_length;
+    } else if (offset < 0) {  // deleted meter, reuse its space
+      fseek(fp, -offset, SEEK_SET);
+      fwrite(pos, new_length, 1, fp);
+      pVnode->meterIndex[pObj->sid].offset = -offset;
+    } else {  // meter exists, overwrite it, offset > 0
+      fseek(fp, offset, SEEK_SET);
+      fwrite(pos, new_length, 1, fp);
+      pVnode->meterIndex[pObj->sid].offset = (pObj->meterId[0] == 0) ? -offset : offset;
+    }
+    pVnode->meterIndex[pObj->sid].length = new_length;
+
+    if (pObj->sid < minSid) minSid = pObj->sid;
+    if (pObj->sid > maxSid) maxSid = pObj->sid;
+  }
+
+  if (appendLen > 0) {
+    fseek(fp, end, SEEK_SET);
+    fwrite(buffer, appendLen, 1, fp);
+  }
+
+  // index slots are contiguous in memory and on file, write the touched range at once
+  fseek(fp, TSDB_FILE_HEADER_LEN + sizeof(SMeterObjHeader) * minSid, SEEK_SET);
+  fwrite(&(pVnode->meterIndex[minSid]), sizeof(SMeterObjHeader), maxSid - minSid + 1, fp);
+
+  tfree(buffer);
+
+  vnodeUpdateVnodeStatistic(fp, pVnode);
+  vnodeUpdateVnodeFileHeader(fp, pVnode);
+
+  fflush(fp);
+  fsync(fileno(fp));
+  fclose(fp);
+
+  dTrace("vid:%d, %d meter objects are saved to file", vnode, numOfMeters);
+  return 0;
+}
+
 int vnodeSaveAllMeterObjToFile(int vnode) {
   int64_t    offset, length, new_length, new_offset;
   FILE *     fp;
@@ -455,7 +541,7 @@ void vnodeCloseMetersVnode(int vnode) {
   pVnode->meterList = NULL;
 }
 
-int vnodeCreateMeterObj(SMeterObj *pNew, SConnSec *pSec) {
+static int vnodeCreateMeterObjImp(SMeterObj *pNew, SConnSec *pSec, bool save) {
   SMeterObj *pObj;
   int        code;
 
@@ -486,7 +572,7 @@ int vnodeCreateMeterObj(SMeterObj *pNew, SConnSec *pSec) {
     vnodeList[pNew->vnode].meterList[pNew->sid] = pNew;
     pNew->state = TSDB_METER_STATE_READY;
     if (pNew->timeStamp > vnodeList[pNew->vnode].lastCreate) vnodeList[pNew->vnode].lastCreate = pNew->timeStamp;
-    vnodeSaveMeterObjToFile(pNew);
+    if (save) vnodeSaveMeterObjToFile(pNew);
     // vnodeCreateMeterMgmt(pNew, pSec);
     vnodeCreateStream(pNew);
     dTrace("vid:%d, sid:%d id:%s, meterObj is created, uid:%ld", pNew->vnode, pNew->sid, pNew->meterId, pNew->uid);
@@ -495,6 +581,14 @@ int vnodeCreateMeterObj(SMeterObj *pNew, SConnSec *pSec) {
   return code;
 }
 
+int vnodeCreateMeterObj(SMeterObj *pNew, SConnSec *pSec) { return vnodeCreateMeterObjImp(pNew, pSec, true); }
+
+/*
+ * The meter object is installed into meterList but not saved to file, the caller shall save
+ * the whole batch through vnodeSaveMeterObjsToFile.
+ */
+int vnodeCreateMeterObjNoSave(SMeterObj *pNew, SConnSec *pSec) { return vnodeCreateMeterObjImp(pNew, pSec, false); }
+
 int vnodeRemoveMeterObj(int vnode, int sid) {
   SMeterObj *pObj;
 
@@ -580,7 +674,15 @@ int vnodeInsertPoints(SMeterObj *pObj, char *cont, int contLen, char source, voi
     return code;
   }
 
-  // FIXME: Here should be after the comparison of sversions.
+  // the submit is retried until the new schema arrives, it shall not be logged or forwarded before
+  if (pObj->sversion < sversion) {
+    dTrace("vid:%d sid:%d id:%s, schema is changed, new:%d old:%d", pObj->vnode, pObj->sid, pObj->meterId, sversion,
+           pObj->sversion);
+    vnodeSendMeterCfgMsg(pObj->vnode, pObj->sid);
+    code = TSDB_CODE_ACTION_IN_PROGRESS;
+    return code;
+  }
+
   if (pVnode->cfg.commitLog && source != TSDB_DATA_SOURCE_LOG) {
     if (pVnode->logFd < 0) return TSDB_CODE_INVALID_COMMIT_LOG;
     code = vnodeWriteToCommitLog(pObj, TSDB_ACTION_INSERT, cont, contLen, sversion);
@@ -592,14 +694,6 @@ int vnodeInsertPoints(SMeterObj *pObj, char *cont, int contLen, char source, voi
     if (code != TSDB_CODE_SUCCESS) return code;
   }
 
-  if (pObj->sversion < sversion) {
-    dTrace("vid:%d sid:%d id:%s, schema is changed, new:%d old:%d", pObj->vnode, pObj->sid, pObj->meterId, sversion,
-           pObj->sversion);
-    vnodeSendMeterCfgMsg(pObj->vnode, pObj->sid);
-    code = TSDB_CODE_ACTION_IN_PROGRESS;
-    return code;
-  }
-
   pData = pSubmit->payLoad;
 
   TSKEY firstKey = *((TSKEY *)pData);
@@ -673,6 +767,176 @@ _over:
   return code;
 }
 
+SShellSubmitBlock *vnodeConvertColumnarBlock(SMeterObj *pObj, SShellSubmitBlock *pBlock) {
+  int rows = htons(pBlock->numOfRows);
+
+  SShellSubmitBlock *pNew = malloc(sizeof(SShellSubmitBlock) + rows * pObj->bytesPerPoint);
+  if (pNew == NULL) return NULL;
+
+  memcpy(pNew, pBlock, sizeof(SShellSubmitBlock));
+
+  const char *payload = pBlock->payLoad;
+  char *      dst = pNew->payLoad;
+  int         rowOffset = 0;
+  for (int col = 0; col < pObj->numOfColumns; ++col) {
+    int         bytes = pObj->schema[col].bytes;
+    const char *pCol = payload;
+    char *      pRow = dst + rowOffset;
+
+    for (int i = 0; i < rows; ++i) {
+      memcpy(pRow, pCol, bytes);
+      pCol += bytes;
+      pRow += pObj->bytesPerPoint;
+    }
+
+    payload += rows * bytes;
+    rowOffset += bytes;
+  }
+
+  return pNew;
+}
+
+/*
+ * Insert a column-major block from shell or commit log, the runs of rows with increasing keys are copied into cache
+ * column by column. The block is logged as it is, while peers take rows only, so it is not used if they are on.
+ */
+int vnodeInsertColumnarPoints(SMeterObj *pObj, char *cont, int contLen, char source, void *param, int sversion,
+                              int *numOfInsertPoints, TSKEY now) {
+  SSubmitMsg *pSubmit = (SSubmitMsg *)cont;
+  SVnodeObj * pVnode = vnodeList + pObj->vnode;
+  int         code = TSDB_CODE_SUCCESS;
+  int         points = 0;
+  short       numOfPoints = htons(pSubmit->numOfRows);
+
+  *numOfInsertPoints = 0;
+
+  int expectedLen = numOfPoints * pObj->bytesPerPoint + sizeof(pSubmit->numOfRows);
+  if (expectedLen != contLen) {
+    dError("vid:%d sid:%d id:%s, invalid columnar submit msg length:%d, expected:%d, bytesPerPoint: %d", pObj->vnode,
+           pObj->sid, pObj->meterId, contLen, expectedLen, pObj->bytesPerPoint);
+    return TSDB_CODE_WRONG_MSG_SIZE;
+  }
+
+  // the timestamp is the first column, to guarantee time stamp is the same for all vnodes
+  TSKEY *keys = (TSKEY *)pSubmit->payLoad;
+  TSKEY  tsKey = now;
+  if (numOfPoints > 0 && keys[0] == 0) {
+    for (int i = 0; i < numOfPoints; ++i) {
+      keys[i] = tsKey++;
+    }
+  }
+
+  if (numOfPoints >= (pVnode->cfg.blocksPerMeter - 2) * pObj->pointsPerBlock) {
+    dError("vid:%d sid:%d id:%s, batch size too big, it shall be smaller than:%d", pObj->vnode, pObj->sid,
+           pObj->meterId, (pVnode->cfg.blocksPerMeter - 2) * pObj->pointsPerBlock);
+    return TSDB_CODE_BATCH_SIZE_TOO_BIG;
+  }
+
+  SCachePool *pPool = (SCachePool *)pVnode->pCachePool;
+  if (pObj->freePoints < numOfPoints || pObj->freePoints < (pObj->pointsPerBlock << 1) ||
+      pPool->notFreeSlots > pVnode->cfg.cacheNumOfBlocks.totalBlocks - 2) {
+    dTrace("vid:%d sid:%d id:%s, cache is full, freePoints:%d, notFreeSlots:%d", pObj->vnode, pObj->sid, pObj->meterId,
+           pObj->freePoints, pPool->notFreeSlots);
+    vnodeProcessCommitTimer(pVnode, NULL);
+    return TSDB_CODE_ACTION_IN_PROGRESS;
+  }
+
+  if (pObj->sversion < sversion) {
+    dTrace("vid:%d sid:%d id:%s, schema is changed, new:%d old:%d", pObj->vnode, pObj->sid, pObj->meterId, sversion,
+           pObj->sversion);
+    vnodeSendMeterCfgMsg(pObj->vnode, pObj->sid);
+    return TSDB_CODE_ACTION_IN_PROGRESS;
+  }
+
+  if (pVnode->cfg.commitLog && source != TSDB_DATA_SOURCE_LOG) {
+    if (pVnode->logFd < 0) return TSDB_CODE_INVALID_COMMIT_LOG;
+    code = vnodeWriteToCommitLog(pObj, TSDB_ACTION_INSERT_COLUMNAR, cont, contLen, sversion);
+    if (code != TSDB_CODE_SUCCESS) return code;
+  }
+
+  if (numOfPoints <= 0) return TSDB_CODE_SUCCESS;
+
+  TSKEY firstKey = keys[0];
+  TSKEY lastKey = keys[numOfPoints - 1];
+  int   cfid = now / pVnode->cfg.daysPerFile / tsMsPerDay[(int32_t)pVnode->cfg.precision];
+
+  TSKEY minAllowedKey =
+      (cfid - pVnode->maxFiles + 1) * pVnode->cfg.daysPerFile * tsMsPerDay[(int32_t)pVnode->cfg.precision];
+  TSKEY maxAllowedKey = (cfid + 2) * pVnode->cfg.daysPerFile * tsMsPerDay[(int32_t)pVnode->cfg.precision] - 2;
+  if (firstKey < minAllowedKey || firstKey > maxAllowedKey || lastKey < minAllowedKey || lastKey > maxAllowedKey) {
+    dError("vid:%d sid:%d id:%s, data is out of range, numOfPoints:%d firstKey:%lld lastKey:%lld minAllowedKey:%lld "
+           "maxAllowedKey:%lld", pObj->vnode, pObj->sid, pObj->meterId, numOfPoints, firstKey, lastKey, minAllowedKey,
+           maxAllowedKey);
+    return TSDB_CODE_TIMESTAMP_OUT_OF_RANGE;
+  }
+
+  if ((code = vnodeSetMeterInsertImportStateEx(pObj, TSDB_METER_STATE_INSERT)) != TSDB_CODE_SUCCESS) {
+    goto _over;
+  }
+
+  int i = 0;
+  while (i < numOfPoints) {
+    if (vnodeIsMeterState(pObj, TSDB_METER_STATE_DELETING)) {  // meter will be dropped, abort current insertion
+      dWarn("vid:%d sid:%d id:%s, meter is dropped, abort insert, state:%d", pObj->vnode, pObj->sid, pObj->meterId,
+            pObj->state);
+      code = TSDB_CODE_NOT_ACTIVE_TABLE;
+      break;
+    }
+
+    if (keys[i] <= pObj->lastKey) {
+      dWarn("vid:%d sid:%d id:%s, received key:%ld not larger than lastKey:%ld", pObj->vnode, pObj->sid, pObj->meterId,
+            keys[i], pObj->lastKey);
+      i++;
+      continue;
+    }
+
+    // find the run of rows with increasing keys
+    int   start = i;
+    TSKEY prevKey = pObj->lastKey;
+    while (i < numOfPoints && keys[i] > prevKey && VALID_TIMESTAMP(keys[i], tsKey, (int32_t)pVnode->cfg.precision)) {
+      prevKey = keys[i++];
+    }
+
+    if (i == start) {
+      code = TSDB_CODE_TIMESTAMP_OUT_OF_RANGE;
+      break;
+    }
+
+    int num = vnodeInsertColumnsToCache(pObj, pSubmit->payLoad, numOfPoints, start, i - start);
+    if (num > 0) {
+      pObj->lastKey = keys[start + num - 1];
+      points += num;
+    }
+
+    if (num < i - start) {
+      code = TSDB_CODE_ACTION_IN_PROGRESS;
+      break;
+    }
+  }
+
+  atomic_fetch_add_64(&(pVnode->vnodeStatistic.pointsWritten), points * (pObj->numOfColumns - 1));
+  atomic_fetch_add_64(&(pVnode->vnodeStatistic.totalStorage), points * pObj->bytesPerPoint);
+
+  pthread_mutex_lock(&(pVnode->vmutex));
+
+  if (pObj->lastKey > pVnode->lastKey) pVnode->lastKey = pObj->lastKey;
+
+  if (firstKey < pVnode->firstKey) pVnode->firstKey = firstKey;
+
+  pVnode->version++;
+
+  pthread_mutex_unlock(&(pVnode->vmutex));
+
+  vnodeClearMeterState(pObj, TSDB_METER_STATE_INSERT);
+
+_over:
+  dTrace("vid:%d sid:%d id:%s, %d out of %d points are inserted from columnar block, lastKey:%ld", pObj->vnode,
+         pObj->sid, pObj->meterId, points, numOfPoints, pObj->lastKey);
+
+  *numOfInsertPoints = points;
+  return code;
+}
+
 /**
  * continue running of the function may cause the free vnode crash with high probability
  * todo fix it by set flag to disable commit in any cases
@@ -24,6 +24,7 @@
 #include "tscompression.h"
 #include "ttime.h"
 #include "vnode.h"
+#include "vnodeBlockCache.h"
 #include "vnodeRead.h"
 #include "vnodeUtil.h"
 
@@ -338,6 +339,16 @@ static int32_t doOpenQueryFileData(SQInfo* pQInfo, SQueryFilesInfo* pVnodeFileIn
     dError("QInfo:%p failed open last file:%s reason:%s", pQInfo, pVnodeFileInfo->lastFilePath, strerror(errno));
     return -1;
   }
+
+  struct stat fstat1, fstat2;
+  if (fstat(pVnodeFileInfo->dataFd, &fstat1) < 0 || fstat(pVnodeFileInfo->lastFd, &fstat2) < 0) {
+    dError("QInfo:%p failed to stat data/last file:%s reason:%s", pQInfo, pVnodeFileInfo->dataFilePath,
+           strerror(errno));
+    return -1;
+  }
+
+  pVnodeFileInfo->dataFileIno = fstat1.st_ino;
+  pVnodeFileInfo->lastFileIno = fstat2.st_ino;
   
   pVnodeFileInfo->pHeaderFileData = mmap(NULL, pVnodeFileInfo->headFileSize, PROT_READ, MAP_SHARED,
                                          pVnodeFileInfo->headerFd, 0);
@@ -526,6 +537,7 @@ static int vnodeGetCompBlockInfo(SMeterObj *pMeterObj, SQueryRuntimeEnv *pRuntim
 
   pQuery->pFields = (SField **)((char *)pQuery->pBlock + compBlockSize);
   vnodeSetCompBlockInfoLoaded(pRuntimeEnv, fileIndex, pMeterObj->sid);
+  vnodeResetReadAhead(pRuntimeEnv);
 
   int64_t et = taosGetTimestampUs();
   qTrace("QInfo:%p vid:%d sid:%d id:%s, fileId:%d, load compblock info, size:%d, elapsed:%f ms", pQInfo,
@@ -709,17 +721,77 @@ static int32_t readDataFromDiskFile(int fd, SQInfo *pQInfo, SQueryFilesInfo *pQu
                                     int32_t size) {
   assert(size >= 0);
 
-  int32_t ret = (int32_t)lseek(fd, offset, SEEK_SET);
+  /* positional read, the file offset shared with other readers of the fd is not touched */
+  ssize_t ret = pread(fd, buf, size, offset);
   if (ret == -1) {
-    //        qTrace("QInfo:%p seek failed, reason:%s", pQInfo, strerror(errno));
+    //        qTrace("QInfo:%p read failed, reason:%s", pQInfo, strerror(errno));
     return -1;
   }
 
-  ret = read(fd, buf, size);
   //    qTrace("QInfo:%p read data %d completed", pQInfo, size);
   return 0;
 }
 
+void vnodeResetReadAhead(SQueryRuntimeEnv *pRuntimeEnv) { pRuntimeEnv->readAheadIndex = -1; }
+
+static void issueReadAhead(int32_t fd, int64_t offset, int64_t len) {
+  if (FD_VALID(fd) && len > 0) {
+    posix_fadvise(fd, offset, len, POSIX_FADV_WILLNEED);
+  }
+}
+
+/*
+ * Ask the kernel to read the next tsQueryReadAheadBlocks data blocks into the page cache. The advice returns
+ * immediately, so the disk I/O of the following blocks overlaps with the decompression and computing of the current
+ * one, and the synchronous read of a block that has been read ahead is served from the page cache. Adjacent blocks in
+ * the same file are merged into one request. The window is refilled only when half of it has been consumed.
+ */
+void vnodeReadAheadDataBlocks(SQueryRuntimeEnv *pRuntimeEnv, void *pBlockList, int32_t numOfBlocks, int32_t current,
+                              int32_t step, __get_comp_block_fn_t getBlockFn) {
+  if (tsQueryReadAheadBlocks <= 0 || numOfBlocks <= 0) {
+    return;
+  }
+
+  int32_t ahead = (pRuntimeEnv->readAheadIndex >= 0) ? (pRuntimeEnv->readAheadIndex - current) * step : 0;
+  if (ahead > (tsQueryReadAheadBlocks >> 1)) {
+    return;
+  }
+
+  int32_t start = (ahead > 0) ? pRuntimeEnv->readAheadIndex + step : current + step;
+  int32_t end = current + step * tsQueryReadAheadBlocks;
+  end = (end >= numOfBlocks) ? numOfBlocks - 1 : ((end < 0) ? 0 : end);
+
+  SQueryFilesInfo *pVnodeFileInfo = &pRuntimeEnv->vnodeFileInfo;
+
+  int32_t fd = FD_INITIALIZER;
+  int64_t offset = 0;
+  int64_t len = 0;
+
+  for (int32_t i = start; (end - i) * step >= 0; i += step) {
+    SCompBlock *pBlock = getBlockFn(pBlockList, i);
+    int32_t     blockFd = pBlock->last ? pVnodeFileInfo->lastFd : pVnodeFileInfo->dataFd;
+
+    if (blockFd == fd && pBlock->offset == offset + len) {
+      len += pBlock->len;
+    } else if (blockFd == fd && pBlock->offset + pBlock->len == offset) {
+      offset = pBlock->offset;
+      len += pBlock->len;
+    } else {
+      issueReadAhead(fd, offset, len);
+
+      fd = blockFd;
+      offset = pBlock->offset;
+      len = pBlock->len;
+    }
+
+    pRuntimeEnv->readAheadIndex = i;
+  }
+
+  issueReadAhead(fd, offset, len);
+}
+
+static SCompBlock *getCompBlockInQuery(void *pBlockList, int32_t index) { return &((SCompBlock *)pBlockList)[index]; }
+
 static int32_t loadColumnIntoMem(SQuery *pQuery, SQueryFilesInfo *pQueryFileInfo, SCompBlock *pBlock, SField *pFields,
                                  int32_t col, SData *sdata, void *tmpBuf, char *buffer, int32_t buffersize) {
   char *dst = (pBlock->algorithm) ? tmpBuf : sdata->data;
@@ -727,6 +799,18 @@ static int32_t loadColumnIntoMem(SQuery *pQuery, SQueryFilesInfo *pQueryFileInfo
   int64_t offset = pBlock->offset + pFields[col].offset;
   SQInfo *pQInfo = (SQInfo *)GET_QINFO_ADDR(pQuery);
 
+  // the decompressed column may have been loaded by another query
+  int32_t        size = pFields[col].bytes * pBlock->numOfPoints;
+  SBlockCacheKey key = {.vnode = pQueryFileInfo->vnodeId,
+                        .fileId = pQueryFileInfo->pFileInfo[pQueryFileInfo->current].fileID,
+                        .fileIno = pBlock->last ? pQueryFileInfo->lastFileIno : pQueryFileInfo->dataFileIno,
+                        .offset = offset,
+                        .colId = pFields[col].colId};
+
+  if (vnodeGetColumnFromBlockCache(&key, sdata->data, size)) {
+    return 0;
+  }
+
   int     fd = pBlock->last ? pQueryFileInfo->lastFd : pQueryFileInfo->dataFd;
   int32_t ret = readDataFromDiskFile(fd, pQInfo, pQueryFileInfo, dst, offset, pFields[col].len);
   if (ret != 0) {
@@ -750,10 +834,18 @@ static int32_t loadColumnIntoMem(SQuery *pQuery, SQueryFilesInfo *pQueryFileInfo
   }
 
   if (pBlock->algorithm) {
-    (*pDecompFunc[pFields[col].type])(tmpBuf, pFields[col].len, pBlock->numOfPoints, sdata->data,
-                                      pFields[col].bytes * pBlock->numOfPoints, pBlock->algorithm, buffer, buffersize);
+    __decompress_fn_t decompFunc = tsGetColumnDecompFunc(pFields[col].codec, pFields[col].type);
+    if (decompFunc == NULL) {
+      dLError("QInfo:%p, invalid column codec:%d type:%d, file:%s, col:%d, offset:%ld", GET_QINFO_ADDR(pQuery),
+              pFields[col].codec, pFields[col].type, pQueryFileInfo->dataFilePath, col, offset);
+      return -TSDB_CODE_FILE_CORRUPTED;
+    }
+
+    (*decompFunc)(tmpBuf, pFields[col].len, pBlock->numOfPoints, sdata->data, size, pBlock->algorithm, buffer,
+                  buffersize);
   }
 
+  vnodePutColumnIntoBlockCache(&key, sdata->data, size);
   return 0;
 }
 
@@ -885,6 +977,7 @@ static int32_t loadDataBlockIntoMem(SCompBlock *pBlock, SField **pField, SQueryR
                                   pRuntimeEnv->secondaryUnzipBuffer, pRuntimeEnv->unzipBufSize);
 
           pSummary->numOfSeek++;
+          if (ret != 0) break;
         }
       }
       ++i;
@@ -936,10 +1029,11 @@ SBlockInfo getBlockBasicInfo(void *pBlock, int32_t blockType) {
     blockInfo.numOfCols = pDiskBlock->numOfCols;
   } else {
     SCacheBlock *pCacheBlock = (SCacheBlock *)pBlock;
+    int32_t      numOfPoints = atomic_load_16(&pCacheBlock->numOfPoints);
 
     blockInfo.keyFirst = getTimestampInCacheBlock(pCacheBlock, 0);
-    blockInfo.keyLast = getTimestampInCacheBlock(pCacheBlock, pCacheBlock->numOfPoints - 1);
-    blockInfo.size = pCacheBlock->numOfPoints;
+    blockInfo.keyLast = getTimestampInCacheBlock(pCacheBlock, numOfPoints - 1);
+    blockInfo.size = numOfPoints;
     blockInfo.numOfCols = pCacheBlock->pMeterObj->numOfColumns;
   }
 
@@ -1370,8 +1464,8 @@ static bool needToLoadDataBlock(SQuery *pQuery, SField *pField, SQLFunctionCtx *
     }
 
     if (pFilterInfo->info.data.type == TSDB_DATA_TYPE_FLOAT) {
-      float minval = *(double *)(&pField[colIndex].min);
-      float maxval = *(double *)(&pField[colIndex].max);
+      float minval = *(float *)(&pField[colIndex].min);
+      float maxval = *(float *)(&pField[colIndex].max);
 
       for (int32_t i = 0; i < pFilterInfo->numOfFilters; ++i) {
         if (pFilterInfo->pFilters[i].fp(&pFilterInfo->pFilters[i], (char *)&minval, (char *)&maxval)) {
@@ -1398,6 +1492,39 @@ static bool needToLoadDataBlock(SQuery *pQuery, SField *pField, SQLFunctionCtx *
   return true;
 }
 
+/*
+ * all data in this block satisfy the value filter according to the min/max of each filter column, so the block can be
+ * handled in the same way as a query without filter, and the aggregates can be answered by the SField statistics.
+ */
+static bool filterAllQualifiedInBlock(SQuery *pQuery, SField *pField) {
+  if (pField == NULL) {
+    return false;
+  }
+
+  for (int32_t k = 0; k < pQuery->numOfFilterCols; ++k) {
+    SSingleColumnFilterInfo *pFilterInfo = &pQuery->pFilterInfo[k];
+    int32_t                  colIndex = pFilterInfo->info.colIdx;
+
+    // null value never satisfies the filter
+    if (colIndex < 0 || pField[colIndex].colId != pFilterInfo->info.data.colId ||
+        pField[colIndex].numOfNullPoints > 0) {
+      return false;
+    }
+
+    bool qualified = false;
+    for (int32_t i = 0; i < pFilterInfo->numOfFilters && !qualified; ++i) {
+      qualified = vnodeFilterAllQualified(&pFilterInfo->pFilters[i], pFilterInfo->info.data.type,
+                                          &pField[colIndex].min, &pField[colIndex].max);
+    }
+
+    if (!qualified) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 static int32_t setGroupResultForKey(SQueryRuntimeEnv *pRuntimeEnv, char *pData, int16_t type, char *columnData) {
   SOutputRes *pOutputRes = NULL;
 
@@ -1606,6 +1733,31 @@ static int32_t rowwiseApplyAllFunctions(SQueryRuntimeEnv *pRuntimeEnv, int32_t *
 
   int32_t numOfRes = 0;
   int32_t step = GET_FORWARD_DIRECTION_FACTOR(pQuery->order.order);
+  int32_t numOfRows = (*forwardStep);
+
+  // evaluate the filters over the whole range of rows before applying the functions row by row
+  uint8_t *pSelection = NULL;
+  int32_t  selectionStart = 0;
+  if (pQuery->numOfFilterCols > 0 && numOfRows > 0) {
+    selectionStart = QUERY_IS_ASC_QUERY(pQuery) ? pQuery->pos : pQuery->pos - numOfRows + 1;
+    pSelection = malloc(numOfRows * 2);
+    if (pSelection == NULL) {
+      SQInfo *pQInfo = (SQInfo *)GET_QINFO_ADDR(pQuery);
+      dError("QInfo:%p failed to allocate filter selection for %d rows", pQInfo, numOfRows);
+
+      pQInfo->code = -TSDB_CODE_SERV_OUT_OF_MEMORY;
+      pQInfo->killed = 1;
+      setQueryStatus(pQuery, QUERY_NO_DATA_TO_CHECK);
+
+      free(sasArray);
+      return 0;
+    }
+
+    int32_t numOfQualified = vnodeFilterDataBlock(pQuery, selectionStart, numOfRows, pSelection, pSelection + numOfRows);
+    if (numOfQualified == 0 && pRuntimeEnv->pTSBuf == NULL) {
+      numOfRows = 0;
+    }
+  }
 
   // from top to bottom in desc
   // from bottom to top in asc order
@@ -1615,7 +1767,7 @@ static int32_t rowwiseApplyAllFunctions(SQueryRuntimeEnv *pRuntimeEnv, int32_t *
            pQuery->order.order, pRuntimeEnv->pTSBuf->cur.order);
   }
 
-  for (int32_t j = 0; j < (*forwardStep); ++j) {
+  for (int32_t j = 0; j < numOfRows; ++j) {
     int32_t offset = GET_COL_DATA_POS(pQuery, j, step);
 
     if (pRuntimeEnv->pTSBuf != NULL) {
@@ -1630,7 +1782,7 @@ static int32_t rowwiseApplyAllFunctions(SQueryRuntimeEnv *pRuntimeEnv, int32_t *
       }
     }
 
-    if (pQuery->numOfFilterCols > 0 && (!vnodeDoFilterData(pQuery, offset))) {
+    if (pSelection != NULL && pSelection[offset - selectionStart] == 0) {
       continue;
     }
 
@@ -1674,6 +1826,7 @@ static int32_t rowwiseApplyAllFunctions(SQueryRuntimeEnv *pRuntimeEnv, int32_t *
   }
 
   free(sasArray);
+  tfree(pSelection);
 
   /*
    * No need to calculate the number of output results for groupby normal columns
@@ -1805,7 +1958,8 @@ static int32_t applyFunctionsOnBlock(SQueryRuntimeEnv *pRuntimeEnv, SBlockInfo *
 
   bool isFileBlock = IS_FILE_BLOCK(pRuntimeEnv->blockStatus);
 
-  if (pQuery->numOfFilterCols > 0 || pRuntimeEnv->pTSBuf != NULL || isGroupbyNormalCol(pQuery->pGroupbyExpr)) {
+  bool filter = (pQuery->numOfFilterCols > 0) && !filterAllQualifiedInBlock(pQuery, pFields);
+  if (filter || pRuntimeEnv->pTSBuf != NULL || isGroupbyNormalCol(pQuery->pGroupbyExpr)) {
     *numOfRes =
         rowwiseApplyAllFunctions(pRuntimeEnv, &newForwardStep, pPrimaryColumn, sdata, pFields, pBlockInfo, isFileBlock);
   } else {
@@ -2457,11 +2611,7 @@ void getBasicCacheInfoSnapshot(SQuery *pQuery, SCacheInfo *pCacheInfo, int32_t v
   int32_t numOfBlocks = 0;
   int32_t lastSlot = 0;
 
-  SCachePool *pPool = (SCachePool *)vnodeList[vid].pCachePool;
-  pthread_mutex_lock(&pPool->vmutex);
-  numOfBlocks = pCacheInfo->numOfBlocks;
-  lastSlot = pCacheInfo->currentSlot;
-  pthread_mutex_unlock(&pPool->vmutex);
+  vnodeGetCacheInfoSnapshot(pCacheInfo, &lastSlot, &numOfBlocks);
 
   // make sure it is there, otherwise, return right away
   pQuery->currentSlot = lastSlot;
@@ -3791,6 +3941,11 @@ void vnodeQueryFreeQInfoEx(SQInfo *pQInfo) {
   SQuery *               pQuery = &pQInfo->query;
   SMeterQuerySupportObj *pSupporter = pQInfo->pMeterQuerySupporter;
 
+  for (int32_t i = 0; i < pSupporter->numOfSubQueries; ++i) {
+    vnodeFreeQInfo(pSupporter->pSubQInfo[i], false);
+  }
+  tfree(pSupporter->pSubQInfo);
+
   teardownQueryRuntimeEnv(&pSupporter->runtimeEnv);
   tfree(pSupporter->pMeterSidExtInfo);
 
@@ -4252,6 +4407,9 @@ static int32_t moveToNextBlock(SQueryRuntimeEnv *pRuntimeEnv, int32_t step, __bl
       return DISK_DATA_LOADED;
     }
 
+    vnodeReadAheadDataBlocks(pRuntimeEnv, pQuery->pBlock, pQuery->numOfBlocks, pQuery->slot, step,
+                             getCompBlockInQuery);
+
     int32_t ret =
         LoadDatablockOnDemand(&pQuery->pBlock[pQuery->slot], &pQuery->pFields[pQuery->slot], &pRuntimeEnv->blockStatus,
                               pRuntimeEnv, fileIndex, pQuery->slot, searchFn, true);
@@ -5750,6 +5908,123 @@ static tFilePage *allocNewPage(SQuery* pQuery, SMeterQuerySupportObj *pSupporter
   return getFilePage(pSupporter, *pageId);
 }
 
+static void addQueryCostSummary(SQueryCostSummary *pDst, SQueryCostSummary *pSrc) {
+  pDst->cacheTimeUs += pSrc->cacheTimeUs;
+  pDst->fileTimeUs += pSrc->fileTimeUs;
+  pDst->numOfFiles += pSrc->numOfFiles;
+  pDst->numOfSeek += pSrc->numOfSeek;
+  pDst->readDiskBlocks += pSrc->readDiskBlocks;
+  pDst->skippedFileBlocks += pSrc->skippedFileBlocks;
+  pDst->blocksInCache += pSrc->blocksInCache;
+  pDst->readField += pSrc->readField;
+  pDst->totalFieldSize += pSrc->totalFieldSize;
+  pDst->loadFieldUs += pSrc->loadFieldUs;
+  pDst->totalBlockSize += pSrc->totalBlockSize;
+  pDst->loadBlocksUs += pSrc->loadBlocksUs;
+  pDst->totalGenData += pSrc->totalGenData;
+  pDst->readCompInfo += pSrc->readCompInfo;
+  pDst->totalCompInfoSize += pSrc->totalCompInfoSize;
+  pDst->loadCompInfoUs += pSrc->loadCompInfoUs;
+  pDst->tmpBufferInDisk += pSrc->tmpBufferInDisk;
+}
+
+/*
+ * the pages of each meter are copied into the disk-based buffer of the query, and the SMeterQueryInfo is taken over
+ * by the meter of the query with the same sid, so the results are merged as if all meters are scanned by the query
+ */
+static int32_t moveSubQueryResults(SQInfo *pQInfo, SQInfo *pSub, void *pSidIndex) {
+  SQuery *               pQuery = &pQInfo->query;
+  SMeterQuerySupportObj *pSupporter = pQInfo->pMeterQuerySupporter;
+  SMeterQuerySupportObj *pSubSupporter = pSub->pMeterQuerySupporter;
+
+  if (pSubSupporter->pMeterDataInfo == NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  for (int32_t i = 0; i < pSubSupporter->numOfMeters; ++i) {
+    SMeterDataInfo * pSubMeterInfo = &pSubSupporter->pMeterDataInfo[i];
+    SMeterQueryInfo *pMeterQueryInfo = pSubMeterInfo->pMeterQInfo;
+    if (pMeterQueryInfo == NULL) {
+      continue;
+    }
+
+    int32_t *index = (int32_t *)taosGetIntHashData(pSidIndex, pSubSupporter->pSidSet->pSids[i]->sid);
+    assert(index != NULL && pSupporter->pMeterDataInfo[*index].pMeterQInfo == NULL);
+
+    for (int32_t j = 0; j < pMeterQueryInfo->numOfPages; ++j) {
+      uint32_t   pageId = 0;
+      tFilePage *pPage = allocNewPage(pQuery, pSupporter, &pageId);
+      if (pPage == NULL) {
+        return pQInfo->code;
+      }
+
+      memcpy(pPage, getFilePage(pSubSupporter, pMeterQueryInfo->pageList[j]), DEFAULT_INTERN_BUF_SIZE);
+      pMeterQueryInfo->pageList[j] = pageId;
+    }
+
+    pSupporter->pMeterDataInfo[*index].pMeterQInfo = pMeterQueryInfo;
+    pSubMeterInfo->pMeterQInfo = NULL;
+  }
+
+  addQueryCostSummary(&pSupporter->runtimeEnv.summary, &pSubSupporter->runtimeEnv.summary);
+  return TSDB_CODE_SUCCESS;
+}
+
+int32_t vnodeMoveSubQueryResults(SQInfo *pQInfo) {
+  SQuery *               pQuery = &pQInfo->query;
+  SMeterQuerySupportObj *pSupporter = pQInfo->pMeterQuerySupporter;
+  tSidSet *              pSidSet = pSupporter->pSidSet;
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  void *  pSidIndex = taosInitIntHash(pSupporter->numOfMeters, sizeof(int32_t), taosHashInt);
+
+  for (int32_t i = 0; i < pSidSet->numOfSubSet; ++i) {
+    for (int32_t j = pSidSet->starterPos[i]; j < pSidSet->starterPos[i + 1]; ++j) {
+      SMeterObj *pMeterObj = getMeterObj(pSupporter->pMeterObj, pSidSet->pSids[j]->sid);
+      setMeterDataInfo(&pSupporter->pMeterDataInfo[j], pMeterObj, j, i);
+      taosAddIntHash(pSidIndex, pSidSet->pSids[j]->sid, (char *)&j);
+    }
+  }
+
+  for (int32_t i = 0; i < pSupporter->numOfSubQueries; ++i) {
+    SQInfo *pSub = pSupporter->pSubQInfo[i];
+
+    if (code == TSDB_CODE_SUCCESS && pSub->code != TSDB_CODE_SUCCESS) {
+      code = pSub->code;
+    }
+
+    if (code == TSDB_CODE_SUCCESS) {
+      code = moveSubQueryResults(pQInfo, pSub, pSidIndex);
+    }
+
+    vnodeFreeQInfo(pSub, false);
+  }
+
+  pSupporter->numOfSubQueries = 0;
+  tfree(pSupporter->pSubQInfo);
+  taosCleanUpIntHash(pSidIndex);
+
+  // the meters without any data in sub queries
+  for (int32_t i = 0; i < pSupporter->numOfMeters; ++i) {
+    if (pSupporter->pMeterDataInfo[i].pMeterQInfo == NULL) {
+      pSupporter->pMeterDataInfo[i].pMeterQInfo =
+          createMeterQueryInfo(pQuery, pSupporter->rawSKey, pSupporter->rawEKey);
+    }
+  }
+
+  /*
+   * the result info of the last scanned meter is used by the merge stage when the meters are scanned by the query
+   * itself, the result info of runtime environment is used instead since no meter is scanned here
+   */
+  SQueryRuntimeEnv *pRuntimeEnv = &pSupporter->runtimeEnv;
+  for (int32_t i = 0; i < pQuery->numOfOutputCols; ++i) {
+    pRuntimeEnv->pCtx[i].resultInfo = &pRuntimeEnv->resultInfo[i];
+  }
+
+  pRuntimeEnv->summary.numOfTables = pSupporter->numOfMeters;
+  return code;
+}
+
 tFilePage *addDataPageForMeterQueryInfo(SQuery* pQuery, SMeterQueryInfo *pMeterQueryInfo, SMeterQuerySupportObj *pSupporter) {
   uint32_t   pageId = 0;
   
@@ -6614,11 +6889,32 @@ int32_t LoadDatablockOnDemand(SCompBlock *pBlock, SField **pFields, uint8_t *blk
   SET_FILE_BLOCK_FLAG(*blkStatus);
   SET_DATA_BLOCK_NOT_LOADED(*blkStatus);
 
+  bool fieldsLoaded = false;
+
   if (((pQuery->lastKey <= pBlock->keyFirst && pQuery->ekey >= pBlock->keyLast && QUERY_IS_ASC_QUERY(pQuery)) ||
        (pQuery->ekey <= pBlock->keyFirst && pQuery->lastKey >= pBlock->keyLast && !QUERY_IS_ASC_QUERY(pQuery))) &&
       onDemand) {
     int32_t req = 0;
-    if (pQuery->numOfFilterCols > 0) {
+    bool    filter = (pQuery->numOfFilterCols > 0);
+
+    if (filter && pRuntimeEnv->pTSBuf == NULL) {
+      // the value filter may be decided to be all-false or all-true by the statistics of this block
+      if (loadDataBlockFieldsInfo(pRuntimeEnv, pBlock, pFields) < 0) {
+        return DISK_DATA_LOAD_FAILED;
+      }
+
+      fieldsLoaded = true;
+      if (!needToLoadDataBlock(pQuery, *pFields, pRuntimeEnv->pCtx)) {
+        qTrace("QInfo:%p id:%s slot:%d, data block ignored by pre-filter, fields loaded, brange:%lld-%lld, rows:%d",
+               GET_QINFO_ADDR(pQuery), pMeterObj->meterId, pQuery->slot, pBlock->keyFirst, pBlock->keyLast,
+               pBlock->numOfPoints);
+        return DISK_DATA_DISCARDED;
+      }
+
+      filter = !filterAllQualifiedInBlock(pQuery, *pFields);
+    }
+
+    if (filter) {
       req = BLK_DATA_ALL_NEEDED;
     } else {
       for (int32_t i = 0; i < pQuery->numOfOutputCols; ++i) {
@@ -6639,7 +6935,7 @@ int32_t LoadDatablockOnDemand(SCompBlock *pBlock, SField **pFields, uint8_t *blk
 
       setTimestampRange(pRuntimeEnv, pBlock->keyFirst, pBlock->keyLast);
     } else if (req == BLK_DATA_FILEDS_NEEDED) {
-      if (loadDataBlockFieldsInfo(pRuntimeEnv, pBlock, pFields) < 0) {
+      if (!fieldsLoaded && loadDataBlockFieldsInfo(pRuntimeEnv, pBlock, pFields) < 0) {
         return DISK_DATA_LOAD_FAILED;
       }
     } else {
@@ -6648,7 +6944,7 @@ int32_t LoadDatablockOnDemand(SCompBlock *pBlock, SField **pFields, uint8_t *blk
     }
   } else {
   _load_all:
-    if (loadDataBlockFieldsInfo(pRuntimeEnv, pBlock, pFields) < 0) {
+    if (!fieldsLoaded && loadDataBlockFieldsInfo(pRuntimeEnv, pBlock, pFields) < 0) {
       return DISK_DATA_LOAD_FAILED;
     }
 
@@ -6980,6 +7276,10 @@ int32_t vnodeGetResultSize(void *thandle, int32_t *numOfRows) {
 
 int64_t vnodeGetOffsetVal(void *thandle) {
   SQInfo *pQInfo = (SQInfo *)thandle;
+  if (pQInfo->pRetrievePage != NULL) {
+    return pQInfo->pRetrievePage->offset;
+  }
+
   return pQInfo->query.limit.offset;
 }
 
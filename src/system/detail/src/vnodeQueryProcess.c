@@ -259,6 +259,10 @@ static SMeterDataInfo *queryOnMultiDataCache(SQInfo *pQInfo, SMeterDataInfo *pMe
   return pMeterInfo;
 }
 
+static SCompBlock *getCompBlockInBlockInfoEx(void *pBlockList, int32_t index) {
+  return ((SMeterDataBlockInfoEx *)pBlockList)[index].pBlock.compBlock;
+}
+
 static SMeterDataInfo *queryOnMultiDataFiles(SQInfo *pQInfo, SMeterDataInfo *pMeterDataInfo) {
   SQuery *               pQuery = &pQInfo->query;
   SMeterQuerySupportObj *pSupporter = pQInfo->pMeterQuerySupporter;
@@ -356,12 +360,15 @@ static SMeterDataInfo *queryOnMultiDataFiles(SQInfo *pQInfo, SMeterDataInfo *pMe
 
     // sequentially scan the pHeaderFileData file
     int32_t j = QUERY_IS_ASC_QUERY(pQuery) ? 0 : numOfBlocks - 1;
+    vnodeResetReadAhead(pRuntimeEnv);
 
     for (; j < numOfBlocks && j >= 0; j += step) {
       if (isQueryKilled(pQuery)) {
         break;
       }
 
+      vnodeReadAheadDataBlocks(pRuntimeEnv, pDataBlockInfoEx, numOfBlocks, j - step, step, getCompBlockInBlockInfoEx);
+
       /* output elapsed time for log every TRACE_OUTPUT_BLOCK_CNT blocks */
       if (j == 0) {
         stimeUnit = taosGetTimestampMs();
@@ -863,6 +870,157 @@ static void doMultiMeterSupplementaryScan(SQInfo *pQInfo) {
   SET_MASTER_SCAN_FLAG(pRuntimeEnv);
 }
 
+/*
+ * scan all data of the meters in both files and cache, and close the intermediate results of each meter,
+ * followed by the supplementary scan
+ */
+static int32_t doMultiMeterScan(SQInfo *pQInfo) {
+  SMeterQuerySupportObj *pSupporter = pQInfo->pMeterQuerySupporter;
+  SQuery *               pQuery = &pQInfo->query;
+
+  dTrace("QInfo:%p main query scan start", pQInfo);
+  int64_t st = taosGetTimestampMs();
+  doOrderedScan(pQInfo);
+  int64_t et = taosGetTimestampMs();
+  dTrace("QInfo:%p main scan completed, elapsed time: %lldms, supplementary scan start, order:%d", pQInfo, et - st,
+         pQuery->order.order ^ 1);
+
+  // failed to save all intermediate results into disk, abort further query processing
+  if (doCloseAllOpenedResults(pSupporter) != TSDB_CODE_SUCCESS) {
+    dError("QInfo:%p failed to save intermediate results, abort further query processing", pQInfo);
+    return TSDB_CODE_APP_ERROR;
+  }
+
+  doMultiMeterSupplementaryScan(pQInfo);
+  return TSDB_CODE_SUCCESS;
+}
+
+typedef struct SSubQueryRunner {
+  SQInfo **pSubQInfo;
+  int32_t  numOfSubQueries;
+  int32_t  nextIdx;    // index of the next sub query to be scanned
+  int32_t  numOfRefs;  // the query itself and the helper tasks which may be still in queue
+  sem_t    finished;   // posted once a sub query is completed
+} SSubQueryRunner;
+
+static void doScanSubQueries(SSubQueryRunner *pRunner) {
+  while (1) {
+    int32_t idx = atomic_fetch_add_32(&pRunner->nextIdx, 1);
+    if (idx >= pRunner->numOfSubQueries) {
+      break;
+    }
+
+    SQInfo *               pSub = pRunner->pSubQInfo[idx];
+    SMeterQuerySupportObj *pSupporter = pSub->pMeterQuerySupporter;
+
+    pSupporter->pMeterDataInfo = (SMeterDataInfo *)calloc(1, sizeof(SMeterDataInfo) * pSupporter->numOfMeters);
+    if (pSupporter->pMeterDataInfo == NULL) {
+      pSub->code = -TSDB_CODE_SERV_OUT_OF_MEMORY;
+    } else if (!pSub->killed && doMultiMeterScan(pSub) != TSDB_CODE_SUCCESS && pSub->code == TSDB_CODE_SUCCESS) {
+      pSub->code = -TSDB_CODE_APP_ERROR;
+    }
+
+    sem_post(&pRunner->finished);
+  }
+}
+
+static void releaseSubQueryRunner(SSubQueryRunner *pRunner) {
+  if (atomic_sub_fetch_32(&pRunner->numOfRefs, 1) == 0) {
+    sem_destroy(&pRunner->finished);
+    free(pRunner);
+  }
+}
+
+static void vnodeScanSubQueries(SSchedMsg *pMsg) {
+  SSubQueryRunner *pRunner = (SSubQueryRunner *)pMsg->ahandle;
+
+  doScanSubQueries(pRunner);
+  releaseSubQueryRunner(pRunner);
+}
+
+/*
+ * The sub queries are scanned by the query thread together with the helper tasks in query queue. The query thread
+ * never blocks on a sub query that is not started yet, so no deadlock happens even if all query threads are occupied.
+ */
+static int32_t doParallelMultiMeterScan(SQInfo *pQInfo) {
+  SMeterQuerySupportObj *pSupporter = pQInfo->pMeterQuerySupporter;
+  SQuery *               pQuery = &pQInfo->query;
+
+  SSubQueryRunner *pRunner = calloc(1, sizeof(SSubQueryRunner));
+  if (pRunner == NULL) {
+    dError("QInfo:%p failed to allocate memory, %s", pQInfo, strerror(errno));
+    pQInfo->code = -TSDB_CODE_SERV_OUT_OF_MEMORY;
+    pQInfo->killed = 1;
+    return pQInfo->code;
+  }
+
+  pRunner->pSubQInfo = pSupporter->pSubQInfo;
+  pRunner->numOfSubQueries = pSupporter->numOfSubQueries;
+  pRunner->numOfRefs = 1;
+  sem_init(&pRunner->finished, 0, 0);
+
+  dTrace("QInfo:%p parallel scan start, %d sub queries", pQInfo, pRunner->numOfSubQueries);
+  int64_t st = taosGetTimestampMs();
+
+  /*
+   * this thread is a worker of the query queue, so it must not block on a full queue. The sub queries not taken by
+   * any helper task are scanned by this thread below
+   */
+  for (int32_t i = 1; i < pRunner->numOfSubQueries; ++i) {
+    SSchedMsg schedMsg = {0};
+    schedMsg.fp = vnodeScanSubQueries;
+    schedMsg.ahandle = pRunner;
+
+    atomic_add_fetch_32(&pRunner->numOfRefs, 1);
+    if (taosTryScheduleTask(queryQhandle, &schedMsg) != 0) {
+      atomic_sub_fetch_32(&pRunner->numOfRefs, 1);
+      dTrace("QInfo:%p query queue is full, %d helper tasks are scheduled", pQInfo, i - 1);
+      break;
+    }
+  }
+
+  doScanSubQueries(pRunner);
+
+  // wait for the sub queries scanned by other threads, and pass the kill flag to them
+  for (int32_t i = 0; i < pRunner->numOfSubQueries;) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_nsec += 100 * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+      ts.tv_sec += 1;
+      ts.tv_nsec -= 1000000000L;
+    }
+
+    if (sem_timedwait(&pRunner->finished, &ts) == 0) {
+      i++;
+    } else if (isQueryKilled(pQuery)) {
+      for (int32_t j = 0; j < pRunner->numOfSubQueries; ++j) {
+        pRunner->pSubQInfo[j]->killed = 1;
+      }
+    }
+  }
+
+  releaseSubQueryRunner(pRunner);
+
+  // the sub query is killed if any of its meters is going to be deleted, so the query is aborted as well
+  for (int32_t i = 0; i < pSupporter->numOfSubQueries; ++i) {
+    if (pSupporter->pSubQInfo[i]->killed) {
+      pQInfo->killed = 1;
+    }
+  }
+
+  dTrace("QInfo:%p parallel scan completed, elapsed time: %lldms", pQInfo, taosGetTimestampMs() - st);
+
+  int32_t code = vnodeMoveSubQueryResults(pQInfo);
+  if (code != TSDB_CODE_SUCCESS) {
+    dError("QInfo:%p failed to scan in sub queries, code:%d, abort", pQInfo, code);
+    pQInfo->code = code;
+    pQInfo->killed = 1;
+  }
+
+  return code;
+}
+
 static void vnodeMultiMeterQueryProcessor(SQInfo *pQInfo) {
   SMeterQuerySupportObj *pSupporter = pQInfo->pMeterQuerySupporter;
   SQuery *               pQuery = &pQInfo->query;
@@ -902,20 +1060,13 @@ static void vnodeMultiMeterQueryProcessor(SQInfo *pQInfo) {
   dTrace("QInfo:%p query start, qrange:%lld-%lld, order:%d, group:%d", pQInfo, pSupporter->rawSKey, pSupporter->rawEKey,
          pQuery->order.order, pSupporter->pSidSet->numOfSubSet);
 
-  dTrace("QInfo:%p main query scan start", pQInfo);
-  int64_t st = taosGetTimestampMs();
-  doOrderedScan(pQInfo);
-  int64_t et = taosGetTimestampMs();
-  dTrace("QInfo:%p main scan completed, elapsed time: %lldms, supplementary scan start, order:%d", pQInfo, et - st,
-         pQuery->order.order ^ 1);
-
-  // failed to save all intermediate results into disk, abort further query processing
-  if (doCloseAllOpenedResults(pSupporter) != TSDB_CODE_SUCCESS) {
-    dError("QInfo:%p failed to save intermediate results, abort further query processing", pQInfo);
+  if (pSupporter->numOfSubQueries > 0) {
+    if (doParallelMultiMeterScan(pQInfo) != TSDB_CODE_SUCCESS) {
+      return;
+    }
+  } else if (doMultiMeterScan(pQInfo) != TSDB_CODE_SUCCESS) {
     return;
   }
-  
-  doMultiMeterSupplementaryScan(pQInfo);
 
   if (isQueryKilled(pQuery)) {
     dTrace("QInfo:%p query killed, abort", pQInfo);
@@ -1171,12 +1322,6 @@ void vnodeSingleMeterQuery(SSchedMsg *pMsg) {
     return;
   }
 
-  if (pQInfo->killed) {
-    TSDB_QINFO_RESET_SIG(pQInfo);
-    dTrace("QInfo:%p it is already killed, reset signature and abort", pQInfo);
-    return;
-  }
-
   assert(pQInfo->signature == TSDB_QINFO_QUERY_FLAG);
 
   SQuery *   pQuery = &pQInfo->query;
@@ -1210,12 +1355,6 @@ void vnodeSingleMeterQuery(SSchedMsg *pMsg) {
         "totalReturn:%d",
         pQInfo, pMeterObj->vnode, pMeterObj->sid, pMeterObj->meterId, pQuery->pointsRead, numOfInterpo,
         pQInfo->pointsRead, pQInfo->pointsInterpo, pQInfo->pointsReturned);
-
-    dTrace("QInfo:%p reset signature", pQInfo);
-
-    TSDB_QINFO_RESET_SIG(pQInfo);
-    sem_post(&pQInfo->dataReady);
-
     return;
   }
 
@@ -1232,24 +1371,16 @@ void vnodeSingleMeterQuery(SSchedMsg *pMsg) {
           dTrace("QInfo:%p vid:%d sid:%d id:%s, %d points returned %d from group results, totalRead:%d totalReturn:%d",
                  pQInfo, pMeterObj->vnode, pMeterObj->sid, pMeterObj->meterId, pQuery->pointsRead, pQInfo->pointsRead,
                  pQInfo->pointsInterpo, pQInfo->pointsReturned);
-
-          dTrace("QInfo:%p reset signature", pQInfo);
-
-          TSDB_QINFO_RESET_SIG(pQInfo);
-          sem_post(&pQInfo->dataReady);
           return;
         }
       }
     }
 
     pQInfo->over = 1;
-    dTrace("QInfo:%p vid:%d sid:%d id:%s, query over, %d points are returned, reset signature", pQInfo,
-           pMeterObj->vnode, pMeterObj->sid, pMeterObj->meterId, pQInfo->pointsRead);
+    dTrace("QInfo:%p vid:%d sid:%d id:%s, query over, %d points are returned", pQInfo, pMeterObj->vnode,
+           pMeterObj->sid, pMeterObj->meterId, pQInfo->pointsRead);
 
     vnodePrintQueryStatistics(pQInfo->pMeterQuerySupporter);
-    TSDB_QINFO_RESET_SIG(pQInfo);
-    sem_post(&pQInfo->dataReady);
-
     return;
   }
 
@@ -1277,15 +1408,12 @@ void vnodeSingleMeterQuery(SSchedMsg *pMsg) {
 
   /* check if query is killed or not */
   if (isQueryKilled(pQuery)) {
-    dTrace("QInfo:%p query is killed, reset signature", pQInfo);
+    dTrace("QInfo:%p query is killed", pQInfo);
     pQInfo->over = 1;
   } else {
-    dTrace("QInfo:%p vid:%d sid:%d id:%s, meter query thread completed, %d points are returned, reset signature",
-           pQInfo, pMeterObj->vnode, pMeterObj->sid, pMeterObj->meterId, pQuery->pointsRead);
+    dTrace("QInfo:%p vid:%d sid:%d id:%s, meter query thread completed, %d points are returned", pQInfo,
+           pMeterObj->vnode, pMeterObj->sid, pMeterObj->meterId, pQuery->pointsRead);
   }
-
-  TSDB_QINFO_RESET_SIG(pQInfo);
-  sem_post(&pQInfo->dataReady);
 }
 
 void vnodeMultiMeterQuery(SSchedMsg *pMsg) {
@@ -1295,12 +1423,6 @@ void vnodeMultiMeterQuery(SSchedMsg *pMsg) {
     return;
   }
 
-  if (pQInfo->killed) {
-    TSDB_QINFO_RESET_SIG(pQInfo);
-    dTrace("QInfo:%p it is already killed, reset signature and abort", pQInfo);
-    return;
-  }
-
   assert(pQInfo->signature == TSDB_QINFO_QUERY_FLAG);
 
   SQuery *pQuery = &pQInfo->query;
@@ -1322,7 +1444,6 @@ void vnodeMultiMeterQuery(SSchedMsg *pMsg) {
   pQInfo->useconds += (taosGetTimestampUs() - st);
   pQInfo->over = isQueryKilled(pQuery) ? 1 : 0;
 
-  dTrace("QInfo:%p reset signature", pQInfo);
   taosInterpoSetStartInfo(&pQInfo->pMeterQuerySupporter->runtimeEnv.interpoInfo, pQuery->pointsRead,
                           pQInfo->query.interpoType);
 
@@ -1330,11 +1451,8 @@ void vnodeMultiMeterQuery(SSchedMsg *pMsg) {
 
   if (pQuery->pointsRead == 0) {
     pQInfo->over = 1;
-    dTrace("QInfo:%p over, %d meters queried, %d points are returned, reset signature", pQInfo, pSupporter->numOfMeters,
+    dTrace("QInfo:%p over, %d meters queried, %d points are returned", pQInfo, pSupporter->numOfMeters,
            pQInfo->pointsRead);
     vnodePrintQueryStatistics(pSupporter);
   }
-
-  TSDB_QINFO_RESET_SIG(pQInfo);
-  sem_post(&pQInfo->dataReady);
 }
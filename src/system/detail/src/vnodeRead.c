@@ -24,6 +24,7 @@
 #include "tscompression.h"
 #include "vnode.h"
 #include "vnodeRead.h"
+#include "vnodeQueryImpl.h"
 #include "vnodeUtil.h"
 
 #pragma GCC diagnostic ignored "-Wint-conversion"
@@ -394,8 +395,48 @@ __clean_memory:
   return NULL;
 }
 
+static void vnodeInitQueryResultPages(SQInfo *pQInfo) {
+  pthread_mutex_init(&pQInfo->resultLock, NULL);
+  pthread_cond_init(&pQInfo->roundDone, NULL);
+  pQInfo->roundState = TSDB_QROUND_DONE;
+  pQInfo->window = 1;
+}
+
+static void vnodeFreeQueryResultPages(SQInfo *pQInfo) {
+  SQueryResultPage *pPage = pQInfo->pPageHead;
+  while (pPage != NULL) {
+    SQueryResultPage *pNext = pPage->next;
+    free(pPage);
+    pPage = pNext;
+  }
+
+  tfree(pQInfo->pRetrievePage);
+  pQInfo->pPageHead = pQInfo->pPageTail = NULL;
+  pQInfo->numOfPages = 0;
+
+  pthread_cond_destroy(&pQInfo->roundDone);
+  pthread_mutex_destroy(&pQInfo->resultLock);
+}
+
 static void vnodeFreeQInfoInQueueImpl(SSchedMsg *pMsg) {
   SQInfo *pQInfo = (SQInfo *)pMsg->ahandle;
+  if (!vnodeIsQInfoValid(pQInfo)) return;
+
+  /*
+   * The round holding the query flag may wait in queue behind this urgent task, so the worker shall not wait for the
+   * flag. Out of a round, the flag is only held under the resultLock, and the round resets it under the lock as well.
+   * So if the flag is held here, the free is handed over to the round, which sees the killed flag and frees the QInfo.
+   */
+  pthread_mutex_lock(&pQInfo->resultLock);
+  bool inRound = (pQInfo->signature == TSDB_QINFO_QUERY_FLAG);
+  pQInfo->freeInRound = inRound;
+  pthread_mutex_unlock(&pQInfo->resultLock);
+
+  if (inRound) {
+    dTrace("QInfo:%p query round is running, it frees the QInfo when it ends", pQInfo);
+    return;
+  }
+
   vnodeFreeQInfo(pQInfo, true);
 }
 
@@ -413,7 +454,9 @@ void vnodeFreeQInfoInQueue(void *param) {
   schedMsg.msg = NULL;
   schedMsg.thandle = (void *)1;
   schedMsg.ahandle = param;
-  taosScheduleTask(queryQhandle, &schedMsg);
+
+  // the killed query is released ahead of the queries waiting in queue, to free its resources asap
+  taosScheduleTaskWithPriority(queryQhandle, &schedMsg, TSCHED_PRIORITY_URGENT);
 }
 
 void vnodeFreeQInfo(void *param, bool decQueryRef) {
@@ -423,6 +466,10 @@ void vnodeFreeQInfo(void *param, bool decQueryRef) {
   pQInfo->killed = 1;
   TSDB_WAIT_TO_SAFE_DROP_QINFO(pQInfo);
 
+  // the round resets the signature and posts dataReady under the resultLock, wait for it to leave
+  pthread_mutex_lock(&pQInfo->resultLock);
+  pthread_mutex_unlock(&pQInfo->resultLock);
+
   SMeterObj *pObj = pQInfo->pObj;
   dTrace("QInfo:%p start to free SQInfo", pQInfo);
 
@@ -452,6 +499,7 @@ void vnodeFreeQInfo(void *param, bool decQueryRef) {
   }
 
   sem_destroy(&(pQInfo->dataReady));
+  vnodeFreeQueryResultPages(pQInfo);
   vnodeQueryFreeQInfoEx(pQInfo);
 
   for (int32_t i = 0; i < pQuery->numOfFilterCols; ++i) {
@@ -510,12 +558,6 @@ void vnodeQueryData(SSchedMsg *pMsg) {
 
   pQInfo = (SQInfo *)pMsg->ahandle;
 
-  if (pQInfo->killed) {
-    TSDB_QINFO_RESET_SIG(pQInfo);
-    dTrace("QInfo:%p it is already killed, reset signature and abort", pQInfo);
-    return;
-  }
-
   assert(pQInfo->signature == TSDB_QINFO_QUERY_FLAG);
   pQuery = &(pQInfo->query);
 
@@ -583,11 +625,122 @@ void vnodeQueryData(SSchedMsg *pMsg) {
     tclose(pQInfo->query.dfd);
     tclose(pQInfo->query.lfd);
   }
+}
+
+static void vnodeQueryRound(SSchedMsg *pMsg);
+
+// the query flag shall be set by caller
+static void vnodeScheduleQueryRound(SQInfo *pQInfo) {
+  SSchedMsg schedMsg = {0};
+
+  pQInfo->roundState = TSDB_QROUND_RUNNING;
+
+  schedMsg.fp = vnodeQueryRound;
+  schedMsg.msg = NULL;
+  schedMsg.thandle = (void *)1;
+  schedMsg.ahandle = pQInfo;
+  taosScheduleTask(queryQhandle, &schedMsg);
+}
+
+/*
+ * move the results of the completed round in sdata into a page, if the window advertised by client is not full.
+ * The results of the last round are left in sdata, as well as the results of ts comp query in a file.
+ */
+static bool vnodePrefetchRoundResults(SQInfo *pQInfo) {
+  SQuery *pQuery = &pQInfo->query;
+  int32_t numOfRows = pQInfo->pointsRead - pQInfo->pointsReturned;
+
+  if (pQInfo->over != 0 || pQInfo->killed != 0 || pQInfo->code != TSDB_CODE_SUCCESS || numOfRows <= 0 ||
+      pQInfo->numOfPages + 1 >= pQInfo->window || isTSCompQuery(pQuery)) {
+    return false;
+  }
+
+  SQueryResultPage *pPage = malloc(sizeof(SQueryResultPage) + pQuery->rowSize * numOfRows);
+  if (pPage == NULL) {
+    return false;
+  }
+
+  pPage->next = NULL;
+  pPage->numOfRows = vnodeCopyQueryResultToMsg(pQInfo, pPage->data, numOfRows);
+  pPage->offset = pQuery->limit.offset;
+  pQInfo->pointsReturned += pPage->numOfRows;
+
+  if (pQInfo->pPageTail != NULL) {
+    pQInfo->pPageTail->next = pPage;
+  } else {
+    pQInfo->pPageHead = pPage;
+  }
+  pQInfo->pPageTail = pPage;
+  pQInfo->numOfPages++;
+
+  dTrace("QInfo:%p %d rows are prefetched, pages:%d window:%d", pQInfo, pPage->numOfRows, pQInfo->numOfPages,
+         pQInfo->window);
+  return true;
+}
+
+// the caller holds the resultLock and the query flag, which is kept by the next round if it is launched
+static bool vnodeLaunchNextRound(SQInfo *pQInfo, bool prefetch) {
+  if (prefetch && !vnodePrefetchRoundResults(pQInfo)) {
+    return false;
+  }
+
+  if (pQInfo->pMeterQuerySupporter == NULL) {
+    pQInfo->bufIndex = pQInfo->bufIndex ^ 1;  // exchange between 0 and 1
+  }
+
+  dTrace("%p add query into task queue for schedule", pQInfo);
+  vnodeScheduleQueryRound(pQInfo);
+  return true;
+}
+
+/*
+ * The query flag is held during the whole round, and the round is ended here instead of in the query functions:
+ * the results are moved into a page and the round state is updated before the signature is reset and dataReady is
+ * posted. Both are done under the resultLock, which is also taken by vnodeFreeQInfo before it is released.
+ */
+static void vnodeQueryRound(SSchedMsg *pMsg) {
+  SQInfo *pQInfo = (SQInfo *)pMsg->ahandle;
+
+  if (pQInfo->killed) {
+    dTrace("QInfo:%p it is already killed, reset signature and abort", pQInfo);
+
+    pthread_mutex_lock(&pQInfo->resultLock);
+    TSDB_QINFO_RESET_SIG(pQInfo);
+    bool freeInRound = pQInfo->freeInRound;
+    pthread_mutex_unlock(&pQInfo->resultLock);
+
+    if (freeInRound) vnodeFreeQInfo(pQInfo, true);
+    return;
+  }
+
+  if (pQInfo->pMeterQuerySupporter != NULL) {
+    if (pQInfo->pMeterQuerySupporter->pSidSet == NULL) {
+      vnodeSingleMeterQuery(pMsg);
+    } else {  // group by tag
+      vnodeMultiMeterQuery(pMsg);
+    }
+  } else {
+    vnodeQueryData(pMsg);
+  }
+
+  pthread_mutex_lock(&pQInfo->resultLock);
+
+  pQInfo->roundState = TSDB_QROUND_DONE;
+  bool launched = vnodeLaunchNextRound(pQInfo, true);
+  pthread_cond_broadcast(&pQInfo->roundDone);
+
+  bool freeInRound = false;
+  if (!launched) {
+    dTrace("QInfo:%p reset signature", pQInfo);
+    TSDB_QINFO_RESET_SIG(pQInfo);
+    freeInRound = pQInfo->freeInRound;
+  }
 
-  /* reset QInfo signature */
-  dTrace("QInfo:%p reset signature", pQInfo);
-  TSDB_QINFO_RESET_SIG(pQInfo);
   sem_post(&pQInfo->dataReady);
+  pthread_mutex_unlock(&pQInfo->resultLock);
+
+  // the free task has found this round running, the QInfo is freed here
+  if (freeInRound) vnodeFreeQInfo(pQInfo, true);
 }
 
 void *vnodeQueryInTimeRange(SMeterObj **pMetersObj, SSqlGroupbyExpr *pGroupbyExpr, SSqlFunctionExpr *pSqlExprs,
@@ -620,6 +773,7 @@ void *vnodeQueryInTimeRange(SMeterObj **pMetersObj, SSqlGroupbyExpr *pGroupbyExp
   pQInfo->fp = pQueryFunc[pQueryMsg->order];
   pQInfo->num = pQueryMsg->num;
 
+  vnodeInitQueryResultPages(pQInfo);
   if (sem_init(&(pQInfo->dataReady), 0, 0) != 0) {
     dError("QInfo:%p vid:%d sid:%d meterId:%s, init dataReady sem failed, reason:%s", pQInfo, pMeterObj->vnode,
            pMeterObj->sid, pMeterObj->meterId, strerror(errno));
@@ -627,8 +781,6 @@ void *vnodeQueryInTimeRange(SMeterObj **pMetersObj, SSqlGroupbyExpr *pGroupbyExp
     goto _error;
   }
 
-  SSchedMsg schedMsg = {0};
-
   if (!isProjQuery) {
     if (vnodeParametersSafetyCheck(pQuery) == false) {
       *code = TSDB_CODE_APP_ERROR;
@@ -663,22 +815,14 @@ void *vnodeQueryInTimeRange(SMeterObj **pMetersObj, SSqlGroupbyExpr *pGroupbyExp
     if (pQInfo->over == 1) {
       return pQInfo;
     }
-
-    schedMsg.fp = vnodeSingleMeterQuery;
-  } else {
-    schedMsg.fp = vnodeQueryData;
   }
 
   // set in query flag
   pQInfo->signature = TSDB_QINFO_QUERY_FLAG;
 
-  schedMsg.msg = NULL;
-  schedMsg.thandle = (void *)1;
-  schedMsg.ahandle = pQInfo;
-
   dTrace("QInfo:%p set query flag and prepare runtime environment completed, wait for schedule", pQInfo);
 
-  taosScheduleTask(queryQhandle, &schedMsg);
+  vnodeScheduleQueryRound(pQInfo);
   return pQInfo;
 
 _error:
@@ -687,6 +831,155 @@ _error:
   return NULL;
 }
 
+static SMeterQuerySupportObj *vnodeCreateMultiMeterSupporter(SMeterObj **pMetersObj, SMeterSidExtInfo **pSids,
+                                                              int32_t numOfSids, SQueryMeterMsg *pQueryMsg,
+                                                              SSqlGroupbyExpr *pGroupbyExpr) {
+  SMeterQuerySupportObj *pSupporter = (SMeterQuerySupportObj *)calloc(1, sizeof(SMeterQuerySupportObj));
+  if (pSupporter == NULL) {
+    return NULL;
+  }
+
+  pSupporter->numOfMeters = numOfSids;
+
+  pSupporter->pMeterObj = taosInitIntHash(pSupporter->numOfMeters, POINTER_BYTES, taosHashInt);
+  for (int32_t i = 0; i < pSupporter->numOfMeters; ++i) {
+    taosAddIntHash(pSupporter->pMeterObj, pMetersObj[i]->sid, (char *)&pMetersObj[i]);
+  }
+
+  int32_t sidElemLen = pQueryMsg->tagLength + sizeof(SMeterSidExtInfo);
+
+  int32_t size = POINTER_BYTES * numOfSids + sidElemLen * numOfSids;
+  pSupporter->pMeterSidExtInfo = (SMeterSidExtInfo **)malloc(size);
+  if (pSupporter->pMeterSidExtInfo == NULL) {
+    taosCleanUpIntHash(pSupporter->pMeterObj);
+    free(pSupporter);
+    return NULL;
+  }
+
+  char *px = ((char *)pSupporter->pMeterSidExtInfo) + POINTER_BYTES * numOfSids;
+
+  for (int32_t i = 0; i < numOfSids; ++i) {
+    pSupporter->pMeterSidExtInfo[i] = (SMeterSidExtInfo *)px;
+    pSupporter->pMeterSidExtInfo[i]->sid = pSids[i]->sid;
+
+    if (pQueryMsg->tagLength > 0) {
+      memcpy(pSupporter->pMeterSidExtInfo[i]->tags, pSids[i]->tags, pQueryMsg->tagLength);
+    }
+    px += sidElemLen;
+  }
+
+  if (pGroupbyExpr != NULL && pGroupbyExpr->numOfGroupCols > 0) {
+    pSupporter->pSidSet =
+        tSidSetCreate(pSupporter->pMeterSidExtInfo, numOfSids, (SSchema *)pQueryMsg->pTagSchema,
+                      pQueryMsg->numOfTagsCols, pGroupbyExpr->columnInfo, pGroupbyExpr->numOfGroupCols);
+  } else {
+    pSupporter->pSidSet = tSidSetCreate(pSupporter->pMeterSidExtInfo, numOfSids, (SSchema *)pQueryMsg->pTagSchema,
+                                        pQueryMsg->numOfTagsCols, NULL, 0);
+  }
+
+  return pSupporter;
+}
+
+static SQInfo *vnodeCreateSubQuery(SQInfo *pQInfo, SMeterObj **pMetersObj, SMeterSidExtInfo **pSids,
+                                   int32_t numOfSids, SQueryMeterMsg *pQueryMsg) {
+  SQuery *pQuery = &pQInfo->query;
+
+  // the expressions are owned by each query, the arithmetic expression is excluded, so a plain copy is enough
+  size_t            size = sizeof(SSqlFunctionExpr) * pQuery->numOfOutputCols;
+  SSqlFunctionExpr *pExprs = malloc(size);
+  if (pExprs == NULL) {
+    return NULL;
+  }
+  memcpy(pExprs, pQuery->pSelectExpr, size);
+
+  SSqlGroupbyExpr *pGroupbyExpr = NULL;
+  if (pQuery->pGroupbyExpr != NULL) {
+    size = sizeof(SSqlGroupbyExpr) + pQuery->pGroupbyExpr->numOfGroupCols * sizeof(SColIndexEx);
+    if ((pGroupbyExpr = malloc(size)) == NULL) {
+      free(pExprs);
+      return NULL;
+    }
+    memcpy(pGroupbyExpr, pQuery->pGroupbyExpr, size);
+  }
+
+  SQInfo *pSub = vnodeAllocateQInfoEx(pQueryMsg, pGroupbyExpr, pExprs, pMetersObj[0]);
+  if (pSub == NULL) {
+    return NULL;
+  }
+
+  pSub->query.skey = pQueryMsg->skey;
+  pSub->query.ekey = pQueryMsg->ekey;
+  pSub->fp = pQInfo->fp;
+  pSub->num = pQInfo->num;
+
+  vnodeInitQueryResultPages(pSub);
+  if (sem_init(&pSub->dataReady, 0, 0) != 0) {
+    vnodeFreeQInfo(pSub, false);
+    return NULL;
+  }
+
+  pSub->pMeterQuerySupporter = vnodeCreateMultiMeterSupporter(pMetersObj, pSids, numOfSids, pQueryMsg, pGroupbyExpr);
+  if (pSub->pMeterQuerySupporter == NULL ||
+      vnodeMultiMeterQueryPrepare(pSub, &pSub->query, NULL) != TSDB_CODE_SUCCESS) {
+    vnodeFreeQInfo(pSub, false);
+    return NULL;
+  }
+
+  return pSub;
+}
+
+/*
+ * The meters of an interval query on super table are split into sub queries, which are scanned on the query threads
+ * in parallel, and the intermediate results of each meter are merged into groups by the query itself. If any sub query
+ * fails to be created, the meters are scanned by the query itself.
+ */
+static void vnodeCreateSubQueries(SQInfo *pQInfo, SMeterObj **pMetersObj, SQueryMeterMsg *pQueryMsg) {
+  SQuery *               pQuery = &pQInfo->query;
+  SMeterQuerySupportObj *pSupporter = pQInfo->pMeterQuerySupporter;
+
+  // sub queries more than the cores only take turns on them, and the merge of their results is not paid back
+  int32_t maxSubQueries = MIN(tsNumOfQueryThreads, tsNumOfCores);
+  int32_t numOfSubQueries = MIN(maxSubQueries, pQueryMsg->numOfSids / TSDB_MIN_METERS_OF_SUB_QUERY);
+  if (pQuery->nAggTimeInterval == 0 || numOfSubQueries <= 1) {
+    return;
+  }
+
+  for (int32_t i = 0; i < pQuery->numOfOutputCols; ++i) {
+    if (pQuery->pSelectExpr[i].pBase.functionId == TSDB_FUNC_ARITHM) {
+      return;
+    }
+  }
+
+  pSupporter->pSubQInfo = calloc(numOfSubQueries, POINTER_BYTES);
+  if (pSupporter->pSubQInfo == NULL) {
+    return;
+  }
+
+  SMeterSidExtInfo **pSids = (SMeterSidExtInfo **)pQueryMsg->pSidExtInfo;
+
+  for (int32_t i = 0; i < numOfSubQueries; ++i) {
+    int32_t start = (int32_t)((int64_t)pQueryMsg->numOfSids * i / numOfSubQueries);
+    int32_t end = (int32_t)((int64_t)pQueryMsg->numOfSids * (i + 1) / numOfSubQueries);
+
+    SQInfo *pSub = vnodeCreateSubQuery(pQInfo, pMetersObj + start, pSids + start, end - start, pQueryMsg);
+    if (pSub == NULL) {
+      dError("QInfo:%p failed to create sub query, scan %d meters in one thread", pQInfo, pQueryMsg->numOfSids);
+
+      for (int32_t j = 0; j < pSupporter->numOfSubQueries; ++j) {
+        vnodeFreeQInfo(pSupporter->pSubQInfo[j], false);
+      }
+
+      pSupporter->numOfSubQueries = 0;
+      tfree(pSupporter->pSubQInfo);
+      return;
+    }
+
+    pSupporter->pSubQInfo[pSupporter->numOfSubQueries++] = pSub;
+  }
+
+  dTrace("QInfo:%p %d meters are scanned by %d sub queries", pQInfo, pQueryMsg->numOfSids, numOfSubQueries);
+}
+
 /*
  * query on multi-meters
  */
@@ -713,6 +1006,7 @@ void *vnodeQueryOnMultiMeters(SMeterObj **pMetersObj, SSqlGroupbyExpr *pGroupbyE
   pQInfo->fp = pQueryFunc[pQueryMsg->order];
   pQInfo->num = pQueryMsg->num;
 
+  vnodeInitQueryResultPages(pQInfo);
   if (sem_init(&(pQInfo->dataReady), 0, 0) != 0) {
     dError("QInfo:%p vid:%d sid:%d id:%s, init dataReady sem failed, reason:%s", pQInfo, pMetersObj[0]->vnode,
            pMetersObj[0]->sid, pMetersObj[0]->meterId, strerror(errno));
@@ -720,49 +1014,14 @@ void *vnodeQueryOnMultiMeters(SMeterObj **pMetersObj, SSqlGroupbyExpr *pGroupbyE
     goto _error;
   }
 
-  SSchedMsg schedMsg = {0};
-
-  SMeterQuerySupportObj *pSupporter = (SMeterQuerySupportObj *)calloc(1, sizeof(SMeterQuerySupportObj));
-  pSupporter->numOfMeters = pQueryMsg->numOfSids;
-
-  pSupporter->pMeterObj = taosInitIntHash(pSupporter->numOfMeters, POINTER_BYTES, taosHashInt);
-  for (int32_t i = 0; i < pSupporter->numOfMeters; ++i) {
-    taosAddIntHash(pSupporter->pMeterObj, pMetersObj[i]->sid, (char *)&pMetersObj[i]);
-  }
-
-  pSupporter->pMeterSidExtInfo = (SMeterSidExtInfo **)pQueryMsg->pSidExtInfo;
-  int32_t sidElemLen = pQueryMsg->tagLength + sizeof(SMeterSidExtInfo);
-
-  int32_t size = POINTER_BYTES * pQueryMsg->numOfSids + sidElemLen * pQueryMsg->numOfSids;
-  pSupporter->pMeterSidExtInfo = (SMeterSidExtInfo **)malloc(size);
-  if (pSupporter->pMeterSidExtInfo == NULL) {
+  SMeterQuerySupportObj *pSupporter = vnodeCreateMultiMeterSupporter(
+      pMetersObj, (SMeterSidExtInfo **)pQueryMsg->pSidExtInfo, pQueryMsg->numOfSids, pQueryMsg, pGroupbyExpr);
+  if (pSupporter == NULL) {
     *code = TSDB_CODE_SERV_OUT_OF_MEMORY;
-    dError("QInfo:%p failed to allocate memory for meterSid info, size:%d, abort", pQInfo, size);
+    dError("QInfo:%p failed to allocate memory for meterSid info, abort", pQInfo);
     goto _error;
   }
 
-  char *px = ((char *)pSupporter->pMeterSidExtInfo) + POINTER_BYTES * pQueryMsg->numOfSids;
-
-  for (int32_t i = 0; i < pQueryMsg->numOfSids; ++i) {
-    pSupporter->pMeterSidExtInfo[i] = (SMeterSidExtInfo *)px;
-    pSupporter->pMeterSidExtInfo[i]->sid = ((SMeterSidExtInfo **)pQueryMsg->pSidExtInfo)[i]->sid;
-
-    if (pQueryMsg->tagLength > 0) {
-      memcpy(pSupporter->pMeterSidExtInfo[i]->tags, ((SMeterSidExtInfo **)pQueryMsg->pSidExtInfo)[i]->tags,
-             pQueryMsg->tagLength);
-    }
-    px += sidElemLen;
-  }
-
-  if (pGroupbyExpr != NULL && pGroupbyExpr->numOfGroupCols > 0) {
-    pSupporter->pSidSet =
-        tSidSetCreate(pSupporter->pMeterSidExtInfo, pQueryMsg->numOfSids, (SSchema *)pQueryMsg->pTagSchema,
-                      pQueryMsg->numOfTagsCols, pGroupbyExpr->columnInfo, pGroupbyExpr->numOfGroupCols);
-  } else {
-    pSupporter->pSidSet = tSidSetCreate(pSupporter->pMeterSidExtInfo, pQueryMsg->numOfSids,
-                                        (SSchema *)pQueryMsg->pTagSchema, pQueryMsg->numOfTagsCols, NULL, 0);
-  }
-
   pQInfo->pMeterQuerySupporter = pSupporter;
 
   STSBuf *pTSBuf = NULL;
@@ -771,6 +1030,8 @@ void *vnodeQueryOnMultiMeters(SMeterObj **pMetersObj, SSqlGroupbyExpr *pGroupbyE
     char *tsBlock = (char *)pQueryMsg + pQueryMsg->tsOffset;
     pTSBuf = tsBufCreateFromCompBlocks(tsBlock, pQueryMsg->tsNumOfBlocks, pQueryMsg->tsLen, pQueryMsg->tsOrder);
     tsBufResetPos(pTSBuf);
+  } else {
+    vnodeCreateSubQueries(pQInfo, pMetersObj, pQueryMsg);
   }
 
   if (((*code) = vnodeMultiMeterQueryPrepare(pQInfo, pQuery, pTSBuf)) != TSDB_CODE_SUCCESS) {
@@ -783,14 +1044,9 @@ void *vnodeQueryOnMultiMeters(SMeterObj **pMetersObj, SSqlGroupbyExpr *pGroupbyE
 
   pQInfo->signature = TSDB_QINFO_QUERY_FLAG;
 
-  schedMsg.msg = NULL;
-  schedMsg.thandle = (void *)1;
-  schedMsg.ahandle = pQInfo;
-  schedMsg.fp = vnodeMultiMeterQuery;
-
   dTrace("QInfo:%p set query flag and prepare runtime environment completed, wait for schedule", pQInfo);
 
-  taosScheduleTask(queryQhandle, &schedMsg);
+  vnodeScheduleQueryRound(pQInfo);
   return pQInfo;
 
 _error:
@@ -804,7 +1060,7 @@ _error:
    the point to retrieved column
 */
 
-int vnodeRetrieveQueryInfo(void *handle, int *numOfRows, int *rowSize, int16_t *timePrec) {
+int vnodeRetrieveQueryInfo(void *handle, int32_t window, int *numOfRows, int *rowSize, int16_t *timePrec) {
   SQInfo *pQInfo;
   SQuery *pQuery;
 
@@ -833,7 +1089,27 @@ int vnodeRetrieveQueryInfo(void *handle, int *numOfRows, int *rowSize, int16_t *
   }
 
   sem_wait(&pQInfo->dataReady);
-  *numOfRows = pQInfo->pointsRead - pQInfo->pointsReturned;
+
+  pthread_mutex_lock(&pQInfo->resultLock);
+  pQInfo->window = MIN(MAX(window, 1), TSDB_MAX_RETRIEVE_WINDOW);
+
+  // the round has posted dataReady, wait for it to decide whether its results are moved into a page
+  while (pQInfo->pPageHead == NULL && pQInfo->roundState == TSDB_QROUND_RUNNING) {
+    pthread_cond_wait(&pQInfo->roundDone, &pQInfo->resultLock);
+  }
+
+  if (pQInfo->pPageHead != NULL) {
+    pQInfo->pRetrievePage = pQInfo->pPageHead;
+    pQInfo->pPageHead = pQInfo->pPageHead->next;
+    if (pQInfo->pPageHead == NULL) pQInfo->pPageTail = NULL;
+    pQInfo->numOfPages--;
+
+    *numOfRows = pQInfo->pRetrievePage->numOfRows;
+  } else {
+    *numOfRows = pQInfo->pointsRead - pQInfo->pointsReturned;
+  }
+  pthread_mutex_unlock(&pQInfo->resultLock);
+
   *rowSize = pQuery->rowSize;
 
   *timePrec = vnodeList[pQInfo->pObj->vnode].cfg.precision;
@@ -851,17 +1127,35 @@ int vnodeRetrieveQueryInfo(void *handle, int *numOfRows, int *rowSize, int16_t *
 // vnodeRetrieveQueryInfo must be called first
 int vnodeSaveQueryResult(void *handle, char *data, int32_t *size) {
   SQInfo *pQInfo = (SQInfo *)handle;
+  int32_t numOfFinal = 0;
+  bool    prefetch = false;
 
-  // the remained number of retrieved rows, not the interpolated result
-  int numOfRows = pQInfo->pointsRead - pQInfo->pointsReturned;
+  pthread_mutex_lock(&pQInfo->resultLock);
 
-  int32_t numOfFinal = vnodeCopyQueryResultToMsg(pQInfo, data, numOfRows);
-  pQInfo->pointsReturned += numOfFinal;
+  SQueryResultPage *pPage = pQInfo->pRetrievePage;
+  if (pPage != NULL) {
+    pQInfo->pRetrievePage = NULL;
+    numOfFinal = pPage->numOfRows;
+    memcpy(data, pPage->data, (*size));
+    free(pPage);
 
-  dTrace("QInfo:%p %d are returned, totalReturned:%d totalRead:%d", pQInfo, numOfFinal, pQInfo->pointsReturned,
-         pQInfo->pointsRead);
+    dTrace("QInfo:%p %d prefetched are returned, pages:%d totalReturned:%d totalRead:%d", pQInfo, numOfFinal,
+           pQInfo->numOfPages, pQInfo->pointsReturned, pQInfo->pointsRead);
 
-  if (pQInfo->over == 0) {
+    // the window is not full any more, the round waiting in sdata is moved into a page if no round is running
+    prefetch = true;
+  } else {
+    // the remained number of retrieved rows, not the interpolated result
+    int numOfRows = pQInfo->pointsRead - pQInfo->pointsReturned;
+
+    numOfFinal = vnodeCopyQueryResultToMsg(pQInfo, data, numOfRows);
+    pQInfo->pointsReturned += numOfFinal;
+
+    dTrace("QInfo:%p %d are returned, totalReturned:%d totalRead:%d", pQInfo, numOfFinal, pQInfo->pointsReturned,
+           pQInfo->pointsRead);
+  }
+
+  if (pQInfo->over == 0 && pQInfo->roundState == TSDB_QROUND_DONE) {
     //dTrace("QInfo:%p set query flag, oldSig:%p, func:%s", pQInfo, pQInfo->signature, __FUNCTION__);
     dTrace("QInfo:%p set query flag, oldSig:%p", pQInfo, pQInfo->signature);
     uint64_t oldSignature = TSDB_QINFO_SET_QUERY_FLAG(pQInfo);
@@ -873,29 +1167,12 @@ int vnodeSaveQueryResult(void *handle, char *data, int32_t *size) {
      */
     if (oldSignature == 0 || oldSignature != (uint64_t)pQInfo) {
       dTrace("%p freed or killed, old sig:%p abort query", pQInfo, oldSignature);
-    } else {
-      dTrace("%p add query into task queue for schedule", pQInfo);
-
-      SSchedMsg schedMsg;
-
-      if (pQInfo->pMeterQuerySupporter != NULL) {
-        if (pQInfo->pMeterQuerySupporter->pSidSet == NULL) {
-          schedMsg.fp = vnodeSingleMeterQuery;
-        } else {  // group by tag
-          schedMsg.fp = vnodeMultiMeterQuery;
-        }
-      } else {
-        pQInfo->bufIndex = pQInfo->bufIndex ^ 1;  // exchange between 0 and 1
-        schedMsg.fp = vnodeQueryData;
-      }
-
-      schedMsg.msg = NULL;
-      schedMsg.thandle = (void *)1;
-      schedMsg.ahandle = pQInfo;
-      taosScheduleTask(queryQhandle, &schedMsg);
+    } else if (!vnodeLaunchNextRound(pQInfo, prefetch)) {
+      TSDB_QINFO_RESET_SIG(pQInfo);
     }
   }
 
+  pthread_mutex_unlock(&pQInfo->resultLock);
   return numOfFinal;
 }
 
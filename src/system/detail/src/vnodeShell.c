@@ -39,21 +39,62 @@ SShellObj **shellList = NULL;
 int vnodeProcessRetrieveRequest(char *pMsg, int msgLen, SShellObj *pObj);
 int vnodeProcessQueryRequest(char *pMsg, int msgLen, SShellObj *pObj);
 int vnodeProcessShellSubmitRequest(char *pMsg, int msgLen, SShellObj *pObj);
-static void vnodeProcessBatchSubmitTimer(void *param, void *tmrId);
+int vnodeSendShellSubmitRspMsg(SShellObj *pObj, int code, int numOfPoints);
+static void vnodeProcessPendingSubmitTimer(void *param, void *tmrId);
 
 int vnodeSelectReqNum = 0;
 int vnodeInsertReqNum = 0;
 
+/*
+ * An insert is split by the sid of blocks into parts, one part for each write lane. The response is sent back once
+ * all parts are processed.
+ */
 typedef struct {
+  SShellObj *pObj;
+  int32_t    numOfParts;   // parts not processed yet
+  int32_t    code;         // code of the first failed part
+  int32_t    numOfPoints;
+} SSubmitJob;
+
+typedef struct _batch_submit_info {
   int32_t import;
+  int32_t columnar;  // payload of blocks is column-major
   int32_t vnode;
   int32_t numOfSid;
   int32_t ssid;   // Start sid
   SShellObj *pObj;
   int64_t offset; // offset relative the blks
+  int64_t parkTime;  // us, when it is put into the pending queue
+  SSubmitJob *pJob;  // not NULL if it is a part processed by a write lane
+  int32_t numOfPoints;  // points inserted by the part
+  struct _batch_submit_info *next;
   char    blks[];
 } SBatchSubmitInfo;
 
+/*
+ * Submits blocked by a full cache or an ongoing commit are parked in the queue of the vnode, and resumed in order
+ * when the commit is over. Once the queue is not empty, new submits are appended to it, so that the rows of a
+ * meter are not reordered.
+ */
+typedef struct {
+  pthread_mutex_t   mutex;
+  SBatchSubmitInfo *pHead;
+  SBatchSubmitInfo *pTail;
+  int32_t           numOfSubmits;
+  bool              draining;     // submits are being resumed
+  bool              timerStarted;
+  int32_t           numOfLaneParts;  // parts dispatched to the write lanes and not processed yet
+  pthread_cond_t    lanePartsDone;   // signaled when numOfLaneParts drops to 0
+} SPendingSubmitQueue;
+
+#define VNODE_PENDING_SUBMIT_RETRY_MS 100
+
+static SPendingSubmitQueue vnodePendingSubmits[TSDB_MAX_VNODES];
+static int64_t             vnodeSubmitWaitTime = 0;  // us, total wait time of resumed submits
+static int64_t             vnodeNumOfResumedSubmits = 0;
+
+static void vnodeFinishSubmit(SBatchSubmitInfo *pSubmitInfo, int32_t code);
+
 void *vnodeProcessMsgFromShell(char *msg, void *ahandle, void *thandle) {
   int        sid, vnode;
   SShellObj *pObj = (SShellObj *)ahandle;
@@ -138,6 +179,12 @@ int vnodeInitShell() {
   if (shellList == NULL) return -1;
   memset(shellList, 0, size);
 
+  for (int vnode = 0; vnode < TSDB_MAX_VNODES; ++vnode) {
+    memset(vnodePendingSubmits + vnode, 0, sizeof(SPendingSubmitQueue));
+    pthread_mutex_init(&vnodePendingSubmits[vnode].mutex, NULL);
+    pthread_cond_init(&vnodePendingSubmits[vnode].lanePartsDone, NULL);
+  }
+
   int numOfThreads = tsNumOfCores * tsNumOfThreadsPerCore;
   numOfThreads = (1.0 - tsRatioOfQueryThreads) * numOfThreads / 2.0;
   if (numOfThreads < 1) numOfThreads = 1;
@@ -211,9 +258,36 @@ static void vnodeDelayedFreeResource(void *param, void *tmrId) {
   vnodeCalcOpenVnodes();
 }
 
+static void vnodeFlushPendingSubmits(int vnode) {
+  SPendingSubmitQueue *pQueue = vnodePendingSubmits + vnode;
+
+  pthread_mutex_lock(&pQueue->mutex);
+  SBatchSubmitInfo *pSubmitInfo = pQueue->pHead;
+  if (pQueue->draining && pSubmitInfo != NULL) {
+    // the head is being resumed, it will be responded by the draining thread
+    pQueue->pTail = pSubmitInfo;
+    pQueue->numOfSubmits = 1;
+    pSubmitInfo = pSubmitInfo->next;
+    pQueue->pTail->next = NULL;
+  } else {
+    pQueue->pHead = pQueue->pTail = NULL;
+    pQueue->numOfSubmits = 0;
+  }
+  pthread_mutex_unlock(&pQueue->mutex);
+
+  while (pSubmitInfo) {
+    SBatchSubmitInfo *pNext = pSubmitInfo->next;
+    dTrace("vid:%d, pending submit:%p is discarded since vnode is closed", vnode, pSubmitInfo);
+    vnodeFinishSubmit(pSubmitInfo, TSDB_CODE_NOT_ACTIVE_VNODE);
+    pSubmitInfo = pNext;
+  }
+}
+
 void vnodeCloseShellVnode(int vnode) {
   if (shellList[vnode] == NULL) return;
 
+  vnodeFlushPendingSubmits(vnode);
+
   for (int i = 0; i < vnodeList[vnode].cfg.maxSessions; ++i) {
     vnodeFreeQInfo(shellList[vnode][i].qhandle, true);
   }
@@ -271,6 +345,17 @@ int vnodeSendShellSubmitRspMsg(SShellObj *pObj, int code, int numOfPoints) {
   *(int32_t *)pMsg = numOfPoints;
   pMsg += sizeof(numOfPoints);
 
+  // credits: number of submits the vnode can still park in network order, -1 if submits are never parked
+  int32_t credits = -1;
+  if (tsMaxPendingSubmits > 0) {
+    credits = MAX(tsMaxPendingSubmits - vnodePendingSubmits[pObj->vnode].numOfSubmits, 0);
+  }
+  *(int32_t *)pMsg = htonl(credits);
+  pMsg += sizeof(credits);
+
+  *(uint32_t *)pMsg = htonl(TSDB_VNODE_FEATURE_COLUMNAR_SUBMIT);
+  pMsg += sizeof(uint32_t);
+
   msgLen = pMsg - pStart;
   taosSendMsgToPeer(pObj->thandle, pStart, msgLen);
 
@@ -428,7 +513,8 @@ void vnodeExecuteRetrieveReq(SSchedMsg *pSched) {
   if (pRetrieve->qhandle == (uint64_t)pObj->qhandle) {
     // if free flag is set, client wants to clean the resources
     if ((pRetrieve->free & TSDB_QUERY_TYPE_FREE_RESOURCE) != TSDB_QUERY_TYPE_FREE_RESOURCE) {
-      code = vnodeRetrieveQueryInfo((void *)(pRetrieve->qhandle), &numOfRows, &rowSize, &timePrec);
+      code = vnodeRetrieveQueryInfo((void *)(pRetrieve->qhandle), htons(pRetrieve->window), &numOfRows, &rowSize,
+                                    &timePrec);
     }
   } else {
     dError("QInfo:%p, qhandle:%p is not matched with saved:%p", pObj->qhandle, pRetrieve->qhandle, pObj->qhandle);
@@ -488,7 +574,8 @@ _exit:
 int vnodeProcessRetrieveRequest(char *pMsg, int msgLen, SShellObj *pObj) {
   SSchedMsg schedMsg;
 
-  char *msg = malloc(msgLen);
+  // the window is 0 if the msg is sent by an old client
+  char *msg = calloc(1, MAX(msgLen, sizeof(SRetrieveMeterMsg)));
   memcpy(msg, pMsg, msgLen);
   schedMsg.msg = msg;
   schedMsg.ahandle = pObj;
@@ -523,14 +610,17 @@ static int vnodeCheckSubmitBlockContext(SShellSubmitBlock *pBlocks, SVnodeObj *p
   return TSDB_CODE_SUCCESS;
 }
 
-static int vnodeDoSubmitJob(SVnodeObj *pVnode, int import, int32_t *ssid, int32_t esid, SShellSubmitBlock **ppBlocks,
-                            TSKEY now, SShellObj *pObj) {
+static int vnodeDoSubmitJob(SVnodeObj *pVnode, int import, int columnar, int32_t *ssid, int32_t esid,
+                            SShellSubmitBlock **ppBlocks, TSKEY now, SShellObj *pObj, int32_t *numOfTotalPoints) {
   SShellSubmitBlock *pBlocks = *ppBlocks;
   int code = TSDB_CODE_SUCCESS;
   int32_t numOfPoints = 0;
   int32_t i = 0;
   SShellSubmitBlock tBlock;
 
+  // the commit log is synced once for all blocks
+  uint64_t startLsn = vnodeGetCommitLogLsn(pVnode);
+
   for (i = *ssid; i < esid; i++) {
     numOfPoints = 0;
     tBlock = *pBlocks;
@@ -544,40 +634,412 @@ static int vnodeDoSubmitJob(SVnodeObj *pVnode, int import, int32_t *ssid, int32_
     int32_t subMsgLen = sizeof(pBlocks->numOfRows) + htons(pBlocks->numOfRows) * pMeterObj->bytesPerPoint;
     int32_t sversion = htonl(pBlocks->sversion);
 
+    // import and peers take rows only
+    SShellSubmitBlock *pRowBlock = NULL;
+    if (columnar && (import || pVnode->cfg.replications > 1)) {
+      pRowBlock = vnodeConvertColumnarBlock(pMeterObj, pBlocks);
+      if (pRowBlock == NULL) {
+        code = TSDB_CODE_SERV_OUT_OF_MEMORY;
+        break;
+      }
+    }
+
+    char *cont = (char *)&((pRowBlock != NULL) ? pRowBlock : pBlocks)->numOfRows;
+
     if (import) {
-      code = vnodeImportPoints(pMeterObj, (char *)&(pBlocks->numOfRows), subMsgLen, TSDB_DATA_SOURCE_SHELL, pObj,
-                               sversion, &numOfPoints, now);
-      pObj->numOfTotalPoints += numOfPoints;
+      code = vnodeImportPoints(pMeterObj, cont, subMsgLen, TSDB_DATA_SOURCE_SHELL, pObj, sversion, &numOfPoints, now);
+      *numOfTotalPoints += numOfPoints;
 
       // records for one table should be consecutive located in the payload buffer, which is guaranteed by client
       if (code == TSDB_CODE_SUCCESS) {
         pObj->count--;
       }
+    } else if (columnar && pRowBlock == NULL) {
+      code = vnodeInsertColumnarPoints(pMeterObj, cont, subMsgLen, TSDB_DATA_SOURCE_SHELL, NULL, sversion,
+                                       &numOfPoints, now);
+      *numOfTotalPoints += numOfPoints;
     } else {
-      code = vnodeInsertPoints(pMeterObj, (char *)&(pBlocks->numOfRows), subMsgLen, TSDB_DATA_SOURCE_SHELL, NULL,
-                               sversion, &numOfPoints, now);
-      pObj->numOfTotalPoints += numOfPoints;
+      code = vnodeInsertPoints(pMeterObj, cont, subMsgLen, TSDB_DATA_SOURCE_SHELL, NULL, sversion, &numOfPoints, now);
+      *numOfTotalPoints += numOfPoints;
     }
 
+    tfree(pRowBlock);
+
     if (code != TSDB_CODE_SUCCESS) break;
 
     pBlocks = (SShellSubmitBlock *)((char *)pBlocks + sizeof(SShellSubmitBlock) +
                                     htons(pBlocks->numOfRows) * pMeterObj->bytesPerPoint);
   }
 
+  int32_t logCode = vnodeWaitForCommitLog(pVnode, startLsn);
+  if (logCode != TSDB_CODE_SUCCESS) code = logCode;
+
   *ssid = i;
   *ppBlocks = pBlocks;
   /* Since the pBlock part can be changed by the vnodeForwardToPeer interface,
    * which is also possible to be used again. For that case, we just copy the original
    * block content back.
    */
-  if (import && (code == TSDB_CODE_ACTION_IN_PROGRESS)) {
+  if (code == TSDB_CODE_ACTION_IN_PROGRESS) {
     memcpy((void *)pBlocks, (void *)&tBlock, sizeof(SShellSubmitBlock));
   }
 
   return code;
 }
 
+static bool vnodeHasPendingSubmits(int32_t vnode) {
+  SPendingSubmitQueue *pQueue = vnodePendingSubmits + vnode;
+
+  pthread_mutex_lock(&pQueue->mutex);
+  bool hasPending = (pQueue->pHead != NULL);
+  pthread_mutex_unlock(&pQueue->mutex);
+
+  return hasPending;
+}
+
+// the caller shall hold the mutex of queue
+static void vnodeStartPendingSubmitTimer(SPendingSubmitQueue *pQueue, int32_t vnode, int32_t mseconds) {
+  if (pQueue->timerStarted) return;
+
+  pQueue->timerStarted = true;
+  taosTmrStart(vnodeProcessPendingSubmitTimer, mseconds, (void *)(int64_t)vnode, vnodeTmrCtrl);
+}
+
+// the caller still owns the submit if it is not parked
+static int32_t vnodeEnqueueSubmit(SBatchSubmitInfo *pSubmitInfo) {
+  SPendingSubmitQueue *pQueue = vnodePendingSubmits + pSubmitInfo->vnode;
+
+  pSubmitInfo->parkTime = taosGetTimestampUs();
+  pthread_mutex_lock(&pQueue->mutex);
+
+  // imports are always parked, since part of them may have been imported. Inserts are sent back to client if full
+  if (!pSubmitInfo->import && pQueue->numOfSubmits >= tsMaxPendingSubmits) {
+    pthread_mutex_unlock(&pQueue->mutex);
+    dTrace("vid:%d, pending submit queue is full, num:%d", pSubmitInfo->vnode, pQueue->numOfSubmits);
+    return TSDB_CODE_ACTION_IN_PROGRESS;
+  }
+
+  if (pQueue->pTail) {
+    pQueue->pTail->next = pSubmitInfo;
+  } else {
+    pQueue->pHead = pSubmitInfo;
+  }
+  pQueue->pTail = pSubmitInfo;
+  pQueue->numOfSubmits++;
+
+  // in case no commit will wake it up, e.g., waiting for the new schema of meter
+  vnodeStartPendingSubmitTimer(pQueue, pSubmitInfo->vnode, VNODE_PENDING_SUBMIT_RETRY_MS);
+
+  pthread_mutex_unlock(&pQueue->mutex);
+
+  dTrace("vid:%d, submit:%p is parked, import:%d ssid:%d pending:%d", pSubmitInfo->vnode, pSubmitInfo,
+         pSubmitInfo->import, pSubmitInfo->ssid, pQueue->numOfSubmits);
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t vnodeParkSubmit(SShellSubmitMsg *pSubmit, int32_t columnar, char *pMsg, int msgLen, int32_t ssid,
+                               SShellSubmitBlock *pBlocks, SShellObj *pObj) {
+  SBatchSubmitInfo *pSubmitInfo =
+      (SBatchSubmitInfo *)calloc(1, sizeof(SBatchSubmitInfo) + msgLen - sizeof(SShellSubmitMsg));
+  if (pSubmitInfo == NULL) {
+    return TSDB_CODE_SERV_OUT_OF_MEMORY;
+  }
+
+  pSubmitInfo->import = pSubmit->import;
+  pSubmitInfo->columnar = columnar;
+  pSubmitInfo->vnode = pSubmit->vnode;
+  pSubmitInfo->numOfSid = pSubmit->numOfSid;
+  pSubmitInfo->ssid = ssid;  // start from this position, not the initial position
+  pSubmitInfo->pObj = pObj;
+  pSubmitInfo->offset = ((char *)pBlocks) - (pMsg + sizeof(SShellSubmitMsg));
+  assert(pSubmitInfo->offset >= 0);
+  memcpy((void *)(pSubmitInfo->blks), (void *)(pMsg + sizeof(SShellSubmitMsg)), msgLen - sizeof(SShellSubmitMsg));
+
+  int32_t code = vnodeEnqueueSubmit(pSubmitInfo);
+  if (code != TSDB_CODE_SUCCESS) free(pSubmitInfo);
+
+  return code;
+}
+
+static int32_t vnodeResumeSubmit(SBatchSubmitInfo *pSubmitInfo) {
+  SShellObj *pShell = pSubmitInfo->pObj;
+  SVnodeObj *pVnode = &vnodeList[pSubmitInfo->vnode];
+
+  if (pVnode->cfg.maxSessions == 0 || pVnode->meterList == NULL) {
+    return TSDB_CODE_NOT_ACTIVE_VNODE;
+  }
+
+  SShellSubmitBlock *pBlocks = (SShellSubmitBlock *)(pSubmitInfo->blks + pSubmitInfo->offset);
+  TSKEY              now = taosGetTimestamp(pVnode->cfg.precision);
+  int32_t            i = pSubmitInfo->ssid;
+
+  int32_t *numOfPoints = (pSubmitInfo->pJob != NULL) ? &pSubmitInfo->numOfPoints : &pShell->numOfTotalPoints;
+  int32_t  code = vnodeDoSubmitJob(pVnode, pSubmitInfo->import, pSubmitInfo->columnar, &i, pSubmitInfo->numOfSid,
+                                   &pBlocks, now, pShell, numOfPoints);
+
+  if (code == TSDB_CODE_ACTION_IN_PROGRESS) {
+    pSubmitInfo->ssid = i;
+    pSubmitInfo->offset = ((char *)pBlocks) - pSubmitInfo->blks;
+  } else if (pSubmitInfo->import && code == TSDB_CODE_SUCCESS) {
+    assert(pShell->count == 0);
+  }
+
+  return code;
+}
+
+static void vnodeDrainPendingSubmits(SSchedMsg *pSched) {
+  int32_t              vnode = (int32_t)(int64_t)pSched->ahandle;
+  SPendingSubmitQueue *pQueue = vnodePendingSubmits + vnode;
+
+  pthread_mutex_lock(&pQueue->mutex);
+  assert(pQueue->draining);
+
+  // resume in order, stop at the first one still blocked
+  while (pQueue->pHead != NULL) {
+    SBatchSubmitInfo *pSubmitInfo = pQueue->pHead;
+    pthread_mutex_unlock(&pQueue->mutex);
+
+    int32_t code = vnodeResumeSubmit(pSubmitInfo);
+
+    pthread_mutex_lock(&pQueue->mutex);
+    if (code == TSDB_CODE_ACTION_IN_PROGRESS) {
+      break;
+    }
+
+    pQueue->pHead = pSubmitInfo->next;
+    if (pQueue->pHead == NULL) pQueue->pTail = NULL;
+    pQueue->numOfSubmits--;
+    pthread_mutex_unlock(&pQueue->mutex);
+
+    int64_t waitTime = taosGetTimestampUs() - pSubmitInfo->parkTime;
+    atomic_fetch_add_64(&vnodeSubmitWaitTime, waitTime);
+    atomic_fetch_add_64(&vnodeNumOfResumedSubmits, 1);
+
+    dTrace("vid:%d, submit:%p is resumed, code:%d wait:%ldus", vnode, pSubmitInfo, code, waitTime);
+    vnodeFinishSubmit(pSubmitInfo, code);
+
+    pthread_mutex_lock(&pQueue->mutex);
+  }
+
+  pQueue->draining = false;
+  if (pQueue->pHead != NULL) {
+    vnodeStartPendingSubmitTimer(pQueue, vnode, VNODE_PENDING_SUBMIT_RETRY_MS);
+  }
+
+  pthread_mutex_unlock(&pQueue->mutex);
+}
+
+/*
+ * parked submits are resumed by the worker serving the shell messages of the vnode, neither by the timer thread nor
+ * by the commit thread. If the queue of the worker is full, try again by timer.
+ */
+static void vnodeScheduleSubmitDrain(int32_t vnode) {
+  SPendingSubmitQueue *pQueue = vnodePendingSubmits + vnode;
+
+  pthread_mutex_lock(&pQueue->mutex);
+  if (pQueue->draining || pQueue->pHead == NULL) {
+    pthread_mutex_unlock(&pQueue->mutex);
+    return;
+  }
+  pQueue->draining = true;
+  pthread_mutex_unlock(&pQueue->mutex);
+
+  SSchedMsg schedMsg = {0};
+  schedMsg.fp = vnodeDrainPendingSubmits;
+  schedMsg.ahandle = (void *)(int64_t)vnode;
+  if (taosTryScheduleTask(rpcQhandle[(vnode + 1) % tsMaxQueues], &schedMsg) == 0) {
+    return;
+  }
+
+  dTrace("vid:%d, queue of worker is full, pending submits are resumed later", vnode);
+  pthread_mutex_lock(&pQueue->mutex);
+  pQueue->draining = false;
+  vnodeStartPendingSubmitTimer(pQueue, vnode, VNODE_PENDING_SUBMIT_RETRY_MS);
+  pthread_mutex_unlock(&pQueue->mutex);
+}
+
+static void vnodeProcessPendingSubmitTimer(void *param, void *tmrId) {
+  int32_t              vnode = (int32_t)(int64_t)param;
+  SPendingSubmitQueue *pQueue = vnodePendingSubmits + vnode;
+
+  pthread_mutex_lock(&pQueue->mutex);
+  pQueue->timerStarted = false;
+  pthread_mutex_unlock(&pQueue->mutex);
+
+  vnodeScheduleSubmitDrain(vnode);
+}
+
+void vnodeResumePendingSubmits(int vnode) {
+  // cache blocks are freed by commit, the parked submits are resumed right now
+  vnodeScheduleSubmitDrain(vnode);
+}
+
+void vnodeGetPendingSubmitStatis(int32_t *numOfSubmits, int64_t *avgWaitTime) {
+  *numOfSubmits = 0;
+  for (int vnode = 0; vnode < TSDB_MAX_VNODES; ++vnode) {
+    *numOfSubmits += vnodePendingSubmits[vnode].numOfSubmits;
+  }
+
+  int64_t numOfResumed = vnodeNumOfResumedSubmits;
+  *avgWaitTime = (numOfResumed > 0) ? vnodeSubmitWaitTime / numOfResumed / 1000 : 0;
+}
+
+static void vnodeFinishSubmit(SBatchSubmitInfo *pSubmitInfo, int32_t code) {
+  SSubmitJob *pJob = pSubmitInfo->pJob;
+
+  if (pJob == NULL) {
+    SShellObj *pShell = pSubmitInfo->pObj;
+    vnodeSendShellSubmitRspMsg(pShell, code, pShell->numOfTotalPoints);
+    free(pSubmitInfo);
+    return;
+  }
+
+  atomic_fetch_add_32(&pJob->numOfPoints, pSubmitInfo->numOfPoints);
+  if (code != TSDB_CODE_SUCCESS) {
+    atomic_val_compare_exchange_32(&pJob->code, TSDB_CODE_SUCCESS, code);
+  }
+  free(pSubmitInfo);
+
+  // the last part sends the response
+  if (atomic_sub_fetch_32(&pJob->numOfParts, 1) == 0) {
+    vnodeSendShellSubmitRspMsg(pJob->pObj, pJob->code, pJob->numOfPoints);
+    free(pJob);
+  }
+}
+
+static void vnodeProcessSubmitPart(SSchedMsg *pSched) {
+  SBatchSubmitInfo *   pSubmitInfo = (SBatchSubmitInfo *)pSched->ahandle;
+  SPendingSubmitQueue *pQueue = vnodePendingSubmits + pSubmitInfo->vnode;
+  int32_t              code = TSDB_CODE_ACTION_IN_PROGRESS;
+
+  // earlier submits are waiting, this part shall wait behind them
+  if (!vnodeHasPendingSubmits(pSubmitInfo->vnode)) {
+    code = vnodeResumeSubmit(pSubmitInfo);
+  }
+
+  if (code == TSDB_CODE_ACTION_IN_PROGRESS) {
+    code = vnodeEnqueueSubmit(pSubmitInfo);
+    if (code == TSDB_CODE_SUCCESS) pSubmitInfo = NULL;  // owned by the pending queue now
+  }
+
+  if (pSubmitInfo != NULL) {
+    vnodeFinishSubmit(pSubmitInfo, code);
+  }
+
+  pthread_mutex_lock(&pQueue->mutex);
+  if (atomic_sub_fetch_32(&pQueue->numOfLaneParts, 1) == 0) {
+    pthread_cond_broadcast(&pQueue->lanePartsDone);
+  }
+  pthread_mutex_unlock(&pQueue->mutex);
+}
+
+/*
+ * Blocks are hashed by sid onto the write lanes, so the blocks of a meter are always inserted by the single thread
+ * of the same lane in arrival order. Blocks after an invalid one are not dispatched, as the serial path stops there.
+ * Returns the number of parts dispatched, 0 if the response shall be sent by the caller.
+ */
+static int32_t vnodeDispatchSubmit(SVnodeObj *pVnode, SShellSubmitMsg *pSubmit, int32_t columnar, char *pMsg,
+                                   int msgLen, SShellObj *pObj, int *code) {
+  int32_t            numOfBlocks[TSDB_MAX_WRITE_LANES] = {0};
+  int32_t            size[TSDB_MAX_WRITE_LANES] = {0};
+  SBatchSubmitInfo * pParts[TSDB_MAX_WRITE_LANES] = {0};
+  SShellSubmitBlock *pBlocks = (SShellSubmitBlock *)(pMsg + sizeof(SShellSubmitMsg));
+  int32_t            numOfSid = 0;
+  int32_t            numOfParts = 0;
+
+  *code = TSDB_CODE_SUCCESS;
+  for (numOfSid = 0; numOfSid < pSubmit->numOfSid; ++numOfSid) {
+    *code = vnodeCheckSubmitBlockContext(pBlocks, pVnode);
+    if (*code != TSDB_CODE_SUCCESS) break;
+
+    int32_t    sid = htonl(pBlocks->sid);
+    SMeterObj *pMeterObj = (SMeterObj *)pVnode->meterList[sid];
+    int32_t    len = sizeof(SShellSubmitBlock) + htons(pBlocks->numOfRows) * pMeterObj->bytesPerPoint;
+    if ((char *)pBlocks + len > pMsg + msgLen) {
+      dError("vid:%d sid:%d, submit block is out of msg, len:%d", pVnode->vnode, sid, len);
+      *code = TSDB_CODE_INVALID_SUBMIT_MSG;
+      break;
+    }
+
+    int32_t lane = (pVnode->vnode + sid) % tsMaxWriteQueues;
+    numOfBlocks[lane]++;
+    size[lane] += len;
+    pBlocks = (SShellSubmitBlock *)((char *)pBlocks + len);
+  }
+
+  SSubmitJob *pJob = (SSubmitJob *)calloc(1, sizeof(SSubmitJob));
+  if (pJob == NULL) {
+    *code = TSDB_CODE_SERV_OUT_OF_MEMORY;
+    return 0;
+  }
+
+  for (int32_t lane = 0; lane < tsMaxWriteQueues; ++lane) {
+    if (numOfBlocks[lane] == 0) continue;
+
+    pParts[lane] = (SBatchSubmitInfo *)calloc(1, sizeof(SBatchSubmitInfo) + size[lane]);
+    if (pParts[lane] == NULL) {
+      for (int32_t j = 0; j < lane; ++j) free(pParts[j]);
+      free(pJob);
+      *code = TSDB_CODE_SERV_OUT_OF_MEMORY;
+      return 0;
+    }
+
+    pParts[lane]->columnar = columnar;
+    pParts[lane]->vnode = pSubmit->vnode;
+    pParts[lane]->numOfSid = numOfBlocks[lane];
+    pParts[lane]->pObj = pObj;
+    pParts[lane]->pJob = pJob;
+    size[lane] = 0;  // offset to copy the next block
+    numOfParts++;
+  }
+
+  if (numOfParts == 0) {
+    free(pJob);
+    return 0;
+  }
+
+  pBlocks = (SShellSubmitBlock *)(pMsg + sizeof(SShellSubmitMsg));
+  for (int32_t i = 0; i < numOfSid; ++i) {
+    int32_t    sid = htonl(pBlocks->sid);
+    SMeterObj *pMeterObj = (SMeterObj *)pVnode->meterList[sid];
+    int32_t    len = sizeof(SShellSubmitBlock) + htons(pBlocks->numOfRows) * pMeterObj->bytesPerPoint;
+    int32_t    lane = (pVnode->vnode + sid) % tsMaxWriteQueues;
+
+    memcpy(pParts[lane]->blks + size[lane], (char *)pBlocks, len);
+    size[lane] += len;
+    pBlocks = (SShellSubmitBlock *)((char *)pBlocks + len);
+  }
+
+  pJob->pObj = pObj;
+  pJob->numOfParts = numOfParts;
+  pJob->code = *code;
+
+  atomic_fetch_add_32(&vnodePendingSubmits[pSubmit->vnode].numOfLaneParts, numOfParts);
+
+  for (int32_t lane = 0; lane < tsMaxWriteQueues; ++lane) {
+    if (pParts[lane] == NULL) continue;
+
+    SSchedMsg schedMsg = {0};
+    schedMsg.fp = vnodeProcessSubmitPart;
+    schedMsg.ahandle = pParts[lane];
+    taosScheduleTask(writeQhandle[lane], &schedMsg);
+  }
+
+  dTrace("vid:%d, submit with %d blocks is dispatched into %d lanes", pSubmit->vnode, numOfSid, numOfParts);
+  return numOfParts;
+}
+
+// imports are processed serially, the inserts dispatched before shall be processed or parked first
+static void vnodeWaitForLaneParts(int32_t vnode) {
+  SPendingSubmitQueue *pQueue = vnodePendingSubmits + vnode;
+
+  pthread_mutex_lock(&pQueue->mutex);
+  while (atomic_load_32(&pQueue->numOfLaneParts) > 0) {
+    pthread_cond_wait(&pQueue->lanePartsDone, &pQueue->mutex);
+  }
+  pthread_mutex_unlock(&pQueue->mutex);
+}
+
 int vnodeProcessShellSubmitRequest(char *pMsg, int msgLen, SShellObj *pObj) {
   int              code = 0, ret = 0;
   int32_t          i = 0;
@@ -588,6 +1050,9 @@ int vnodeProcessShellSubmitRequest(char *pMsg, int msgLen, SShellObj *pObj) {
   pSubmit->vnode = htons(pSubmit->vnode);
   pSubmit->numOfSid = htonl(pSubmit->numOfSid);
 
+  int32_t columnar = (pSubmit->import & TSDB_SUBMIT_COLUMNAR) ? 1 : 0;
+  pSubmit->import &= TSDB_SUBMIT_IMPORT;
+
   if (pSubmit->numOfSid <= 0) {
     dError("invalid num of meters:%d", pSubmit->numOfSid);
     code = TSDB_CODE_INVALID_QUERY_MSG;
@@ -627,63 +1092,40 @@ int vnodeProcessShellSubmitRequest(char *pMsg, int msgLen, SShellObj *pObj) {
 
   pBlocks = (SShellSubmitBlock *)(pMsg + sizeof(SShellSubmitMsg));
   i = 0;
-  code = vnodeDoSubmitJob(pVnode, pSubmit->import, &i, pSubmit->numOfSid, &pBlocks, now, pObj);
+
+  if (tsMaxWriteQueues > 1) {
+    if (!pSubmit->import) {
+      if (vnodeDispatchSubmit(pVnode, pSubmit, columnar, pMsg, msgLen, pObj, &code) > 0) {
+        atomic_fetch_add_32(&vnodeInsertReqNum, 1);
+        return 0;
+      }
+      goto _submit_over;
+    }
+
+    vnodeWaitForLaneParts(pSubmit->vnode);
+  }
+
+  // earlier submits are waiting, this one shall wait behind them
+  if (vnodeHasPendingSubmits(pSubmit->vnode)) {
+    code = TSDB_CODE_ACTION_IN_PROGRESS;
+  } else {
+    code = vnodeDoSubmitJob(pVnode, pSubmit->import, columnar, &i, pSubmit->numOfSid, &pBlocks, now, pObj,
+                            &pObj->numOfTotalPoints);
+  }
 
 _submit_over:
   ret = 0;
-  if (pSubmit->import) {  // Import case
-    if (code == TSDB_CODE_ACTION_IN_PROGRESS) {
-
-      SBatchSubmitInfo *pSubmitInfo =
-          (SBatchSubmitInfo *)calloc(1, sizeof(SBatchSubmitInfo) + msgLen - sizeof(SShellSubmitMsg));
-      if (pSubmitInfo == NULL) {
-        code = TSDB_CODE_SERV_OUT_OF_MEMORY;
-        ret = vnodeSendShellSubmitRspMsg(pObj, code, pObj->numOfTotalPoints);
-      } else { // Start a timer to process the next part of request
-        pSubmitInfo->import = 1;
-        pSubmitInfo->vnode = pSubmit->vnode;
-        pSubmitInfo->numOfSid = pSubmit->numOfSid;
-        pSubmitInfo->ssid = i;   // start from this position, not the initial position
-        pSubmitInfo->pObj = pObj;
-        pSubmitInfo->offset = ((char *)pBlocks) - (pMsg + sizeof(SShellSubmitMsg));
-        assert(pSubmitInfo->offset >= 0);
-        memcpy((void *)(pSubmitInfo->blks), (void *)(pMsg + sizeof(SShellSubmitMsg)), msgLen - sizeof(SShellSubmitMsg));
-        taosTmrStart(vnodeProcessBatchSubmitTimer, 10, (void *)pSubmitInfo, vnodeTmrCtrl);
-      }
-    } else {
-      if (code == TSDB_CODE_SUCCESS) assert(pObj->count == 0);
+  if (code == TSDB_CODE_ACTION_IN_PROGRESS) {
+    // the response is sent after the parked submit is resumed
+    code = vnodeParkSubmit(pSubmit, columnar, pMsg, msgLen, i, pBlocks, pObj);
+    if (code != TSDB_CODE_SUCCESS) {
       ret = vnodeSendShellSubmitRspMsg(pObj, code, pObj->numOfTotalPoints);
     }
-  } else {  // Insert case
+  } else {
+    if (pSubmit->import && code == TSDB_CODE_SUCCESS) assert(pObj->count == 0);
     ret = vnodeSendShellSubmitRspMsg(pObj, code, pObj->numOfTotalPoints);
   }
 
   atomic_fetch_add_32(&vnodeInsertReqNum, 1);
   return ret;
 }
-
-static void vnodeProcessBatchSubmitTimer(void *param, void *tmrId) {
-  SBatchSubmitInfo *pSubmitInfo = (SBatchSubmitInfo *)param;
-  assert(pSubmitInfo != NULL && pSubmitInfo->import);
-
-  int32_t i = 0;
-  int32_t code = TSDB_CODE_SUCCESS;
-
-  SShellObj *        pShell = pSubmitInfo->pObj;
-  SVnodeObj *        pVnode = &vnodeList[pSubmitInfo->vnode];
-  SShellSubmitBlock *pBlocks = (SShellSubmitBlock *)(pSubmitInfo->blks + pSubmitInfo->offset);
-  TSKEY   now = taosGetTimestamp(pVnode->cfg.precision);
-  i = pSubmitInfo->ssid;
-
-  code = vnodeDoSubmitJob(pVnode, pSubmitInfo->import, &i, pSubmitInfo->numOfSid, &pBlocks, now, pShell);
-
-  if (code == TSDB_CODE_ACTION_IN_PROGRESS) {
-    pSubmitInfo->ssid = i;
-    pSubmitInfo->offset = ((char *)pBlocks) - pSubmitInfo->blks;
-    taosTmrStart(vnodeProcessBatchSubmitTimer, 10, (void *)pSubmitInfo, vnodeTmrCtrl);
-  } else {
-    if (code == TSDB_CODE_SUCCESS) assert(pShell->count == 0);
-    tfree(param);
-    vnodeSendShellSubmitRspMsg(pShell, code, pShell->numOfTotalPoints);
-  }
-}
@@ -20,6 +20,7 @@
 #include "trpc.h"
 #include "ttime.h"
 #include "vnode.h"
+#include "vnodeBlockCache.h"
 #include "vnodeStore.h"
 #include "vnodeUtil.h"
 #include "tstatus.h"
@@ -214,6 +215,8 @@ static void vnodeRemoveDataFiles(int vnode) {
   struct dirent *de = NULL;
   DIR *          dir = NULL;
 
+  vnodeInvalidateBlockCache(vnode, -1);
+
   sprintf(vnodeDir, "%s/vnode%d/db", tsDirectory, vnode);
   dir = opendir(vnodeDir);
   if (dir == NULL) return;
@@ -55,9 +55,13 @@ void vnodeProcessStreamRes(void *param, TAOS_RES *tres, TAOS_ROW row) {
 
   contLen += sizeof(SSubmitMsg);
 
-  int32_t numOfPoints = 0;
-  int32_t code = vnodeInsertPoints(pObj, (char *)pMsg, contLen, TSDB_DATA_SOURCE_SHELL, NULL, pObj->sversion,
+  int32_t  numOfPoints = 0;
+  uint64_t startLsn = vnodeGetCommitLogLsn(vnodeList + pObj->vnode);
+  int32_t  code = vnodeInsertPoints(pObj, (char *)pMsg, contLen, TSDB_DATA_SOURCE_SHELL, NULL, pObj->sversion,
       &numOfPoints, taosGetTimestamp(vnodeList[pObj->vnode].cfg.precision));
+  if (code == TSDB_CODE_SUCCESS) {
+    code = vnodeWaitForCommitLog(vnodeList + pObj->vnode, startLsn);
+  }
 
   if (code != TSDB_CODE_SUCCESS) {
     dError("vid:%d sid:%d id:%s, failed to insert continuous query results", pObj->vnode, pObj->sid, pObj->meterId);
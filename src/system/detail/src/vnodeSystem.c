@@ -19,6 +19,7 @@
 #include "tsdb.h"
 #include "tsocket.h"
 #include "vnode.h"
+#include "vnodeBlockCache.h"
 #include "vnodeSystem.h"
 
 // internal global, not configurable
@@ -26,21 +27,35 @@ void *   vnodeTmrCtrl;
 void **  rpcQhandle;
 void *   dmQhandle;
 void *   queryQhandle;
+int      tsNumOfQueryThreads = 1;
+void *   commitQhandle;
 int      tsVnodePeers = TSDB_VNODES_SUPPORT - 1;
 int      tsMaxQueues;
+void **  writeQhandle;
+int      tsMaxWriteQueues;
 uint32_t tsRebootTime;
 
 void vnodeCleanUpSystem() {
   vnodeCleanUpVnodes();
+  vnodeCleanUpBlockCache();
 }
 
 bool vnodeInitQueryHandle() {
   int numOfThreads = tsRatioOfQueryThreads * tsNumOfCores * tsNumOfThreadsPerCore;
   if (numOfThreads < 1) numOfThreads = 1;
   queryQhandle = taosInitScheduler(tsNumOfVnodesPerCore * tsNumOfCores * tsSessionsPerVnode, numOfThreads, "query");
+  tsNumOfQueryThreads = numOfThreads;
   return true;
 }
 
+bool vnodeInitCommitHandle() {
+  // commit threads compress the meters in parallel, the file is still written by the commit thread of each vnode
+  if (tsNumOfCommitThreads <= 1) return true;
+
+  commitQhandle = taosInitScheduler(tsNumOfCommitThreads * 4, tsNumOfCommitThreads, "commit");
+  return commitQhandle != NULL;
+}
+
 bool vnodeInitTmrCtl() {
   vnodeTmrCtrl = taosTmrInit(TSDB_MAX_VNODES * (tsVnodePeers + 10) + tsSessionsPerVnode + 1000, 200, 60000, "DND-vnode");
   if (vnodeTmrCtrl == NULL) {
@@ -57,11 +72,21 @@ int vnodeInitSystem() {
     return -1;
   }
 
+  if (!vnodeInitCommitHandle()) {
+    dError("failed to init commit qhandle, exit");
+    return -1;
+  }
+
   if (!vnodeInitTmrCtl()) {
     dError("failed to init timer, exit");
     return -1;
   }
 
+  if (vnodeInitBlockCache() < 0) {
+    dError("failed to init query block cache, exit");
+    return -1;
+  }
+
   if (vnodeInitStore() < 0) {
     dError("failed to init vnode storage");
     return -1;
@@ -103,5 +128,28 @@ void vnodeInitQHandle() {
   for (int i=0; i< tsMaxQueues; ++i ) 
     rpcQhandle[i] = taosInitScheduler(tsSessionsPerVnode, 1, "dnode");
 
+  // each lane has one thread only, so the rows of a meter hashed onto it are inserted in order
+  tsMaxWriteQueues = tsNumOfWriteLanes;
+  if (tsMaxWriteQueues == 0) tsMaxWriteQueues = (1.0 - tsRatioOfQueryThreads) * tsNumOfCores * tsNumOfThreadsPerCore;
+  if (tsMaxWriteQueues < 1) tsMaxWriteQueues = 1;
+  if (tsMaxWriteQueues > TSDB_MAX_WRITE_LANES) tsMaxWriteQueues = TSDB_MAX_WRITE_LANES;
+
+  if (tsMaxWriteQueues > 1) {
+    writeQhandle = calloc(tsMaxWriteQueues, sizeof(void *));
+    for (int i = 0; writeQhandle != NULL && i < tsMaxWriteQueues; ++i) {
+      writeQhandle[i] = taosInitScheduler(tsSessionsPerVnode, 1, "write");
+      if (writeQhandle[i] == NULL) {
+        for (int j = 0; j < i; ++j) taosCleanUpScheduler(writeQhandle[j]);
+        tfree(writeQhandle);
+      }
+    }
+
+    // inserts are done in the rpc threads, as if there is one lane only
+    if (writeQhandle == NULL) {
+      dError("failed to init %d write lanes, inserts are not dispatched to lanes", tsMaxWriteQueues);
+      tsMaxWriteQueues = 1;
+    }
+  }
+
   dmQhandle = taosInitScheduler(tsSessionsPerVnode, 1, "mgmt");
 }
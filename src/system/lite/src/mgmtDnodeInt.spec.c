@@ -22,6 +22,7 @@
 #include "tsched.h"
 #include "tutil.h"
 #include "vnode.h"
+#include "vnodeBlockCache.h"
 #include "tsystem.h"
 #include "tstatus.h"
 
@@ -89,6 +90,10 @@ void mgmtProcessDnodeStatus(void *handle, void *tmrId) {
   taosGetSysMemory(&memoryUsedMB);
   pObj->diskAvailable = tsAvailDataDirGB;
 
+  int64_t blockCacheUsed = 0;
+  vnodeGetBlockCacheStatis(&pObj->blockCacheHits, &pObj->blockCacheMisses, &blockCacheUsed);
+  vnodeGetPendingSubmitStatis(&pObj->pendingSubmits, &pObj->submitWaitTime);
+
   for (int vnode = 0; vnode < pObj->numOfVnodes; ++vnode) {
     SVnodeLoad *pVload = &(pObj->vload[vnode]);
     SVnodeObj * pVnode = vnodeList + vnode;
@@ -26,9 +26,15 @@
 #define HASH_DEFAULT_LOAD_FACTOR (0.75)
 #define HASH_INDEX(v, c) ((v) & ((c)-1))
 
-/**
- * todo: refactor to extract the hash table out of cache structure
+/*
+ * the cache is split into shards by the top bits of the hash value, each shard has its own lock,
+ * hash list and trash, the low bits of hash value are used as the slot index in a shard
  */
+#define CACHE_SHARD_BITS     4
+#define CACHE_NUM_OF_SHARDS  (1 << CACHE_SHARD_BITS)
+#define CACHE_SHARD_INDEX(v) ((uint32_t)(v) >> (32 - CACHE_SHARD_BITS))
+#define CACHE_REHASH_STEP    64  // number of slots moved to the new hash list by each write during resize
+
 typedef struct SCacheStatis {
   int64_t missCount;
   int64_t hitCount;
@@ -51,9 +57,10 @@ typedef struct _cache_node_t {
    * reference count for this object
    * if this value is larger than 0, this value will never be released
    */
-  uint32_t refCount;
+  int32_t  refCount;
   uint32_t hashVal;   // the hash value of key, if hashVal == HASH_VALUE_IN_TRASH, this node is moved to trash
   uint32_t nodeSize;  // allocated size for current SDataNode
+  int32_t  shard;     // index of the shard this node belongs to
   char     data[];
 } SDataNode;
 
@@ -61,10 +68,19 @@ typedef uint32_t (*_hashFunc)(const char *, uint32_t);
 
 typedef struct {
   SDataNode **hashList;
-  int         capacity;
-  int         size;
-  int64_t     totalSize;  // total allocated buffer in this hash table, SCacheObj is not included.
-  int64_t     refreshTime;
+  int32_t     capacity;
+
+  /*
+   * the hash list is doubled incrementally: the old list is kept until all of its slots are moved
+   * into the new one, CACHE_REHASH_STEP slots by each write operation. Slots before rehashIndex
+   * have been moved.
+   */
+  SDataNode **pOldList;
+  int32_t     oldCapacity;
+  int32_t     rehashIndex;
+
+  int32_t size;
+  int64_t totalSize;  // total allocated buffer in this shard
 
   /*
    * to accommodate the old datanode which has the same key value of new one in hashList
@@ -75,58 +91,63 @@ typedef struct {
    * when the node in pTrash does not be referenced, it will be release at the expired time
    */
   SDataNode *  pTrash;
-  void *       tmrCtrl;
-  void *       pTimer;
+  int32_t      numOfElemsInTrash;  // number of element in trash
   SCacheStatis statistics;
-  _hashFunc    hashFp;
-  int          numOfElemsInTrash;  // number of element in trash
-  int16_t      deleting;           // set the deleting flag to stop refreshing asap.
 
 #if defined        LINUX
   pthread_rwlock_t lock;
 #else
   pthread_mutex_t lock;
 #endif
+} SCacheShard;
 
+typedef struct {
+  SCacheShard shards[CACHE_NUM_OF_SHARDS];
+  int32_t     capacity;  // initial capacity of all shards, 0 means the cache is destroyed
+  int64_t     refreshTime;
+  void *      tmrCtrl;
+  void *      pTimer;
+  _hashFunc   hashFp;
+  int16_t     deleting;  // set the deleting flag to stop refreshing asap.
 } SCacheObj;
 
-static FORCE_INLINE void __cache_wr_lock(SCacheObj *pObj) {
+static FORCE_INLINE void __cache_wr_lock(SCacheShard *pShard) {
 #if defined LINUX
-  pthread_rwlock_wrlock(&pObj->lock);
+  pthread_rwlock_wrlock(&pShard->lock);
 #else
-  pthread_mutex_lock(&pObj->lock);
+  pthread_mutex_lock(&pShard->lock);
 #endif
 }
 
-static FORCE_INLINE void __cache_rd_lock(SCacheObj *pObj) {
+static FORCE_INLINE void __cache_rd_lock(SCacheShard *pShard) {
 #if defined LINUX
-  pthread_rwlock_rdlock(&pObj->lock);
+  pthread_rwlock_rdlock(&pShard->lock);
 #else
-  pthread_mutex_lock(&pObj->lock);
+  pthread_mutex_lock(&pShard->lock);
 #endif
 }
 
-static FORCE_INLINE void __cache_unlock(SCacheObj *pObj) {
+static FORCE_INLINE void __cache_unlock(SCacheShard *pShard) {
 #if defined LINUX
-  pthread_rwlock_unlock(&pObj->lock);
+  pthread_rwlock_unlock(&pShard->lock);
 #else
-  pthread_mutex_unlock(&pObj->lock);
+  pthread_mutex_unlock(&pShard->lock);
 #endif
 }
 
-static FORCE_INLINE int32_t __cache_lock_init(SCacheObj *pObj) {
+static FORCE_INLINE int32_t __cache_lock_init(SCacheShard *pShard) {
 #if defined LINUX
-  return pthread_rwlock_init(&pObj->lock, NULL);
+  return pthread_rwlock_init(&pShard->lock, NULL);
 #else
-  return pthread_mutex_init(&pObj->lock, NULL);
+  return pthread_mutex_init(&pShard->lock, NULL);
 #endif
 }
 
-static FORCE_INLINE void __cache_lock_destroy(SCacheObj *pObj) {
+static FORCE_INLINE void __cache_lock_destroy(SCacheShard *pShard) {
 #if defined LINUX
-  pthread_rwlock_destroy(&pObj->lock);
+  pthread_rwlock_destroy(&pShard->lock);
 #else
-  pthread_mutex_destroy(&pObj->lock);
+  pthread_mutex_destroy(&pShard->lock);
 #endif
 }
 
@@ -138,6 +159,22 @@ static FORCE_INLINE int32_t taosHashTableLength(int32_t length) {
   return i;
 }
 
+/**
+ * the slot where the node of hashVal resides, in the old list if the slot is not moved yet during resize
+ * @param pShard    cache shard
+ * @param hashVal   hash value of key
+ * @return          address of the slot
+ */
+static FORCE_INLINE SDataNode **taosGetHashSlot(SCacheShard *pShard, uint32_t hashVal) {
+  if (pShard->pOldList != NULL) {
+    int32_t index = HASH_INDEX(hashVal, pShard->oldCapacity);
+    if (index >= pShard->rehashIndex) return &pShard->pOldList[index];
+  }
+
+  return &pShard->hashList[HASH_INDEX(hashVal, pShard->capacity)];
+}
+
+
 /**
  * @param key      key of object for hash, usually a null-terminated string
  * @param keyLen   length of key
@@ -182,40 +219,40 @@ static FORCE_INLINE uint32_t taosHashKey(const char *key, uint32_t len) { return
 /**
  * add object node into trash, and this object is closed for referencing if it is add to trash
  * It will be removed until the pNode->refCount == 0
- * @param pObj    Cache object
+ * @param pShard  Cache shard
  * @param pNode   Cache slot object
  */
-static void taosAddToTrash(SCacheObj *pObj, SDataNode *pNode) {
+static void taosAddToTrash(SCacheShard *pShard, SDataNode *pNode) {
   if (pNode->hashVal == HASH_VALUE_IN_TRASH) { /* node is already in trash */
     return;
   }
 
-  pNode->next = pObj->pTrash;
-  if (pObj->pTrash) {
-    pObj->pTrash->prev = pNode;
+  pNode->next = pShard->pTrash;
+  if (pShard->pTrash) {
+    pShard->pTrash->prev = pNode;
   }
 
   pNode->prev = NULL;
-  pObj->pTrash = pNode;
+  pShard->pTrash = pNode;
 
   pNode->hashVal = HASH_VALUE_IN_TRASH;
-  pObj->numOfElemsInTrash++;
+  pShard->numOfElemsInTrash++;
 
-  pTrace("key:%s %p move to trash, numOfElem in trash:%d", pNode->key, pNode, pObj->numOfElemsInTrash);
+  pTrace("key:%s %p move to trash, numOfElem in trash:%d", pNode->key, pNode, pShard->numOfElemsInTrash);
 }
 
-static void taosRemoveFromTrash(SCacheObj *pObj, SDataNode *pNode) {
+static void taosRemoveFromTrash(SCacheShard *pShard, SDataNode *pNode) {
   if (pNode->signature != (uint64_t)pNode) {
     pError("key:sig:%d %p data has been released, ignore", pNode->signature, pNode);
     return;
   }
 
-  pObj->numOfElemsInTrash--;
+  pShard->numOfElemsInTrash--;
   if (pNode->prev) {
     pNode->prev->next = pNode->next;
   } else {
     /* pnode is the header, update header */
-    pObj->pTrash = pNode->next;
+    pShard->pTrash = pNode->next;
   }
 
   if (pNode->next) {
@@ -227,25 +264,24 @@ static void taosRemoveFromTrash(SCacheObj *pObj, SDataNode *pNode) {
 }
 /**
  * remove nodes in trash with refCount == 0 in cache
- * @param pNode
- * @param pObj
+ * @param pShard
  * @param force   force model, if true, remove data in trash without check refcount.
  *                may cause corruption. So, forece model only applys before cache is closed
  */
-static void taosClearCacheTrash(SCacheObj *pObj, bool force) {
-  __cache_wr_lock(pObj);
+static void taosClearCacheTrash(SCacheShard *pShard, bool force) {
+  __cache_wr_lock(pShard);
 
-  if (pObj->numOfElemsInTrash == 0) {
-    if (pObj->pTrash != NULL) {
-      pError("key:inconsistency data in cache, numOfElem in trash:%d", pObj->numOfElemsInTrash);
+  if (pShard->numOfElemsInTrash == 0) {
+    if (pShard->pTrash != NULL) {
+      pError("key:inconsistency data in cache, numOfElem in trash:%d", pShard->numOfElemsInTrash);
     }
-    pObj->pTrash = NULL;
+    pShard->pTrash = NULL;
 
-    __cache_unlock(pObj);
+    __cache_unlock(pShard);
     return;
   }
 
-  SDataNode *pNode = pObj->pTrash;
+  SDataNode *pNode = pShard->pTrash;
 
   while (pNode) {
     if (pNode->refCount < 0) {
@@ -258,61 +294,61 @@ static void taosClearCacheTrash(SCacheObj *pObj, bool force) {
     }
 
     if (force || (pNode->refCount == 0)) {
-      pTrace("key:%s %p removed from trash. numOfElem in trash:%d", pNode->key, pNode, pObj->numOfElemsInTrash - 1)
+      pTrace("key:%s %p removed from trash. numOfElem in trash:%d", pNode->key, pNode, pShard->numOfElemsInTrash - 1)
       SDataNode *pTmp = pNode;
       pNode = pNode->next;
-      taosRemoveFromTrash(pObj, pTmp);
+      taosRemoveFromTrash(pShard, pTmp);
     } else {
       pNode = pNode->next;
     }
   }
 
-  assert(pObj->numOfElemsInTrash >= 0);
-  __cache_unlock(pObj);
+  assert(pShard->numOfElemsInTrash >= 0);
+  __cache_unlock(pShard);
 }
 
 /**
  * add data node into cache
- * @param pObj    cache object
+ * @param pShard  cache shard
  * @param pNode   Cache slot object
  */
-static void taosAddNodeToHashTable(SCacheObj *pObj, SDataNode *pNode) {
-  int32_t slotIndex = HASH_INDEX(pNode->hashVal, pObj->capacity);
-  pNode->next = pObj->hashList[slotIndex];
+static void taosAddNodeToHashTable(SCacheShard *pShard, SDataNode *pNode) {
+  SDataNode **pSlot = taosGetHashSlot(pShard, pNode->hashVal);
+  pNode->next = *pSlot;
 
-  if (pObj->hashList[slotIndex] != NULL) {
-    (pObj->hashList[slotIndex])->prev = pNode;
-    pObj->statistics.numOfCollision++;
+  if (*pSlot != NULL) {
+    (*pSlot)->prev = pNode;
+    pShard->statistics.numOfCollision++;
   }
-  pObj->hashList[slotIndex] = pNode;
+  *pSlot = pNode;
 
-  pObj->size++;
-  pObj->totalSize += pNode->nodeSize;
+  pShard->size++;
+  pShard->totalSize += pNode->nodeSize;
 
   pTrace("key:%s %p add to hash table", pNode->key, pNode);
 }
 
 /**
  * remove node in hash list
- * @param pObj
+ * @param pShard
  * @param pNode
  */
-static void taosRemoveNodeInHashTable(SCacheObj *pObj, SDataNode *pNode) {
+static void taosRemoveNodeInHashTable(SCacheShard *pShard, SDataNode *pNode) {
   if (pNode->hashVal == HASH_VALUE_IN_TRASH) return;
 
   SDataNode *pNext = pNode->next;
   if (pNode->prev != NULL) {
     pNode->prev->next = pNext;
   } else { /* the node is in hashlist, remove it */
-    pObj->hashList[HASH_INDEX(pNode->hashVal, pObj->capacity)] = pNext;
+    *taosGetHashSlot(pShard, pNode->hashVal) = pNext;
   }
 
   if (pNext != NULL) {
     pNext->prev = pNode->prev;
   }
 
-  pObj->size--;
-  pObj->totalSize -= pNode->nodeSize;
+  pShard->size--;
+  pShard->totalSize -= pNode->nodeSize;
 
   pNode->next = NULL;
   pNode->prev = NULL;
@@ -322,16 +358,16 @@ static void taosRemoveNodeInHashTable(SCacheObj *pObj, SDataNode *pNode) {
 
 /**
  * in-place node in hashlist
- * @param pObj      cache object
+ * @param pShard    cache shard
  * @param pNode     data node
  */
-static void taosUpdateInHashTable(SCacheObj *pObj, SDataNode *pNode) {
-  assert(pNode->hashVal >= 0);
+static void taosUpdateInHashTable(SCacheShard *pShard, SDataNode *pNode) {
+  assert(pNode->hashVal != HASH_VALUE_IN_TRASH);
 
   if (pNode->prev) {
     pNode->prev->next = pNode;
   } else {
-    pObj->hashList[HASH_INDEX(pNode->hashVal, pObj->capacity)] = pNode;
+    *taosGetHashSlot(pShard, pNode->hashVal) = pNode;
   }
 
   if (pNode->next) {
@@ -343,141 +379,140 @@ static void taosUpdateInHashTable(SCacheObj *pObj, SDataNode *pNode) {
 
 /**
  * get SDataNode from hashlist, nodes from trash are not included.
- * @param pObj      Cache objection
+ * @param pShard    Cache shard
  * @param key       key for hash
- * @param keyLen    key length
+ * @param hashVal   hash value of key
  * @return
  */
-static SDataNode *taosGetNodeFromHashTable(SCacheObj *pObj, const char *key, uint32_t keyLen) {
-  uint32_t hash = (*pObj->hashFp)(key, keyLen);
-
-  int32_t    slot = HASH_INDEX(hash, pObj->capacity);
-  SDataNode *pNode = pObj->hashList[slot];
+static SDataNode *taosGetNodeFromHashTable(SCacheShard *pShard, const char *key, uint32_t hashVal) {
+  SDataNode *pNode = *taosGetHashSlot(pShard, hashVal);
 
   while (pNode) {
-    if (strcmp(pNode->key, key) == 0) break;
+    if (pNode->hashVal == hashVal && strcmp(pNode->key, key) == 0) break;
 
     pNode = pNode->next;
   }
 
-  if (pNode) {
-    assert(HASH_INDEX(pNode->hashVal, pObj->capacity) == slot);
+  return pNode;
+}
+
+/**
+ * move at most CACHE_REHASH_STEP slots of the old hash list into the new one, and release the old
+ * list when all slots are moved
+ *
+ * @param pShard
+ */
+static void taosHashTableRehashStep(SCacheShard *pShard) {
+  if (pShard->pOldList == NULL) return;
+
+  int64_t st = taosGetTimestampUs();
+  int32_t end = MIN(pShard->rehashIndex + CACHE_REHASH_STEP, pShard->oldCapacity);
+
+  for (int32_t i = pShard->rehashIndex; i < end; ++i) {
+    SDataNode *pNode = pShard->pOldList[i];
+    pShard->pOldList[i] = NULL;
+
+    while (pNode) {
+      SDataNode *pNext = pNode->next;
+      int32_t    j = HASH_INDEX(pNode->hashVal, pShard->capacity);
+
+      pNode->prev = NULL;
+      pNode->next = pShard->hashList[j];
+      if (pShard->hashList[j] != NULL) {
+        (pShard->hashList[j])->prev = pNode;
+      }
+      pShard->hashList[j] = pNode;
+
+      pNode = pNext;
+    }
   }
 
-  return pNode;
+  pShard->rehashIndex = end;
+  pShard->statistics.resizeTime += (taosGetTimestampUs() - st);
+
+  if (pShard->rehashIndex >= pShard->oldCapacity) {
+    tfree(pShard->pOldList);
+    pShard->oldCapacity = 0;
+    pShard->rehashIndex = 0;
+
+    pTrace("cache resize completed, new capacity:%d, load factor:%f, elapsed time:%fms", pShard->capacity,
+           ((double)pShard->size) / pShard->capacity, pShard->statistics.resizeTime / 1000.0);
+  }
 }
 
 /**
- * resize the hash list if the threshold is reached
+ * start to double the hash list if the threshold is reached, or continue the resize in progress.
+ * The nodes are moved into the new list incrementally by the following writes.
  *
- * @param pObj
+ * @param pShard
  */
-static void taosHashTableResize(SCacheObj *pObj) {
-  if (pObj->size < pObj->capacity * HASH_DEFAULT_LOAD_FACTOR) {
+static void taosHashTableResize(SCacheShard *pShard) {
+  if (pShard->pOldList != NULL) {
+    taosHashTableRehashStep(pShard);
     return;
   }
 
-  // double the original capacity
-  pObj->statistics.numOfResize++;
-  SDataNode *pNode = NULL;
-  SDataNode *pNext = NULL;
+  if (pShard->size < pShard->capacity * HASH_DEFAULT_LOAD_FACTOR) {
+    return;
+  }
 
-  int32_t newSize = pObj->capacity << 1;
+  // double the original capacity
+  int32_t newSize = pShard->capacity << 1;
   if (newSize > HASH_MAX_CAPACITY) {
     pTrace("current capacity:%d, maximum capacity:%d, no resize applied due to limitation is reached",
-           pObj->capacity, HASH_MAX_CAPACITY);
+           pShard->capacity, HASH_MAX_CAPACITY);
     return;
   }
 
-  int64_t     st = taosGetTimestampUs();
-  SDataNode **pList = realloc(pObj->hashList, sizeof(SDataNode *) * newSize);
+  SDataNode **pList = calloc(newSize, sizeof(SDataNode *));
   if (pList == NULL) {
-    pTrace("cache resize failed due to out of memory, capacity remain:%d", pObj->capacity);
+    pTrace("cache resize failed due to out of memory, capacity remain:%d", pShard->capacity);
     return;
   }
 
-  pObj->hashList = pList;
-
-  int32_t inc = newSize - pObj->capacity;
-  memset(&pObj->hashList[pObj->capacity], 0, inc * sizeof(SDataNode *));
+  pShard->statistics.numOfResize++;
+  pShard->statistics.resizeTime = 0;
 
-  pObj->capacity = newSize;
+  pShard->pOldList = pShard->hashList;
+  pShard->oldCapacity = pShard->capacity;
+  pShard->rehashIndex = 0;
 
-  for (int32_t i = 0; i < pObj->capacity; ++i) {
-    pNode = pObj->hashList[i];
+  pShard->hashList = pList;
+  pShard->capacity = newSize;
 
-    while (pNode) {
-      int32_t j = HASH_INDEX(pNode->hashVal, pObj->capacity);
-      if (j == i) {  // this key resides in the same slot, no need to relocate it
-        pNode = pNode->next;
-      } else {
-        pNext = pNode->next;
-
-        // remove from current slot
-        if (pNode->prev != NULL) {
-          pNode->prev->next = pNode->next;
-        } else {
-          pObj->hashList[i] = pNode->next;
-        }
-
-        if (pNode->next != NULL) {
-          (pNode->next)->prev = pNode->prev;
-        }
-
-        // added into new slot
-        pNode->next = NULL;
-        pNode->prev = NULL;
-
-        pNode->next = pObj->hashList[j];
-
-        if (pObj->hashList[j] != NULL) {
-          (pObj->hashList[j])->prev = pNode;
-        }
-        pObj->hashList[j] = pNode;
-
-        // continue
-        pNode = pNext;
-      }
-    }
-  }
-
-  int64_t et = taosGetTimestampUs();
-  pObj->statistics.resizeTime += (et - st);
-
-  pTrace("cache resize completed, new capacity:%d, load factor:%f, elapsed time:%fms", pObj->capacity,
-         ((double)pObj->size) / pObj->capacity, (et - st) / 1000.0);
+  taosHashTableRehashStep(pShard);
 }
 
 /**
  * release node
- * @param pObj      cache object
+ * @param pShard    cache shard
  * @param pNode     data node
  */
-static FORCE_INLINE void taosCacheReleaseNode(SCacheObj *pObj, SDataNode *pNode) {
-  taosRemoveNodeInHashTable(pObj, pNode);
+static FORCE_INLINE void taosCacheReleaseNode(SCacheShard *pShard, SDataNode *pNode) {
+  taosRemoveNodeInHashTable(pShard, pNode);
   if (pNode->signature != (uint64_t)pNode) {
     pError("key:%s, %p data is invalid, or has been released", pNode->key, pNode);
     return;
   }
 
-  pTrace("key:%s is removed from cache,total:%d,size:%ldbytes", pNode->key, pObj->size, pObj->totalSize);
+  pTrace("key:%s is removed from cache,total:%d,size:%ldbytes", pNode->key, pShard->size, pShard->totalSize);
   pNode->signature = 0;
   free(pNode);
 }
 
 /**
  * move the old node into trash
- * @param pObj
+ * @param pShard
  * @param pNode
  */
-static FORCE_INLINE void taosCacheMoveNodeToTrash(SCacheObj *pObj, SDataNode *pNode) {
-  taosRemoveNodeInHashTable(pObj, pNode);
-  taosAddToTrash(pObj, pNode);
+static FORCE_INLINE void taosCacheMoveNodeToTrash(SCacheShard *pShard, SDataNode *pNode) {
+  taosRemoveNodeInHashTable(pShard, pNode);
+  taosAddToTrash(pShard, pNode);
 }
 
 /**
  * update data in cache
- * @param pObj
+ * @param pShard
  * @param pNode
  * @param key
  * @param keyLen
@@ -485,7 +520,7 @@ static FORCE_INLINE void taosCacheMoveNodeToTrash(SCacheObj *pObj, SDataNode *pN
  * @param dataSize
  * @return
  */
-static SDataNode *taosUpdateCacheImpl(SCacheObj *pObj, SDataNode *pNode, char *key, int32_t keyLen, void *pData,
+static SDataNode *taosUpdateCacheImpl(SCacheShard *pShard, SDataNode *pNode, char *key, int32_t keyLen, void *pData,
                                       uint32_t dataSize, uint64_t keepTime) {
   SDataNode *pNewNode = NULL;
 
@@ -498,6 +533,8 @@ static SDataNode *taosUpdateCacheImpl(SCacheObj *pObj, SDataNode *pNode, char *k
       return NULL;
     }
 
+    pShard->totalSize += (int64_t)newSize - pNewNode->nodeSize;
+    pNewNode->nodeSize = (uint32_t)newSize;
     pNewNode->signature = (uint64_t)pNewNode;
     memcpy(pNewNode->data, pData, dataSize);
 
@@ -511,10 +548,10 @@ static SDataNode *taosUpdateCacheImpl(SCacheObj *pObj, SDataNode *pNode, char *k
     atomic_add_fetch_32(&pNewNode->refCount, 1);
 
     // the address of this node may be changed, so the prev and next element should update the corresponding pointer
-    taosUpdateInHashTable(pObj, pNewNode);
+    taosUpdateInHashTable(pShard, pNewNode);
   } else {
-    int32_t hashVal = pNode->hashVal;
-    taosCacheMoveNodeToTrash(pObj, pNode);
+    uint32_t hashVal = pNode->hashVal;
+    taosCacheMoveNodeToTrash(pShard, pNode);
 
     pNewNode = taosCreateHashNode(key, keyLen, pData, dataSize, keepTime);
     if (pNewNode == NULL) {
@@ -523,11 +560,11 @@ static SDataNode *taosUpdateCacheImpl(SCacheObj *pObj, SDataNode *pNode, char *k
 
     atomic_add_fetch_32(&pNewNode->refCount, 1);
 
-    assert(hashVal == (*pObj->hashFp)(key, keyLen - 1));
     pNewNode->hashVal = hashVal;
+    pNewNode->shard = CACHE_SHARD_INDEX(hashVal);
 
     // add new element to hashtable
-    taosAddNodeToHashTable(pObj, pNewNode);
+    taosAddNodeToHashTable(pShard, pNewNode);
   }
 
   return pNewNode;
@@ -535,24 +572,25 @@ static SDataNode *taosUpdateCacheImpl(SCacheObj *pObj, SDataNode *pNode, char *k
 
 /**
  * add data into hash table
+ * @param pShard
  * @param key
+ * @param keyLen
+ * @param hashVal
  * @param pData
  * @param size
- * @param pObj
- * @param keyLen
- * @param pNode
  * @return
  */
-static FORCE_INLINE SDataNode *taosAddToCacheImpl(SCacheObj *pObj, char *key, uint32_t keyLen, const char *pData,
-                                                  int dataSize, uint64_t lifespan) {
+static FORCE_INLINE SDataNode *taosAddToCacheImpl(SCacheShard *pShard, char *key, uint32_t keyLen, uint32_t hashVal,
+                                                  const char *pData, int dataSize, uint64_t lifespan) {
   SDataNode *pNode = taosCreateHashNode(key, keyLen, pData, dataSize, lifespan);
   if (pNode == NULL) {
     return NULL;
   }
 
   atomic_add_fetch_32(&pNode->refCount, 1);
-  pNode->hashVal = (*pObj->hashFp)(key, keyLen - 1);
-  taosAddNodeToHashTable(pObj, pNode);
+  pNode->hashVal = hashVal;
+  pNode->shard = CACHE_SHARD_INDEX(hashVal);
+  taosAddNodeToHashTable(pShard, pNode);
 
   return pNode;
 }
@@ -574,30 +612,34 @@ void *taosAddDataIntoCache(void *handle, char *key, char *pData, int dataSize, i
   pObj = (SCacheObj *)handle;
   if (pObj == NULL || pObj->capacity == 0) return NULL;
 
-  uint32_t keyLen = (uint32_t)strlen(key) + 1;
+  uint32_t     keyLen = (uint32_t)strlen(key) + 1;
+  uint32_t     hashVal = (*pObj->hashFp)(key, keyLen - 1);
+  SCacheShard *pShard = &pObj->shards[CACHE_SHARD_INDEX(hashVal)];
 
-  __cache_wr_lock(pObj);
+  __cache_wr_lock(pShard);
 
-  SDataNode *pOldNode = taosGetNodeFromHashTable(pObj, key, keyLen - 1);
+  SDataNode *pOldNode = taosGetNodeFromHashTable(pShard, key, hashVal);
 
   if (pOldNode == NULL) {  // do add to cache
     // check if the threshold is reached
-    taosHashTableResize(pObj);
+    taosHashTableResize(pShard);
 
-    pNode = taosAddToCacheImpl(pObj, key, keyLen, pData, dataSize, keepTime * 1000L);
+    pNode = taosAddToCacheImpl(pShard, key, keyLen, hashVal, pData, dataSize, keepTime * 1000L);
     if (NULL != pNode) {
       pTrace(
-          "key:%s %p added into cache, slot:%d, addTime:%lld, expireTime:%lld, cache total:%d, "
+          "key:%s %p added into cache, shard:%d, addTime:%lld, expireTime:%lld, shard total:%d, "
           "size:%lldbytes, collision:%d",
-          pNode->key, pNode, HASH_INDEX(pNode->hashVal, pObj->capacity), pNode->addTime, pNode->time, pObj->size,
-          pObj->totalSize, pObj->statistics.numOfCollision);
+          pNode->key, pNode, pNode->shard, pNode->addTime, pNode->time, pShard->size, pShard->totalSize,
+          pShard->statistics.numOfCollision);
     }
   } else {  // old data exists, update the node
-    pNode = taosUpdateCacheImpl(pObj, pOldNode, key, keyLen, pData, dataSize, keepTime * 1000L);
+    taosHashTableRehashStep(pShard);
+
+    pNode = taosUpdateCacheImpl(pShard, pOldNode, key, keyLen, pData, dataSize, keepTime * 1000L);
     pTrace("key:%s %p exist in cache, updated", key, pNode);
   }
 
-  __cache_unlock(pObj);
+  __cache_unlock(pShard);
 
   return (pNode != NULL) ? pNode->data : NULL;
 }
@@ -607,15 +649,16 @@ static FORCE_INLINE void taosDecRef(SDataNode *pNode) {
     return;
   }
 
-  if (pNode->refCount > 0) {
-    atomic_sub_fetch_32(&pNode->refCount, 1);
-    pTrace("key:%s is released by app.refcnt:%d", pNode->key, pNode->refCount);
+  int32_t ref = atomic_sub_fetch_32(&pNode->refCount, 1);
+  if (ref >= 0) {
+    pTrace("key:%s is released by app.refcnt:%d", pNode->key, ref);
   } else {
     /*
      * safety check.
      * app may false releases cached object twice, to decrease the refcount more than acquired
      */
-    pError("key:%s is released by app more than referenced.refcnt:%d", pNode->key, pNode->refCount);
+    atomic_add_fetch_32(&pNode->refCount, 1);
+    pError("key:%s is released by app more than referenced.refcnt:%d", pNode->key, ref + 1);
   }
 }
 
@@ -627,7 +670,7 @@ static FORCE_INLINE void taosDecRef(SDataNode *pNode) {
  */
 void taosRemoveDataFromCache(void *handle, void **data, bool _remove) {
   SCacheObj *pObj = (SCacheObj *)handle;
-  if (pObj == NULL || pObj->capacity == 0 || (*data) == NULL || (pObj->size + pObj->numOfElemsInTrash == 0)) return;
+  if (pObj == NULL || pObj->capacity == 0 || (*data) == NULL) return;
 
   size_t     offset = offsetof(SDataNode, data);
   SDataNode *pNode = (SDataNode *)((char *)(*data) - offset);
@@ -640,14 +683,17 @@ void taosRemoveDataFromCache(void *handle, void **data, bool _remove) {
   *data = NULL;
 
   if (_remove) {
-    __cache_wr_lock(pObj);
+    SCacheShard *pShard = &pObj->shards[pNode->shard];
+
+    __cache_wr_lock(pShard);
     // pNode may be released immediately by other thread after the reference count of pNode is set to 0,
     // So we need to lock it in the first place.
     taosDecRef(pNode);
-    taosCacheMoveNodeToTrash(pObj, pNode);
+    taosCacheMoveNodeToTrash(pShard, pNode);
 
-    __cache_unlock(pObj);
+    __cache_unlock(pShard);
   } else {
+    // the reference count is atomic, no lock is required to release a reference
     taosDecRef(pNode);
   }
 }
@@ -662,26 +708,28 @@ void *taosGetDataFromCache(void *handle, char *key) {
   SCacheObj *pObj = (SCacheObj *)handle;
   if (pObj == NULL || pObj->capacity == 0) return NULL;
 
-  uint32_t keyLen = (uint32_t)strlen(key);
+  uint32_t     keyLen = (uint32_t)strlen(key);
+  uint32_t     hashVal = (*pObj->hashFp)(key, keyLen);
+  SCacheShard *pShard = &pObj->shards[CACHE_SHARD_INDEX(hashVal)];
 
-  __cache_rd_lock(pObj);
+  __cache_rd_lock(pShard);
 
-  SDataNode *ptNode = taosGetNodeFromHashTable(handle, key, keyLen);
+  SDataNode *ptNode = taosGetNodeFromHashTable(pShard, key, hashVal);
   if (ptNode != NULL) {
     atomic_add_fetch_32(&ptNode->refCount, 1);
   }
 
-  __cache_unlock(pObj);
+  __cache_unlock(pShard);
 
   if (ptNode != NULL) {
-    atomic_add_fetch_32(&pObj->statistics.hitCount, 1);
+    atomic_add_fetch_64(&pShard->statistics.hitCount, 1);
     pTrace("key:%s is retrieved from cache,refcnt:%d", key, ptNode->refCount);
   } else {
-    atomic_add_fetch_32(&pObj->statistics.missCount, 1);
+    atomic_add_fetch_64(&pShard->statistics.missCount, 1);
     pTrace("key:%s not in cache,retrieved failed", key);
   }
 
-  atomic_add_fetch_32(&pObj->statistics.totalAccess, 1);
+  atomic_add_fetch_64(&pShard->statistics.totalAccess, 1);
   return (ptNode != NULL) ? ptNode->data : NULL;
 }
 
@@ -699,59 +747,88 @@ void *taosUpdateDataFromCache(void *handle, char *key, char *pData, int size, in
 
   SDataNode *pNew = NULL;
 
-  uint32_t keyLen = strlen(key) + 1;
+  uint32_t     keyLen = strlen(key) + 1;
+  uint32_t     hashVal = (*pObj->hashFp)(key, keyLen - 1);
+  SCacheShard *pShard = &pObj->shards[CACHE_SHARD_INDEX(hashVal)];
 
-  __cache_wr_lock(pObj);
+  __cache_wr_lock(pShard);
 
-  SDataNode *pNode = taosGetNodeFromHashTable(handle, key, keyLen - 1);
+  SDataNode *pNode = taosGetNodeFromHashTable(pShard, key, hashVal);
 
   if (pNode == NULL) {  // object has been released, do add operation
-    pNew = taosAddToCacheImpl(pObj, key, keyLen, pData, size, duration * 1000L);
-    pWarn("key:%s does not exist, update failed,do add to cache.total:%d,size:%ldbytes", key, pObj->size,
-          pObj->totalSize);
+    taosHashTableResize(pShard);
+
+    pNew = taosAddToCacheImpl(pShard, key, keyLen, hashVal, pData, size, duration * 1000L);
+    pWarn("key:%s does not exist, update failed,do add to cache.total:%d,size:%ldbytes", key, pShard->size,
+          pShard->totalSize);
   } else {
-    pNew = taosUpdateCacheImpl(pObj, pNode, key, keyLen, pData, size, duration * 1000L);
-    pTrace("key:%s updated.expireTime:%lld.refCnt:%d", key, pNode->time, pNode->refCount);
+    taosHashTableRehashStep(pShard);
+
+    pNew = taosUpdateCacheImpl(pShard, pNode, key, keyLen, pData, size, duration * 1000L);
+    pTrace("key:%s updated.refCnt:%d", key, (pNew != NULL) ? pNew->refCount : 0);
   }
 
-  __cache_unlock(pObj);
+  __cache_unlock(pShard);
   return (pNew != NULL) ? pNew->data : NULL;
 }
 
-static void doCleanUpDataCache(SCacheObj* pObj) {
-  SDataNode *pNode, *pNext;
+static void taosFreeNodeList(SDataNode *pNode) {
+  while (pNode) {
+    SDataNode *pNext = pNode->next;
+    free(pNode);
+    pNode = pNext;
+  }
+}
+
+static void doCleanUpDataCache(SCacheObj *pObj) {
+  for (int32_t i = 0; i < CACHE_NUM_OF_SHARDS; ++i) {
+    SCacheShard *pShard = &pObj->shards[i];
 
-  __cache_wr_lock(pObj);
+    __cache_wr_lock(pShard);
 
-  if (pObj->hashList && pObj->size > 0) {
-    for (int i = 0; i < pObj->capacity; ++i) {
-      pNode = pObj->hashList[i];
-      while (pNode) {
-        pNext = pNode->next;
-        free(pNode);
-        pNode = pNext;
-      }
+    if (pShard->hashList) {
+      for (int32_t j = 0; j < pShard->capacity; ++j) taosFreeNodeList(pShard->hashList[j]);
+      tfree(pShard->hashList);
     }
 
-    tfree(pObj->hashList);
-  }
+    if (pShard->pOldList) {
+      for (int32_t j = pShard->rehashIndex; j < pShard->oldCapacity; ++j) taosFreeNodeList(pShard->pOldList[j]);
+      tfree(pShard->pOldList);
+    }
 
-  __cache_unlock(pObj);
+    __cache_unlock(pShard);
 
-  taosClearCacheTrash(pObj, true);
-  __cache_lock_destroy(pObj);
+    taosClearCacheTrash(pShard, true);
+    __cache_lock_destroy(pShard);
+  }
 
   memset(pObj, 0, sizeof(SCacheObj));
 
   free(pObj);
 }
 
+/**
+ * release the expired nodes in one slot, which are not referenced by others
+ * @param pShard
+ * @param pNode   the first node of slot
+ * @param time    current time
+ */
+static void taosRemoveExpiredNodes(SCacheShard *pShard, SDataNode *pNode, uint64_t time) {
+  while (pNode) {
+    SDataNode *pNext = pNode->next;
+
+    if (pNode->time <= time && pNode->refCount <= 0) {
+      taosCacheReleaseNode(pShard, pNode);
+    }
+    pNode = pNext;
+  }
+}
+
 /**
  * refresh cache to remove data in both hash list and trash, if any nodes' refcount == 0, every pObj->refreshTime
  * @param handle   Cache object handle
  */
 void taosRefreshDataCache(void *handle, void *tmrId) {
-  SDataNode *pNode, *pNext;
   SCacheObj *pObj = (SCacheObj *)handle;
 
   if (pObj == NULL || pObj->capacity <= 0) {
@@ -765,75 +842,85 @@ void taosRefreshDataCache(void *handle, void *tmrId) {
   }
 
   uint64_t time = taosGetTimestampMs();
-  uint32_t numOfCheck = 0;
-  pObj->statistics.refreshCount++;
 
-  int32_t num = pObj->size;
+  for (int32_t i = 0; i < CACHE_NUM_OF_SHARDS && pObj->deleting != 1; ++i) {
+    SCacheShard *pShard = &pObj->shards[i];
+    pShard->statistics.refreshCount++;
 
-  for (int i = 0; i < pObj->capacity; ++i) {
-    // in deleting process, quit refreshing immediately
-    if (pObj->deleting == 1) {
-      break;
-    }
+    /*
+     * lock one slot at a time, the capacity may be changed by a resize in the meantime, and the
+     * slots not moved yet are checked in the old list
+     */
+    for (int32_t j = 0;; ++j) {
+      // in deleting process, quit refreshing immediately
+      if (pObj->deleting == 1) {
+        break;
+      }
 
-    __cache_wr_lock(pObj);
-    pNode = pObj->hashList[i];
+      __cache_wr_lock(pShard);
 
-    while (pNode) {
-      numOfCheck++;
-      pNext = pNode->next;
+      if (pShard->size <= 0 || j >= pShard->capacity) {
+        __cache_unlock(pShard);
+        break;
+      }
 
-      if (pNode->time <= time && pNode->refCount <= 0) {
-        taosCacheReleaseNode(pObj, pNode);
+      taosRemoveExpiredNodes(pShard, pShard->hashList[j], time);
+      if (pShard->pOldList != NULL && j >= pShard->rehashIndex && j < pShard->oldCapacity) {
+        taosRemoveExpiredNodes(pShard, pShard->pOldList[j], time);
       }
-      pNode = pNext;
-    }
 
-    /* all data have been checked, not need to iterate further */
-    if (numOfCheck == num || pObj->size <= 0) {
-      __cache_unlock(pObj);
-      break;
+      __cache_unlock(pShard);
     }
 
-    __cache_unlock(pObj);
+    taosClearCacheTrash(pShard, false);
   }
 
-  if (pObj->deleting == 1) { // clean up resources and abort
+  if (pObj->deleting == 1) {  // clean up resources and abort
     doCleanUpDataCache(pObj);
   } else {
-    taosClearCacheTrash(pObj, false);
     taosTmrReset(taosRefreshDataCache, pObj->refreshTime, pObj, pObj->tmrCtrl, &pObj->pTimer);
   }
 }
 
+static void taosMoveSlotToTrash(SCacheShard *pShard, SDataNode **pSlot) {
+  SDataNode *pNode = *pSlot;
+
+  while (pNode) {
+    SDataNode *pNext = pNode->next;
+    taosCacheMoveNodeToTrash(pShard, pNode);
+    pNode = pNext;
+  }
+
+  *pSlot = NULL;
+}
+
 /**
  *
  * @param handle
  * @param tmrId
  */
 void taosClearDataCache(void *handle) {
-  SDataNode *pNode, *pNext;
   SCacheObj *pObj = (SCacheObj *)handle;
 
-  int32_t capacity = pObj->capacity;
+  for (int32_t i = 0; i < CACHE_NUM_OF_SHARDS; ++i) {
+    SCacheShard *pShard = &pObj->shards[i];
 
-  for (int i = 0; i < capacity; ++i) {
-    __cache_wr_lock(pObj);
+    __cache_wr_lock(pShard);
 
-    pNode = pObj->hashList[i];
+    for (int32_t j = 0; j < pShard->capacity; ++j) {
+      taosMoveSlotToTrash(pShard, &pShard->hashList[j]);
+    }
 
-    while (pNode) {
-      pNext = pNode->next;
-      taosCacheMoveNodeToTrash(pObj, pNode);
-      pNode = pNext;
+    if (pShard->pOldList != NULL) {
+      for (int32_t j = pShard->rehashIndex; j < pShard->oldCapacity; ++j) {
+        taosMoveSlotToTrash(pShard, &pShard->pOldList[j]);
+      }
     }
 
-    pObj->hashList[i] = NULL;
+    __cache_unlock(pShard);
 
-    __cache_unlock(pObj);
+    taosClearCacheTrash(pShard, false);
   }
-
-  taosClearCacheTrash(pObj, false);
 }
 
 /**
@@ -854,32 +941,37 @@ void *taosInitDataCache(int capacity, void *tmrCtrl, int64_t refreshTime) {
     return NULL;
   }
 
-  // the max slots is not defined by user
-  pObj->capacity = taosHashTableLength(capacity);
-  assert((pObj->capacity & (pObj->capacity - 1)) == 0);
+  // the max slots is not defined by user, the slots are evenly divided into shards
+  pObj->capacity = capacity;
+  int32_t shardCapacity = taosHashTableLength(capacity / CACHE_NUM_OF_SHARDS);
 
-  pObj->hashFp = taosHashKey;
-  pObj->refreshTime = refreshTime * 1000;
+  for (int32_t i = 0; i < CACHE_NUM_OF_SHARDS; ++i) {
+    SCacheShard *pShard = &pObj->shards[i];
 
-  pObj->hashList = (SDataNode **)calloc(1, sizeof(SDataNode *) * pObj->capacity);
-  if (pObj->hashList == NULL) {
-    free(pObj);
-    pError("failed to allocate memory, reason:%s", strerror(errno));
-    return NULL;
-  }
+    pShard->capacity = shardCapacity;
+    assert((pShard->capacity & (pShard->capacity - 1)) == 0);
 
-  pObj->tmrCtrl = tmrCtrl;
-  taosTmrReset(taosRefreshDataCache, pObj->refreshTime, pObj, pObj->tmrCtrl, &pObj->pTimer);
+    pShard->hashList = (SDataNode **)calloc(1, sizeof(SDataNode *) * pShard->capacity);
+    if (pShard->hashList == NULL || __cache_lock_init(pShard) != 0) {
+      pError("failed to init cache shard, reason:%s", strerror(errno));
 
-  if (__cache_lock_init(pObj) != 0) {
-    taosTmrStopA(&pObj->pTimer);
-    free(pObj->hashList);
-    free(pObj);
+      tfree(pShard->hashList);
+      for (int32_t j = 0; j < i; ++j) {
+        tfree(pObj->shards[j].hashList);
+        __cache_lock_destroy(&pObj->shards[j]);
+      }
 
-    pError("failed to init lock, reason:%s", strerror(errno));
-    return NULL;
+      free(pObj);
+      return NULL;
+    }
   }
 
+  pObj->hashFp = taosHashKey;
+  pObj->refreshTime = refreshTime * 1000;
+
+  pObj->tmrCtrl = tmrCtrl;
+  taosTmrReset(taosRefreshDataCache, pObj->refreshTime, pObj, pObj->tmrCtrl, &pObj->pTimer);
+
   return (void *)pObj;
 }
 
@@ -903,3 +995,24 @@ void taosCleanUpDataCache(void *handle) {
   pObj->deleting = 1;
   return;
 }
+
+/**
+ * get the hit and miss counters of each shard
+ * @param handle      cache object
+ * @param hitCount    hit count of each shard, with at least maxShards elements
+ * @param missCount   miss count of each shard, with at least maxShards elements
+ * @param maxShards   maximum number of shards to get
+ * @return            number of shards returned
+ */
+int32_t taosGetDataCacheStatis(void *handle, int64_t *hitCount, int64_t *missCount, int32_t maxShards) {
+  SCacheObj *pObj = (SCacheObj *)handle;
+  if (pObj == NULL || pObj->capacity == 0) return 0;
+
+  int32_t num = MIN(maxShards, CACHE_NUM_OF_SHARDS);
+  for (int32_t i = 0; i < num; ++i) {
+    hitCount[i] = atomic_load_64(&pObj->shards[i].statistics.hitCount);
+    missCount[i] = atomic_load_64(&pObj->shards[i].statistics.missCount);
+  }
+
+  return num;
+}
@@ -45,6 +45,17 @@
  *   of leading zeros are larger than the trailing zeros, then record the last serveral bytes
  *   of the XORed value with informations. If not, record the first corresponding bytes.
  *
+ * BITPACK Codec (TSDB_CODEC_BITPACK):
+ *   An alternative codec for integers and timestamps, selected per column and saved in SField.
+ *   Deltas (delta-of-delta for timestamps) are zigzag encoded, then bit-packed with a fixed width
+ *   per frame of 128 values. Decoding has no per-value branches; the prefix sum uses AVX2 if the
+ *   CPU supports it, and the output is the same as the scalar one.
+ *
+ * GORILLA Codec (TSDB_CODEC_GORILLA):
+ *   XOR with the previous float/double value like the default one, but the meaningful bits are
+ *   written into a bit stream with the leading/trailing-zero window of the previous value reused
+ *   if possible. Which codec a column block uses is decided by trial-compressing its first values.
+ *
  */
 
 #include "os.h"
@@ -1105,3 +1116,552 @@ int tsDecompressFloatImp(const char *const input, const int nelements, char *con
 
   return nelements * FLOAT_BYTES;
 }
+
+/* ----------------------------------------------Bit-packing codec---------------------------------------------- */
+#define BITPACK_FRAME_SIZE 128
+
+#define ZIGZAG_ENCODE(_v) (((uint64_t)(_v) << 1) ^ (uint64_t)((int64_t)(_v) >> 63))
+#define ZIGZAG_DECODE(_v) (((uint64_t)(_v) >> 1) ^ (uint64_t)(-(int64_t)((_v) & 1)))
+
+static inline int64_t tsBitpackReadValue(const char *const input, int i, char type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:
+      return ((int8_t *)input)[i];
+    case TSDB_DATA_TYPE_SMALLINT:
+      return ((int16_t *)input)[i];
+    case TSDB_DATA_TYPE_INT:
+      return ((int32_t *)input)[i];
+    default:
+      return ((int64_t *)input)[i];
+  }
+}
+
+static void tsBitpackWriteValues(const int64_t *values, int num, char *const output, int start, char type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:
+      for (int i = 0; i < num; ++i) ((int8_t *)output)[start + i] = (int8_t)values[i];
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      for (int i = 0; i < num; ++i) ((int16_t *)output)[start + i] = (int16_t)values[i];
+      break;
+    case TSDB_DATA_TYPE_INT:
+      for (int i = 0; i < num; ++i) ((int32_t *)output)[start + i] = (int32_t)values[i];
+      break;
+    default:
+      memcpy(output + start * LONG_BYTES, values, num * LONG_BYTES);
+      break;
+  }
+}
+
+/* pack num values of width bits into (num * width + 7) / 8 bytes, little endian */
+static void tsBitpackFrame(const uint64_t *frame, int num, int width, char *output) {
+  uint64_t acc = 0;
+  int      nbits = 0;
+
+  if (width == 0) return;
+
+  for (int i = 0; i < num; ++i) {
+    acc |= frame[i] << nbits;
+    if (nbits + width >= 64) {
+      memcpy(output, &acc, LONG_BYTES);
+      output += LONG_BYTES;
+
+      int used = 64 - nbits;
+      acc = (used == 64) ? 0 : (frame[i] >> used);
+      nbits = nbits + width - 64;
+    } else {
+      nbits += width;
+    }
+  }
+
+  memcpy(output, &acc, (nbits + 7) / 8);
+}
+
+static void tsBitunpackFrame(const char *input, int num, int width, uint64_t *frame) {
+  const char *end = input + (num * width + 7) / 8;
+  uint64_t    mask = (width == 64) ? (uint64_t)-1 : (((uint64_t)1 << width) - 1);
+  uint64_t    acc = 0;
+  int         nbits = 0;
+
+  if (width == 0) {
+    memset(frame, 0, num * sizeof(uint64_t));
+    return;
+  }
+
+  for (int i = 0; i < num; ++i) {
+    if (nbits >= width) {
+      frame[i] = acc & mask;
+      acc = (width == 64) ? 0 : (acc >> width);
+      nbits -= width;
+    } else {
+      uint64_t word = 0;
+      int      bytes = (end - input) >= LONG_BYTES ? LONG_BYTES : (int)(end - input);
+      memcpy(&word, input, bytes);
+      input += bytes;
+
+      int used = width - nbits;
+      frame[i] = (acc | (word << nbits)) & mask;
+      acc = (used == 64) ? 0 : (word >> used);
+      nbits = bytes * BITS_PER_BYTE - used;
+    }
+  }
+}
+
+/* zigzag decode the frame if required, then compute the prefix sum starting from base */
+static int64_t tsPrefixSumScalar(uint64_t *frame, int num, int64_t base, bool zigzag) {
+  for (int i = 0; i < num; ++i) {
+    base += (int64_t)(zigzag ? ZIGZAG_DECODE(frame[i]) : frame[i]);
+    frame[i] = (uint64_t)base;
+  }
+
+  return base;
+}
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+
+__attribute__((target("avx2"))) static int64_t tsPrefixSumAVX2(uint64_t *frame, int num, int64_t base, bool zigzag) {
+  __m256i zero = _mm256_setzero_si256();
+  __m256i one = _mm256_set1_epi64x(1);
+  __m256i carry = _mm256_set1_epi64x(base);
+  int     i = 0;
+
+  for (; i + 4 <= num; i += 4) {
+    __m256i x = _mm256_loadu_si256((__m256i *)(frame + i));
+    if (zigzag) {
+      x = _mm256_xor_si256(_mm256_srli_epi64(x, 1), _mm256_sub_epi64(zero, _mm256_and_si256(x, one)));
+    }
+
+    // [a, b, c, d] -> [a, a+b, c, c+d] -> [a, a+b, a+b+c, a+b+c+d]
+    x = _mm256_add_epi64(x, _mm256_slli_si256(x, 8));
+    x = _mm256_add_epi64(x, _mm256_blend_epi32(zero, _mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 1, 0, 0)), 0xF0));
+    x = _mm256_add_epi64(x, carry);
+
+    _mm256_storeu_si256((__m256i *)(frame + i), x);
+    carry = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(3, 3, 3, 3));
+  }
+
+  base = _mm256_extract_epi64(carry, 0);
+  return tsPrefixSumScalar(frame + i, num - i, base, zigzag);
+}
+
+static int64_t tsPrefixSum(uint64_t *frame, int num, int64_t base, bool zigzag) {
+  static int8_t avx2Supported = -1;
+
+  if (avx2Supported < 0) avx2Supported = __builtin_cpu_supports("avx2") ? 1 : 0;
+  if (avx2Supported) return tsPrefixSumAVX2(frame, num, base, zigzag);
+
+  return tsPrefixSumScalar(frame, num, base, zigzag);
+}
+#else
+static int64_t tsPrefixSum(uint64_t *frame, int num, int64_t base, bool zigzag) {
+  return tsPrefixSumScalar(frame, num, base, zigzag);
+}
+#endif
+
+/*
+ * Layout: flag(1 byte, 0: packed, 1: not compressed), first value(8 bytes), first delta(8 bytes, timestamp only),
+ * followed by frames of BITPACK_FRAME_SIZE residuals: bit width(1 byte) + bit-packed zigzag residuals.
+ * The residual is the delta for integers, and delta-of-delta for timestamps.
+ */
+static int tsCompressBitpackImp(const char *const input, const int nelements, char *const output, const char type) {
+  uint64_t frame[BITPACK_FRAME_SIZE];
+  int      bytes = tDataTypeDesc[(int)type].nSize;
+  int      rawSize = nelements * bytes;
+  bool     dod = (type == TSDB_DATA_TYPE_TIMESTAMP);
+  int      start = (dod && nelements > 1) ? 2 : 1;
+  int      opos = 1 + start * LONG_BYTES;
+
+  if (nelements <= 0 || opos > rawSize) goto _copy_exit;
+
+  output[0] = 0;
+  int64_t prev = tsBitpackReadValue(input, 0, type);
+  memcpy(output + 1, &prev, LONG_BYTES);
+
+  uint64_t prevDelta = 0;
+  if (start == 2) {
+    int64_t curr = tsBitpackReadValue(input, 1, type);
+    prevDelta = (uint64_t)curr - (uint64_t)prev;
+    memcpy(output + 1 + LONG_BYTES, &prevDelta, LONG_BYTES);
+    prev = curr;
+  }
+
+  for (int i = start; i < nelements; i += BITPACK_FRAME_SIZE) {
+    int      num = MIN(BITPACK_FRAME_SIZE, nelements - i);
+    uint64_t bits = 0;
+
+    for (int j = 0; j < num; ++j) {
+      int64_t  curr = tsBitpackReadValue(input, i + j, type);
+      uint64_t delta = (uint64_t)curr - (uint64_t)prev;
+      uint64_t residual = delta;
+      if (dod) {
+        residual = delta - prevDelta;
+        prevDelta = delta;
+      }
+
+      frame[j] = ZIGZAG_ENCODE(residual);
+      bits |= frame[j];
+      prev = curr;
+    }
+
+    int width = (bits == 0) ? 0 : 64 - __builtin_clzll(bits);
+    int len = (num * width + 7) / 8;
+    if (opos + 1 + len > rawSize) goto _copy_exit;
+
+    output[opos++] = (char)width;
+    tsBitpackFrame(frame, num, width, output + opos);
+    opos += len;
+  }
+
+  return opos;
+
+_copy_exit:
+  output[0] = 1;
+  memcpy(output + 1, input, rawSize);
+  return rawSize + 1;
+}
+
+static int tsDecompressBitpackImp(const char *const input, const int nelements, char *const output, const char type) {
+  uint64_t frame[BITPACK_FRAME_SIZE];
+  int      bytes = tDataTypeDesc[(int)type].nSize;
+  bool     dod = (type == TSDB_DATA_TYPE_TIMESTAMP);
+  int      start = (dod && nelements > 1) ? 2 : 1;
+  int      ipos = 1 + start * LONG_BYTES;
+
+  if (nelements <= 0) return 0;
+
+  if (input[0] == 1) {
+    memcpy(output, input + 1, nelements * bytes);
+    return nelements * bytes;
+  }
+
+  int64_t head[2] = {0};
+  int64_t prevDelta = 0;
+  memcpy(&head[0], input + 1, LONG_BYTES);
+  if (start == 2) {
+    memcpy(&prevDelta, input + 1 + LONG_BYTES, LONG_BYTES);
+    head[1] = (int64_t)((uint64_t)head[0] + (uint64_t)prevDelta);
+  }
+  tsBitpackWriteValues(head, start, output, 0, type);
+
+  int64_t prev = head[start - 1];
+  for (int i = start; i < nelements; i += BITPACK_FRAME_SIZE) {
+    int num = MIN(BITPACK_FRAME_SIZE, nelements - i);
+    int width = (uint8_t)input[ipos++];
+
+    tsBitunpackFrame(input + ipos, num, width, frame);
+    ipos += (num * width + 7) / 8;
+
+    if (dod) {
+      prevDelta = tsPrefixSum(frame, num, prevDelta, true);
+      prev = tsPrefixSum(frame, num, prev, false);
+    } else {
+      prev = tsPrefixSum(frame, num, prev, true);
+    }
+
+    tsBitpackWriteValues((int64_t *)frame, num, output, i, type);
+  }
+
+  return nelements * bytes;
+}
+
+int tsCompressBitpack(const char *const input, int inputSize, const int nelements, char *const output, int outputSize,
+                      char algorithm, char *const buffer, int bufferSize, char type) {
+  if (algorithm == ONE_STAGE_COMP) {
+    return tsCompressBitpackImp(input, nelements, output, type);
+  } else if (algorithm == TWO_STAGE_COMP) {
+    int len = tsCompressBitpackImp(input, nelements, buffer, type);
+    return tsCompressStringImp(buffer, len, output, outputSize);
+  } else {
+    assert(0);
+  }
+}
+
+int tsDecompressBitpack(const char *const input, int compressedSize, const int nelements, char *const output,
+                        int outputSize, char algorithm, char *const buffer, int bufferSize, char type) {
+  if (algorithm == ONE_STAGE_COMP) {
+    return tsDecompressBitpackImp(input, nelements, output, type);
+  } else if (algorithm == TWO_STAGE_COMP) {
+    tsDecompressStringImp(input, compressedSize, buffer, bufferSize);
+    return tsDecompressBitpackImp(buffer, nelements, output, type);
+  } else {
+    assert(0);
+  }
+}
+
+#define BITPACK_FUNCS(_name, _type)                                                                                    \
+  static int tsCompressBitpack##_name(const char *const input, int inputSize, const int nelements, char *const output, \
+                                      int outputSize, char algorithm, char *const buffer, int bufferSize) {          \
+    return tsCompressBitpack(input, inputSize, nelements, output, outputSize, algorithm, buffer, bufferSize, _type);  \
+  }                                                                                                                    \
+  static int tsDecompressBitpack##_name(const char *const input, int compressedSize, const int nelements,             \
+                                        char *const output, int outputSize, char algorithm, char *const buffer,       \
+                                        int bufferSize) {                                                              \
+    return tsDecompressBitpack(input, compressedSize, nelements, output, outputSize, algorithm, buffer, bufferSize,   \
+                               _type);                                                                                 \
+  }
+
+BITPACK_FUNCS(Tinyint, TSDB_DATA_TYPE_TINYINT)
+BITPACK_FUNCS(Smallint, TSDB_DATA_TYPE_SMALLINT)
+BITPACK_FUNCS(Int, TSDB_DATA_TYPE_INT)
+BITPACK_FUNCS(Bigint, TSDB_DATA_TYPE_BIGINT)
+BITPACK_FUNCS(Timestamp, TSDB_DATA_TYPE_TIMESTAMP)
+
+/* ----------------------------------------------Gorilla codec---------------------------------------------- */
+typedef struct {
+  char *   data;
+  int      pos;
+  int      capacity;
+  uint64_t acc;
+  int      nbits;
+} SBitWriter;
+
+typedef struct {
+  const char *data;
+  int         pos;
+  int         size;
+  uint64_t    acc;
+  int         nbits;
+} SBitReader;
+
+/* append the lowest num bits of value, little endian. Return -1 if there is no space left */
+static inline int tsBitWrite(SBitWriter *pWriter, uint64_t value, int num) {
+  pWriter->acc |= value << pWriter->nbits;
+  if (pWriter->nbits + num >= 64) {
+    if (pWriter->pos + LONG_BYTES > pWriter->capacity) return -1;
+    memcpy(pWriter->data + pWriter->pos, &pWriter->acc, LONG_BYTES);
+    pWriter->pos += LONG_BYTES;
+
+    int used = 64 - pWriter->nbits;
+    pWriter->acc = (used == 64) ? 0 : (value >> used);
+    pWriter->nbits = pWriter->nbits + num - 64;
+  } else {
+    pWriter->nbits += num;
+  }
+
+  return 0;
+}
+
+static int tsBitFlush(SBitWriter *pWriter) {
+  int bytes = (pWriter->nbits + 7) / 8;
+  if (pWriter->pos + bytes > pWriter->capacity) return -1;
+
+  memcpy(pWriter->data + pWriter->pos, &pWriter->acc, bytes);
+  pWriter->pos += bytes;
+  return pWriter->pos;
+}
+
+static inline uint64_t tsBitRead(SBitReader *pReader, int num) {
+  uint64_t mask = (num == 64) ? (uint64_t)-1 : (((uint64_t)1 << num) - 1);
+  uint64_t value;
+
+  if (pReader->nbits >= num) {
+    value = pReader->acc & mask;
+    pReader->acc = (num == 64) ? 0 : (pReader->acc >> num);
+    pReader->nbits -= num;
+  } else {
+    uint64_t word = 0;
+    int      bytes = MIN(LONG_BYTES, pReader->size - pReader->pos);
+    if (bytes > 0) {
+      memcpy(&word, pReader->data + pReader->pos, bytes);
+      pReader->pos += bytes;
+    } else {
+      bytes = 0;
+    }
+
+    int used = num - pReader->nbits;
+    value = (pReader->acc | (word << pReader->nbits)) & mask;
+    pReader->acc = (used == 64) ? 0 : (word >> used);
+    pReader->nbits = MAX(0, bytes * BITS_PER_BYTE - used);
+  }
+
+  return value;
+}
+
+static inline uint64_t tsGorillaReadValue(const char *const input, int i, int width) {
+  if (width == 64) return ((uint64_t *)input)[i];
+  return ((uint32_t *)input)[i];
+}
+
+/*
+ * Layout: flag(1 byte, 0: encoded, 1: not compressed), followed by a bit stream: the first value, then the XOR with
+ * the previous value for each of the others:
+ *   '0'                                 : same as the previous value
+ *   '1' '0' + meaningful bits           : meaningful bits are in the window of the previous one
+ *   '1' '1' + leading zeros(5 bits) + length - 1(5 bits for float, 6 bits for double) + meaningful bits
+ */
+static int tsCompressGorillaImp(const char *const input, const int nelements, char *const output, const int width) {
+  int        rawSize = nelements * width / BITS_PER_BYTE;
+  int        lenBits = (width == 64) ? 6 : 5;
+  int        prevLeading = -1, prevTrailing = 0;
+  SBitWriter writer = {.data = output + 1, .pos = 0, .capacity = rawSize - 1, .acc = 0, .nbits = 0};
+
+  if (nelements <= 0) goto _copy_exit;
+
+  output[0] = 0;
+  uint64_t prev = tsGorillaReadValue(input, 0, width);
+  if (tsBitWrite(&writer, prev, width) < 0) goto _copy_exit;
+
+  for (int i = 1; i < nelements; ++i) {
+    uint64_t curr = tsGorillaReadValue(input, i, width);
+    uint64_t xor = curr ^ prev;
+    int      code = 0;
+    prev = curr;
+
+    if (xor == 0) {
+      code = tsBitWrite(&writer, 0, 1);
+    } else {
+      int leading = MIN(31, __builtin_clzll(xor) - (64 - width));
+      int trailing = __builtin_ctzll(xor);
+
+      if (prevLeading >= 0 && leading >= prevLeading && trailing >= prevTrailing) {
+        code = tsBitWrite(&writer, 1, 2);  // '1' '0'
+        code |= tsBitWrite(&writer, xor >> prevTrailing, width - prevLeading - prevTrailing);
+      } else {
+        int len = width - leading - trailing;
+        code = tsBitWrite(&writer, 3, 2);  // '1' '1'
+        code |= tsBitWrite(&writer, leading, 5);
+        code |= tsBitWrite(&writer, len - 1, lenBits);
+        code |= tsBitWrite(&writer, xor >> trailing, len);
+        prevLeading = leading;
+        prevTrailing = trailing;
+      }
+    }
+
+    if (code < 0) goto _copy_exit;
+  }
+
+  if (tsBitFlush(&writer) < 0) goto _copy_exit;
+  return writer.pos + 1;
+
+_copy_exit:
+  output[0] = 1;
+  memcpy(output + 1, input, rawSize);
+  return rawSize + 1;
+}
+
+static int tsDecompressGorillaImp(const char *const input, int compressedSize, const int nelements,
+                                  char *const output, const int width) {
+  int        bytes = width / BITS_PER_BYTE;
+  int        lenBits = (width == 64) ? 6 : 5;
+  int        leading = 0, trailing = 0;
+  SBitReader reader = {.data = input + 1, .pos = 0, .size = compressedSize - 1, .acc = 0, .nbits = 0};
+
+  if (nelements <= 0) return 0;
+
+  if (input[0] == 1) {
+    memcpy(output, input + 1, nelements * bytes);
+    return nelements * bytes;
+  }
+
+  uint64_t prev = tsBitRead(&reader, width);
+  for (int i = 0; i < nelements; ++i) {
+    if (i > 0 && tsBitRead(&reader, 1)) {
+      if (tsBitRead(&reader, 1)) {
+        leading = (int)tsBitRead(&reader, 5);
+        int len = (int)tsBitRead(&reader, lenBits) + 1;
+        trailing = width - leading - len;
+      }
+
+      prev ^= tsBitRead(&reader, width - leading - trailing) << trailing;
+    }
+
+    if (width == 64) {
+      ((uint64_t *)output)[i] = prev;
+    } else {
+      ((uint32_t *)output)[i] = (uint32_t)prev;
+    }
+  }
+
+  return nelements * bytes;
+}
+
+int tsCompressGorilla(const char *const input, int inputSize, const int nelements, char *const output, int outputSize,
+                      char algorithm, char *const buffer, int bufferSize, char type) {
+  int width = (type == TSDB_DATA_TYPE_DOUBLE) ? 64 : 32;
+
+  if (algorithm == ONE_STAGE_COMP) {
+    return tsCompressGorillaImp(input, nelements, output, width);
+  } else if (algorithm == TWO_STAGE_COMP) {
+    int len = tsCompressGorillaImp(input, nelements, buffer, width);
+    return tsCompressStringImp(buffer, len, output, outputSize);
+  } else {
+    assert(0);
+  }
+}
+
+int tsDecompressGorilla(const char *const input, int compressedSize, const int nelements, char *const output,
+                        int outputSize, char algorithm, char *const buffer, int bufferSize, char type) {
+  int width = (type == TSDB_DATA_TYPE_DOUBLE) ? 64 : 32;
+
+  if (algorithm == ONE_STAGE_COMP) {
+    return tsDecompressGorillaImp(input, compressedSize, nelements, output, width);
+  } else if (algorithm == TWO_STAGE_COMP) {
+    int len = tsDecompressStringImp(input, compressedSize, buffer, bufferSize);
+    return tsDecompressGorillaImp(buffer, len, nelements, output, width);
+  } else {
+    assert(0);
+  }
+}
+
+#define GORILLA_FUNCS(_name, _type)                                                                                    \
+  static int tsCompressGorilla##_name(const char *const input, int inputSize, const int nelements, char *const output, \
+                                      int outputSize, char algorithm, char *const buffer, int bufferSize) {          \
+    return tsCompressGorilla(input, inputSize, nelements, output, outputSize, algorithm, buffer, bufferSize, _type);  \
+  }                                                                                                                    \
+  static int tsDecompressGorilla##_name(const char *const input, int compressedSize, const int nelements,             \
+                                        char *const output, int outputSize, char algorithm, char *const buffer,       \
+                                        int bufferSize) {                                                              \
+    return tsDecompressGorilla(input, compressedSize, nelements, output, outputSize, algorithm, buffer, bufferSize,   \
+                               _type);                                                                                 \
+  }
+
+GORILLA_FUNCS(Float, TSDB_DATA_TYPE_FLOAT)
+GORILLA_FUNCS(Double, TSDB_DATA_TYPE_DOUBLE)
+
+SCompCodec tsCompCodecs[TSDB_CODEC_MAX] = {
+    {"default",
+     {NULL, tsCompressBool, tsCompressTinyint, tsCompressSmallint, tsCompressInt, tsCompressBigint, tsCompressFloat,
+      tsCompressDouble, tsCompressString, tsCompressTimestamp, tsCompressString},
+     {NULL, tsDecompressBool, tsDecompressTinyint, tsDecompressSmallint, tsDecompressInt, tsDecompressBigint,
+      tsDecompressFloat, tsDecompressDouble, tsDecompressString, tsDecompressTimestamp, tsDecompressString}},
+    {"bitpack",
+     {NULL, NULL, tsCompressBitpackTinyint, tsCompressBitpackSmallint, tsCompressBitpackInt, tsCompressBitpackBigint,
+      NULL, NULL, NULL, tsCompressBitpackTimestamp, NULL},
+     {NULL, NULL, tsDecompressBitpackTinyint, tsDecompressBitpackSmallint, tsDecompressBitpackInt,
+      tsDecompressBitpackBigint, NULL, NULL, NULL, tsDecompressBitpackTimestamp, NULL}},
+    {"gorilla",
+     {NULL, NULL, NULL, NULL, NULL, NULL, tsCompressGorillaFloat, tsCompressGorillaDouble, NULL, NULL, NULL},
+     {NULL, NULL, NULL, NULL, NULL, NULL, tsDecompressGorillaFloat, tsDecompressGorillaDouble, NULL, NULL, NULL}},
+};
+
+__decompress_fn_t tsGetColumnDecompFunc(int codec, int type) {
+  if (codec < 0 || codec >= TSDB_CODEC_MAX || type < TSDB_DATA_TYPE_BOOL || type > TSDB_DATA_TYPE_NCHAR) {
+    return NULL;
+  }
+
+  return tsCompCodecs[codec].decompFunc[type];
+}
+
+int tsSelectColumnCodec(const char *const input, const int nelements, int type) {
+  char buffer[TSDB_CODEC_SAMPLE_SIZE * LONG_BYTES * 2];
+  int  codec = TSDB_CODEC_DEFAULT;
+  int  minLen = INT32_MAX;
+
+  // binary, nchar and bool columns have only the default codec
+  if (type == TSDB_DATA_TYPE_BOOL || type == TSDB_DATA_TYPE_BINARY || type == TSDB_DATA_TYPE_NCHAR) return codec;
+
+  int num = MIN(nelements, TSDB_CODEC_SAMPLE_SIZE);
+  for (int i = 0; i < TSDB_CODEC_MAX; ++i) {
+    if (tsCompCodecs[i].compFunc[type] == NULL) continue;
+
+    int len = (*tsCompCodecs[i].compFunc[type])(input, num * tDataTypeDesc[type].nSize, num, buffer, sizeof(buffer),
+                                                ONE_STAGE_COMP, NULL, 0);
+    if (len < minLen) {
+      minLen = len;
+      codec = i;
+    }
+  }
+
+  return codec;
+}
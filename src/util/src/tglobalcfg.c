@@ -74,6 +74,14 @@ int tsMetricMetaKeepTimer = 600;  // second
 
 float tsNumOfThreadsPerCore = 1.0;
 float tsRatioOfQueryThreads = 0.5;
+int   tsNumOfCommitThreads = 1;  // 1: meters are compressed by the commit thread itself
+int   tsQueryReadAheadBlocks = 8; // 0: no read-ahead of data blocks during query
+int   tsQueryBlockCacheSize = 0;  // MB, decompressed file blocks shared by queries, 0: disabled
+int   tsMaxPendingSubmits = 64;   // per vnode, inserts blocked by full cache wait in server, 0: sent back to client
+int   tsRetrieveWindow = 4;       // pages of results a vnode computes ahead of the retrieve of client, 1: disabled
+int   tsNumOfWriteLanes = 0;      // inserts are hashed by sid onto write lanes, 0: decided by the number of cores
+int   tsTagIndexMinTables = 10000; // super tables with fewer tables do not build secondary tag indexes, 0: disabled
+int   tsMetricMetaDeltaLogSize = 16384; // changes of sub-tables kept per super table for metric meta delta, 0: disabled
 char  tsPublicIp[TSDB_IPv4ADDR_LEN] = {0};
 char  tsInternalIp[TSDB_IPv4ADDR_LEN] = {0};
 char  tsPrivateIp[TSDB_IPv4ADDR_LEN] = {0};
@@ -92,7 +100,10 @@ float tsFileBlockMinPercent = 0.05;
 short tsNumOfBlocksPerMeter = 100;
 short tsCommitTime = 3600;  // seconds
 short tsCommitLog = 1;
+int   tsCommitLogSyncWindow = 2;  // milliseconds, only for clog 2
+int   tsCommitLogSyncBytes = 1048576;
 short tsCompression = TSDB_MAX_COMPRESSION_LEVEL;
+short tsColumnCodec = 0;  // 0: legacy codecs only, 1: select the codec of each column block by trial compression
 short tsDaysPerFile = 10;
 int   tsDaysToKeep = 3650;
 int   tsReplications = TSDB_REPLICA_MIN_NUM;
@@ -503,6 +514,30 @@ static void doInitGlobalConfig() {
   tsInitConfigOption(cfg++, "ratioOfQueryThreads", &tsRatioOfQueryThreads, TSDB_CFG_VTYPE_FLOAT,
                      TSDB_CFG_CTYPE_B_CONFIG,
                      0.1, 0.9, 0, TSDB_CFG_UTYPE_NONE);
+  tsInitConfigOption(cfg++, "numOfCommitThreads", &tsNumOfCommitThreads, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
+                     1, 256, 0, TSDB_CFG_UTYPE_NONE);
+  tsInitConfigOption(cfg++, "queryReadAheadBlocks", &tsQueryReadAheadBlocks, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
+                     0, 256, 0, TSDB_CFG_UTYPE_NONE);
+  tsInitConfigOption(cfg++, "queryBlockCacheSize", &tsQueryBlockCacheSize, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
+                     0, 65536, 0, TSDB_CFG_UTYPE_MB);
+  tsInitConfigOption(cfg++, "maxPendingSubmits", &tsMaxPendingSubmits, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
+                     0, 4096, 0, TSDB_CFG_UTYPE_NONE);
+  tsInitConfigOption(cfg++, "retrieveWindow", &tsRetrieveWindow, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_CLIENT | TSDB_CFG_CTYPE_B_SHOW,
+                     1, 16, 0, TSDB_CFG_UTYPE_NONE);
+  tsInitConfigOption(cfg++, "numOfWriteLanes", &tsNumOfWriteLanes, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
+                     0, 64, 0, TSDB_CFG_UTYPE_NONE);
+  tsInitConfigOption(cfg++, "tagIndexMinTables", &tsTagIndexMinTables, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
+                     0, 100000000, 0, TSDB_CFG_UTYPE_NONE);
+  tsInitConfigOption(cfg++, "metricMetaDeltaLogSize", &tsMetricMetaDeltaLogSize, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
+                     0, 10000000, 0, TSDB_CFG_UTYPE_NONE);
   tsInitConfigOption(cfg++, "numOfVnodesPerCore", &tsNumOfVnodesPerCore, TSDB_CFG_VTYPE_SHORT,
                      TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
                      1, 64, 0, TSDB_CFG_UTYPE_NONE);
@@ -619,10 +654,19 @@ static void doInitGlobalConfig() {
 
   tsInitConfigOption(cfg++, "clog", &tsCommitLog, TSDB_CFG_VTYPE_SHORT,
                      TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
-                     0, 1, 0, TSDB_CFG_UTYPE_NONE);
+                     TSDB_MIN_COMMIT_LOG_LEVEL, TSDB_MAX_COMMIT_LOG_LEVEL, 0, TSDB_CFG_UTYPE_NONE);
+  tsInitConfigOption(cfg++, "clogSyncWindow", &tsCommitLogSyncWindow, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
+                     0, 1000, 0, TSDB_CFG_UTYPE_MS);
+  tsInitConfigOption(cfg++, "clogSyncBytes", &tsCommitLogSyncBytes, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
+                     4096, 67108864, 0, TSDB_CFG_UTYPE_BYTE);
   tsInitConfigOption(cfg++, "comp", &tsCompression, TSDB_CFG_VTYPE_SHORT,
                      TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
                      0, 2, 0, TSDB_CFG_UTYPE_NONE);
+  tsInitConfigOption(cfg++, "columnCodec", &tsColumnCodec, TSDB_CFG_VTYPE_SHORT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
+                     0, 1, 0, TSDB_CFG_UTYPE_NONE);
 
   // database configs
   tsInitConfigOption(cfg++, "days", &tsDaysPerFile, TSDB_CFG_VTYPE_SHORT,
@@ -17,22 +17,106 @@
 #include "tlog.h"
 #include "tsched.h"
 
+/*
+ * Every worker thread owns a ring of tasks. Tasks are distributed to the rings round-robin, and a worker takes
+ * tasks from its own ring first, then steals from the rings of other workers when its own ring is empty, so that
+ * producers and consumers only contend on the short ring lock of one worker instead of one lock of the whole
+ * queue. Urgent tasks are put into a separate ring, which is checked by every worker before its own ring.
+ */
+typedef struct {
+  pthread_mutex_t mutex;
+  int32_t         head;      // slot of the next task to be taken
+  int32_t         tail;      // slot of the next task to be put
+  int32_t         size;      // number of tasks in ring, read without lock to skip empty rings
+  int32_t         capacity;
+  SSchedMsg *     msgs;
+} SSchedRing;
+
+struct _sched_queue;
+
 typedef struct {
-  char            label[16];
-  tsem_t          emptySem;
-  tsem_t          fullSem;
-  pthread_mutex_t queueMutex;
-  int             fullSlot;
-  int             emptySlot;
-  int             queueSize;
-  int             numOfThreads;
-  pthread_t *     qthread;
-  SSchedMsg *     queue;
+  struct _sched_queue *pSched;
+  int32_t              index;  // index of the ring owned by this worker
+} SSchedWorker;
+
+typedef struct _sched_queue {
+  char          label[16];
+  tsem_t        emptySem;
+  tsem_t        fullSem;
+  int           queueSize;
+  int           numOfThreads;
+  int32_t       numOfRings;
+  int32_t       nextRing;  // ring of the next normal task, increased atomically
+  pthread_t *   qthread;
+  SSchedWorker *workers;
+  SSchedRing *  rings;
+  SSchedRing    urgentRing;
 } SSchedQueue;
 
 void *taosProcessSchedQueue(void *param);
 void taosCleanUpScheduler(void *param);
 
+static int taosInitSchedRing(SSchedRing *pRing, int32_t capacity) {
+  memset(pRing, 0, sizeof(SSchedRing));
+
+  pRing->msgs = (SSchedMsg *)calloc((size_t)capacity, sizeof(SSchedMsg));
+  if (pRing->msgs == NULL) return -1;
+
+  if (pthread_mutex_init(&pRing->mutex, NULL) != 0) {
+    free(pRing->msgs);
+    pRing->msgs = NULL;
+    return -1;
+  }
+
+  pRing->capacity = capacity;
+  return 0;
+}
+
+static void taosDestroySchedRing(SSchedRing *pRing) {
+  if (pRing->msgs == NULL) return;
+
+  pthread_mutex_destroy(&pRing->mutex);
+  free(pRing->msgs);
+  pRing->msgs = NULL;
+}
+
+static bool taosPushToSchedRing(SSchedRing *pRing, SSchedMsg *pMsg) {
+  if (atomic_load_32(&pRing->size) >= pRing->capacity) return false;
+
+  pthread_mutex_lock(&pRing->mutex);
+
+  if (pRing->size >= pRing->capacity) {
+    pthread_mutex_unlock(&pRing->mutex);
+    return false;
+  }
+
+  pRing->msgs[pRing->tail] = *pMsg;
+  pRing->tail = (pRing->tail + 1) % pRing->capacity;
+  atomic_add_fetch_32(&pRing->size, 1);
+
+  pthread_mutex_unlock(&pRing->mutex);
+  return true;
+}
+
+static bool taosPopFromSchedRing(SSchedRing *pRing, SSchedMsg *pMsg) {
+  if (atomic_load_32(&pRing->size) <= 0) return false;
+
+  pthread_mutex_lock(&pRing->mutex);
+
+  if (pRing->size <= 0) {
+    pthread_mutex_unlock(&pRing->mutex);
+    return false;
+  }
+
+  *pMsg = pRing->msgs[pRing->head];
+  memset(pRing->msgs + pRing->head, 0, sizeof(SSchedMsg));
+  pRing->head = (pRing->head + 1) % pRing->capacity;
+  atomic_sub_fetch_32(&pRing->size, 1);
+
+  pthread_mutex_unlock(&pRing->mutex);
+  return true;
+}
+
 void *taosInitScheduler(int queueSize, int numOfThreads, const char *label) {
   pthread_attr_t attr;
   SSchedQueue *  pSched = (SSchedQueue *)malloc(sizeof(SSchedQueue));
@@ -46,11 +130,6 @@ void *taosInitScheduler(int queueSize, int numOfThreads, const char *label) {
   strncpy(pSched->label, label, sizeof(pSched->label)); // fix buffer overflow
   pSched->label[sizeof(pSched->label)-1] = '\0';
 
-  if (pthread_mutex_init(&pSched->queueMutex, NULL) < 0) {
-    pError("init %s:queueMutex failed, reason:%s", pSched->label, strerror(errno));
-    goto _error;
-  }
-
   if (tsem_init(&pSched->emptySem, 0, (unsigned int)pSched->queueSize) != 0) {
     pError("init %s:empty semaphore failed, reason:%s", pSched->label, strerror(errno));
     goto _error;
@@ -61,17 +140,33 @@ void *taosInitScheduler(int queueSize, int numOfThreads, const char *label) {
     goto _error;
   }
 
-  if ((pSched->queue = (SSchedMsg *)malloc((size_t)pSched->queueSize * sizeof(SSchedMsg))) == NULL) {
+  /*
+   * the total capacity of rings is not less than queueSize, so a normal task always finds a slot in one of the
+   * rings after emptySem is acquired
+   */
+  int32_t ringCapacity = pSched->queueSize / numOfThreads + 1;
+
+  if ((pSched->rings = (SSchedRing *)calloc((size_t)numOfThreads, sizeof(SSchedRing))) == NULL) {
     pError("%s: no enough memory for queue, reason:%s", pSched->label, strerror(errno));
     goto _error;
   }
 
-  memset(pSched->queue, 0, (size_t)pSched->queueSize * sizeof(SSchedMsg));
-  pSched->fullSlot = 0;
-  pSched->emptySlot = 0;
+  pSched->numOfRings = numOfThreads;
+  for (int i = 0; i < pSched->numOfRings; ++i) {
+    if (taosInitSchedRing(pSched->rings + i, ringCapacity) != 0) {
+      pError("%s: no enough memory for queue, reason:%s", pSched->label, strerror(errno));
+      goto _error;
+    }
+  }
+
+  if (taosInitSchedRing(&pSched->urgentRing, ringCapacity) != 0) {
+    pError("%s: no enough memory for queue, reason:%s", pSched->label, strerror(errno));
+    goto _error;
+  }
 
   pSched->qthread = malloc(sizeof(pthread_t) * (size_t)numOfThreads);
-  if (pSched->qthread == NULL) {
+  pSched->workers = malloc(sizeof(SSchedWorker) * (size_t)numOfThreads);
+  if (pSched->qthread == NULL || pSched->workers == NULL) {
     pError("%s: no enough memory for qthread, reason: %s", pSched->label, strerror(errno));
     goto _error;
   }
@@ -80,7 +175,10 @@ void *taosInitScheduler(int queueSize, int numOfThreads, const char *label) {
   pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
 
   for (int i = 0; i < numOfThreads; ++i) {
-    if (pthread_create(pSched->qthread + i, &attr, taosProcessSchedQueue, (void *)pSched) != 0) {
+    pSched->workers[i].pSched = pSched;
+    pSched->workers[i].index = i;
+
+    if (pthread_create(pSched->qthread + i, &attr, taosProcessSchedQueue, (void *)(pSched->workers + i)) != 0) {
       pError("%s: failed to create rpc thread, reason:%s", pSched->label, strerror(errno));
       goto _error;
     }
@@ -96,9 +194,24 @@ _error:
   return NULL;
 }
 
+/*
+ * a successful wait on fullSem reserves one task in the rings, so the task is always found after the urgent ring,
+ * the own ring and the rings of other workers are checked in turn
+ */
+static void taosTakeSchedTask(SSchedQueue *pSched, int32_t index, SSchedMsg *pMsg) {
+  while (1) {
+    if (taosPopFromSchedRing(&pSched->urgentRing, pMsg)) return;
+
+    for (int32_t i = 0; i < pSched->numOfRings; ++i) {
+      if (taosPopFromSchedRing(pSched->rings + (index + i) % pSched->numOfRings, pMsg)) return;
+    }
+  }
+}
+
 void *taosProcessSchedQueue(void *param) {
-  SSchedMsg    msg;
-  SSchedQueue *pSched = (SSchedQueue *)param;
+  SSchedMsg     msg;
+  SSchedWorker *pWorker = (SSchedWorker *)param;
+  SSchedQueue * pSched = pWorker->pSched;
 
   while (1) {
     if (tsem_wait(&pSched->fullSem) != 0) {
@@ -110,15 +223,7 @@ void *taosProcessSchedQueue(void *param) {
       pError("wait %s fullSem failed, errno:%d, reason:%s", pSched->label, errno, strerror(errno));
     }
 
-    if (pthread_mutex_lock(&pSched->queueMutex) != 0)
-      pError("lock %s queueMutex failed, reason:%s", pSched->label, strerror(errno));
-
-    msg = pSched->queue[pSched->fullSlot];
-    memset(pSched->queue + pSched->fullSlot, 0, sizeof(SSchedMsg));
-    pSched->fullSlot = (pSched->fullSlot + 1) % pSched->queueSize;
-
-    if (pthread_mutex_unlock(&pSched->queueMutex) != 0)
-      pError("unlock %s queueMutex failed, reason:%s\n", pSched->label, strerror(errno));
+    taosTakeSchedTask(pSched, pWorker->index, &msg);
 
     if (tsem_post(&pSched->emptySem) != 0)
       pError("post %s emptySem failed, reason:%s\n", pSched->label, strerror(errno));
@@ -130,7 +235,19 @@ void *taosProcessSchedQueue(void *param) {
   }
 }
 
-int taosScheduleTask(void *qhandle, SSchedMsg *pMsg) {
+static void taosPushSchedTask(SSchedQueue *pSched, SSchedMsg *pMsg, int priority) {
+  // urgent tasks fall back to the normal rings if the urgent ring is full
+  if (priority != TSCHED_PRIORITY_URGENT || !taosPushToSchedRing(&pSched->urgentRing, pMsg)) {
+    uint32_t start = (uint32_t)atomic_fetch_add_32(&pSched->nextRing, 1);
+    for (int32_t i = 0;; ++i) {
+      if (taosPushToSchedRing(pSched->rings + (start + i) % pSched->numOfRings, pMsg)) break;
+    }
+  }
+
+  if (tsem_post(&pSched->fullSem) != 0) pError("post %s fullSem failed, reason:%s", pSched->label, strerror(errno));
+}
+
+int taosScheduleTaskWithPriority(void *qhandle, SSchedMsg *pMsg, int priority) {
   SSchedQueue *pSched = (SSchedQueue *)qhandle;
   if (pSched == NULL) {
     pError("sched is not ready, msg:%p is dropped", pMsg);
@@ -145,20 +262,26 @@ int taosScheduleTask(void *qhandle, SSchedMsg *pMsg) {
     pTrace("wait %s emptySem was interrupted", pSched->label);
   }
 
-  if (pthread_mutex_lock(&pSched->queueMutex) != 0)
-    pError("lock %s queueMutex failed, reason:%s", pSched->label, strerror(errno));
-
-  pSched->queue[pSched->emptySlot] = *pMsg;
-  pSched->emptySlot = (pSched->emptySlot + 1) % pSched->queueSize;
+  taosPushSchedTask(pSched, pMsg, priority);
+  return 0;
+}
 
-  if (pthread_mutex_unlock(&pSched->queueMutex) != 0)
-    pError("unlock %s queueMutex failed, reason:%s", pSched->label, strerror(errno));
+int taosTryScheduleTask(void *qhandle, SSchedMsg *pMsg) {
+  SSchedQueue *pSched = (SSchedQueue *)qhandle;
+  if (pSched == NULL) return -1;
 
-  if (tsem_post(&pSched->fullSem) != 0) pError("post %s fullSem failed, reason:%s", pSched->label, strerror(errno));
+  while (tsem_trywait(&pSched->emptySem) != 0) {
+    if (errno != EINTR) return -1;
+  }
 
+  taosPushSchedTask(pSched, pMsg, TSCHED_PRIORITY_NORMAL);
   return 0;
 }
 
+int taosScheduleTask(void *qhandle, SSchedMsg *pMsg) {
+  return taosScheduleTaskWithPriority(qhandle, pMsg, TSCHED_PRIORITY_NORMAL);
+}
+
 void taosCleanUpScheduler(void *param) {
   SSchedQueue *pSched = (SSchedQueue *)param;
   if (pSched == NULL) return;
@@ -172,9 +295,16 @@ void taosCleanUpScheduler(void *param) {
 
   tsem_destroy(&pSched->emptySem);
   tsem_destroy(&pSched->fullSem);
-  pthread_mutex_destroy(&pSched->queueMutex);
 
-  free(pSched->queue);
+  if (pSched->rings != NULL) {
+    for (int i = 0; i < pSched->numOfRings; ++i) {
+      taosDestroySchedRing(pSched->rings + i);
+    }
+  }
+  taosDestroySchedRing(&pSched->urgentRing);
+
+  free(pSched->rings);
+  free(pSched->workers);
   free(pSched->qthread);
   free(pSched); // fix memory leak
 }
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Micro benchmark of the block kernels of sum/avg/min/max, for each numeric type, on blocks without and with null
+// values. The kernels are run through aAggs[], as the query engine does, and compared with a scalar loop checking
+// null value per row, which is the way the blocks were aggregated before. The results of both shall be the same.
+// usage: aggKernelBench [rows-per-block] [number-of-blocks]
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "tsdb.h"
+#include "tsqlfunction.h"
+#include "ttypes.h"
+
+#define NULL_RATIO 10  // one out of NULL_RATIO rows is null in the blocks with null value
+
+typedef struct {
+  int16_t     type;
+  int16_t     bytes;
+  const char *name;
+} SBenchType;
+
+static SBenchType types[] = {
+    {TSDB_DATA_TYPE_TINYINT, sizeof(int8_t), "tinyint"}, {TSDB_DATA_TYPE_SMALLINT, sizeof(int16_t), "smallint"},
+    {TSDB_DATA_TYPE_INT, sizeof(int32_t), "int"},         {TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), "bigint"},
+    {TSDB_DATA_TYPE_FLOAT, sizeof(float), "float"},       {TSDB_DATA_TYPE_DOUBLE, sizeof(double), "double"},
+};
+
+static int32_t funcs[] = {TSDB_FUNC_SUM, TSDB_FUNC_AVG, TSDB_FUNC_MIN, TSDB_FUNC_MAX};
+
+static int32_t numOfRows = 4096;
+static int32_t numOfBlocks = 20000;
+static int32_t numOfFailed = 0;
+
+static int64_t nowNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static double getValue(const char *p, int16_t type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:  return *(int8_t *)p;
+    case TSDB_DATA_TYPE_SMALLINT: return *(int16_t *)p;
+    case TSDB_DATA_TYPE_INT:      return *(int32_t *)p;
+    case TSDB_DATA_TYPE_BIGINT:   return (double)*(int64_t *)p;
+    case TSDB_DATA_TYPE_FLOAT:    return *(float *)p;
+    default:                      return *(double *)p;
+  }
+}
+
+static void fillBlock(char *pData, int16_t type, int16_t bytes, bool hasNull) {
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    char *p = pData + i * bytes;
+    if (hasNull && (i % NULL_RATIO) == 3) {
+      setNull(p, type, bytes);
+      continue;
+    }
+
+    int32_t v = (int32_t)((i * 7919L) % 113) - 56;  // small values, so the integer sums do not overflow
+    switch (type) {
+      case TSDB_DATA_TYPE_TINYINT:  *(int8_t *)p = (int8_t)v; break;
+      case TSDB_DATA_TYPE_SMALLINT: *(int16_t *)p = (int16_t)(v * 100); break;
+      case TSDB_DATA_TYPE_INT:      *(int32_t *)p = v * 10000; break;
+      case TSDB_DATA_TYPE_BIGINT:   *(int64_t *)p = v * 1000000000LL; break;
+      case TSDB_DATA_TYPE_FLOAT:    *(float *)p = v / 4.0f; break;
+      default:                      *(double *)p = v / 8.0; break;
+    }
+  }
+}
+
+/*
+ * the scalar loop over a block, which checks null value per row. The sum is accumulated in the same type as the
+ * kernels, int64 for integers and double for floating point numbers.
+ */
+static double scalarAggregate(const char *pData, int16_t type, int16_t bytes, int32_t functionId, bool hasNull) {
+  int64_t isum = 0;
+  double  dsum = 0, m = 0;
+  int64_t num = 0;
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    const char *p = pData + i * bytes;
+    if (hasNull && isNull(p, type)) continue;
+
+    double v = getValue(p, type);
+    if (functionId == TSDB_FUNC_SUM && type <= TSDB_DATA_TYPE_BIGINT) {
+      isum += (type == TSDB_DATA_TYPE_BIGINT) ? *(int64_t *)p : (int64_t)v;
+    } else if (functionId == TSDB_FUNC_SUM || functionId == TSDB_FUNC_AVG) {
+      dsum += v;
+    } else if (num == 0 || (functionId == TSDB_FUNC_MIN ? v < m : v > m)) {
+      m = v;
+    }
+    num++;
+  }
+
+  if (functionId == TSDB_FUNC_SUM) return (type <= TSDB_DATA_TYPE_BIGINT) ? (double)isum : dsum;
+  if (functionId == TSDB_FUNC_AVG) return dsum;
+  return m;
+}
+
+static void benchOne(SBenchType *pType, int32_t functionId, bool hasNull) {
+  char *   pData = malloc((size_t)numOfRows * pType->bytes);
+  int64_t *pTs = malloc(sizeof(int64_t) * numOfRows);
+  for (int32_t i = 0; i < numOfRows; ++i) pTs[i] = 1700000000000LL + i;
+  fillBlock(pData, pType->type, pType->bytes, hasNull);
+
+  int16_t resType = 0, resBytes = 0, interBytes = 0;
+  getResultDataInfo(pType->type, pType->bytes, functionId, 0, &resType, &resBytes, &interBytes, 0, false);
+
+  SResultInfo resInfo = {0};
+  resInfo.bufLen = interBytes;
+  resInfo.interResultBuf = calloc(1, (size_t)interBytes + sizeof(int64_t));
+
+  SQLFunctionCtx ctx = {0};
+  ctx.size = numOfRows;
+  ctx.order = TSQL_SO_ASC;
+  ctx.inputType = pType->type;
+  ctx.inputBytes = pType->bytes;
+  ctx.outputType = resType;
+  ctx.outputBytes = resBytes;
+  ctx.hasNull = hasNull;
+  ctx.functionId = functionId;
+  ctx.blockStatus = BLK_CACHE_BLOCK | BLK_BLOCK_LOADED;
+  ctx.aInputElemBuf = pData;
+  ctx.aOutputBuf = calloc(1, (size_t)resBytes + sizeof(int64_t));
+  ctx.ptsList = pTs;
+  ctx.resultInfo = &resInfo;
+
+  aAggs[functionId].init(&ctx);
+
+  int64_t st = nowNs();
+  for (int32_t b = 0; b < numOfBlocks; ++b) {
+    aAggs[functionId].xFunction(&ctx);
+  }
+  int64_t kernelNs = nowNs() - st;
+
+  volatile double sink = 0;
+  double          expect = 0;
+  st = nowNs();
+  for (int32_t b = 0; b < numOfBlocks; ++b) {
+    expect = scalarAggregate(pData, pType->type, pType->bytes, functionId, hasNull);
+    sink += expect;
+  }
+  int64_t scalarNs = nowNs() - st;
+
+  // the kernel result is accumulated over all blocks, while the scalar one is of one block
+  double actual = 0;
+  if (functionId == TSDB_FUNC_AVG) {
+    actual = *(double *)resInfo.interResultBuf / numOfBlocks;
+  } else if (functionId == TSDB_FUNC_SUM) {
+    actual = (pType->type <= TSDB_DATA_TYPE_BIGINT) ? (double)*(int64_t *)ctx.aOutputBuf / numOfBlocks
+                                                     : *(double *)ctx.aOutputBuf / numOfBlocks;
+  } else {
+    actual = getValue(ctx.aOutputBuf, pType->type);
+  }
+
+  bool ok = fabs(actual - expect) <= 1e-6 * fmax(1.0, fabs(expect));
+  if (!ok) numOfFailed++;
+
+  double rows = (double)numOfRows * numOfBlocks;
+  printf("%-4s %-8s %-6s null:%-3s kernel:%7.3f ns/row scalar:%7.3f ns/row speedup:%5.2fx\n", ok ? "PASS" : "FAIL",
+         pType->name, aAggs[functionId].aName, hasNull ? "yes" : "no", kernelNs / rows, scalarNs / rows,
+         (double)scalarNs / kernelNs);
+
+  free(ctx.aOutputBuf);
+  free(resInfo.interResultBuf);
+  free(pTs);
+  free(pData);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 1) numOfRows = atoi(argv[1]);
+  if (argc > 2) numOfBlocks = atoi(argv[2]);
+  if (numOfRows <= 0 || numOfBlocks <= 0) {
+    printf("usage: %s [rows-per-block] [number-of-blocks]\n", argv[0]);
+    return 1;
+  }
+
+  printf("%d rows per block, %d blocks\n", numOfRows, numOfBlocks);
+  for (int32_t t = 0; t < sizeof(types) / sizeof(types[0]); ++t) {
+    for (int32_t f = 0; f < sizeof(funcs) / sizeof(funcs[0]); ++f) {
+      benchOne(&types[t], funcs[f], false);
+      benchOne(&types[t], funcs[f], true);
+    }
+  }
+
+  printf("%s, %d failed\n", numOfFailed == 0 ? "all passed" : "failed", numOfFailed);
+  return numOfFailed == 0 ? 0 : 1;
+}
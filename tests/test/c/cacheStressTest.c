@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Stress test of the sharded data cache. Threads get, add, update and remove random keys concurrently, with a small
+// initial capacity so that the shards are resized incrementally during the run, and a short refresh time so that the
+// expired nodes and the trash are cleared by the timer meanwhile. Each value carries its key and a sequence number
+// twice, a value is checked when it is got and again before it is released, it must not be changed or freed while
+// it is referenced. The hit and miss counters of the shards must add up to the number of gets.
+// usage: cacheStressTest [number-of-threads] [operations-per-thread] [number-of-keys]
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "tcache.h"
+#include "ttimer.h"
+
+#define REFRESH_TIME 1  // seconds
+#define KEEP_TIME    1  // seconds
+#define MAX_SHARDS   64
+
+typedef struct {
+  int32_t key;
+  int32_t pad;
+  int64_t seq;
+  int64_t check;  // ~seq, a torn or freed value does not match
+} SCacheValue;
+
+typedef struct {
+  pthread_t thread;
+  int32_t   index;
+  unsigned  seed;
+  int64_t   numOfGets;
+  int64_t   numOfHits;
+  int64_t   numOfPuts;
+  int64_t   numOfRemoves;
+  int64_t   numOfErrors;
+} SStressThread;
+
+static void *   pCache = NULL;
+static int32_t  numOfThreads = 8;
+static int32_t  numOfOps = 1000000;
+static int32_t  numOfKeys = 100000;
+static int64_t  sequence = 0;
+
+static int64_t nowMs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+}
+
+static bool checkValue(SCacheValue *pValue, int32_t key) {
+  return pValue->key == key && pValue->check == ~pValue->seq;
+}
+
+static void *stressMain(void *param) {
+  SStressThread *pThread = (SStressThread *)param;
+  char           key[32];
+
+  for (int32_t i = 0; i < numOfOps; ++i) {
+    int32_t k = rand_r(&pThread->seed) % numOfKeys;
+    int32_t op = rand_r(&pThread->seed) % 100;
+    snprintf(key, sizeof(key), "key.%d", k);
+
+    if (op < 70) {  // get, then hold the reference for a while
+      pThread->numOfGets++;
+      SCacheValue *pValue = (SCacheValue *)taosGetDataFromCache(pCache, key);
+      if (pValue == NULL) continue;
+
+      pThread->numOfHits++;
+      SCacheValue copy = *pValue;
+      if (!checkValue(&copy, k)) pThread->numOfErrors++;
+
+      for (volatile int32_t j = 0; j < 64; ++j) {
+      }
+
+      if (memcmp(&copy, pValue, sizeof(SCacheValue)) != 0) pThread->numOfErrors++;
+      taosRemoveDataFromCache(pCache, (void **)&pValue, false);
+    } else if (op < 95) {  // add or update
+      SCacheValue value = {.key = k};
+      value.seq = __sync_add_and_fetch(&sequence, 1);
+      value.check = ~value.seq;
+
+      pThread->numOfPuts++;
+      SCacheValue *pValue = (op < 85) ? (SCacheValue *)taosAddDataIntoCache(pCache, key, (char *)&value,
+                                                                             sizeof(value), KEEP_TIME)
+                                      : (SCacheValue *)taosUpdateDataFromCache(pCache, key, (char *)&value,
+                                                                               sizeof(value), KEEP_TIME);
+      if (pValue == NULL || memcmp(pValue, &value, sizeof(value)) != 0) {
+        pThread->numOfErrors++;
+      }
+
+      if (pValue != NULL) taosRemoveDataFromCache(pCache, (void **)&pValue, false);
+    } else {  // remove
+      pThread->numOfGets++;
+      SCacheValue *pValue = (SCacheValue *)taosGetDataFromCache(pCache, key);
+      if (pValue == NULL) continue;
+
+      pThread->numOfHits++;
+      pThread->numOfRemoves++;
+      if (!checkValue(pValue, k)) pThread->numOfErrors++;
+      taosRemoveDataFromCache(pCache, (void **)&pValue, true);
+    }
+  }
+
+  return NULL;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 1) numOfThreads = atoi(argv[1]);
+  if (argc > 2) numOfOps = atoi(argv[2]);
+  if (argc > 3) numOfKeys = atoi(argv[3]);
+  if (numOfThreads <= 0 || numOfOps <= 0 || numOfKeys <= 0) {
+    printf("usage: %s [number-of-threads] [operations-per-thread] [number-of-keys]\n", argv[0]);
+    return 1;
+  }
+
+  void *pTimer = taosTmrInit(100, 100, 10000, "CST");
+  pCache = taosInitDataCache(256, pTimer, REFRESH_TIME);
+  if (pTimer == NULL || pCache == NULL) {
+    printf("failed to init the cache\n");
+    return 1;
+  }
+
+  SStressThread *pThreads = (SStressThread *)calloc(numOfThreads, sizeof(SStressThread));
+  int64_t        st = nowMs();
+  for (int32_t i = 0; i < numOfThreads; ++i) {
+    pThreads[i].index = i;
+    pThreads[i].seed = (unsigned)(i * 7919 + 1);
+    if (pthread_create(&pThreads[i].thread, NULL, stressMain, &pThreads[i]) != 0) {
+      printf("failed to create thread %d\n", i);
+      return 1;
+    }
+  }
+
+  SStressThread total = {0};
+  for (int32_t i = 0; i < numOfThreads; ++i) {
+    pthread_join(pThreads[i].thread, NULL);
+    total.numOfGets += pThreads[i].numOfGets;
+    total.numOfHits += pThreads[i].numOfHits;
+    total.numOfPuts += pThreads[i].numOfPuts;
+    total.numOfRemoves += pThreads[i].numOfRemoves;
+    total.numOfErrors += pThreads[i].numOfErrors;
+  }
+  int64_t ms = nowMs() - st;
+
+  int32_t numOfFailed = 0;
+
+  bool ok = (total.numOfErrors == 0);
+  if (!ok) numOfFailed++;
+  printf("%s %d threads, %lld ops in %lld ms, %.0f ops/s, gets:%lld hits:%lld puts:%lld removes:%lld errors:%lld\n",
+         ok ? "PASS" : "FAIL", numOfThreads, (long long)numOfThreads * numOfOps, (long long)ms,
+         (double)numOfThreads * numOfOps * 1000 / (ms > 0 ? ms : 1), (long long)total.numOfGets,
+         (long long)total.numOfHits, (long long)total.numOfPuts, (long long)total.numOfRemoves,
+         (long long)total.numOfErrors);
+
+  int64_t hitCount[MAX_SHARDS] = {0}, missCount[MAX_SHARDS] = {0};
+  int64_t hits = 0, misses = 0;
+  int32_t numOfShards = taosGetDataCacheStatis(pCache, hitCount, missCount, MAX_SHARDS);
+  for (int32_t i = 0; i < numOfShards; ++i) {
+    hits += hitCount[i];
+    misses += missCount[i];
+  }
+
+  ok = (hits == total.numOfHits && hits + misses == total.numOfGets);
+  if (!ok) numOfFailed++;
+  printf("%s %d shards, hits:%lld/%lld misses:%lld/%lld\n", ok ? "PASS" : "FAIL", numOfShards, (long long)hits,
+         (long long)total.numOfHits, (long long)misses, (long long)(total.numOfGets - total.numOfHits));
+
+  // whatever is left in the cache must be the value of its own key
+  int32_t numOfBad = 0, numOfLeft = 0;
+  char    key[32];
+  for (int32_t k = 0; k < numOfKeys; ++k) {
+    snprintf(key, sizeof(key), "key.%d", k);
+    SCacheValue *pValue = (SCacheValue *)taosGetDataFromCache(pCache, key);
+    if (pValue == NULL) continue;
+
+    numOfLeft++;
+    if (!checkValue(pValue, k)) numOfBad++;
+    taosRemoveDataFromCache(pCache, (void **)&pValue, false);
+  }
+
+  ok = (numOfBad == 0);
+  if (!ok) numOfFailed++;
+  printf("%s %d keys left in cache, bad:%d\n", ok ? "PASS" : "FAIL", numOfLeft, numOfBad);
+
+  taosCleanUpDataCache(pCache);
+  free(pThreads);
+
+  printf("%s, %d failed\n", numOfFailed == 0 ? "all passed" : "failed", numOfFailed);
+  return numOfFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Regression test of the value filter on a float column, whose file blocks straddle the filter bounds. The blocks
+// must be loaded and filtered row by row, instead of being answered by the min/max of the block.
+// usage: floatFilterTest [server-ip] [config-dir]
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <taos.h>
+
+#define NUM_OF_ROWS   2000
+#define COMMIT_TIME   30
+#define START_TS      1700000000000LL
+
+static TAOS *taos;
+static int   numOfFailed = 0;
+
+static void execute(const char *sql) {
+  if (taos_query(taos, sql) != 0) {
+    printf("failed to execute:%s, reason:%s\n", sql, taos_errstr(taos));
+    exit(1);
+  }
+
+  TAOS_RES *result = taos_use_result(taos);
+  if (result != NULL) taos_free_result(result);
+}
+
+static float rowValue(int i) { return 5.0f + (float)(i % 16); }  // 5 ... 20 in every block
+
+static void checkQuery(const char *cond, int (*qualified)(float), const char *phase) {
+  char sql[256];
+  snprintf(sql, sizeof(sql), "select count(*), sum(v), min(v), max(v) from t where %s", cond);
+
+  int64_t count = 0;
+  double  sum = 0, min = INFINITY, max = -INFINITY;
+  for (int i = 0; i < NUM_OF_ROWS; ++i) {
+    float v = rowValue(i);
+    if (!qualified(v)) continue;
+
+    count++;
+    sum += v;
+    if (v < min) min = v;
+    if (v > max) max = v;
+  }
+
+  if (taos_query(taos, sql) != 0) {
+    printf("%s: failed to query:%s, reason:%s\n", phase, sql, taos_errstr(taos));
+    numOfFailed++;
+    return;
+  }
+
+  TAOS_RES *result = taos_use_result(taos);
+  TAOS_ROW  row = taos_fetch_row(result);
+
+  int64_t rcount = (row != NULL && row[0] != NULL) ? *(int64_t *)row[0] : 0;
+  double  rsum = (row != NULL && row[1] != NULL) ? *(double *)row[1] : 0;
+  double  rmin = (row != NULL && row[2] != NULL) ? *(float *)row[2] : INFINITY;
+  double  rmax = (row != NULL && row[3] != NULL) ? *(float *)row[3] : -INFINITY;
+  taos_free_result(result);
+
+  bool ok = (rcount == count) && (fabs(rsum - sum) < 1e-3) && (count == 0 || (rmin == min && rmax == max));
+  printf("%s %-6s %-24s count:%lld/%lld sum:%.3f/%.3f min:%.3f/%.3f max:%.3f/%.3f\n", ok ? "PASS" : "FAIL", phase,
+         cond, (long long)rcount, (long long)count, rsum, sum, rmin, min, rmax, max);
+
+  if (!ok) numOfFailed++;
+}
+
+static int lessThan10(float v) { return v < 10; }
+static int lessEqual12(float v) { return v <= 12.5; }
+static int largerThan15(float v) { return v > 15; }
+static int between(float v) { return v >= 7.5 && v <= 17; }
+static int notEqual8(float v) { return v != 8; }
+static int allRows(float v) { return v > 4; }
+
+static void checkAll(const char *phase) {
+  checkQuery("v < 10", lessThan10, phase);
+  checkQuery("v <= 12.5", lessEqual12, phase);
+  checkQuery("v > 15", largerThan15, phase);
+  checkQuery("v >= 7.5 and v <= 17", between, phase);
+  checkQuery("v <> 8", notEqual8, phase);
+  checkQuery("v > 4", allRows, phase);
+}
+
+int main(int argc, char *argv[]) {
+  const char *ip = (argc > 1) ? argv[1] : "127.0.0.1";
+  if (argc > 2) taos_options(TSDB_OPTION_CONFIGDIR, argv[2]);
+
+  taos_init();
+
+  taos = taos_connect(ip, "root", "taosdata", NULL, 0);
+  if (taos == NULL) {
+    printf("failed to connect to server:%s, reason:%s\n", ip, taos_errstr(taos));
+    exit(1);
+  }
+
+  taos_query(taos, "drop database if exists fftest");
+
+  char sql[4096];
+  snprintf(sql, sizeof(sql), "create database fftest ctime %d rows 200", COMMIT_TIME);
+  execute(sql);
+  execute("use fftest");
+  execute("create table t (ts timestamp, v float)");
+
+  for (int i = 0; i < NUM_OF_ROWS;) {
+    int len = sprintf(sql, "insert into t values");
+    for (int j = 0; j < 100 && i < NUM_OF_ROWS; ++j, ++i) {
+      len += sprintf(sql + len, " (%lld, %f)", START_TS + i * 1000LL, rowValue(i));
+    }
+    execute(sql);
+  }
+
+  checkAll("cache");
+
+  // wait for the rows to be committed into file blocks, which have the pre-computed min/max
+  printf("wait %d seconds for the cache to be committed\n", COMMIT_TIME + 5);
+  sleep(COMMIT_TIME + 5);
+
+  checkAll("file");
+
+  taos_query(taos, "drop database if exists fftest");
+  taos_close(taos);
+
+  printf("%s, %d failed\n", numOfFailed == 0 ? "all passed" : "failed", numOfFailed);
+  return numOfFailed == 0 ? 0 : 1;
+}
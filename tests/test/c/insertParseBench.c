@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Benchmark of the client parser of insert VALUES clauses, on statements generated the way taosdemo does. The
+// VALUES clause is parsed by tsParseValues into a data block, with no server involved, and every parsed row is
+// compared with the values the statement is generated from.
+// usage: insertParseBench [rows-per-statement] [number-of-statements]
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "tschemautil.h"
+#include "tscUtil.h"
+#include "tsclient.h"
+#include "ttime.h"
+
+int tsParseValues(char **str, STableDataBlocks *pDataBlock, SMeterMeta *pMeterMeta, int maxRows,
+                  SParsedDataColInfo *spd, char *error, int32_t *code, char *tmpTokenBuf);
+
+#define START_TS    1500000000000LL
+#define MAX_COLUMNS 8
+
+typedef struct {
+  const char *name;
+  const char *desc;
+  int32_t     numOfCols;
+  int16_t     types[MAX_COLUMNS];
+  int16_t     bytes[MAX_COLUMNS];
+  bool        timeStr;  // the timestamp is written as 'YYYY-MM-DD HH:MM:SS.mmm'
+} SBenchCase;
+
+static SBenchCase cases[] = {
+    {"default", "ts, int x 3, as taosdemo by default", 4,
+     {TSDB_DATA_TYPE_TIMESTAMP, TSDB_DATA_TYPE_INT, TSDB_DATA_TYPE_INT, TSDB_DATA_TYPE_INT},
+     {8, 4, 4, 4}, false},
+    {"numeric", "ts, tinyint, smallint, int, bigint, float, double", 7,
+     {TSDB_DATA_TYPE_TIMESTAMP, TSDB_DATA_TYPE_TINYINT, TSDB_DATA_TYPE_SMALLINT, TSDB_DATA_TYPE_INT,
+      TSDB_DATA_TYPE_BIGINT, TSDB_DATA_TYPE_FLOAT, TSDB_DATA_TYPE_DOUBLE},
+     {8, 1, 2, 4, 8, 4, 8}, false},
+    {"string", "'time string', binary(16), int, double", 4,
+     {TSDB_DATA_TYPE_TIMESTAMP, TSDB_DATA_TYPE_BINARY, TSDB_DATA_TYPE_INT, TSDB_DATA_TYPE_DOUBLE},
+     {8, 16, 4, 8}, true},
+};
+
+static int32_t numOfRows = 1000;
+static int32_t numOfStatements = 2000;
+static int32_t numOfFailed = 0;
+
+static int64_t nowNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/*
+ * print one value as taosdemo does, and put the value it stands for into the expected row. Numbers are converted
+ * back from the text, the parser shall return the same correctly rounded values.
+ */
+static int32_t generateValue(char *pstr, int16_t type, int16_t bytes, int32_t row, bool timeStr, char *expect) {
+  char    text[64];
+  int32_t len = 0;
+
+  switch (type) {
+    case TSDB_DATA_TYPE_TIMESTAMP: {
+      int64_t ts = START_TS + row;
+      if (!timeStr) {
+        *(int64_t *)expect = ts;
+        return sprintf(pstr, "%lld", (long long)ts);
+      }
+
+      time_t    t = (time_t)(ts / 1000);
+      struct tm tm;
+      localtime_r(&t, &tm);
+      len = (int32_t)strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &tm);
+      len += sprintf(text + len, ".%03d", (int32_t)(ts % 1000));
+      taosParseTime(text, (int64_t *)expect, len, TSDB_TIME_PRECISION_MILLI);
+      return sprintf(pstr, "'%s'", text);
+    }
+    case TSDB_DATA_TYPE_TINYINT:
+      *(int8_t *)expect = (int8_t)(rand() % 128);
+      return sprintf(pstr, "%d", *(int8_t *)expect);
+    case TSDB_DATA_TYPE_SMALLINT:
+      *(int16_t *)expect = (int16_t)(rand() % 32767);
+      return sprintf(pstr, "%d", *(int16_t *)expect);
+    case TSDB_DATA_TYPE_INT:
+      *(int32_t *)expect = rand() % 10;
+      return sprintf(pstr, "%d", *(int32_t *)expect);
+    case TSDB_DATA_TYPE_BIGINT:
+      *(int64_t *)expect = rand() % 2147483648L;
+      return sprintf(pstr, "%lld", (long long)*(int64_t *)expect);
+    case TSDB_DATA_TYPE_FLOAT:
+      len = sprintf(text, "%10.4f", (float)rand() / 1000);
+      *(float *)expect = (float)strtod(text, NULL);
+      return sprintf(pstr, "%s", text);
+    case TSDB_DATA_TYPE_DOUBLE:
+      len = sprintf(text, "%20.8f", (double)rand() / 1000000);
+      *(double *)expect = strtod(text, NULL);
+      return sprintf(pstr, "%s", text);
+    default:
+      for (len = 0; len < bytes - 1; ++len) text[len] = "abcdefghijklmnopqrstuvwxyz0123456789"[rand() % 36];
+      memset(expect, 0, bytes);
+      memcpy(expect, text, len);
+      return sprintf(pstr, "'%.*s'", len, text);
+  }
+}
+
+static void benchOne(SBenchCase *pCase) {
+  SMeterMeta *pMeta = calloc(1, sizeof(SMeterMeta) + sizeof(SSchema) * pCase->numOfCols);
+  SSchema *   pSchema = tsGetSchema(pMeta);
+  pMeta->numOfColumns = pCase->numOfCols;
+  pMeta->precision = TSDB_TIME_PRECISION_MILLI;
+  for (int32_t i = 0; i < pCase->numOfCols; ++i) {
+    pSchema[i].type = (uint8_t)pCase->types[i];
+    pSchema[i].bytes = pCase->bytes[i];
+    sprintf(pSchema[i].name, "c%d", i);
+    pMeta->rowSize += pCase->bytes[i];
+  }
+
+  SParsedDataColInfo spd = {0};
+  spd.numOfCols = pCase->numOfCols;
+  spd.numOfAssignedCols = pCase->numOfCols;
+  for (int32_t i = 0; i < pCase->numOfCols; ++i) {
+    spd.hasVal[i] = true;
+    spd.elems[i].colIndex = (int16_t)i;
+    spd.elems[i].offset = (int16_t)((i > 0) ? spd.elems[i - 1].offset + pSchema[i - 1].bytes : 0);
+  }
+
+  // the VALUES clause of one statement, as "insert into test.t0 values" is followed by
+  char *  sql = malloc((size_t)numOfRows * (pCase->numOfCols * 40 + 8) + 1);
+  char *  expect = calloc(numOfRows, pMeta->rowSize);
+  char *  pstr = sql;
+  for (int32_t r = 0; r < numOfRows; ++r) {
+    char *pRow = expect + (size_t)r * pMeta->rowSize;
+    pstr += sprintf(pstr, " (");
+    for (int32_t i = 0; i < pCase->numOfCols; ++i) {
+      if (i > 0) pstr += sprintf(pstr, ", ");
+      pstr += generateValue(pstr, pCase->types[i], pCase->bytes[i], r, pCase->timeStr, pRow + spd.elems[i].offset);
+    }
+    pstr += sprintf(pstr, ")");
+  }
+  size_t sqlLen = pstr - sql;
+
+  char    error[512] = {0};
+  char    tmpTokenBuf[TSDB_MAX_BYTES_PER_ROW];
+  int32_t code = 0;
+  int32_t rows = 0;
+  bool    ok = true;
+
+  int64_t elapsed = 0;
+  for (int32_t s = 0; s < numOfStatements && ok; ++s) {
+    STableDataBlocks *pBlock = tscCreateDataBlock(pMeta->rowSize * 16);
+    pBlock->rowSize = pMeta->rowSize;
+    pBlock->tsSource = -1;
+
+    char *  str = sql;
+    int64_t st = nowNs();
+    rows = tsParseValues(&str, pBlock, pMeta, 16, &spd, error, &code, tmpTokenBuf);
+    elapsed += nowNs() - st;
+
+    // the last statement is checked row by row
+    if (rows != numOfRows) {
+      printf("failed to parse %s, rows:%d code:%d reason:%s\n", pCase->name, rows, code, error);
+      ok = false;
+    } else if (s == numOfStatements - 1 && memcmp(pBlock->pData, expect, (size_t)numOfRows * pMeta->rowSize) != 0) {
+      for (int32_t r = 0; r < numOfRows; ++r) {
+        if (memcmp(pBlock->pData + (size_t)r * pMeta->rowSize, expect + (size_t)r * pMeta->rowSize,
+                   pMeta->rowSize) != 0) {
+          printf("%s, row %d is not parsed as expected\n", pCase->name, r);
+          break;
+        }
+      }
+      ok = false;
+    }
+
+    tscDestroyDataBlock(pBlock);
+  }
+
+  if (!ok) numOfFailed++;
+
+  double totalRows = (double)numOfRows * numOfStatements;
+  printf("%s %-8s %-52s %8.0f ns/row %6.2f Mrows/s %7.1f MB/s\n", ok ? "PASS" : "FAIL", pCase->name, pCase->desc,
+         elapsed / totalRows, totalRows * 1000 / (elapsed > 0 ? elapsed : 1),
+         (double)sqlLen * numOfStatements * 1000 / (elapsed > 0 ? elapsed : 1));
+
+  free(expect);
+  free(sql);
+  free(pMeta);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 1) numOfRows = atoi(argv[1]);
+  if (argc > 2) numOfStatements = atoi(argv[2]);
+  if (numOfRows <= 0 || numOfRows > INT16_MAX || numOfStatements <= 0) {
+    printf("usage: %s [rows-per-statement] [number-of-statements]\n", argv[0]);
+    return 1;
+  }
+
+  tzset();
+  srand(1);
+
+  printf("%d rows per statement, %d statements\n", numOfRows, numOfStatements);
+  for (int32_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+    benchOne(&cases[i]);
+  }
+
+  printf("%s, %d failed\n", numOfFailed == 0 ? "all passed" : "failed", numOfFailed);
+  return numOfFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Benchmark of an interval query on a super table, whose meters are in one vnode, so that the query is split into
+// sub queries over ranges of meters within the vnode. The data is inserted once and kept for the later runs, the
+// server is restarted with a different number of query threads between the runs to get the scaling. The result of
+// each query is compared with the one computed from the inserted values.
+// usage: queryScaleBench [server-ip] [config-dir] [number-of-meters] [rows-per-meter] [repeat]
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <taos.h>
+
+#define NUM_OF_GROUPS 10
+#define START_TS      1699999200000LL  // aligned to the hour
+#define ROW_INTERVAL  60000LL          // one row per minute
+#define WINDOW        3600000LL        // interval(1h)
+
+static TAOS *  taos;
+static int32_t numOfMeters = 4096;
+static int32_t numOfRows = 720;
+static int32_t repeat = 5;
+static int     numOfFailed = 0;
+
+static int64_t nowMs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+}
+
+static void execute(const char *sql) {
+  if (taos_query(taos, sql) != 0) {
+    printf("failed to execute:%.128s, reason:%s\n", sql, taos_errstr(taos));
+    exit(1);
+  }
+
+  TAOS_RES *result = taos_use_result(taos);
+  if (result != NULL) taos_free_result(result);
+}
+
+static int32_t rowValue(int32_t meter, int32_t row) { return (meter + row) % 100; }
+
+static int64_t countRows() {
+  if (taos_query(taos, "select count(*) from qsbench.stb") != 0) return -1;
+
+  TAOS_RES *result = taos_use_result(taos);
+  TAOS_ROW  row = taos_fetch_row(result);
+  int64_t   count = (row != NULL && row[0] != NULL) ? *(int64_t *)row[0] : 0;
+  taos_free_result(result);
+  return count;
+}
+
+static void prepare() {
+  if (countRows() == (int64_t)numOfMeters * numOfRows) {
+    printf("reuse the data of %d meters x %d rows\n", numOfMeters, numOfRows);
+    return;
+  }
+
+  // all meters in one vnode
+  char sql[64 * 1024];
+  taos_query(taos, "drop database if exists qsbench");
+  snprintf(sql, sizeof(sql), "create database qsbench tables %d", numOfMeters + 100);
+  execute(sql);
+  execute("create table qsbench.stb (ts timestamp, v int) tags (t int)");
+
+  int64_t st = nowMs();
+  for (int32_t i = 0; i < numOfMeters; ++i) {
+    for (int32_t j = 0; j < numOfRows;) {
+      int len = sprintf(sql, "insert into qsbench.m%d using qsbench.stb tags (%d) values", i, i % NUM_OF_GROUPS);
+      for (int32_t k = 0; k < 1000 && j < numOfRows; ++k, ++j) {
+        len += sprintf(sql + len, " (%lld, %d)", START_TS + j * ROW_INTERVAL, rowValue(i, j));
+      }
+      execute(sql);
+    }
+  }
+  printf("%d meters x %d rows inserted in %lld ms\n", numOfMeters, numOfRows, (long long)(nowMs() - st));
+}
+
+static int compareMs(const void *lhs, const void *rhs) {
+  return (int)(*(const int64_t *)lhs - *(const int64_t *)rhs);
+}
+
+int main(int argc, char *argv[]) {
+  const char *ip = (argc > 1) ? argv[1] : "127.0.0.1";
+  if (argc > 2) taos_options(TSDB_OPTION_CONFIGDIR, argv[2]);
+  if (argc > 3) numOfMeters = atoi(argv[3]);
+  if (argc > 4) numOfRows = atoi(argv[4]);
+  if (argc > 5) repeat = atoi(argv[5]);
+  if (numOfMeters <= 0 || numOfRows <= 0 || repeat <= 0) {
+    printf("usage: %s [server-ip] [config-dir] [number-of-meters] [rows-per-meter] [repeat]\n", argv[0]);
+    return 1;
+  }
+
+  taos_init();
+
+  taos = taos_connect(ip, "root", "taosdata", NULL, 0);
+  if (taos == NULL) {
+    printf("failed to connect to server:%s, reason:%s\n", ip, taos_errstr(taos));
+    exit(1);
+  }
+
+  prepare();
+
+  // the expected count and sum of each group and window
+  int32_t  numOfWindows = (int32_t)((numOfRows * ROW_INTERVAL + WINDOW - 1) / WINDOW);
+  int64_t *count = calloc((size_t)NUM_OF_GROUPS * numOfWindows, sizeof(int64_t));
+  int64_t *sum = calloc((size_t)NUM_OF_GROUPS * numOfWindows, sizeof(int64_t));
+  for (int32_t i = 0; i < numOfMeters; ++i) {
+    for (int32_t j = 0; j < numOfRows; ++j) {
+      int32_t w = (int32_t)(j * ROW_INTERVAL / WINDOW);
+      count[(i % NUM_OF_GROUPS) * numOfWindows + w]++;
+      sum[(i % NUM_OF_GROUPS) * numOfWindows + w] += rowValue(i, j);
+    }
+  }
+
+  const char *sql = "select count(*), avg(v) from qsbench.stb interval(1h) group by t";
+  int64_t *   elapsed = calloc(repeat, sizeof(int64_t));
+
+  for (int32_t r = 0; r < repeat; ++r) {
+    int64_t st = nowMs();
+    if (taos_query(taos, sql) != 0) {
+      printf("FAIL failed to query:%s, reason:%s\n", sql, taos_errstr(taos));
+      numOfFailed++;
+      break;
+    }
+
+    TAOS_RES *result = taos_use_result(taos);
+    TAOS_ROW  row;
+    int32_t   numOfResRows = 0, numOfBad = 0;
+    while ((row = taos_fetch_row(result)) != NULL) {
+      int32_t w = (int32_t)((*(int64_t *)row[0] - START_TS) / WINDOW);
+      int32_t g = *(int32_t *)row[3];
+      int64_t c = *(int64_t *)row[1];
+      double  avg = *(double *)row[2];
+
+      numOfResRows++;
+      if (w < 0 || w >= numOfWindows || g < 0 || g >= NUM_OF_GROUPS) {
+        numOfBad++;
+        continue;
+      }
+
+      int64_t ec = count[g * numOfWindows + w];
+      if (c != ec || fabs(avg - (double)sum[g * numOfWindows + w] / ec) > 1e-9) numOfBad++;
+    }
+    taos_free_result(result);
+    elapsed[r] = nowMs() - st;
+
+    bool ok = (numOfBad == 0 && numOfResRows == NUM_OF_GROUPS * numOfWindows);
+    if (!ok) numOfFailed++;
+    printf("%s round %d, %lld ms, rows:%d/%d bad:%d\n", ok ? "PASS" : "FAIL", r, (long long)elapsed[r], numOfResRows,
+           NUM_OF_GROUPS * numOfWindows, numOfBad);
+  }
+
+  qsort(elapsed, repeat, sizeof(int64_t), compareMs);
+  printf("%d meters x %d rows, min:%lld ms median:%lld ms\n", numOfMeters, numOfRows, (long long)elapsed[0],
+         (long long)elapsed[repeat / 2]);
+
+  free(elapsed);
+  free(sum);
+  free(count);
+  taos_close(taos);
+
+  printf("%s, %d failed\n", numOfFailed == 0 ? "all passed" : "failed", numOfFailed);
+  return numOfFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Throughput and dispatch latency of the task scheduler against the number of worker threads. Producer threads
+// schedule short tasks, one out of ten with the urgent priority, and each task records the time from being
+// scheduled to being started by a worker. Every task must run exactly once.
+// usage: schedBench [number-of-tasks] [task-work-ns] [number-of-producers]
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "tsched.h"
+
+#define URGENT_RATIO 10  // one out of URGENT_RATIO tasks is urgent
+#define QUEUE_SIZE   10000
+
+typedef struct {
+  int64_t scheduled;  // ns
+  int64_t latency;    // ns
+  int32_t numOfRuns;
+} STaskSlot;
+
+typedef struct {
+  pthread_t thread;
+  void *    qhandle;
+  int32_t   start;
+  int32_t   end;
+} SProducer;
+
+static int32_t    numOfTasks = 200000;
+static int32_t    taskWork = 1000;
+static int32_t    numOfProducers = 4;
+static STaskSlot *slots = NULL;
+static int32_t    numOfDone = 0;
+static int32_t    numOfFailed = 0;
+
+static int64_t nowNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void benchTask(SSchedMsg *pMsg) {
+  STaskSlot *pSlot = (STaskSlot *)pMsg->ahandle;
+  int64_t    st = nowNs();
+
+  pSlot->latency = st - pSlot->scheduled;
+  pSlot->numOfRuns++;
+
+  while (nowNs() - st < taskWork) {
+  }
+
+  __sync_add_and_fetch(&numOfDone, 1);
+}
+
+static void *produceMain(void *param) {
+  SProducer *pProducer = (SProducer *)param;
+
+  for (int32_t i = pProducer->start; i < pProducer->end; ++i) {
+    SSchedMsg msg = {0};
+    msg.fp = benchTask;
+    msg.ahandle = slots + i;
+
+    slots[i].scheduled = nowNs();
+    taosScheduleTaskWithPriority(pProducer->qhandle, &msg,
+                                 (i % URGENT_RATIO) == 0 ? TSCHED_PRIORITY_URGENT : TSCHED_PRIORITY_NORMAL);
+  }
+
+  return NULL;
+}
+
+static int compareLatency(const void *lhs, const void *rhs) {
+  int64_t l = *(const int64_t *)lhs;
+  int64_t r = *(const int64_t *)rhs;
+  return (l == r) ? 0 : ((l < r) ? -1 : 1);
+}
+
+static double percentile(int64_t *latency, int32_t num, double p) {
+  if (num == 0) return 0;
+  qsort(latency, num, sizeof(int64_t), compareLatency);
+  return latency[(int32_t)((num - 1) * p)] / 1000.0;
+}
+
+static void benchOne(int32_t numOfThreads) {
+  memset(slots, 0, sizeof(STaskSlot) * numOfTasks);
+  numOfDone = 0;
+
+  void *qhandle = taosInitScheduler(QUEUE_SIZE, numOfThreads, "bench");
+  if (qhandle == NULL) {
+    printf("FAIL %2d threads, failed to init the scheduler\n", numOfThreads);
+    numOfFailed++;
+    return;
+  }
+
+  SProducer *pProducers = calloc(numOfProducers, sizeof(SProducer));
+  int64_t    st = nowNs();
+  for (int32_t i = 0; i < numOfProducers; ++i) {
+    pProducers[i].qhandle = qhandle;
+    pProducers[i].start = (int32_t)((int64_t)numOfTasks * i / numOfProducers);
+    pProducers[i].end = (int32_t)((int64_t)numOfTasks * (i + 1) / numOfProducers);
+    pthread_create(&pProducers[i].thread, NULL, produceMain, pProducers + i);
+  }
+
+  for (int32_t i = 0; i < numOfProducers; ++i) pthread_join(pProducers[i].thread, NULL);
+  while (__sync_fetch_and_add(&numOfDone, 0) < numOfTasks) usleep(100);
+  int64_t elapsed = nowNs() - st;
+
+  taosCleanUpScheduler(qhandle);
+  free(pProducers);
+
+  int64_t *normal = malloc(sizeof(int64_t) * numOfTasks);
+  int64_t *urgent = malloc(sizeof(int64_t) * numOfTasks);
+  int32_t  numOfNormal = 0, numOfUrgent = 0, numOfBad = 0;
+  for (int32_t i = 0; i < numOfTasks; ++i) {
+    if (slots[i].numOfRuns != 1) numOfBad++;
+    if ((i % URGENT_RATIO) == 0) {
+      urgent[numOfUrgent++] = slots[i].latency;
+    } else {
+      normal[numOfNormal++] = slots[i].latency;
+    }
+  }
+
+  bool ok = (numOfBad == 0);
+  if (!ok) numOfFailed++;
+
+  printf("%s %2d threads %9.0f tasks/s normal p50:%8.1f p99:%9.1f us urgent p50:%8.1f p99:%9.1f us bad:%d\n",
+         ok ? "PASS" : "FAIL", numOfThreads, (double)numOfTasks * 1e9 / elapsed, percentile(normal, numOfNormal, 0.5),
+         percentile(normal, numOfNormal, 0.99), percentile(urgent, numOfUrgent, 0.5),
+         percentile(urgent, numOfUrgent, 0.99), numOfBad);
+
+  free(urgent);
+  free(normal);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 1) numOfTasks = atoi(argv[1]);
+  if (argc > 2) taskWork = atoi(argv[2]);
+  if (argc > 3) numOfProducers = atoi(argv[3]);
+  if (numOfTasks <= 0 || taskWork < 0 || numOfProducers <= 0) {
+    printf("usage: %s [number-of-tasks] [task-work-ns] [number-of-producers]\n", argv[0]);
+    return 1;
+  }
+
+  slots = malloc(sizeof(STaskSlot) * numOfTasks);
+  printf("%d tasks of %d ns, %d producers, %ld cores\n", numOfTasks, taskWork, numOfProducers,
+         sysconf(_SC_NPROCESSORS_ONLN));
+
+  int32_t threads[] = {1, 2, 4, 8, 16, 32};
+  for (int32_t i = 0; i < sizeof(threads) / sizeof(threads[0]); ++i) {
+    benchOne(threads[i]);
+  }
+
+  free(slots);
+  printf("%s, %d failed\n", numOfFailed == 0 ? "all passed" : "failed", numOfFailed);
+  return numOfFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Benchmark of the SDB startup, the time sdbOpenTable takes to load a table of string keys, as the meter table of
+// mnode. For each number of rows, the rows are inserted into an empty table, one out of ten is updated and one out
+// of ten is deleted. The table is then reopened twice: from the log segments left by the inserts, part of which may
+// be merged by the background compaction, and from the snapshot only. The rows are checked after each reopen.
+// usage: sdbStartupBench [directory] [number-of-rows ...]
+
+#include <dirent.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sdb.h"
+#include "tglobalcfg.h"
+
+typedef struct {
+  char    name[24];
+  int64_t val;
+} SBenchRow;
+
+static int32_t numOfFailed = 0;
+
+static int64_t nowMs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+}
+
+static void *benchAction(char action, void *row, char *str, int size, int *ssize) {
+  SBenchRow *pRow = (SBenchRow *)row;
+
+  switch (action) {
+    case SDB_TYPE_ENCODE:
+      memcpy(str, pRow, sizeof(SBenchRow));
+      *ssize = sizeof(SBenchRow);
+      return NULL;
+    case SDB_TYPE_DECODE:
+      pRow = (SBenchRow *)malloc(sizeof(SBenchRow));
+      if (pRow != NULL) memcpy(pRow, str, sizeof(SBenchRow));
+      return pRow;
+    case SDB_TYPE_RESET:
+    case SDB_TYPE_UPDATE:
+      memcpy(pRow, str, sizeof(SBenchRow));
+      return NULL;
+    case SDB_TYPE_DESTROY:
+      free(pRow);
+      return NULL;
+    default:
+      return NULL;
+  }
+}
+
+static void removeDir(const char *dir) {
+  char           fn[512];
+  struct dirent *pEntry;
+  DIR *          pDir = opendir(dir);
+  if (pDir == NULL) return;
+
+  while ((pEntry = readdir(pDir)) != NULL) {
+    if (strcmp(pEntry->d_name, ".") == 0 || strcmp(pEntry->d_name, "..") == 0) continue;
+    snprintf(fn, sizeof(fn), "%s/%s", dir, pEntry->d_name);
+    remove(fn);
+  }
+
+  closedir(pDir);
+  rmdir(dir);
+}
+
+static int64_t expectedValue(int32_t i) { return (i % 10 == 0) ? -i : i; }
+
+static int64_t dirSize(const char *dir) {
+  char           fn[512];
+  struct stat    st;
+  struct dirent *pEntry;
+  int64_t        size = 0;
+  DIR *          pDir = opendir(dir);
+  if (pDir == NULL) return 0;
+
+  while ((pEntry = readdir(pDir)) != NULL) {
+    snprintf(fn, sizeof(fn), "%s/%s", dir, pEntry->d_name);
+    if (stat(fn, &st) == 0 && S_ISREG(st.st_mode)) size += st.st_size;
+  }
+
+  closedir(pDir);
+  return size;
+}
+
+static void *openTable(int32_t numOfRows, char *dir, const char *phase) {
+  int64_t st = nowMs();
+  void *  handle = sdbOpenTable(numOfRows + 1000, sizeof(SBenchRow), "meters", SDB_KEYTYPE_STRING, dir, benchAction);
+  int64_t ms = nowMs() - st;
+
+  if (handle == NULL) {
+    printf("FAIL %-9d %-8s failed to open the table\n", numOfRows, phase);
+    numOfFailed++;
+    return NULL;
+  }
+
+  // every tenth row with remainder 5 is deleted, the others are kept with their value
+  int64_t   expectRows = numOfRows - (numOfRows + 4) / 10;
+  int32_t   numOfBad = 0;
+  SBenchRow key;
+  memset(&key, 0, sizeof(key));
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    snprintf(key.name, sizeof(key.name), "m%d", i);
+    SBenchRow *pRow = (SBenchRow *)sdbGetRow(handle, key.name);
+    if (i % 10 == 5) {
+      if (pRow != NULL) numOfBad++;
+    } else if (pRow == NULL || pRow->val != expectedValue(i)) {
+      numOfBad++;
+    }
+  }
+
+  bool ok = (sdbGetNumOfRows(handle) == expectRows) && numOfBad == 0;
+  if (!ok) numOfFailed++;
+
+  printf("%s %-9d %-8s open:%6lld ms files:%5lld MB rows:%lld/%lld bad:%d\n", ok ? "PASS" : "FAIL", numOfRows, phase,
+         (long long)ms, (long long)(dirSize(dir) >> 20), (long long)sdbGetNumOfRows(handle), (long long)expectRows,
+         numOfBad);
+  return handle;
+}
+
+static void benchOne(const char *base, int32_t numOfRows) {
+  char dir[256];
+  snprintf(dir, sizeof(dir), "%s/sdbbench.%d.%d", base, (int)getpid(), numOfRows);
+  removeDir(dir);
+  if (mkdir(dir, 0755) != 0) {
+    printf("FAIL %-9d failed to create directory:%s\n", numOfRows, dir);
+    numOfFailed++;
+    return;
+  }
+
+  void *handle = sdbOpenTable(numOfRows + 1000, sizeof(SBenchRow), "meters", SDB_KEYTYPE_STRING, dir, benchAction);
+  if (handle == NULL) {
+    printf("FAIL %-9d failed to create the table\n", numOfRows);
+    numOfFailed++;
+    removeDir(dir);
+    return;
+  }
+
+  int64_t st = nowMs();
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    SBenchRow *pRow = (SBenchRow *)calloc(1, sizeof(SBenchRow));
+    snprintf(pRow->name, sizeof(pRow->name), "m%d", i);
+    pRow->val = i;
+    sdbInsertRow(handle, pRow, 0);
+  }
+
+  SBenchRow key;
+  memset(&key, 0, sizeof(key));
+  for (int32_t i = 0; i < numOfRows; i += 10) {
+    snprintf(key.name, sizeof(key.name), "m%d", i);
+    SBenchRow *pRow = (SBenchRow *)sdbGetRow(handle, key.name);
+    pRow->val = expectedValue(i);
+    sdbUpdateRow(handle, pRow, 0, 1);
+  }
+
+  for (int32_t i = 5; i < numOfRows; i += 10) {
+    snprintf(key.name, sizeof(key.name), "m%d", i);
+    sdbDeleteRow(handle, sdbGetRow(handle, key.name));
+  }
+  printf("     %-9d %-8s write:%5lld ms\n", numOfRows, "insert", (long long)(nowMs() - st));
+  sdbCloseTable(handle);
+
+  handle = openTable(numOfRows, dir, "log");
+  if (handle != NULL) {
+    sdbSaveSnapShot(handle);
+    sdbCloseTable(handle);
+  }
+
+  handle = openTable(numOfRows, dir, "snapshot");
+  if (handle != NULL) sdbCloseTable(handle);
+
+  removeDir(dir);
+}
+
+int main(int argc, char *argv[]) {
+  const char *base = (argc > 1) ? argv[1] : "/tmp";
+  int32_t     defaults[] = {1000000, 5000000, 10000000};
+
+  sdbDebugFlag = 131;
+  tsNumOfCores = (int32_t)sysconf(_SC_NPROCESSORS_ONLN);
+  printf("%d cores\n", tsNumOfCores);
+
+  if (argc > 2) {
+    for (int i = 2; i < argc; ++i) {
+      int32_t numOfRows = atoi(argv[i]);
+      if (numOfRows <= 0) {
+        printf("usage: %s [directory] [number-of-rows ...]\n", argv[0]);
+        return 1;
+      }
+      benchOne(base, numOfRows);
+    }
+  } else {
+    for (int i = 0; i < sizeof(defaults) / sizeof(defaults[0]); ++i) benchOne(base, defaults[i]);
+  }
+
+  printf("%s, %d failed\n", numOfFailed == 0 ? "all passed" : "failed", numOfFailed);
+  return numOfFailed == 0 ? 0 : 1;
+}